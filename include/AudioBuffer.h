@@ -42,7 +42,7 @@ namespace lmms
  *
  * Features:
  * - Up to `MaxChannelsPerAudioBuffer` total channels
- * - Audio data in planar format (plus a temporary interleaved buffer for conversions until we use planar only)
+ * - Audio data in planar format (plus an interleaved scratch buffer for plugins which still process interleaved audio)
  * - All planar buffers are sourced from the same large buffer for better cache locality
  * - Custom allocator support
  * - Silence tracking for each channel (NOTE: requires careful use so that non-silent data is not written to a
@@ -57,12 +57,13 @@ namespace lmms
  * - All planar audio data for all channels in an AudioBuffer is sourced from the same large contiguous
  *       buffer called the source buffer (m_sourceBuffer).
  * - The source buffer consists of the buffer for 1st channel followed by the buffer for the 2nd channel, and so on
- *       for all channels. In total, the number of elements is `channels * frames`.
+ *       for all channels. Each channel buffer starts at an `AudioBufferAlignment`-byte boundary, so channels are
+ *       padded to a multiple of that size and the source buffer has some room for aligning the first channel.
  * - A separate vector of non-owning pointers to channel buffers is also maintained. In this vector, each index
  *       corresponds to a channel, providing a mapping from the channel index to a pointer to the start of that
  *       channel's buffer within the source buffer. This is called the access buffer (m_accessBuffer).
  * - The purpose of the access buffer is to provide channel-wise access to buffers within the source buffer, so
- *       it's `m_accessBuffer[channelIdx][frameIdx]` instead of `m_sourceBuffer[channelIdx * frames + frameIdx]`.
+ *       it's `m_accessBuffer[channelIdx][frameIdx]` instead of `m_sourceBuffer[offset + channelIdx * stride + frameIdx]`.
  *       This is very important since many APIs dealing with planar audio expect it in this `float**` 2D array form.
  * - Groups have no effect on the audio data layout in the source/access buffers and are merely a layer built on top.
  *       Conveniently, if you take `m_accessBuffer` and offset it by `channelIndex`, you get another `float**`
@@ -133,7 +134,7 @@ public:
 	/**
 	 * Creates AudioBuffer with a 1st (main) channel group.
 	 *
-	 * Silence tracking is enabled or disabled depending on the auto-quit setting.
+	 * Silence tracking is enabled.
 	 *
 	 * @param frames frame count for each channel
 	 * @param channels channel count for the 1st group, or zero to skip adding the 1st group
@@ -145,7 +146,7 @@ public:
 	/**
 	 * Creates AudioBuffer with groups defined.
 	 *
-	 * Silence tracking is enabled or disabled depending on the auto-quit setting.
+	 * Silence tracking is enabled.
 	 *
 	 * @param frames frame count for each channel
 	 * @param channels total channel count
@@ -226,6 +227,8 @@ public:
 	auto frames() const -> f_cnt_t { return m_frames; }
 
 	//! @returns scratch buffer for conversions between interleaved and planar TODO: Remove once using planar only
+	//! The planar buffers are the only ones kept up to date, the contents of this one are only
+	//! meaningful right after converting to it.
 	auto interleavedBuffer() const -> InterleavedBufferView<const float, 2>
 	{
 		assert(hasInterleavedBuffer());
@@ -305,8 +308,9 @@ public:
 	 * When silence tracking is enabled, channels will be checked for silence whenever their data may
 	 * have changed, so it'll always be known whether they are silent or non-silent. There is a performance cost
 	 * to this, but it is likely worth it since this information allows many effects to be put to sleep
-	 * when their inputs are silent ("auto-quit"). When a channel is known to be silent, it also
-	 * enables optimizations in buffer sanitization, buffer zeroing, and finding the absolute peak sample value.
+	 * when their inputs are silent ("auto-quit"), and lets the mixer skip silent buses, channels and sends.
+	 * When a channel is known to be silent, it also enables optimizations in buffer sanitization, buffer zeroing,
+	 * and finding the absolute peak sample value.
 	 *
 	 * When silence tracking is disabled, channels are not checked for silence, so a silence flag may be
 	 * unset despite the channel being silent. Non-silence must be assumed whenever the silence status is not
@@ -355,6 +359,9 @@ public:
 	/**
 	 * @brief Updates the silence status of the given channels, up to the upperBound index.
 	 *
+	 * Channels found to be silent are also zeroed, so a set silence flag always
+	 * means the channel's samples are exactly zero.
+	 *
 	 * @param channels channels to update; 1 = selected, 0 = skip
 	 * @param upperBound any channel indexes at or above this are skipped
 	 * @returns true if all selected channels were silent
@@ -372,7 +379,9 @@ public:
 	 */
 	void silenceChannels(const ChannelFlags& channels, ch_cnt_t upperBound = MaxChannelsPerAudioBuffer);
 
-	//! Silences (zeroes) all channels. @see silenceChannels
+	//! Silences (zeroes) all channels. Like silenceChannels, channels already known
+	//! to be silent are not touched since their samples are already zero, so
+	//! silencing a quiet buffer is almost free.
 	void silenceAllChannels();
 
 	//! @returns absolute peak sample value for the given channel
@@ -395,6 +404,7 @@ private:
 
 	/**
 	 * Interleaved scratch buffer for conversions between interleaved and planar.
+	 * Not kept in sync with the planar buffers.
 	 *
 	 * TODO: Remove once using planar only
 	 */
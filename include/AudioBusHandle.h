@@ -37,6 +37,7 @@ namespace lmms
 {
 
 class EffectChain;
+class EncoderThread;
 class FloatModel;
 class BoolModel;
 
@@ -54,6 +55,16 @@ class BoolModel;
 class AudioBusHandle : public ThreadableJob
 {
 public:
+	//! Work its play handles leave to the bus, because it can be done for
+	//! all of them at once. The bus runs it at the start of its job, when
+	//! all of its play handles are done with the period.
+	class VoiceProcessor
+	{
+	public:
+		virtual ~VoiceProcessor() = default;
+		virtual void processVoices() = 0;
+	};
+
 	AudioBusHandle(const QString& name, bool hasEffectChain = true,
 		FloatModel* volumeModel = nullptr, FloatModel* panningModel = nullptr,
 		BoolModel* mutedModel = nullptr);
@@ -77,6 +88,7 @@ public:
 	// ThreadableJob stuff
 	void doProcessing() override;
 	bool requiresProcessing() const override { return true; }
+	QString profilerName() const override { return QString("%1 (effects)").arg(m_name); }
 
 	void addPlayHandle(PlayHandle* handle);
 	void removePlayHandle(PlayHandle* handle);
@@ -84,6 +96,12 @@ public:
 	//! @returns true if the processing outputted corrupted audio (infs/nans).
 	bool isCorrupted() const { return m_corrupted.load(std::memory_order_relaxed); }
 
+	//! Stem export: also write the output of every period, after effects, to @p tap.
+	//! Must only be changed while the audio engine is not rendering.
+	void setTap(EncoderThread* tap) { m_tap = tap; }
+
+	void setVoiceProcessor(VoiceProcessor* processor) { m_voiceProcessor = processor; }
+
 private:
 	volatile bool m_bufferUsage;
 
@@ -105,6 +123,10 @@ private:
 	
 	std::atomic<bool> m_corrupted = false;
 
+	EncoderThread* m_tap = nullptr;
+
+	VoiceProcessor* m_voiceProcessor = nullptr;
+
 	friend class AudioEngine;
 	friend class AudioEngineWorkerThread;
 };
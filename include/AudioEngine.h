@@ -46,6 +46,7 @@ namespace lmms
 {
 
 class MidiClient;
+class MidiPort;
 class AudioBusHandle;  // IWYU pragma: keep
 class AudioEngineWorkerThread;
 
@@ -307,6 +308,29 @@ public:
 	//! Enable/disable sanitization of inf/nan values
 	void setSanitizationEnabled(bool enabled) { m_sanitizationEnabled.store(enabled, std::memory_order_relaxed); }
 
+	//! @returns true if play handles, effects and mixer channels are rendered as one task graph
+	bool taskGraphEnabled() const { return m_taskGraphEnabled.load(std::memory_order_relaxed); }
+
+	//! Enable/disable rendering as one task graph instead of three separate stages. The task graph
+	//! lets a track's effects start as soon as its own play handles are done, and a mixer channel as
+	//! soon as its own inputs are done.
+	void setTaskGraphEnabled(bool enabled) { m_taskGraphEnabled.store(enabled, std::memory_order_relaxed); }
+
+	//! @returns true if live MIDI input is queued and played at the frame matching its arrival
+	bool midiInputTimestamping() const { return m_midiInputTimestamping.load(std::memory_order_relaxed); }
+
+	//! Enable/disable queueing live MIDI input, see MidiInputQueue. Without it, events are processed
+	//! right when they arrive and play at the start of whichever period is rendered next.
+	void setMidiInputTimestamping(bool enabled) { m_midiInputTimestamping.store(enabled, std::memory_order_relaxed); }
+
+	//! Ports whose queued MIDI input is processed at the start of every period
+	void addMidiInputPort(MidiPort* port);
+	void removeMidiInputPort(MidiPort* port);
+
+	//! @returns the number of notes that can play at once without allocating memory on the audio threads.
+	//! Instruments size their per-note state pools with it.
+	std::size_t polyphony() const { return m_polyphony; }
+
 signals:
 	void qualitySettingsChanged();
 	void sampleRateChanged();
@@ -361,7 +385,15 @@ private:
 	void renderStageInstruments();
 	void renderStageEffects();
 	void renderStageMix();
+	void renderStageGraph();
+	void renderStageGraphMix();
+
+	void processMidiInput();
+	//! Only call while not processing
+	void resetMidiInputTiming();
 
+	void removeFinishedPlayHandles();
+	void finishPeriod();
 
 	void swapBuffers();
 
@@ -407,17 +439,23 @@ private:
 	// MIDI device stuff
 	MidiClient * m_midiClient;
 	QString m_midiClientName;
+	std::vector<MidiPort*> m_midiInputPorts;
+	AudioEngineProfiler::Clock::time_point m_lastMidiInputPeriod = AudioEngineProfiler::Clock::now();
 
 	AudioEngineProfiler m_profiler;
 
 	bool m_clearSignal;
 	std::atomic<bool> m_sanitizationEnabled = false;
+	std::atomic<bool> m_taskGraphEnabled = false;
+	std::atomic<bool> m_midiInputTimestamping = false;
+	std::size_t m_polyphony;
 
 	std::recursive_mutex m_changeMutex;
 
 	friend class Engine;
 	friend class AudioEngineWorkerThread;
 	friend class ProjectRenderer;
+	friend class RenderBenchmark;
 } ;
 
 } // namespace lmms
@@ -27,6 +27,11 @@
 
 #include <array>
 #include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <QByteArray>
 #include <QFile>
 
 #include "LmmsTypes.h"
@@ -35,15 +40,28 @@
 namespace lmms
 {
 
+class ThreadableJob;
+
+/**
+ * Measures the CPU load of the audio engine.
+ *
+ * If the output file given to setOutputFile() ends with ".json", every
+ * processed ThreadableJob is recorded together with the worker that ran it
+ * and written as Chrome trace events (chrome://tracing, Perfetto). Otherwise
+ * the duration of every period is written as one line of plain text.
+ */
 class AudioEngineProfiler
 {
 public:
+	using Clock = std::chrono::steady_clock;
+
 	AudioEngineProfiler();
-	~AudioEngineProfiler() = default;
+	~AudioEngineProfiler();
 
 	void startPeriod()
 	{
 		m_periodTimer.reset();
+		m_periodStart = Clock::now();
 	}
 
 	void finishPeriod( sample_rate_t sampleRate, f_cnt_t framesPerPeriod );
@@ -55,6 +73,21 @@ public:
 
 	void setOutputFile( const QString& outputFile );
 
+	//! Number of job queue workers, including the one run by the audio engine thread
+	void setNumThreads( std::size_t numThreads ) { m_numThreads = numThreads; }
+
+	bool jobTracing() const
+	{
+		return m_jobTracing.load(std::memory_order_relaxed);
+	}
+
+	//! Called by the job queue after @p worker processed @p job. Realtime-safe.
+	void recordJob(std::size_t worker, const ThreadableJob* job, Clock::time_point start, Clock::time_point end);
+
+	//! Resolves the names of all jobs recorded so far. Called by the audio
+	//! engine thread before finished jobs may be deleted.
+	void collectJobSamples();
+
 	enum class DetailType {
 		NoteSetup,
 		Instruments,
@@ -70,6 +103,48 @@ public:
 		return m_detailLoad[static_cast<std::size_t>(type)].load(std::memory_order_relaxed);
 	}
 
+	//! Processing times in microseconds, summed up since the last resetTotals()
+	struct Totals
+	{
+		std::uint64_t periods = 0;
+		std::uint64_t periodTime = 0;
+		std::array<std::uint64_t, DetailCount> detailTime = {};
+	};
+
+	//! Not synchronized, only read it while the audio engine isn't rendering
+	const Totals& totals() const
+	{
+		return m_totals;
+	}
+
+	void resetTotals()
+	{
+		m_totals = {};
+	}
+
+	//! Time from the arrival of live MIDI input until it plays, see MidiInputQueue
+	struct MidiLatencyHistogram
+	{
+		static constexpr std::size_t Buckets = 64;
+		//! Width of a bucket in microseconds
+		static constexpr std::uint64_t BucketWidth = 500;
+
+		//! The last bucket also counts everything longer
+		std::array<std::uint64_t, Buckets> counts = {};
+
+		std::uint64_t events() const;
+
+		//! @return the latency in microseconds that @p fraction of all events stay below
+		double percentile(double fraction) const;
+	};
+
+	//! Called by the audio engine for every live MIDI event it plays. Realtime-safe.
+	void recordMidiInputLatency(Clock::duration latency);
+
+	MidiLatencyHistogram midiInputLatency() const;
+
+	void resetMidiInputLatency();
+
 	class Probe
 	{
 	public:
@@ -90,6 +165,48 @@ public:
 	};
 
 private:
+	struct JobSample
+	{
+		const ThreadableJob* job;
+		Clock::time_point start;
+		Clock::time_point end;
+	};
+
+	//! Single producer, single consumer ring of job samples, one per worker
+	class JobRing
+	{
+	public:
+		explicit JobRing(std::size_t capacity) : m_samples(capacity) {}
+
+		bool push(const JobSample& sample)
+		{
+			const auto head = m_head.load(std::memory_order_relaxed);
+			if (head - m_tail.load(std::memory_order_acquire) == m_samples.size()) { return false; }
+			m_samples[head % m_samples.size()] = sample;
+			m_head.store(head + 1, std::memory_order_release);
+			return true;
+		}
+
+		bool pop(JobSample& sample)
+		{
+			const auto tail = m_tail.load(std::memory_order_relaxed);
+			if (tail == m_head.load(std::memory_order_acquire)) { return false; }
+			sample = m_samples[tail % m_samples.size()];
+			m_tail.store(tail + 1, std::memory_order_release);
+			return true;
+		}
+
+	private:
+		std::vector<JobSample> m_samples;
+		std::atomic_size_t m_head = 0;
+		std::atomic_size_t m_tail = 0;
+	};
+
+	static constexpr std::size_t JobRingSize = 4096;
+
+	void writeTraceEvents(sample_rate_t sampleRate, f_cnt_t framesPerPeriod);
+	void closeOutputFile();
+
 	void startDetail(const DetailType type) { m_detailTimer[static_cast<std::size_t>(type)].reset(); }
 	void finishDetail(const DetailType type)
 	{
@@ -104,6 +221,18 @@ private:
 	std::array<MicroTimer, DetailCount> m_detailTimer;
 	std::array<int, DetailCount> m_detailTime{0};
 	std::array<std::atomic<float>, DetailCount> m_detailLoad{0};
+	Totals m_totals;
+
+	// per-job tracing
+	std::size_t m_numThreads = 1;
+	std::atomic_bool m_jobTracing = false;
+	std::vector<std::unique_ptr<JobRing>> m_jobRings;
+	std::atomic_size_t m_droppedJobs = 0;
+	Clock::time_point m_traceStart;
+	Clock::time_point m_periodStart;
+	QByteArray m_traceEvents;
+
+	std::array<std::atomic<std::uint64_t>, MidiLatencyHistogram::Buckets> m_midiLatency = {};
 };
 
 } // namespace lmms
@@ -28,6 +28,10 @@
 #include <QThread>
 
 #include <atomic>
+#include <memory>
+#include <vector>
+
+#include "WorkStealingDeque.h"
 
 class QWaitCondition;
 
@@ -35,6 +39,7 @@ namespace lmms
 {
 
 class AudioEngine;
+class AudioEngineProfiler;
 class ThreadableJob;
 
 class AudioEngineWorkerThread : public QThread
@@ -42,6 +47,12 @@ class AudioEngineWorkerThread : public QThread
 	Q_OBJECT
 public:
 	// internal representation of the job queue - all functions are thread-safe
+	//
+	// Every worker owns a work-stealing deque. Jobs added from outside the
+	// workers are spread round-robin across all deques, jobs added by a job
+	// that is being processed go to the deque of the worker processing it.
+	// Idle workers steal from the other deques, so no worker ever has to
+	// scan the whole queue.
 	class JobQueue
 	{
 	public:
@@ -51,29 +62,52 @@ public:
 			Dynamic	// jobs can be added while processing queue
 		} ;
 
+		//! Capacity of each worker's deque
 		static constexpr size_t JOB_QUEUE_SIZE = 8192;
 
-		JobQueue() :
-			m_items(),
-			m_writeIndex( 0 ),
-			m_itemsDone( 0 ),
-			m_opMode( OperationMode::Static )
-		{
-			std::fill(m_items, m_items + JOB_QUEUE_SIZE, nullptr);
-		}
+		//! Worker index of the thread calling startAndWaitForJobs()
+		static constexpr size_t InlineWorker = static_cast<size_t>(-1);
+
+		JobQueue( size_t numWorkers = 1 );
+
+		//! Not thread-safe, must only be called while no jobs are processed
+		void setNumWorkers( size_t numWorkers );
+		size_t numWorkers() const { return m_deques.size(); }
 
 		void reset( OperationMode _opMode );
 
-		void addJob( ThreadableJob * _job );
+		//! Report the processing time of every job to @p profiler if it is tracing jobs
+		void setProfiler( AudioEngineProfiler * profiler ) { m_profiler = profiler; }
 
-		void run();
+		//! @returns false if the job does not require processing and was not queued
+		bool addJob( ThreadableJob * _job );
+
+		//! Opens the queue for workers; jobs may only be added from outside
+		//! of run() while the queue is closed
+		void start();
+		//! Processes jobs as worker @p worker until there is nothing left to do
+		void run( size_t worker = InlineWorker );
+		//! Waits until all jobs are done and all workers left run(), then
+		//! closes the queue again
 		void wait();
 
 	private:
-		std::atomic<ThreadableJob*> m_items[JOB_QUEUE_SIZE];
-		std::atomic_size_t m_writeIndex;
-		std::atomic_size_t m_itemsDone;
+		using Deque = WorkStealingDeque<ThreadableJob>;
+
+		ThreadableJob * takeJob( size_t worker );
+		void processJob( ThreadableJob * job, size_t worker );
+		bool empty() const;
+
+		std::vector<std::unique_ptr<Deque>> m_deques;
+		std::atomic_size_t m_jobsQueued;
+		std::atomic_size_t m_jobsDone;
+		std::atomic_size_t m_activeWorkers;
+		std::atomic_bool m_open;
+		size_t m_nextDeque;
 		OperationMode m_opMode;
+		AudioEngineProfiler * m_profiler;
+
+		static thread_local size_t s_currentWorker;
 	} ;
 
 
@@ -88,9 +122,9 @@ public:
 		globalJobQueue.reset( _opMode );
 	}
 
-	static void addJob( ThreadableJob * _job )
+	static bool addJob( ThreadableJob * _job )
 	{
-		globalJobQueue.addJob( _job );
+		return globalJobQueue.addJob( _job );
 	}
 
 	// a convenient helper function allowing to pass a container with pointers
@@ -108,6 +142,11 @@ public:
 
 	static void startAndWaitForJobs();
 
+	static void setProfiler( AudioEngineProfiler * profiler )
+	{
+		globalJobQueue.setProfiler( profiler );
+	}
+
 
 private:
 	void run() override;
@@ -116,6 +155,7 @@ private:
 	static QWaitCondition * queueReadyWaitCond;
 	static QList<AudioEngineWorkerThread *> workerThreads;
 
+	size_t m_index;
 	volatile bool m_quit;
 } ;
 
@@ -25,7 +25,9 @@
 #ifndef LMMS_AUTOMATABLE_MODEL_H
 #define LMMS_AUTOMATABLE_MODEL_H
 
+#include <atomic>
 #include <cmath>
+#include <span>
 #include <QMap>
 #include <QMutex>
 
@@ -175,8 +177,15 @@ public:
 
 	//! @brief Function that returns sample-exact data as a ValueBuffer
 	//! @return pointer to model's valueBuffer when s.ex.data exists, NULL otherwise
+	//!
+	//! If another thread is calculating the buffer of this period right now,
+	//! the calling thread waits until that buffer is published.
 	ValueBuffer * valueBuffer();
 
+	//! @brief Writes sample-exact data for @p values.size() frames of the current period,
+	//! starting at frame @p offset, into the valueBuffer of this model and the linked ones
+	void setAutomatedValues(f_cnt_t offset, std::span<const float> values);
+
 	template<class T>
 	T initValue() const
 	{
@@ -301,16 +310,19 @@ public:
 		m_hasStrictStepSize = b;
 	}
 
-	static void incrementPeriodCounter()
-	{
-		++s_periodCounter;
-	}
+	static void incrementPeriodCounter();
 
 	static void resetPeriodCounter()
 	{
 		s_periodCounter = 0;
 	}
 
+	//! Number of models whose value buffer was calculated in the last period
+	static int recomputedValueBuffers()
+	{
+		return s_recomputedLastPeriod.load(std::memory_order_relaxed);
+	}
+
 	bool useControllerValue() const
 	{
 		return m_useControllerValue;
@@ -369,6 +381,12 @@ private:
 	}
 
 	void setValueInternal(const float value);
+	void setAutomatedValuesInternal(f_cnt_t offset, std::span<const float> values);
+
+	//! Calculates the value buffer for the current period into @p buffer,
+	//! ramping from @p oldValue, which is updated if it was used
+	//! @return whether @p buffer holds sample exact data
+	bool updateValueBuffer(ValueBuffer& buffer, float& oldValue);
 
 	//! linking is stored in a linked list ring
 	//! @return the model whose `m_nextLink` is `this`,
@@ -411,14 +429,19 @@ private:
 	ControllerConnection* m_controllerConnection;
 
 
+	// The value buffer is calculated once per period by the first thread
+	// asking for it, which claims the period in m_claimedPeriod. Publishing
+	// the period in m_lastUpdatedPeriod hands the buffer to all other threads,
+	// which only read it from then on. Threads asking before it is published
+	// wait for it, see valueBuffer().
 	ValueBuffer m_valueBuffer;
-	long m_lastUpdatedPeriod;
-	static long s_periodCounter;
+	std::atomic<long> m_lastUpdatedPeriod;
+	std::atomic<long> m_claimedPeriod;
+	static std::atomic<long> s_periodCounter;
 
 	bool m_hasSampleExactData;
 
-	// prevent several threads from attempting to write the same vb at the same time
-	QMutex m_valueBufferMutex;
+	static std::atomic<int> s_recomputedLastPeriod;
 
 	bool m_useControllerValue;
 
@@ -0,0 +1,111 @@
+/*
+ * AutomatedValueList.h - the models automation clips control at one point in
+ *                        time, gathered without allocating
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_AUTOMATED_VALUE_LIST_H
+#define LMMS_AUTOMATED_VALUE_LIST_H
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+#include "AutomatableModel.h"
+#include "lmms_export.h"
+
+namespace lmms
+{
+
+class AutomationClip;
+class Clip;
+
+/**
+ * @brief The models automation clips control at one point in time, and which
+ * clip controls each of them.
+ *
+ * TrackContainer::collectAutomatedValues() fills it walking the clips from the
+ * highest precedence down, so the first clip added for a model wins and every
+ * model is evaluated only once. All storage is kept between uses, so once it
+ * has grown to the size of the project, the song can gather the values for
+ * every tick without allocating.
+ */
+class LMMS_EXPORT AutomatedValueList
+{
+public:
+	struct Entry
+	{
+		AutomatableModel* model;
+		const AutomationClip* clip;
+		float time; //!< position in the clip
+		float end; //!< the clip holds its value after this position
+		float value; //!< the clip's value at time, set by evaluate()
+	};
+
+	using const_iterator = std::vector<Entry>::const_iterator;
+
+	//! Removes all entries, keeping the memory
+	void clear();
+
+	//! Adds @p model, controlled by @p clip at @p time, unless the model is
+	//! already controlled by a clip added before
+	void add(AutomatableModel* model, const AutomationClip* clip, float time, float end);
+
+	bool contains(const AutomatableModel* model) const;
+
+	//! Sets the value of all entries
+	void evaluate();
+
+	/**
+	 * @brief Writes the values of @p entry for @p out.size() frames, starting
+	 * @p ticks after the entry's position and advancing @p ticksPerFrame per
+	 * frame. The values are not scaled to the model.
+	 */
+	static void valuesAfter(const Entry& entry, float ticks, float ticksPerFrame, std::span<float> out);
+
+	AutomatedValueMap toMap() const;
+
+	const_iterator begin() const { return m_entries.begin(); }
+	const_iterator end() const { return m_entries.end(); }
+	std::size_t size() const { return m_entries.size(); }
+	bool empty() const { return m_entries.empty(); }
+
+	//! Scratch space for gathering the clips of the song and of a pattern,
+	//! which is done while the clips of the song are being walked
+	std::vector<Clip*>& songClips() { return m_songClips; }
+	std::vector<Clip*>& patternClips() { return m_patternClips; }
+
+private:
+	std::size_t slot(const AutomatableModel* model) const;
+	void grow();
+
+	std::vector<Entry> m_entries;
+
+	//! Open addressing hash set of the models in m_entries, its size is a
+	//! power of two and at least twice the number of entries
+	std::vector<const AutomatableModel*> m_models;
+
+	std::vector<Clip*> m_songClips;
+	std::vector<Clip*> m_patternClips;
+};
+
+} // namespace lmms
+
+#endif // LMMS_AUTOMATED_VALUE_LIST_H
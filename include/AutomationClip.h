@@ -27,6 +27,10 @@
 #ifndef LMMS_AUTOMATION_CLIP_H
 #define LMMS_AUTOMATION_CLIP_H
 
+#include <atomic>
+#include <span>
+#include <vector>
+
 #include <QMap>
 #include <QPointer>
 
@@ -65,7 +69,7 @@ public:
 	using TimemapIterator = timeMap::const_iterator;
 
 	AutomationClip( AutomationTrack * _auto_track );
-	~AutomationClip() override = default;
+	~AutomationClip() override;
 
 	bool addObject( AutomatableModel * _obj, bool _search_dup = true );
 
@@ -166,7 +170,13 @@ public:
 		return supportsTangentEditing(m_progressionType);
 	}
 
+	//! Realtime safe, it never locks or waits for the thread editing the clip
 	float valueAt( const TimePos & _time ) const;
+	//! Same as valueAt(), for positions between two ticks
+	float valueAt(float ticks) const;
+	//! Writes the values at @p ticks, @p ticks + @p step and so on to @p out.
+	//! Positions after @p end read the value at @p end. Realtime safe.
+	void valuesAt(float ticks, float step, float end, std::span<float> out) const;
 	float *valuesAfter( const TimePos & _time ) const;
 
 	QString name() const;
@@ -215,6 +225,21 @@ private:
 	void generateTangents(timeMap::iterator it, int numToGenerate);
 	float valueAt( timeMap::const_iterator v, int offset ) const;
 
+	//! Has to be called whenever anything that shapes the curve changes.
+	//! Compiles the curve again, unless between beginCurveEdit() and
+	//! endCurveEdit(). Not realtime safe.
+	void invalidateCurve();
+
+	//! Defers compiling the curve until the matching endCurveEdit(), for
+	//! changes made node by node. Calls may be nested.
+	void beginCurveEdit();
+	void endCurveEdit();
+
+	//! Compiles the time map and publishes the result to valueAt()
+	void updateCurve();
+	//! Frees all replaced curves, if no lookup might still read them
+	void freeRetiredCurves();
+
 	/**
 	 * @brief
 	 * This function combines the song tracks, pattern store tracks,
@@ -233,6 +258,42 @@ private:
 	objectVector m_objects;
 	timeMap m_timeMap;	// actual values
 	timeMap m_oldTimeMap;	// old values for storing the values before setDragValue() is called.
+
+	//! A node of the time map, with what's needed to evaluate the curve up
+	//! to the next node computed in advance
+	struct CurvePoint
+	{
+		float pos;
+		float inValue;
+		float outValue;
+		float length; //!< distance to the next node, 0 for the last one
+		float slope;
+		float nextInValue;
+		float outTangent; //!< scaled by length and tension
+		float nextInTangent; //!< scaled by length and tension
+	};
+
+	//! The time map compiled into a flat array, so playback doesn't have to
+	//! search the map and recompute the segment for every value
+	struct CompiledCurve
+	{
+		std::vector<CurvePoint> points;
+		ProgressionType type;
+	};
+
+	float curveValueAt(const CompiledCurve& curve, float ticks) const;
+
+	// The curve is compiled on the thread editing the clip, like ClipIndex
+	// builds its snapshots, and published with an atomic pointer swap. A
+	// replaced curve is freed by a later update once no lookup is running.
+	std::atomic<const CompiledCurve*> m_curve;
+	//! Number of lookups reading m_curve right now
+	mutable std::atomic<int> m_curveReaders;
+	mutable std::atomic<std::size_t> m_curveHint; //!< point used by the last lookup
+	// guarded by m_clipMutex
+	std::vector<const CompiledCurve*> m_retiredCurves;
+	int m_curveEdits; //!< nesting depth of beginCurveEdit()
+	bool m_curveDirty;
 	float m_tension;
 	bool m_hasAutomation;
 	ProgressionType m_progressionType;
@@ -34,7 +34,17 @@
 #include <algorithm>
 #include <array>
 #include <cmath>
+#include <functional>
+#include <initializer_list>
 #include <numbers>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#ifdef __SSE2__
+	#include <emmintrin.h>
+#endif
 
 #include "lmms_constants.h"
 #include "LmmsTypes.h"
@@ -44,6 +54,7 @@ namespace lmms
 {
 
 template<ch_cnt_t CHANNELS=DEFAULT_CHANNELS> class BasicFilters;
+template<ch_cnt_t CHANNELS=DEFAULT_CHANNELS> class BasicFilterBank;
 
 template<ch_cnt_t CHANNELS>
 class LinkwitzRiley
@@ -219,6 +230,165 @@ private:
 };
 using StereoOnePole = OnePole<2>;
 
+/**
+ * @brief One sample of each of @p N voices
+ *
+ * Used by BasicFilterBank to run the filters of BasicFilters on several voices
+ * at once. The operations work lane by lane in loops of constant length,
+ * which the compiler turns into SIMD instructions.
+ */
+template<std::size_t N>
+struct SampleLanes
+{
+	std::array<sample_t, N> v;
+
+	SampleLanes() = default;
+	SampleLanes( sample_t x ) { v.fill( x ); }
+
+	static constexpr std::size_t size() { return N; }
+
+	sample_t& operator[]( std::size_t lane ) { return v[lane]; }
+	sample_t operator[]( std::size_t lane ) const { return v[lane]; }
+
+	SampleLanes& operator+=( const SampleLanes& b )
+	{
+		for( std::size_t i = 0; i < N; ++i ) { v[i] += b.v[i]; }
+		return *this;
+	}
+
+	SampleLanes& operator-=( const SampleLanes& b )
+	{
+		for( std::size_t i = 0; i < N; ++i ) { v[i] -= b.v[i]; }
+		return *this;
+	}
+
+	SampleLanes& operator*=( const SampleLanes& b )
+	{
+		for( std::size_t i = 0; i < N; ++i ) { v[i] *= b.v[i]; }
+		return *this;
+	}
+
+	friend SampleLanes operator+( SampleLanes a, const SampleLanes& b ) { return a += b; }
+	friend SampleLanes operator-( SampleLanes a, const SampleLanes& b ) { return a -= b; }
+	friend SampleLanes operator*( SampleLanes a, const SampleLanes& b ) { return a *= b; }
+
+	friend SampleLanes clamp( SampleLanes a, sample_t lo, sample_t hi )
+	{
+#ifdef __SSE2__
+		// the same as std::clamp(), including NaN, but the compiler doesn't
+		// turn the branches into min/max instructions by itself
+		if constexpr( N % 4 == 0 )
+		{
+			for( std::size_t i = 0; i < N; i += 4 )
+			{
+				const __m128 x = _mm_max_ps( _mm_set1_ps( lo ), _mm_loadu_ps( &a.v[i] ) );
+				_mm_storeu_ps( &a.v[i], _mm_min_ps( _mm_set1_ps( hi ), x ) );
+			}
+			return a;
+		}
+#endif
+		for( std::size_t i = 0; i < N; ++i ) { a.v[i] = std::clamp( a.v[i], lo, hi ); }
+		return a;
+	}
+
+	friend SampleLanes lerp( SampleLanes a, const SampleLanes& b, float t )
+	{
+		for( std::size_t i = 0; i < N; ++i ) { a.v[i] = std::lerp( a.v[i], b.v[i], t ); }
+		return a;
+	}
+};
+
+//! In/out history of BasicFilters for @p N channels, with one voice per
+//! lane if @p V is SampleLanes
+template<typename V, std::size_t N>
+struct BasicFilterState
+{
+	using Values = std::array<V, N>;
+
+	// biquad filter
+	Values z1, z2;
+
+	// in/out history for moog-filter
+	Values y1, y2, y3, y4, oldx, oldy1, oldy2, oldy3;
+	// additional one for Tripole filter
+	Values last;
+
+	// in/out history for RC-type-filters
+	Values rcbp0, rclp0, rchp0, rclast0;
+	Values rcbp1, rclp1, rchp1, rclast1;
+
+	// in/out history for Formant-filters
+	std::array<Values, 6> vfbp, vfhp, vflast;
+
+	// in/out history for Lowpass_SV (state-variant lowpass)
+	Values delay1, delay2, delay3, delay4;
+
+	//! Calls @p f with every history array of this and @p other
+	template<typename W, typename F>
+	void zip( BasicFilterState<W, N>& other, F&& f )
+	{
+		using Pair = std::pair<Values*, typename BasicFilterState<W, N>::Values*>;
+		for( auto [a, b] : std::initializer_list<Pair>{ {&z1, &other.z1}, {&z2, &other.z2},
+			{&y1, &other.y1}, {&y2, &other.y2}, {&y3, &other.y3}, {&y4, &other.y4},
+			{&oldx, &other.oldx}, {&oldy1, &other.oldy1}, {&oldy2, &other.oldy2}, {&oldy3, &other.oldy3},
+			{&last, &other.last},
+			{&rcbp0, &other.rcbp0}, {&rclp0, &other.rclp0}, {&rchp0, &other.rchp0}, {&rclast0, &other.rclast0},
+			{&rcbp1, &other.rcbp1}, {&rclp1, &other.rclp1}, {&rchp1, &other.rchp1}, {&rclast1, &other.rclast1},
+			{&delay1, &other.delay1}, {&delay2, &other.delay2}, {&delay3, &other.delay3}, {&delay4, &other.delay4} } )
+		{
+			f( *a, *b );
+		}
+		for( std::size_t i = 0; i < 6; ++i )
+		{
+			f( vfbp[i], other.vfbp[i] );
+			f( vfhp[i], other.vfhp[i] );
+			f( vflast[i], other.vflast[i] );
+		}
+	}
+
+	void clear()
+	{
+		zip( *this, []( Values& a, Values& ) { a.fill( 0.0f ); } );
+	}
+};
+
+//! Coefficients of BasicFilters, with one voice per lane if @p V is SampleLanes
+template<typename V>
+struct BasicFilterCoeffs
+{
+	// biquad filter
+	V a1{}, a2{}, b0{}, b1{}, b2{};
+
+	// coeffs for moog-filter
+	V r{}, p{}, k{};
+
+	// coeffs for RC-type-filters
+	V rca{}, rcb{}, rcc{}, rcq{};
+
+	// coeffs for formant-filters
+	std::array<V, 2> vfa{}, vfb{}, vfc{};
+	V vfq{};
+
+	// coeffs for Lowpass_SV (state-variant lowpass)
+	V svf1{}, svf2{}, svq{};
+
+	//! Calls @p f with every coefficient of this and @p other
+	template<typename W, typename F>
+	void zip( BasicFilterCoeffs<W>& other, F&& f )
+	{
+		for( auto [a, b] : std::initializer_list<std::pair<V*, W*>>{ {&a1, &other.a1}, {&a2, &other.a2},
+			{&b0, &other.b0}, {&b1, &other.b1}, {&b2, &other.b2},
+			{&r, &other.r}, {&p, &other.p}, {&k, &other.k},
+			{&rca, &other.rca}, {&rcb, &other.rcb}, {&rcc, &other.rcc}, {&rcq, &other.rcq},
+			{&vfa[0], &other.vfa[0]}, {&vfb[0], &other.vfb[0]}, {&vfc[0], &other.vfc[0]},
+			{&vfa[1], &other.vfa[1]}, {&vfb[1], &other.vfb[1]}, {&vfc[1], &other.vfc[1]},
+			{&vfq, &other.vfq}, {&svf1, &other.svf1}, {&svf2, &other.svf2}, {&svq, &other.svq} } )
+		{
+			f( *a, *b );
+		}
+	}
+};
+
 template<ch_cnt_t CHANNELS>
 class BasicFilters
 {
@@ -298,33 +468,7 @@ public:
 
 	inline void clearHistory()
 	{
-		// reset in/out history for biquads
-		m_biQuad.clearHistory();
-
-		// reset in/out history
-		for( ch_cnt_t _chnl = 0; _chnl < CHANNELS; ++_chnl )
-		{
-			// reset in/out history for moog-filter
-			m_y1[_chnl] = m_y2[_chnl] = m_y3[_chnl] = m_y4[_chnl] =
-					m_oldx[_chnl] = m_oldy1[_chnl] =
-					m_oldy2[_chnl] = m_oldy3[_chnl] = 0.0f;
-			
-			// tripole
-			m_last[_chnl] = 0.0f;
-
-			// reset in/out history for RC-filters
-			m_rclp0[_chnl] = m_rcbp0[_chnl] = m_rchp0[_chnl] = m_rclast0[_chnl] = 0.0f;
-			m_rclp1[_chnl] = m_rcbp1[_chnl] = m_rchp1[_chnl] = m_rclast1[_chnl] = 0.0f;
-
-			for(int i=0; i<6; i++)
-			   m_vfbp[i][_chnl] = m_vfhp[i][_chnl] = m_vflast[i][_chnl] = 0.0f;
-			   
-			// reset in/out history for SV-filters
-			m_delay1[_chnl] = 0.0f;
-			m_delay2[_chnl] = 0.0f;
-			m_delay3[_chnl] = 0.0f;
-			m_delay4[_chnl] = 0.0f;
-		}
+		m_state.clear();
 	}
 
 	inline void setSampleRate(const sample_rate_t sampleRate)
@@ -339,34 +483,77 @@ public:
 
 	inline sample_t update( sample_t _in0, ch_cnt_t _chnl )
 	{
-		sample_t out = 0.0f;
-		switch( m_type )
+		return withType(m_type, [&](auto type) { return filterSample<decltype(type)::value>(_in0, _chnl); });
+	}
+
+	//! Filters @p frames frames in place with the current coefficients. Does
+	//! the same as calling update() for every sample, but switches on the
+	//! filter type once for the whole block instead of once per sample. The
+	//! samples are still filtered one at a time, one voice per filter.
+	template<typename Frame>
+	inline void process( Frame* buffer, const f_cnt_t frames )
+	{
+		withType(m_type, [&](auto type) {
+			for( f_cnt_t f = 0; f < frames; ++f )
+			{
+				for( ch_cnt_t ch = 0; ch < CHANNELS; ++ch )
+				{
+					buffer[f][ch] = filterSample<decltype(type)::value>(buffer[f][ch], ch);
+				}
+			}
+		});
+	}
+
+	//! Filters one sample with the filter type given at compile time, which
+	//! must be the current one, see setFilterType()
+	template<FilterType Type>
+	inline sample_t filterSample( sample_t _in0, ch_cnt_t _chnl )
+	{
+		const sample_t out = filterKernel<Type>( _in0, m_state, _chnl, m_coeffs );
+		return m_doubleFilter ? m_subFilter->template filterSample<Type>( out, _chnl ) : out;
+	}
+
+	//! Filters one sample of the history at @p idx of @p s. Written once for
+	//! a single voice (V = sample_t) and for the lanes of BasicFilterBank
+	//! (V = SampleLanes), which filter every lane the same way.
+	template<FilterType Type, typename V, std::size_t N>
+	static inline V filterKernel( V _in0, BasicFilterState<V, N>& s, std::size_t idx, const BasicFilterCoeffs<V>& c )
+	{
+		using std::clamp;
+		using std::lerp;
+
+		// the history may alias the coefficients as far as the compiler knows,
+		// so it would load them again after every store
+		const V rca = c.rca, rcb = c.rcb, rcc = c.rcc, rcq = c.rcq;
+
+		V out = 0.0f;
+		switch( Type )
 		{
 			case FilterType::Moog:
 			{
-				sample_t x = _in0 - m_r*m_y4[_chnl];
+				V x = _in0 - c.r*s.y4[idx];
 
 				// four cascaded onepole filters
 				// (bilinear transform)
-				m_y1[_chnl] = std::clamp((x + m_oldx[_chnl]) * m_p
-							- m_k * m_y1[_chnl], -10.0f,
+				s.y1[idx] = clamp((x + s.oldx[idx]) * c.p
+							- c.k * s.y1[idx], -10.0f,
 								10.0f);
-				m_y2[_chnl] = std::clamp((m_y1[_chnl] + m_oldy1[_chnl]) * m_p
-							- m_k * m_y2[_chnl], -10.0f,
+				s.y2[idx] = clamp((s.y1[idx] + s.oldy1[idx]) * c.p
+							- c.k * s.y2[idx], -10.0f,
 								10.0f);
-				m_y3[_chnl] = std::clamp((m_y2[_chnl] + m_oldy2[_chnl]) * m_p
-							- m_k * m_y3[_chnl], -10.0f,
+				s.y3[idx] = clamp((s.y2[idx] + s.oldy2[idx]) * c.p
+							- c.k * s.y3[idx], -10.0f,
 								10.0f );
-				m_y4[_chnl] = std::clamp((m_y3[_chnl] + m_oldy3[_chnl]) * m_p
-							- m_k * m_y4[_chnl], -10.0f,
+				s.y4[idx] = clamp((s.y3[idx] + s.oldy3[idx]) * c.p
+							- c.k * s.y4[idx], -10.0f,
 								10.0f);
 
-				m_oldx[_chnl] = x;
-				m_oldy1[_chnl] = m_y1[_chnl];
-				m_oldy2[_chnl] = m_y2[_chnl];
-				m_oldy3[_chnl] = m_y3[_chnl];
-				out = m_y4[_chnl] - m_y4[_chnl] * m_y4[_chnl] *
-						m_y4[_chnl] * ( 1.0f / 6.0f );
+				s.oldx[idx] = x;
+				s.oldy1[idx] = s.y1[idx];
+				s.oldy2[idx] = s.y2[idx];
+				s.oldy3[idx] = s.y3[idx];
+				out = s.y4[idx] - s.y4[idx] * s.y4[idx] *
+						s.y4[idx] * ( 1.0f / 6.0f );
 				break;
 			}
 			
@@ -378,25 +565,25 @@ public:
 				for( int i = 0; i < 4; ++i )
 				{
 					ip += 0.25f;
-					sample_t x = std::lerp(m_last[_chnl], _in0, ip) - m_r * m_y3[_chnl];
+					V x = lerp(s.last[idx], _in0, ip) - c.r * s.y3[idx];
 					
-					m_y1[_chnl] = std::clamp((x + m_oldx[_chnl]) * m_p
-							- m_k * m_y1[_chnl], -10.0f,
+					s.y1[idx] = clamp((x + s.oldx[idx]) * c.p
+							- c.k * s.y1[idx], -10.0f,
 								10.0f);
-					m_y2[_chnl] = std::clamp((m_y1[_chnl] + m_oldy1[_chnl]) * m_p
-								- m_k * m_y2[_chnl], -10.0f,
+					s.y2[idx] = clamp((s.y1[idx] + s.oldy1[idx]) * c.p
+								- c.k * s.y2[idx], -10.0f,
 									10.0f);
-					m_y3[_chnl] = std::clamp((m_y2[_chnl] + m_oldy2[_chnl]) * m_p
-								- m_k * m_y3[_chnl], -10.0f,
+					s.y3[idx] = clamp((s.y2[idx] + s.oldy2[idx]) * c.p
+								- c.k * s.y3[idx], -10.0f,
 									10.0f);
-					m_oldx[_chnl] = x;
-					m_oldy1[_chnl] = m_y1[_chnl];
-					m_oldy2[_chnl] = m_y2[_chnl];
+					s.oldx[idx] = x;
+					s.oldy1[idx] = s.y1[idx];
+					s.oldy2[idx] = s.y2[idx];
 					
-					out += ( m_y3[_chnl] - m_y3[_chnl] * m_y3[_chnl] * m_y3[_chnl] * ( 1.0f / 6.0f ) );
+					out += ( s.y3[idx] - s.y3[idx] * s.y3[idx] * s.y3[idx] * ( 1.0f / 6.0f ) );
 				}
 				out *= 0.25f;
-				m_last[_chnl] = _in0;
+				s.last[idx] = _in0;
 				return out;
 			}
 			
@@ -407,33 +594,33 @@ public:
 			case FilterType::Lowpass_SV:
 			case FilterType::Bandpass_SV:
 			{
-				float highpass;
+				V highpass;
 				
 				for( int i = 0; i < 2; ++i ) // 2x oversample
 				{
-					m_delay2[_chnl] = m_delay2[_chnl] + m_svf1 * m_delay1[_chnl];				/* delay2/4 = lowpass output */
-					highpass = _in0 - m_delay2[_chnl] - m_svq * m_delay1[_chnl];
-					m_delay1[_chnl] = m_svf1 * highpass + m_delay1[_chnl];           			/* delay1/3 = bandpass output */
+					s.delay2[idx] = s.delay2[idx] + c.svf1 * s.delay1[idx];				/* delay2/4 = lowpass output */
+					highpass = _in0 - s.delay2[idx] - c.svq * s.delay1[idx];
+					s.delay1[idx] = c.svf1 * highpass + s.delay1[idx];           			/* delay1/3 = bandpass output */
 
-					m_delay4[_chnl] = m_delay4[_chnl] + m_svf2 * m_delay3[_chnl];
-					highpass = m_delay2[_chnl] - m_delay4[_chnl] - m_svq * m_delay3[_chnl];
-					m_delay3[_chnl] = m_svf2 * highpass + m_delay3[_chnl];
+					s.delay4[idx] = s.delay4[idx] + c.svf2 * s.delay3[idx];
+					highpass = s.delay2[idx] - s.delay4[idx] - c.svq * s.delay3[idx];
+					s.delay3[idx] = c.svf2 * highpass + s.delay3[idx];
 				}
 
 				/* mix filter output into output buffer */
-				return m_type == FilterType::Lowpass_SV 
-					? m_delay4[_chnl]
-					: m_delay3[_chnl];
+				return Type == FilterType::Lowpass_SV 
+					? s.delay4[idx]
+					: s.delay3[idx];
 			}
 			
 			case FilterType::Highpass_SV:
 			{
-				float hp;
+				V hp;
 				for( int i = 0; i < 2; ++i ) // 2x oversample
 				{				
-					m_delay2[_chnl] = m_delay2[_chnl] + m_svf1 * m_delay1[_chnl];
-					hp = _in0 - m_delay2[_chnl] - m_svq * m_delay1[_chnl];
-					m_delay1[_chnl] = m_svf1 * hp + m_delay1[_chnl];
+					s.delay2[idx] = s.delay2[idx] + c.svf1 * s.delay1[idx];
+					hp = _in0 - s.delay2[idx] - c.svq * s.delay1[idx];
+					s.delay1[idx] = c.svf1 * hp + s.delay1[idx];
 				}
 				
 				return hp;
@@ -441,20 +628,20 @@ public:
 			
 			case FilterType::Notch_SV:
 			{
-				float hp1;
+				V hp1;
 				for( int i = 0; i < 2; ++i ) // 2x oversample
 				{
-					m_delay2[_chnl] = m_delay2[_chnl] + m_svf1 * m_delay1[_chnl];				/* delay2/4 = lowpass output */
-					hp1 = _in0 - m_delay2[_chnl] - m_svq * m_delay1[_chnl];
-					m_delay1[_chnl] = m_svf1 * hp1 + m_delay1[_chnl];           			/* delay1/3 = bandpass output */
+					s.delay2[idx] = s.delay2[idx] + c.svf1 * s.delay1[idx];				/* delay2/4 = lowpass output */
+					hp1 = _in0 - s.delay2[idx] - c.svq * s.delay1[idx];
+					s.delay1[idx] = c.svf1 * hp1 + s.delay1[idx];           			/* delay1/3 = bandpass output */
 
-					m_delay4[_chnl] = m_delay4[_chnl] + m_svf2 * m_delay3[_chnl];
-					float hp2 = m_delay2[_chnl] - m_delay4[_chnl] - m_svq * m_delay3[_chnl];
-					m_delay3[_chnl] = m_svf2 * hp2 + m_delay3[_chnl];
+					s.delay4[idx] = s.delay4[idx] + c.svf2 * s.delay3[idx];
+					V hp2 = s.delay2[idx] - s.delay4[idx] - c.svq * s.delay3[idx];
+					s.delay3[idx] = c.svf2 * hp2 + s.delay3[idx];
 				}
 
 				/* mix filter output into output buffer */
-				return m_delay4[_chnl] + hp1;
+				return s.delay4[idx] + hp1;
 			}
 
 
@@ -465,271 +652,192 @@ public:
 
 			case FilterType::Lowpass_RC12:
 			{
-				sample_t lp = 0.0f;
+				V lp = 0.0f;
 				for( int n = 4; n != 0; --n )
 				{
-					sample_t in = _in0 + m_rcbp0[_chnl] * m_rcq;
-					in = std::clamp(in, -1.0f, 1.0f);
+					V in = _in0 + s.rcbp0[idx] * rcq;
+					in = clamp(in, -1.0f, 1.0f);
 
-					lp = in * m_rcb + m_rclp0[_chnl] * m_rca;
-					lp = std::clamp(lp, -1.0f, 1.0f);
+					lp = in * rcb + s.rclp0[idx] * rca;
+					lp = clamp(lp, -1.0f, 1.0f);
 
-					sample_t hp = m_rcc * (m_rchp0[_chnl] + in - m_rclast0[_chnl]);
-					hp = std::clamp(hp, -1.0f, 1.0f);
+					V hp = rcc * (s.rchp0[idx] + in - s.rclast0[idx]);
+					hp = clamp(hp, -1.0f, 1.0f);
 
-					sample_t bp = hp * m_rcb + m_rcbp0[_chnl] * m_rca;
-					bp = std::clamp(bp, -1.0f, 1.0f);
+					V bp = hp * rcb + s.rcbp0[idx] * rca;
+					bp = clamp(bp, -1.0f, 1.0f);
 
-					m_rclast0[_chnl] = in;
-					m_rclp0[_chnl] = lp;
-					m_rchp0[_chnl] = hp;
-					m_rcbp0[_chnl] = bp;
+					s.rclast0[idx] = in;
+					s.rclp0[idx] = lp;
+					s.rchp0[idx] = hp;
+					s.rcbp0[idx] = bp;
 				}
 				return lp;
 			}
 			case FilterType::Highpass_RC12:
 			case FilterType::Bandpass_RC12:
 			{
-				sample_t hp, bp;
+				V hp, bp;
 				for( int n = 4; n != 0; --n )
 				{
-					sample_t in = _in0 + m_rcbp0[_chnl] * m_rcq;
-					in = std::clamp(in, -1.0f, 1.0f);
+					V in = _in0 + s.rcbp0[idx] * rcq;
+					in = clamp(in, -1.0f, 1.0f);
 
-					hp = m_rcc * ( m_rchp0[_chnl] + in - m_rclast0[_chnl] );
-					hp = std::clamp(hp, -1.0f, 1.0f);
+					hp = rcc * ( s.rchp0[idx] + in - s.rclast0[idx] );
+					hp = clamp(hp, -1.0f, 1.0f);
 
-					bp = hp * m_rcb + m_rcbp0[_chnl] * m_rca;
-					bp = std::clamp(bp, -1.0f, 1.0f);
+					bp = hp * rcb + s.rcbp0[idx] * rca;
+					bp = clamp(bp, -1.0f, 1.0f);
 
-					m_rclast0[_chnl] = in;
-					m_rchp0[_chnl] = hp;
-					m_rcbp0[_chnl] = bp;
+					s.rclast0[idx] = in;
+					s.rchp0[idx] = hp;
+					s.rcbp0[idx] = bp;
 				}
-				return m_type == FilterType::Highpass_RC12 ? hp : bp;
+				return Type == FilterType::Highpass_RC12 ? hp : bp;
 			}
 
 			case FilterType::Lowpass_RC24:
 			{
-				sample_t lp;
+				V lp;
 				for( int n = 4; n != 0; --n )
 				{
 					// first stage is as for the 12dB case...
-					sample_t in = _in0 + m_rcbp0[_chnl] * m_rcq;
-					in = std::clamp(in, -1.0f, 1.0f);
+					V in = _in0 + s.rcbp0[idx] * rcq;
+					in = clamp(in, -1.0f, 1.0f);
 
-					lp = in * m_rcb + m_rclp0[_chnl] * m_rca;
-					lp = std::clamp(lp, -1.0f, 1.0f);
+					lp = in * rcb + s.rclp0[idx] * rca;
+					lp = clamp(lp, -1.0f, 1.0f);
 
-					sample_t hp = m_rcc * ( m_rchp0[_chnl] + in - m_rclast0[_chnl] );
-					hp = std::clamp(hp, -1.0f, 1.0f);
+					V hp = rcc * ( s.rchp0[idx] + in - s.rclast0[idx] );
+					hp = clamp(hp, -1.0f, 1.0f);
 
-					sample_t bp = hp * m_rcb + m_rcbp0[_chnl] * m_rca;
-					bp = std::clamp(bp, -1.0f, 1.0f);
+					V bp = hp * rcb + s.rcbp0[idx] * rca;
+					bp = clamp(bp, -1.0f, 1.0f);
 
-					m_rclast0[_chnl] = in;
-					m_rclp0[_chnl] = lp;
-					m_rcbp0[_chnl] = bp;
-					m_rchp0[_chnl] = hp;
+					s.rclast0[idx] = in;
+					s.rclp0[idx] = lp;
+					s.rcbp0[idx] = bp;
+					s.rchp0[idx] = hp;
 
 					// second stage gets the output of the first stage as input...
-					in = lp + m_rcbp1[_chnl] * m_rcq;
-					in = std::clamp(in, -1.0f, 1.0f );
+					in = lp + s.rcbp1[idx] * rcq;
+					in = clamp(in, -1.0f, 1.0f );
 
-					lp = in * m_rcb + m_rclp1[_chnl] * m_rca;
-					lp = std::clamp(lp, -1.0f, 1.0f);
+					lp = in * rcb + s.rclp1[idx] * rca;
+					lp = clamp(lp, -1.0f, 1.0f);
 
-					hp = m_rcc * ( m_rchp1[_chnl] + in - m_rclast1[_chnl] );
-					hp = std::clamp(hp, -1.0f, 1.0f);
+					hp = rcc * ( s.rchp1[idx] + in - s.rclast1[idx] );
+					hp = clamp(hp, -1.0f, 1.0f);
 
-					bp = hp * m_rcb + m_rcbp1[_chnl] * m_rca;
-					bp = std::clamp(bp, -1.0f, 1.0f);
+					bp = hp * rcb + s.rcbp1[idx] * rca;
+					bp = clamp(bp, -1.0f, 1.0f);
 
-					m_rclast1[_chnl] = in;
-					m_rclp1[_chnl] = lp;
-					m_rcbp1[_chnl] = bp;
-					m_rchp1[_chnl] = hp;
+					s.rclast1[idx] = in;
+					s.rclp1[idx] = lp;
+					s.rcbp1[idx] = bp;
+					s.rchp1[idx] = hp;
 				}
 				return lp;
 			}
 			case FilterType::Highpass_RC24:
 			case FilterType::Bandpass_RC24:
 			{
-				sample_t hp, bp;
+				V hp, bp;
 				for( int n = 4; n != 0; --n )
 				{
 					// first stage is as for the 12dB case...
-					sample_t in = _in0 + m_rcbp0[_chnl] * m_rcq;
-					in = std::clamp(in, -1.0f, 1.0f);
+					V in = _in0 + s.rcbp0[idx] * rcq;
+					in = clamp(in, -1.0f, 1.0f);
 
-					hp = m_rcc * ( m_rchp0[_chnl] + in - m_rclast0[_chnl] );
-					hp = std::clamp(hp, -1.0f, 1.0f);
+					hp = rcc * ( s.rchp0[idx] + in - s.rclast0[idx] );
+					hp = clamp(hp, -1.0f, 1.0f);
 
-					bp = hp * m_rcb + m_rcbp0[_chnl] * m_rca;
-					bp = std::clamp(bp, -1.0f, 1.0f);
+					bp = hp * rcb + s.rcbp0[idx] * rca;
+					bp = clamp(bp, -1.0f, 1.0f);
 
-					m_rclast0[_chnl] = in;
-					m_rchp0[_chnl] = hp;
-					m_rcbp0[_chnl] = bp;
+					s.rclast0[idx] = in;
+					s.rchp0[idx] = hp;
+					s.rcbp0[idx] = bp;
 
 					// second stage gets the output of the first stage as input...
-					in = m_type == FilterType::Highpass_RC24
-						? hp + m_rcbp1[_chnl] * m_rcq
-						: bp + m_rcbp1[_chnl] * m_rcq;
+					in = Type == FilterType::Highpass_RC24
+						? hp + s.rcbp1[idx] * rcq
+						: bp + s.rcbp1[idx] * rcq;
 
-					in = std::clamp(in, -1.0f, 1.0f);
+					in = clamp(in, -1.0f, 1.0f);
 
-					hp = m_rcc * ( m_rchp1[_chnl] + in - m_rclast1[_chnl] );
-					hp = std::clamp(hp, -1.0f, 1.0f);
+					hp = rcc * ( s.rchp1[idx] + in - s.rclast1[idx] );
+					hp = clamp(hp, -1.0f, 1.0f);
 
-					bp = hp * m_rcb + m_rcbp1[_chnl] * m_rca;
-					bp = std::clamp(bp, -1.0f, 1.0f);
+					bp = hp * rcb + s.rcbp1[idx] * rca;
+					bp = clamp(bp, -1.0f, 1.0f);
 
-					m_rclast1[_chnl] = in;
-					m_rchp1[_chnl] = hp;
-					m_rcbp1[_chnl] = bp;
+					s.rclast1[idx] = in;
+					s.rchp1[idx] = hp;
+					s.rcbp1[idx] = bp;
 				}
-				return m_type == FilterType::Highpass_RC24 ? hp : bp;
+				return Type == FilterType::Highpass_RC24 ? hp : bp;
 			}
 
 			case FilterType::Formantfilter:
 			case FilterType::FastFormant:
 			{
-				if (std::abs(_in0) < F_EPSILON && std::abs(m_vflast[0][_chnl]) < F_EPSILON) { return 0.0f; } // performance hack - skip processing when the numbers get too small
-
-				const int os = m_type == FilterType::FastFormant ? 1 : 4; // no oversampling for fast formant
-				for( int o = 0; o < os; ++o )
-				{
-					// first formant
-					sample_t in = _in0 + m_vfbp[0][_chnl] * m_vfq;
-					in = std::clamp(in, -1.0f, 1.0f);
-
-					sample_t hp = m_vfc[0] * ( m_vfhp[0][_chnl] + in - m_vflast[0][_chnl] );
-					hp = std::clamp(hp, -1.0f, 1.0f);
-
-					sample_t bp = hp * m_vfb[0] + m_vfbp[0][_chnl] * m_vfa[0];
-					bp = std::clamp(bp, -1.0f, 1.0f);
-
-					m_vflast[0][_chnl] = in;
-					m_vfhp[0][_chnl] = hp;
-					m_vfbp[0][_chnl] = bp;
-
-					in = bp + m_vfbp[2][_chnl] * m_vfq;
-					in = std::clamp(in, -1.0f, 1.0f);
-
-					hp = m_vfc[0] * ( m_vfhp[2][_chnl] + in - m_vflast[2][_chnl] );
-					hp = std::clamp(hp, -1.0f, 1.0f);
-
-					bp = hp * m_vfb[0] + m_vfbp[2][_chnl] * m_vfa[0];
-					bp = std::clamp(bp, -1.0f, 1.0f);
-
-					m_vflast[2][_chnl] = in;
-					m_vfhp[2][_chnl] = hp;
-					m_vfbp[2][_chnl] = bp;
-
-					in = bp + m_vfbp[4][_chnl] * m_vfq;
-					in = std::clamp(in, -1.0f, 1.0f);
-
-					hp = m_vfc[0] * ( m_vfhp[4][_chnl] + in - m_vflast[4][_chnl] );
-					hp = std::clamp(hp, -1.0f, 1.0f);
-
-					bp = hp * m_vfb[0] + m_vfbp[4][_chnl] * m_vfa[0];
-					bp = std::clamp(bp, -1.0f, 1.0f);
-
-					m_vflast[4][_chnl] = in;
-					m_vfhp[4][_chnl] = hp;
-					m_vfbp[4][_chnl] = bp;
-
-					out += bp;
-
-					// second formant
-					in = _in0 + m_vfbp[0][_chnl] * m_vfq;
-					in = std::clamp(in, -1.0f, 1.0f);
-
-					hp = m_vfc[1] * ( m_vfhp[1][_chnl] + in - m_vflast[1][_chnl] );
-					hp = std::clamp(hp, -1.0f, 1.0f);
-
-					bp = hp * m_vfb[1] + m_vfbp[1][_chnl] * m_vfa[1];
-					bp = std::clamp(bp, -1.0f, 1.0f);
-
-					m_vflast[1][_chnl] = in;
-					m_vfhp[1][_chnl] = hp;
-					m_vfbp[1][_chnl] = bp;
-
-					in = bp + m_vfbp[3][_chnl] * m_vfq;
-					in = std::clamp(in, -1.0f, 1.0f);
-
-					hp = m_vfc[1] * ( m_vfhp[3][_chnl] + in - m_vflast[3][_chnl] );
-					hp = std::clamp(hp, -1.0f, 1.0f);
-
-					bp = hp * m_vfb[1] + m_vfbp[3][_chnl] * m_vfa[1];
-					bp = std::clamp(bp, -1.0f, 1.0f);
-
-					m_vflast[3][_chnl] = in;
-					m_vfhp[3][_chnl] = hp;
-					m_vfbp[3][_chnl] = bp;
-
-					in = bp + m_vfbp[5][_chnl] * m_vfq;
-					in = std::clamp(in, -1.0f, 1.0f);
-
-					hp = m_vfc[1] * ( m_vfhp[5][_chnl] + in - m_vflast[5][_chnl] );
-					hp = std::clamp(hp, -1.0f, 1.0f);
-
-					bp = hp * m_vfb[1] + m_vfbp[5][_chnl] * m_vfa[1];
-					bp = std::clamp(bp, -1.0f, 1.0f);
-
-					m_vflast[5][_chnl] = in;
-					m_vfhp[5][_chnl] = hp;
-					m_vfbp[5][_chnl] = bp;
-
-					out += bp;
-				}
-            	return m_type == FilterType::FastFormant ? out * 2.0f : out * 0.5f;
+				return formantSample<Type>( _in0, s, idx, c );
 			}
 
 			default:
-				out = m_biQuad.update( _in0, _chnl );
+			{
+				// biquad filter in transposed form
+				out = s.z1[idx] + c.b0 * _in0;
+				s.z1[idx] = c.b1 * _in0 + s.z2[idx] - c.a1 * out;
+				s.z2[idx] = c.b2 * _in0 - c.a2 * out;
 				break;
-		}
-
-		if( m_doubleFilter )
-		{
-			return m_subFilter->update( out, _chnl );
+			}
 		}
 
 		// Clipper band limited sigmoid
 		return out;
 	}
 
-
 	inline void calcFilterCoeffs( float _freq, float _q )
+	{
+		calcCoeffs( m_type, _freq, _q, m_sampleRatio, m_coeffs );
+		if( m_doubleFilter )
+		{
+			m_subFilter->m_coeffs = m_coeffs;
+		}
+	}
+
+	//! Calculates the coefficients of @p type into @p c
+	static inline void calcCoeffs( FilterType type, float _freq, float _q, float sampleRatio,
+		BasicFilterCoeffs<float>& c )
 	{
 		using namespace std::numbers;
 		// temp coef vars
 		_q = std::max(_q, minQ());
 
-		if( m_type == FilterType::Lowpass_RC12  ||
-			m_type == FilterType::Bandpass_RC12 ||
-			m_type == FilterType::Highpass_RC12 ||
-			m_type == FilterType::Lowpass_RC24 ||
-			m_type == FilterType::Bandpass_RC24 ||
-			m_type == FilterType::Highpass_RC24 )
+		if( type == FilterType::Lowpass_RC12  ||
+			type == FilterType::Bandpass_RC12 ||
+			type == FilterType::Highpass_RC12 ||
+			type == FilterType::Lowpass_RC24 ||
+			type == FilterType::Bandpass_RC24 ||
+			type == FilterType::Highpass_RC24 )
 		{
 			_freq = std::clamp(_freq, 50.0f, 20000.0f);
-			const float sr = m_sampleRatio * 0.25f;
+			const float sr = sampleRatio * 0.25f;
 			const float f = 1.0f / (_freq * 2 * pi_v<float>);
 			
-			m_rca = 1.0f - sr / ( f + sr );
-			m_rcb = 1.0f - m_rca;
-			m_rcc = f / ( f + sr );
+			c.rca = 1.0f - sr / ( f + sr );
+			c.rcb = 1.0f - c.rca;
+			c.rcc = f / ( f + sr );
 
 			// Stretch Q/resonance, as self-oscillation reliably starts at a q of ~2.5 - ~2.6
-			m_rcq = _q * 0.25f;
+			c.rcq = _q * 0.25f;
 			return;
 		}
 
-		if( m_type == FilterType::Formantfilter ||
-			m_type == FilterType::FastFormant )
+		if( type == FilterType::Formantfilter ||
+			type == FilterType::FastFormant )
 		{
 			_freq = std::clamp(_freq, minFreq(), 20000.0f); // limit freq and q for not getting bad noise out of the filter...
 
@@ -742,7 +850,7 @@ public:
 			static const float freqRatio = 4.0f / 14000.0f;
 
 			// Stretch Q/resonance
-			m_vfq = _q * 0.25f;
+			c.vfq = _q * 0.25f;
 
 			// frequency in lmms ranges from 1Hz to 14000Hz
 			const float vowelf = _freq * freqRatio;
@@ -754,62 +862,56 @@ public:
 			const float f1 = 1.f / (std::lerp(_f[vowel+0][1], _f[vowel+1][1], fract) * 2 * pi_v<float>);
 
 			// samplerate coeff: depends on oversampling
-			const float sr = m_type == FilterType::FastFormant ? m_sampleRatio : m_sampleRatio * 0.25f;
-
-			m_vfa[0] = 1.0f - sr / ( f0 + sr );
-			m_vfb[0] = 1.0f - m_vfa[0];
-			m_vfc[0] = f0 /	( f0 + sr );
-			m_vfa[1] = 1.0f - sr / ( f1 + sr );
-			m_vfb[1] = 1.0f - m_vfa[1];
-			m_vfc[1] = f1 /	( f1 + sr );
+			const float sr = type == FilterType::FastFormant ? sampleRatio : sampleRatio * 0.25f;
+
+			c.vfa[0] = 1.0f - sr / ( f0 + sr );
+			c.vfb[0] = 1.0f - c.vfa[0];
+			c.vfc[0] = f0 /	( f0 + sr );
+			c.vfa[1] = 1.0f - sr / ( f1 + sr );
+			c.vfb[1] = 1.0f - c.vfa[1];
+			c.vfc[1] = f1 /	( f1 + sr );
 			return;
 		}
 
-		if( m_type == FilterType::Moog ||
-			m_type == FilterType::DoubleMoog )
+		if( type == FilterType::Moog ||
+			type == FilterType::DoubleMoog )
 		{
 			// [ 0 - 0.5 ]
-			const float f = std::clamp(_freq, minFreq(), 20000.0f) * m_sampleRatio;
+			const float f = std::clamp(_freq, minFreq(), 20000.0f) * sampleRatio;
 			// (Empirical tuning)
-			m_p = ( 3.6f - 3.2f * f ) * f;
-			m_k = 2.0f * m_p - 1;
-			m_r = _q * std::exp((1 - m_p) * 1.386249f);
+			c.p = ( 3.6f - 3.2f * f ) * f;
+			c.k = 2.0f * c.p - 1;
+			c.r = _q * std::exp((1 - c.p) * 1.386249f);
 
-			if( m_doubleFilter )
-			{
-				m_subFilter->m_r = m_r;
-				m_subFilter->m_p = m_p;
-				m_subFilter->m_k = m_k;
-			}
 			return;
 		}
 		
-		if( m_type == FilterType::Tripole )
+		if( type == FilterType::Tripole )
 		{
-			const float f = std::clamp(_freq, 20.0f, 20000.0f) * m_sampleRatio * 0.25f;
+			const float f = std::clamp(_freq, 20.0f, 20000.0f) * sampleRatio * 0.25f;
 			
-			m_p = ( 3.6f - 3.2f * f ) * f;
-			m_k = 2.0f * m_p - 1.0f;
-			m_r = _q * 0.1f * std::exp((1 - m_p) * 1.386249f);
+			c.p = ( 3.6f - 3.2f * f ) * f;
+			c.k = 2.0f * c.p - 1.0f;
+			c.r = _q * 0.1f * std::exp((1 - c.p) * 1.386249f);
 			
 			return;
 		}
 
-		if( m_type == FilterType::Lowpass_SV || 
-			m_type == FilterType::Bandpass_SV ||
-			m_type == FilterType::Highpass_SV ||
-			m_type == FilterType::Notch_SV )
+		if( type == FilterType::Lowpass_SV || 
+			type == FilterType::Bandpass_SV ||
+			type == FilterType::Highpass_SV ||
+			type == FilterType::Notch_SV )
 		{
-			const float f = std::sin(std::max(minFreq(), _freq) * m_sampleRatio * pi_v<float>);
-			m_svf1 = std::min(f, 0.825f);
-			m_svf2 = std::min(f * 2.0f, 0.825f);
-			m_svq = std::max(0.0001f, 2.0f - (_q * 0.1995f));
+			const float f = std::sin(std::max(minFreq(), _freq) * sampleRatio * pi_v<float>);
+			c.svf1 = std::min(f, 0.825f);
+			c.svf2 = std::min(f * 2.0f, 0.825f);
+			c.svq = std::max(0.0001f, 2.0f - (_q * 0.1995f));
 			return;
 		}
 
 		// other filters
 		_freq = std::clamp(_freq, minFreq(), 20000.0f);
-		const float omega = 2 * pi_v<float> * _freq * m_sampleRatio;
+		const float omega = 2 * pi_v<float> * _freq * sampleRatio;
 		const float tsin = std::sin(omega) * 0.5f;
 		const float tcos = std::cos(omega);
 
@@ -820,87 +922,232 @@ public:
 		const float a1 = -2.0f * tcos * a0;
 		const float a2 = ( 1.0f - alpha ) * a0;
 
-		switch( m_type )
+		switch( type )
 		{
 			case FilterType::LowPass:
 			{
 				const float b1 = ( 1.0f - tcos ) * a0;
 				const float b0 = b1 * 0.5f;
-				m_biQuad.setCoeffs( a1, a2, b0, b1, b0 );
+				setBiQuadCoeffs( c, a1, a2, b0, b1, b0 );
 				break;
 			}
 			case FilterType::HiPass:
 			{
 				const float b1 = ( -1.0f - tcos ) * a0;
 				const float b0 = b1 * -0.5f;
-				m_biQuad.setCoeffs( a1, a2, b0, b1, b0 );
+				setBiQuadCoeffs( c, a1, a2, b0, b1, b0 );
 				break;
 			}
 			case FilterType::BandPass_CSG:
 			{
 				const float b0 = tsin * a0;
-				m_biQuad.setCoeffs( a1, a2, b0, 0.0f, -b0 );
+				setBiQuadCoeffs( c, a1, a2, b0, 0.0f, -b0 );
 				break;
 			}
 			case FilterType::BandPass_CZPG:
 			{
 				const float b0 = alpha * a0;
-				m_biQuad.setCoeffs( a1, a2, b0, 0.0f, -b0 );
+				setBiQuadCoeffs( c, a1, a2, b0, 0.0f, -b0 );
 				break;
 			}
 			case FilterType::Notch:
 			{
-				m_biQuad.setCoeffs( a1, a2, a0, a1, a0 );
+				setBiQuadCoeffs( c, a1, a2, a0, a1, a0 );
 				break;
 			}
 			case FilterType::AllPass:
 			{
-				m_biQuad.setCoeffs( a1, a2, a2, a1, 1.0f );
+				setBiQuadCoeffs( c, a1, a2, a2, a1, 1.0f );
 				break;
 			}
 			default:
 				break;
 		}
-
-		if( m_doubleFilter )
-		{
-			m_subFilter->m_biQuad.setCoeffs( m_biQuad.m_a1, m_biQuad.m_a2, m_biQuad.m_b0, m_biQuad.m_b1, m_biQuad.m_b2 );
-		}
 	}
 
 
 private:
-	// biquad filter
-	BiQuad<CHANNELS> m_biQuad;
+	//! The formant filters of filterKernel(), without the shortcut for silence
+	template<FilterType Type, typename V, std::size_t N>
+	static inline V formantKernel( V _in0, BasicFilterState<V, N>& s, std::size_t idx, const BasicFilterCoeffs<V>& c )
+	{
+		using std::clamp;
 
-	// coeffs for moog-filter
-	float m_r, m_p, m_k;
+		// local copies, see filterKernel()
+		const V vfa0 = c.vfa[0], vfb0 = c.vfb[0], vfc0 = c.vfc[0];
+		const V vfa1 = c.vfa[1], vfb1 = c.vfb[1], vfc1 = c.vfc[1];
+		const V vfq = c.vfq;
 
-	// coeffs for RC-type-filters
-	float m_rca, m_rcb, m_rcc, m_rcq;
+		V out = 0.0f;
 
-	// coeffs for formant-filters
-	float m_vfa[4], m_vfb[4], m_vfc[4], m_vfq;
+		const int os = Type == FilterType::FastFormant ? 1 : 4; // no oversampling for fast formant
+		for( int o = 0; o < os; ++o )
+		{
+			// first formant
+			V in = _in0 + s.vfbp[0][idx] * vfq;
+			in = clamp(in, -1.0f, 1.0f);
 
-	// coeffs for Lowpass_SV (state-variant lowpass)
-	float m_svf1, m_svf2, m_svq;
+			V hp = vfc0 * ( s.vfhp[0][idx] + in - s.vflast[0][idx] );
+			hp = clamp(hp, -1.0f, 1.0f);
 
-	using frame = std::array<sample_t, CHANNELS>;
+			V bp = hp * vfb0 + s.vfbp[0][idx] * vfa0;
+			bp = clamp(bp, -1.0f, 1.0f);
 
-	// in/out history for moog-filter
-	frame m_y1, m_y2, m_y3, m_y4, m_oldx, m_oldy1, m_oldy2, m_oldy3;
-	// additional one for Tripole filter
-	frame m_last;
+			s.vflast[0][idx] = in;
+			s.vfhp[0][idx] = hp;
+			s.vfbp[0][idx] = bp;
 
-	// in/out history for RC-type-filters
-	frame m_rcbp0, m_rclp0, m_rchp0, m_rclast0;
-	frame m_rcbp1, m_rclp1, m_rchp1, m_rclast1;
+			in = bp + s.vfbp[2][idx] * vfq;
+			in = clamp(in, -1.0f, 1.0f);
 
-	// in/out history for Formant-filters
-	frame m_vfbp[6], m_vfhp[6], m_vflast[6];
+			hp = vfc0 * ( s.vfhp[2][idx] + in - s.vflast[2][idx] );
+			hp = clamp(hp, -1.0f, 1.0f);
 
-	// in/out history for Lowpass_SV (state-variant lowpass)
-	frame m_delay1, m_delay2, m_delay3, m_delay4;
+			bp = hp * vfb0 + s.vfbp[2][idx] * vfa0;
+			bp = clamp(bp, -1.0f, 1.0f);
+
+			s.vflast[2][idx] = in;
+			s.vfhp[2][idx] = hp;
+			s.vfbp[2][idx] = bp;
+
+			in = bp + s.vfbp[4][idx] * vfq;
+			in = clamp(in, -1.0f, 1.0f);
+
+			hp = vfc0 * ( s.vfhp[4][idx] + in - s.vflast[4][idx] );
+			hp = clamp(hp, -1.0f, 1.0f);
+
+			bp = hp * vfb0 + s.vfbp[4][idx] * vfa0;
+			bp = clamp(bp, -1.0f, 1.0f);
+
+			s.vflast[4][idx] = in;
+			s.vfhp[4][idx] = hp;
+			s.vfbp[4][idx] = bp;
+
+			out += bp;
+
+			// second formant
+			in = _in0 + s.vfbp[0][idx] * vfq;
+			in = clamp(in, -1.0f, 1.0f);
+
+			hp = vfc1 * ( s.vfhp[1][idx] + in - s.vflast[1][idx] );
+			hp = clamp(hp, -1.0f, 1.0f);
+
+			bp = hp * vfb1 + s.vfbp[1][idx] * vfa1;
+			bp = clamp(bp, -1.0f, 1.0f);
+
+			s.vflast[1][idx] = in;
+			s.vfhp[1][idx] = hp;
+			s.vfbp[1][idx] = bp;
+
+			in = bp + s.vfbp[3][idx] * vfq;
+			in = clamp(in, -1.0f, 1.0f);
+
+			hp = vfc1 * ( s.vfhp[3][idx] + in - s.vflast[3][idx] );
+			hp = clamp(hp, -1.0f, 1.0f);
+
+			bp = hp * vfb1 + s.vfbp[3][idx] * vfa1;
+			bp = clamp(bp, -1.0f, 1.0f);
+
+			s.vflast[3][idx] = in;
+			s.vfhp[3][idx] = hp;
+			s.vfbp[3][idx] = bp;
+
+			in = bp + s.vfbp[5][idx] * vfq;
+			in = clamp(in, -1.0f, 1.0f);
+
+			hp = vfc1 * ( s.vfhp[5][idx] + in - s.vflast[5][idx] );
+			hp = clamp(hp, -1.0f, 1.0f);
+
+			bp = hp * vfb1 + s.vfbp[5][idx] * vfa1;
+			bp = clamp(bp, -1.0f, 1.0f);
+
+			s.vflast[5][idx] = in;
+			s.vfhp[5][idx] = hp;
+			s.vfbp[5][idx] = bp;
+
+			out += bp;
+		}
+		return Type == FilterType::FastFormant ? out * 2.0f : out * 0.5f;
+	}
+
+	//! The formant filters skip processing when the numbers get too small.
+	//! Lanes can only skip together, so quiet lanes among others keep their
+	//! history and output silence, just as their voice would on its own.
+	template<FilterType Type, typename V, std::size_t N>
+	static inline V formantSample( V _in0, BasicFilterState<V, N>& s, std::size_t idx, const BasicFilterCoeffs<V>& c )
+	{
+		if constexpr( std::is_same_v<V, sample_t> )
+		{
+			if (std::abs(_in0) < F_EPSILON && std::abs(s.vflast[0][idx]) < F_EPSILON) { return 0.0f; } // performance hack - skip processing when the numbers get too small
+			return formantKernel<Type>( _in0, s, idx, c );
+		}
+		else
+		{
+			auto quiet = std::array<bool, V::size()>{};
+			for( std::size_t lane = 0; lane < V::size(); ++lane )
+			{
+				quiet[lane] = std::abs(_in0[lane]) < F_EPSILON && std::abs(s.vflast[0][idx][lane]) < F_EPSILON;
+			}
+			if( std::ranges::all_of( quiet, std::identity{} ) ) { return 0.0f; }
+			if( std::ranges::none_of( quiet, std::identity{} ) ) { return formantKernel<Type>( _in0, s, idx, c ); }
+
+			const auto bp = s.vfbp;
+			const auto hp = s.vfhp;
+			const auto last = s.vflast;
+			V out = formantKernel<Type>( _in0, s, idx, c );
+			for( std::size_t lane = 0; lane < V::size(); ++lane )
+			{
+				if( !quiet[lane] ) { continue; }
+				out[lane] = 0.0f;
+				for( std::size_t i = 0; i < 6; ++i )
+				{
+					s.vfbp[i][idx][lane] = bp[i][idx][lane];
+					s.vfhp[i][idx][lane] = hp[i][idx][lane];
+					s.vflast[i][idx][lane] = last[i][idx][lane];
+				}
+			}
+			return out;
+		}
+	}
+
+	static inline void setBiQuadCoeffs( BasicFilterCoeffs<float>& c,
+		float a1, float a2, float b0, float b1, float b2 )
+	{
+		c.a1 = a1;
+		c.a2 = a2;
+		c.b0 = b0;
+		c.b1 = b1;
+		c.b2 = b2;
+	}
+
+	//! Calls @p f with the filter type as std::integral_constant
+	template<typename F>
+	static inline decltype(auto) withType( FilterType type, F&& f )
+	{
+		using T = FilterType;
+		switch( type )
+		{
+			case T::Moog: return f(std::integral_constant<T, T::Moog>{});
+			case T::Tripole: return f(std::integral_constant<T, T::Tripole>{});
+			case T::Lowpass_SV: return f(std::integral_constant<T, T::Lowpass_SV>{});
+			case T::Bandpass_SV: return f(std::integral_constant<T, T::Bandpass_SV>{});
+			case T::Highpass_SV: return f(std::integral_constant<T, T::Highpass_SV>{});
+			case T::Notch_SV: return f(std::integral_constant<T, T::Notch_SV>{});
+			case T::Lowpass_RC12: return f(std::integral_constant<T, T::Lowpass_RC12>{});
+			case T::Bandpass_RC12: return f(std::integral_constant<T, T::Bandpass_RC12>{});
+			case T::Highpass_RC12: return f(std::integral_constant<T, T::Highpass_RC12>{});
+			case T::Lowpass_RC24: return f(std::integral_constant<T, T::Lowpass_RC24>{});
+			case T::Bandpass_RC24: return f(std::integral_constant<T, T::Bandpass_RC24>{});
+			case T::Highpass_RC24: return f(std::integral_constant<T, T::Highpass_RC24>{});
+			case T::Formantfilter: return f(std::integral_constant<T, T::Formantfilter>{});
+			case T::FastFormant: return f(std::integral_constant<T, T::FastFormant>{});
+			// the biquad types only differ in their coefficients
+			default: return f(std::integral_constant<T, T::LowPass>{});
+		}
+	}
+
+	BasicFilterState<sample_t, CHANNELS> m_state;
+	BasicFilterCoeffs<float> m_coeffs;
 
 	FilterType m_type;
 	bool m_doubleFilter;
@@ -909,6 +1156,222 @@ private:
 	float m_sampleRatio;
 	BasicFilters<CHANNELS> * m_subFilter;
 
+	friend class BasicFilterBank<CHANNELS>;
+} ;
+
+
+/**
+ * @brief Runs the filters of many voices together, one voice per lane
+ *
+ * Every voice keeps its history in its own BasicFilters. process() loads the
+ * history of up to Lanes voices into SampleLanes, filters all of them at once
+ * and stores the history back. The filter type is dispatched once per batch
+ * and every operation of the filter works on all lanes, so the compiler can
+ * use SIMD instructions. The coefficients are kept per lane, so every voice
+ * follows its own cutoff and resonance.
+ */
+template<ch_cnt_t CHANNELS>
+class BasicFilterBank
+{
+public:
+	using Filter = BasicFilters<CHANNELS>;
+
+	//! Number of voices filtered at once
+	static constexpr std::size_t Lanes = 8;
+
+	struct Voice
+	{
+		//! The filter of the voice, its type must be set already
+		Filter* filter;
+		//! Interleaved samples, filtered in place
+		sample_t* buffer;
+		f_cnt_t frames;
+		//! Cutoff and resonance of every frame. The coefficients are only
+		//! calculated again where one of them changes.
+		const float* cutoff;
+		const float* resonance;
+	};
+
+	//! Filters all @p voices in place, which are reordered. All of their
+	//! filters must have the same sample rate.
+	void process( std::span<Voice> voices )
+	{
+		// the history of a voice must not run past its last frame, so only
+		// voices with the same filter and number of frames share a batch
+		const auto key = []( const Voice& voice ) {
+			return std::tuple{ voice.filter->m_type, voice.filter->m_doubleFilter, voice.frames };
+		};
+		std::ranges::sort( voices, {}, key );
+
+		auto begin = voices.begin();
+		while( begin != voices.end() )
+		{
+			auto end = begin + 1;
+			while( end != voices.end() && key( *end ) == key( *begin ) &&
+				static_cast<std::size_t>( end - begin ) < Lanes )
+			{
+				++end;
+			}
+
+			const auto batch = std::span<Voice>{ begin, end };
+			Filter::withType( batch[0].filter->m_type, [&]( auto type ) {
+				if( batch.size() == 1 )
+				{
+					processSingle<decltype(type)::value>( batch[0] );
+				}
+				else
+				{
+					processBatch<decltype(type)::value>( batch );
+				}
+			} );
+			begin = end;
+		}
+	}
+
+	//! Filters a single voice in place, without using the lanes
+	static void process( const Voice& voice )
+	{
+		Filter::withType( voice.filter->m_type, [&]( auto type ) {
+			processSingle<decltype(type)::value>( voice );
+		} );
+	}
+
+private:
+	using Type = typename Filter::FilterType;
+	using Lane = SampleLanes<Lanes>;
+
+	//! Frames gathered from the voices before they are filtered
+	static constexpr f_cnt_t BlockFrames = 64;
+
+	static bool coeffsChange( const Voice& voice, f_cnt_t frame )
+	{
+		return frame == 0 || voice.cutoff[frame] != voice.cutoff[frame - 1]
+			|| voice.resonance[frame] != voice.resonance[frame - 1];
+	}
+
+	//! A single voice doesn't gain anything from the lanes
+	template<Type T>
+	static void processSingle( const Voice& voice )
+	{
+		Filter& filter = *voice.filter;
+		for( f_cnt_t f = 0; f < voice.frames; ++f )
+		{
+			if( coeffsChange( voice, f ) )
+			{
+				filter.calcFilterCoeffs( voice.cutoff[f], voice.resonance[f] );
+			}
+			for( ch_cnt_t ch = 0; ch < CHANNELS; ++ch )
+			{
+				sample_t& sample = voice.buffer[f * CHANNELS + ch];
+				sample = filter.template filterSample<T>( sample, ch );
+			}
+		}
+	}
+
+	template<Type T>
+	void processBatch( std::span<const Voice> batch )
+	{
+		const std::size_t used = batch.size();
+		const f_cnt_t frames = batch[0].frames;
+		const bool doubleFilter = batch[0].filter->m_doubleFilter;
+
+		// unused lanes repeat the last voice, so they don't take other paths
+		// than the voices do
+		const auto voiceOf = [&]( std::size_t lane ) -> const Voice& { return batch[std::min( lane, used - 1 )]; };
+
+		for( std::size_t lane = 0; lane < Lanes; ++lane )
+		{
+			const Voice& voice = voiceOf( lane );
+			load( voice.filter->m_state, m_state, lane );
+			if( doubleFilter ) { load( voice.filter->m_subFilter->m_state, m_subState, lane ); }
+			setCoeffs( voice, 0, lane );
+		}
+
+		for( f_cnt_t begin = 0; begin < frames; begin += BlockFrames )
+		{
+			const f_cnt_t blockFrames = std::min( BlockFrames, frames - begin );
+
+			m_changes.fill( 0 );
+			for( std::size_t lane = 0; lane < Lanes; ++lane )
+			{
+				const Voice& voice = voiceOf( lane );
+				const sample_t* in = voice.buffer + begin * CHANNELS;
+				for( f_cnt_t f = 0; f < blockFrames; ++f )
+				{
+					for( ch_cnt_t ch = 0; ch < CHANNELS; ++ch ) { m_block[f][ch][lane] = in[f * CHANNELS + ch]; }
+				}
+				const float* cutoff = voice.cutoff + begin;
+				const float* resonance = voice.resonance + begin;
+				for( f_cnt_t f = begin > 0 ? 0 : 1; f < blockFrames; ++f )
+				{
+					const bool change = ( cutoff[f] != cutoff[f - 1] ) | ( resonance[f] != resonance[f - 1] );
+					m_changes[f] |= static_cast<unsigned>( change ) << lane;
+				}
+			}
+
+			for( f_cnt_t f = 0; f < blockFrames; ++f )
+			{
+				for( std::size_t lane = 0; m_changes[f] != 0 && lane < Lanes; ++lane )
+				{
+					if( m_changes[f] & ( 1u << lane ) ) { setCoeffs( voiceOf( lane ), begin + f, lane ); }
+				}
+
+				for( ch_cnt_t ch = 0; ch < CHANNELS; ++ch )
+				{
+					Lane x = Filter::template filterKernel<T>( m_block[f][ch], m_state, ch, m_coeffs );
+					if( doubleFilter )
+					{
+						x = Filter::template filterKernel<T>( x, m_subState, ch, m_coeffs );
+					}
+					m_block[f][ch] = x;
+				}
+			}
+
+			for( std::size_t lane = 0; lane < used; ++lane )
+			{
+				sample_t* out = batch[lane].buffer + begin * CHANNELS;
+				for( f_cnt_t f = 0; f < blockFrames; ++f )
+				{
+					for( ch_cnt_t ch = 0; ch < CHANNELS; ++ch ) { out[f * CHANNELS + ch] = m_block[f][ch][lane]; }
+				}
+			}
+		}
+
+		for( std::size_t lane = 0; lane < used; ++lane )
+		{
+			store( m_state, batch[lane].filter->m_state, lane );
+			if( doubleFilter ) { store( m_subState, batch[lane].filter->m_subFilter->m_state, lane ); }
+		}
+	}
+
+	void setCoeffs( const Voice& voice, f_cnt_t frame, std::size_t lane )
+	{
+		const Filter& filter = *voice.filter;
+		auto coeffs = BasicFilterCoeffs<float>{};
+		Filter::calcCoeffs( filter.m_type, voice.cutoff[frame], voice.resonance[frame], filter.m_sampleRatio, coeffs );
+		coeffs.zip( m_coeffs, [lane]( float& from, Lane& to ) { to[lane] = from; } );
+	}
+
+	static void load( BasicFilterState<sample_t, CHANNELS>& voice, BasicFilterState<Lane, CHANNELS>& bank, std::size_t lane )
+	{
+		voice.zip( bank, [lane]( auto& from, auto& to ) {
+			for( ch_cnt_t ch = 0; ch < CHANNELS; ++ch ) { to[ch][lane] = from[ch]; }
+		} );
+	}
+
+	static void store( BasicFilterState<Lane, CHANNELS>& bank, BasicFilterState<sample_t, CHANNELS>& voice, std::size_t lane )
+	{
+		voice.zip( bank, [lane]( auto& to, auto& from ) {
+			for( ch_cnt_t ch = 0; ch < CHANNELS; ++ch ) { to[ch] = from[ch][lane]; }
+		} );
+	}
+
+	BasicFilterState<Lane, CHANNELS> m_state;
+	BasicFilterState<Lane, CHANNELS> m_subState;
+	BasicFilterCoeffs<Lane> m_coeffs;
+	std::array<std::array<Lane, CHANNELS>, BlockFrames> m_block;
+	//! Lanes whose coefficients change at each frame of m_block
+	std::array<unsigned, BlockFrames> m_changes;
 } ;
 
 
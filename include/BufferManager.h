@@ -26,23 +26,48 @@
 #ifndef LMMS_BUFFER_MANAGER_H
 #define LMMS_BUFFER_MANAGER_H
 
+#include <memory>
+
 #include "lmms_export.h"
 #include "LmmsTypes.h"
+#include "LocklessPool.h"
 
 namespace lmms
 {
 
 class SampleFrame;
 
+/**
+ * @brief Pool of period-sized buffers for play handles.
+ *
+ * acquire() and release() are lock-free and don't allocate as long as the
+ * pool has free buffers, so they are safe to call from the audio threads.
+ * See LocklessPool for how the pool grows. The buffers are aligned to
+ * AudioBufferAlignment bytes.
+ */
 class LMMS_EXPORT BufferManager
 {
 public:
+	using Statistics = LocklessPool::Statistics;
+
 	static void init( f_cnt_t fpp );
 	static SampleFrame* acquire();
 	static void release( SampleFrame* buf );
 
+	//! Grow the pool to hold at least @p count buffers. Not realtime-safe.
+	static void reserve( std::size_t count );
+	//! Grow the pool if it is running low. Not realtime-safe, call it
+	//! periodically from a non-audio thread.
+	static void refill();
+
+	static Statistics statistics();
+
 private:
+	static constexpr std::size_t InitialCapacity = 512;
+	static constexpr std::size_t ChunkSize = 256;
+
 	static f_cnt_t s_framesPerPeriod;
+	static std::unique_ptr<LocklessPool> s_pool;
 };
 
 
@@ -31,6 +31,7 @@
 #include <QPixmap>
 #include <QWidget>
 
+#include "AudioEngineProfiler.h"
 #include "LmmsTypes.h"
 
 
@@ -68,6 +69,11 @@ private:
 
 	QTimer m_updateTimer;
 
+	//! The live MIDI latency shown is measured over windows of this many updates
+	static constexpr int MidiLatencyWindow = 50;
+	int m_midiLatencyUpdates = 0;
+	AudioEngineProfiler::MidiLatencyHistogram m_midiLatency;
+
 	int m_stepSize = 1;
 
 } ;
@@ -0,0 +1,163 @@
+/*
+ * ClipIndex.h - interval index over the clips of a track
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_CLIP_INDEX_H
+#define LMMS_CLIP_INDEX_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "LmmsTypes.h"
+
+namespace lmms
+{
+
+class Clip;
+
+/**
+ * @brief Finds the clips of a track that intersect a time range.
+ *
+ * The clips are kept sorted by start position, with a tree of the maximum end
+ * position above them, so a query costs O(log n + k) for k results instead of
+ * a scan over all clips. A caller that queries consecutive ranges, as
+ * playback does, can pass its own Cursor. The cursor remembers the result of
+ * the caller's last query, and when the next range continues where that one
+ * ended, only clips that ended or started in between are dropped or added.
+ *
+ * The index doesn't watch the clips itself, the track calls invalidate() and
+ * update() whenever a clip is added, removed, moved or resized. update()
+ * builds a new, immutable snapshot of the index and publishes it with an
+ * atomic pointer swap, so queries never lock or wait for the thread editing
+ * the clips. A snapshot that was replaced is freed by a later update() once
+ * no query is running. Between invalidate() and update(), e.g. while a
+ * project is loaded, queries scan all clips instead.
+ */
+class ClipIndex
+{
+public:
+	//! The position of one caller's consecutive queries, see clipsInRange()
+	class Cursor
+	{
+	public:
+		//! Reserves memory for @p clips clips. Not realtime safe.
+		void reserve(std::size_t clips)
+		{
+			m_active.reserve(clips);
+		}
+
+	private:
+		friend class ClipIndex;
+
+		std::uint64_t m_generation = 0; //!< the snapshot the cursor is valid for, 0 if none
+		tick_t m_start = 0;
+		tick_t m_end = 0;
+		std::size_t m_next = 0; //!< first entry starting after m_end
+		std::vector<std::size_t> m_active; //!< entries intersecting the range, ascending
+	};
+
+	ClipIndex() = default;
+	~ClipIndex();
+
+	ClipIndex(const ClipIndex&) = delete;
+	ClipIndex& operator=(const ClipIndex&) = delete;
+
+	//! Marks the index as outdated, queries scan all clips until update()
+	void invalidate()
+	{
+		m_dirty.store(true, std::memory_order_release);
+	}
+
+	//! Rebuilds the index from @p clips if it was invalidated. Not realtime
+	//! safe, call it from the thread that edits the clips.
+	void update(const std::vector<Clip*>& clips);
+
+	/**
+	 * @brief Adds all clips from @p clips with start <= @p end and
+	 * end >= @p start to @p out. Realtime safe if @p out and @p cursor have
+	 * room for all clips.
+	 *
+	 * @p out must already be sorted by start position, the clips are inserted
+	 * so it stays sorted. Clips starting at the same position keep their order
+	 * in @p clips and come after those already in @p out.
+	 *
+	 * @p cursor may only be used by one thread at a time.
+	 */
+	void clipsInRange(const std::vector<Clip*>& clips, std::vector<Clip*>& out, tick_t start, tick_t end,
+		Cursor* cursor = nullptr) const;
+
+private:
+	struct Entry
+	{
+		tick_t start;
+		tick_t end;
+		std::size_t order; //!< the position in the track's clip list
+		Clip* clip;
+	};
+
+	struct Snapshot
+	{
+		explicit Snapshot(const std::vector<Clip*>& clips, std::uint64_t generation);
+
+		//! Calls @p visit with the index of each entry below @p limit ending
+		//! at or after @p start, in ascending order
+		template<typename Visitor>
+		void collect(Visitor&& visit, std::size_t node, std::size_t first,
+			std::size_t last, std::size_t limit, tick_t start) const;
+
+		//! Index of the first entry starting after @p time
+		std::size_t upperBound(tick_t time) const;
+
+		//! Resets @p cursor to the given range, using the tree
+		void seek(Cursor& cursor, tick_t start, tick_t end) const;
+
+		//! Moves @p cursor forward to the given range
+		void advance(Cursor& cursor, tick_t start, tick_t end) const;
+
+		const std::uint64_t generation;
+		std::vector<Entry> entries; //!< sorted by start position, then order
+		std::vector<tick_t> maxEnd; //!< implicit binary tree, root at index 1
+		std::size_t leaves;
+	};
+
+	//! Adds a clip to @p out, keeping it sorted
+	static void addClip(Clip* clip, std::vector<Clip*>& out);
+
+	//! Frees all replaced snapshots, if no query might still read them
+	void freeRetired();
+
+	std::atomic<bool> m_dirty = true;
+	std::atomic<const Snapshot*> m_snapshot = nullptr;
+	//! Number of queries reading m_snapshot right now
+	mutable std::atomic<int> m_readers = 0;
+
+	// only touched by update(), never by queries
+	std::mutex m_updateMutex;
+	std::uint64_t m_generation = 0;
+	std::vector<const Snapshot*> m_retired;
+};
+
+} // namespace lmms
+
+#endif // LMMS_CLIP_INDEX_H
@@ -26,6 +26,7 @@
 #ifndef LMMS_DATA_FILE_H
 #define LMMS_DATA_FILE_H
 
+#include <chrono>
 #include <map>
 #include <QDomDocument>
 #include <vector>
@@ -95,6 +96,12 @@ public:
 
 	unsigned int legacyFileVersion();
 
+	//! Time spent upgrading the file to the current version while loading it
+	std::chrono::nanoseconds upgradeTime() const
+	{
+		return m_upgradeTime;
+	}
+
 private:
 	static Type type( const QString& typeName );
 	static QString typeName( Type type );
@@ -154,6 +161,7 @@ private:
 	QDomElement m_head;
 	Type m_type;
 	unsigned int m_fileVersion;
+	std::chrono::nanoseconds m_upgradeTime{0};
 } ;
 
 
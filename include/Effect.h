@@ -65,8 +65,11 @@ public:
 		return "effect";
 	}
 
+	//! Processes the main channels of @p inOut in its interleaved buffer,
+	//! where EffectChain keeps them for the whole chain. @p silent says
+	//! whether they are silent, and is updated after processing.
 	//! Returns true if audio was processed and should continue being processed
-	bool processAudioBuffer(AudioBuffer& inOut);
+	bool processAudioBuffer(AudioBuffer& inOut, bool& silent);
 
 	inline bool isOkay() const
 	{
@@ -194,6 +197,9 @@ private:
 	 */
 	void handleAutoQuit(bool silentOutput);
 
+	//! Clears the channels of @p buffer holding Inf or NaN, @return whether there were any
+	static bool sanitizeChannels(std::span<SampleFrame> buffer);
+
 
 	EffectChain * m_parent;
 
@@ -0,0 +1,90 @@
+/*
+ * EncoderThread.h - writes rendered audio to a file device on its own thread
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_ENCODER_THREAD_H
+#define LMMS_ENCODER_THREAD_H
+
+#include <QMutex>
+#include <QThread>
+#include <QWaitCondition>
+
+#include <array>
+#include <vector>
+
+#include "LmmsTypes.h"
+#include "SampleFrame.h"
+
+namespace lmms
+{
+
+class AudioFileDevice;
+
+/**
+ * Writes rendered audio to an AudioFileDevice on its own thread, so encoding
+ * overlaps with rendering the next periods.
+ *
+ * Periods are collected into blocks of MAXIMUM_BUFFER_SIZE frames before
+ * they are handed to the encoder, which saves a lot of calls into the
+ * encoder libraries compared to writing every period on its own.
+ *
+ * write() and finish() must only be called by one thread at a time. They
+ * block while the encoder is too far behind, so they are meant for offline
+ * rendering only.
+ */
+class EncoderThread : public QThread
+{
+public:
+	explicit EncoderThread(AudioFileDevice* fileDev);
+
+	void write(const SampleFrame* frames, f_cnt_t count);
+	void writeSilence(f_cnt_t count);
+
+	//! Writes the remaining frames and waits until the encoder is done
+	void finish();
+
+private:
+	static constexpr std::size_t BlockCount = 8;
+
+	struct Block
+	{
+		std::vector<SampleFrame> frames;
+		f_cnt_t size = 0;
+	};
+
+	void submit();
+	void run() override;
+
+	AudioFileDevice* m_fileDev;
+	std::array<Block, BlockCount> m_blocks;
+
+	// blocks in [m_readIndex, m_writeIndex) are waiting for the encoder
+	QMutex m_mutex;
+	QWaitCondition m_blockReady;
+	QWaitCondition m_blockFree;
+	std::size_t m_readIndex = 0;
+	std::size_t m_writeIndex = 0;
+	bool m_done = false;
+};
+
+} // namespace lmms
+
+#endif // LMMS_ENCODER_THREAD_H
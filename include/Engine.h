@@ -39,6 +39,7 @@ class AudioEngine;
 class Mixer;
 class PatternStore;
 class ProjectJournal;
+class RemotePluginPool;
 class Song;
 class Ladspa2LMMS;
 
@@ -93,6 +94,11 @@ public:
 		return s_ladspaManager;
 	}
 
+	static RemotePluginPool * remotePluginPool()
+	{
+		return s_remotePluginPool;
+	}
+
 	static float framesPerTick()
 	{
 		return s_framesPerTick;
@@ -142,6 +148,7 @@ private:
 	static class Lv2Manager* s_lv2Manager;
 #endif
 	static Ladspa2LMMS* s_ladspaManager;
+	static RemotePluginPool* s_remotePluginPool;
 	static void* s_dndPluginKey;
 
 	// even though most methods are static, an instance is needed for Qt slots/signals
@@ -84,6 +84,7 @@ private:
 	QCheckBox* m_exportBetweenLoopMarkersBox = nullptr;
 	QLabel* m_loopRepeatLabel = nullptr;
 	QSpinBox* m_loopRepeatBox = nullptr;
+	QCheckBox* m_exportThroughMixerBox = nullptr;
 	QPushButton* m_startButton = nullptr;
 	QPushButton* m_cancelButton = nullptr;
 	QProgressBar* m_progressBar = nullptr;
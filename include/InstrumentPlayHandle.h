@@ -50,6 +50,8 @@ public:
 
 	bool isFromTrack(const Track* track) const override;
 
+	QString profilerName() const override;
+
 private:
 	Instrument* m_instrument;
 };
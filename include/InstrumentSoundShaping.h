@@ -25,8 +25,15 @@
 #ifndef LMMS_INSTRUMENT_SOUND_SHAPING_H
 #define LMMS_INSTRUMENT_SOUND_SHAPING_H
 
+#include <array>
+#include <atomic>
+#include <vector>
+
+#include "AudioBusHandle.h"
+#include "BasicFilters.h"
 #include "ComboBoxModel.h"
 #include "EnvelopeAndLfoParameters.h"
+#include "volume.h"
 
 namespace lmms
 {
@@ -42,15 +49,44 @@ class InstrumentSoundShapingView;
 }
 
 
-class InstrumentSoundShaping : public Model, public JournallingObject
+//! What InstrumentSoundShaping keeps for each note, see NotePlayHandle::m_soundShaping
+struct SoundShapingNoteState
+{
+	SoundShapingNoteState( sample_rate_t sampleRate, f_cnt_t framesPerPeriod );
+
+	BasicFilters<> filter;
+
+	// the note's part of the current period, kept from rendering the note
+	// until the filter bank runs
+	SampleFrame* buffer = nullptr;
+	f_cnt_t frames = 0;
+	//! Cutoff and resonance of each frame, held between the frames where
+	//! the coefficients are calculated again
+	std::vector<float> cutoff;
+	std::vector<float> resonance;
+	//! Level of the volume envelope for each frame, if it is used
+	std::vector<float> volume;
+	bool useVolume = false;
+	StereoVolumeVector gain;
+};
+
+
+class InstrumentSoundShaping : public Model, public JournallingObject, public AudioBusHandle::VoiceProcessor
 {
 	Q_OBJECT
 public:
 	InstrumentSoundShaping( InstrumentTrack * _instrument_track );
 	~InstrumentSoundShaping() override = default;
 
+	//! Applies the filter and volume envelope, then @p gain. With the filter
+	//! enabled, the note is only prepared here and processed together with
+	//! the other notes of the track in processVoices().
 	void processAudioBuffer( SampleFrame* _ab, const f_cnt_t _frames,
-							NotePlayHandle * _n );
+							NotePlayHandle * _n, const StereoVolumeVector& gain );
+
+	//! Filters the notes prepared in this period in a BasicFilterBank. Runs in
+	//! the job of the track's AudioBusHandle, after all of its notes.
+	void processVoices() override;
 
 	const EnvelopeAndLfoParameters& getVolumeParameters() const { return m_volumeParameters; }
 	EnvelopeAndLfoParameters& getVolumeParameters() { return m_volumeParameters; }
@@ -84,6 +120,12 @@ private:
 	QString getCutoffNodeName() const;
 	QString getResonanceNodeName() const;
 
+	static void applyVolumeAndGain( SampleFrame* buffer, f_cnt_t frames, const float* volume,
+		const StereoVolumeVector& gain );
+
+	//! Notes of one period filtered at once. More notes are filtered on their own.
+	static constexpr std::size_t MaxBankedNotes = 64;
+
 private:
 	InstrumentTrack * m_instrumentTrack;
 
@@ -95,6 +137,11 @@ private:
 	ComboBoxModel m_filterModel;
 	FloatModel m_filterCutModel;
 	FloatModel m_filterResModel;
+
+	std::array<NotePlayHandle*, MaxBankedNotes> m_bankedNotes;
+	std::atomic<std::size_t> m_bankedNoteCount = 0;
+	std::array<BasicFilterBank<>::Voice, MaxBankedNotes> m_voices;
+	BasicFilterBank<> m_filterBank;
 };
 
 
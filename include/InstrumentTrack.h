@@ -27,6 +27,8 @@
 #define LMMS_INSTRUMENT_TRACK_H
 
 
+#include <vector>
+
 #include "AudioBusHandle.h"
 #include "InstrumentFunctions.h"
 #include "InstrumentSoundShaping.h"
@@ -268,11 +270,15 @@ protected slots:
 
 private:
 	void processCCEvent(int controller);
+	//! Reports the length of a live note held by the sustain pedal, see midiNoteOff()
+	void releaseSustainedNote(NotePlayHandle* nph);
 
 	MidiPort m_midiPort;
 
 	NotePlayHandle* m_notes[NumKeys];
-	NotePlayHandleList m_sustainedNotes;
+	//! Notes released while the sustain pedal is down. Live input is handled
+	//! while rendering, so this never grows beyond NumKeys.
+	std::vector<NotePlayHandle*> m_sustainedNotes;
 
 	int m_runningMidiNotes[NumKeys];
 	QMutex m_midiNotesMutex;
@@ -58,7 +58,8 @@ public:
 		}
 	}
 
-	void addJournalCheckPoint();
+	//! @see ProjectJournal::addJournalCheckPoint()
+	void addJournalCheckPoint( bool coalesce = false );
 
 	QDomElement saveState( QDomDocument & _doc,
 									QDomElement & _parent ) override;
@@ -0,0 +1,103 @@
+/*
+ * LocklessPool.h - growable pool of fixed-size elements for the audio threads
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_LOCKLESS_POOL_H
+#define LMMS_LOCKLESS_POOL_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+
+#include "lmms_export.h"
+
+namespace lmms
+{
+
+class LocklessAllocator;
+
+/**
+ * @brief Pool of fixed-size memory blocks made of LocklessAllocator chunks.
+ *
+ * alloc() and free() are lock-free and don't allocate as long as the pool
+ * has free blocks, so they are safe to call from the audio threads. The pool
+ * only grows in reserve() and refill(), which must be called from a
+ * non-realtime thread. If the pool runs dry anyway, alloc() falls back to
+ * the heap, which is counted in Statistics::fallbackAllocations.
+ */
+class LMMS_EXPORT LocklessPool
+{
+public:
+	struct Statistics
+	{
+		std::size_t capacity; //!< blocks available in the pool
+		std::size_t inUse; //!< blocks currently allocated, including fallback ones
+		std::size_t highWaterMark; //!< maximum of inUse since the pool was created
+		std::size_t fallbackAllocations; //!< blocks that had to be allocated on the heap
+	};
+
+	//! @param chunkSize number of blocks the pool grows by in refill()
+	//! @param alignment alignment of every block, must be a power of two
+	LocklessPool(std::size_t elementSize, std::size_t chunkSize,
+		std::size_t alignment = alignof(std::max_align_t));
+	~LocklessPool();
+
+	LocklessPool(const LocklessPool&) = delete;
+	LocklessPool& operator=(const LocklessPool&) = delete;
+
+	void* alloc();
+	void free(void* ptr);
+
+	//! Grow the pool to hold at least @p count blocks. Not realtime-safe.
+	void reserve(std::size_t count);
+	//! Grow the pool if it is running low. Not realtime-safe, call it
+	//! periodically from a non-audio thread.
+	void refill();
+
+	Statistics statistics() const;
+
+private:
+	static constexpr std::size_t MaxChunks = 64;
+
+	void addChunk(std::size_t count);
+
+	const std::size_t m_elementSize;
+	const std::size_t m_chunkSize;
+	const std::size_t m_alignment;
+
+	// chunks are only ever added, so the audio threads can iterate over
+	// them without locking
+	std::array<std::unique_ptr<LocklessAllocator>, MaxChunks> m_chunks;
+	std::atomic_size_t m_numChunks = 0;
+	std::mutex m_growMutex;
+
+	std::atomic_size_t m_capacity = 0;
+	std::atomic_size_t m_inUse = 0;
+	std::atomic_size_t m_highWaterMark = 0;
+	std::atomic_size_t m_fallbackAllocations = 0;
+};
+
+
+} // namespace lmms
+
+#endif // LMMS_LOCKLESS_POOL_H
@@ -30,6 +30,7 @@
 
 
 #include "MidiEvent.h"
+#include "MidiInputQueue.h"
 
 class QObject;
 
@@ -137,6 +138,8 @@ public:
 protected:
 	// generic raw-MIDI-parser which generates appropriate MIDI-events
 	void parseData( const unsigned char c );
+	// same as above, for clients which know when the byte arrived
+	void parseData( const unsigned char c, MidiInputQueue::Clock::time_point arrival );
 
 	// to be implemented by actual client-implementation
 	virtual void sendByte( const unsigned char c ) = 0;
@@ -167,6 +170,8 @@ private:
 		uint32_t m_buffer[RAW_MIDI_PARSE_BUF_SIZE];
 					// buffer for incoming data
 		MidiEvent m_midiEvent;	// midi-event
+		MidiInputQueue::Clock::time_point m_arrival;
+					// when the last byte arrived
 	} m_midiParseData;
 
 } ;
@@ -0,0 +1,100 @@
+/*
+ * MidiInputQueue.h - timestamped MIDI events on their way from a MIDI client
+ *                    to the audio engine
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_MIDI_INPUT_QUEUE_H
+#define LMMS_MIDI_INPUT_QUEUE_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+
+#include "LmmsTypes.h"
+#include "MidiEvent.h"
+#include "TimePos.h"
+#include "lmms_export.h"
+
+namespace lmms
+{
+
+/**
+ * @brief Carries live MIDI input from the thread of a MIDI client to the audio
+ * engine without locking.
+ *
+ * Every event is stamped with the time it arrived. The audio engine takes all
+ * events at the start of a period and plays each one at the frame matching
+ * its arrival within the time between the last two periods. Live input thus
+ * always has the latency of one period, instead of anything between none and
+ * one period depending on when the event happened to arrive.
+ *
+ * There is one producer, the MIDI client, and one consumer, the audio engine.
+ */
+class LMMS_EXPORT MidiInputQueue
+{
+public:
+	using Clock = std::chrono::steady_clock;
+
+	struct Entry
+	{
+		MidiEvent event;
+		TimePos time;
+		Clock::time_point arrival;
+	};
+
+	static constexpr std::size_t Capacity = 256;
+
+	//! @return false if the queue is full
+	bool push(const MidiEvent& event, const TimePos& time, Clock::time_point arrival)
+	{
+		const auto head = m_head.load(std::memory_order_relaxed);
+		if (head - m_tail.load(std::memory_order_acquire) == Capacity) { return false; }
+		m_entries[head % Capacity] = {event, time, arrival};
+		m_head.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+	//! @return false if the queue is empty
+	bool pop(Entry& entry)
+	{
+		const auto tail = m_tail.load(std::memory_order_relaxed);
+		if (tail == m_head.load(std::memory_order_acquire)) { return false; }
+		entry = m_entries[tail % Capacity];
+		m_tail.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	//! @return the frame in a period of @p frames at which an event that
+	//! arrived at @p arrival plays, if the previous period started rendering
+	//! at @p previousPeriod and the current one at @p currentPeriod
+	static f_cnt_t frameOffset(Clock::time_point arrival, Clock::time_point previousPeriod,
+		Clock::time_point currentPeriod, f_cnt_t frames);
+
+private:
+	std::array<Entry, Capacity> m_entries;
+	std::atomic_size_t m_head = 0;
+	std::atomic_size_t m_tail = 0;
+};
+
+} // namespace lmms
+
+#endif // LMMS_MIDI_INPUT_QUEUE_H
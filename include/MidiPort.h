@@ -26,11 +26,13 @@
 #ifndef LMMS_MIDI_PORT_H
 #define LMMS_MIDI_PORT_H
 
+#include <atomic>
 #include <QString>
 #include <QList>
 #include <QMap>
 
 #include "Midi.h"
+#include "MidiInputQueue.h"
 #include "TimePos.h"
 #include "AutomatableModel.h"
 
@@ -111,7 +113,18 @@ public:
 		return outputChannel() ? outputChannel() - 1 : 0;
 	}
 
+	//! Whether incoming events are queued and handled by the audio engine
+	//! when it timestamps MIDI input, which is the default. Ports whose
+	//! event processor doesn't expect to be called while rendering (e.g.
+	//! one owned by a dialog) turn it off, their events are handled on the
+	//! thread of the MIDI client right away. So are those of ports created
+	//! without an audio engine, which can't be queued.
+	void setInputQueued( bool queued );
+
+	//! Called by MIDI clients for every incoming event
 	void processInEvent( const MidiEvent& event, const TimePos& time = TimePos() );
+	//! Same as above, for an event that arrived at @p arrival
+	void processInEvent( const MidiEvent& event, const TimePos& time, MidiInputQueue::Clock::time_point arrival );
 	void processOutEvent( const MidiEvent& event, const TimePos& time = TimePos() );
 
 
@@ -153,6 +166,14 @@ private slots:
 
 
 private:
+	//! Hands an incoming event to the event processor, @p offset is the frame it plays at
+	void dispatchInEvent( const MidiEvent& event, const TimePos& time, f_cnt_t offset );
+
+	MidiInputQueue& inputQueue()
+	{
+		return m_inputQueue;
+	}
+
 	MidiClient* m_midiClient;
 	MidiEventProcessor* m_midiEventProcessor;
 
@@ -173,6 +194,11 @@ private:
 	Map m_readablePorts;
 	Map m_writablePorts;
 
+	MidiInputQueue m_inputQueue;
+	std::atomic<bool> m_inputQueued;
+
+	friend class AudioEngine;
+
 
 	friend class gui::ControllerConnectionDialog;
 	friend class gui::InstrumentMidiIOView;
@@ -25,6 +25,8 @@
 #ifndef LMMS_MIX_HELPERS_H
 #define LMMS_MIX_HELPERS_H
 
+#include <span>
+
 #include "AudioBufferView.h"
 
 namespace lmms
@@ -46,6 +48,28 @@ void add( SampleFrame* dst, const SampleFrame* src, int frames );
 /*! \brief Add samples from src to dst */
 void add(PlanarBufferView<sample_t> dst, PlanarBufferView<const sample_t> src);
 
+/*! \brief Add interleaved stereo samples from src to planar dst */
+void add(PlanarBufferView<sample_t> dst, const SampleFrame* src);
+
+/*! \brief Add planar samples from src multiplied by coeffSrc to interleaved stereo dst */
+void addMultiplied(SampleFrame* dst, PlanarBufferView<const sample_t> src, float coeffSrc);
+
+/*! \brief Add samples from src multiplied by coeffSrc to dst */
+void addMultiplied(PlanarBufferView<sample_t> dst, PlanarBufferView<const sample_t> src, float coeffSrc);
+
+/*! \brief Add samples from src multiplied by coeffSrc and coeffSrcBuf to dst */
+void addMultipliedByBuffer(PlanarBufferView<sample_t> dst, PlanarBufferView<const sample_t> src,
+	float coeffSrc, const ValueBuffer* coeffSrcBuf);
+
+/*! \brief Add samples from each of srcs multiplied by the matching coeffsSrc to dst,
+ *         touching dst once per group of sources instead of once per source */
+void addMultipliedMany(PlanarBufferView<sample_t> dst, std::span<const PlanarBufferView<const sample_t>> srcs,
+	std::span<const float> coeffsSrc);
+
+/*! \brief Add samples from src multiplied by coeffSrcBuf1 and coeffSrcBuf2 to dst */
+void addMultipliedByBuffers(PlanarBufferView<sample_t> dst, PlanarBufferView<const sample_t> src,
+	const ValueBuffer* coeffSrcBuf1, const ValueBuffer* coeffSrcBuf2);
+
 /*! \brief Multiply samples from `dst` by `coeff` */
 void multiply(SampleFrame* dst, float coeff, int frames);
 
@@ -0,0 +1,92 @@
+/*
+ * MixKernels.h - block mixing functions used by MixHelpers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_MIX_KERNELS_H
+#define LMMS_MIX_KERNELS_H
+
+#include <cstddef>
+#include <vector>
+
+#include "lmms_export.h"
+
+namespace lmms::MixKernels
+{
+
+// All kernels work on @p count consecutive floats, which is one planar
+// channel or 2 * frames of an interleaved stereo buffer
+
+//! dst += src
+using AddKernel = void (*)(float* dst, const float* src, std::size_t count);
+
+//! dst += src * coeff
+using AddMultipliedKernel = void (*)(float* dst, const float* src, float coeff, std::size_t count);
+
+//! dst += src * coeff * coeffs
+using AddMultipliedByBufferKernel = void (*)(float* dst, const float* src, float coeff,
+	const float* coeffs, std::size_t count);
+
+//! dst += src * coeffs1 * coeffs2
+using AddMultipliedByBuffersKernel = void (*)(float* dst, const float* src,
+	const float* coeffs1, const float* coeffs2, std::size_t count);
+
+//! dst = dst * coeffDst + src * coeffSrc
+using MultiplyAndAddMultipliedKernel = void (*)(float* dst, const float* src,
+	float coeffDst, float coeffSrc, std::size_t count);
+
+//! dst += srcs[0] * coeffs[0] + ... + srcs[sources - 1] * coeffs[sources - 1],
+//! reading and writing dst only once
+using AddMultipliedManyKernel = void (*)(float* dst, const float* const* srcs, const float* coeffs,
+	std::size_t sources, std::size_t count);
+
+//! Whether the magnitude of all samples is below @p threshold, NaNs are not
+using IsSilentKernel = bool (*)(const float* src, std::size_t count, float threshold);
+
+/**
+ * @brief The mixing functions of MixHelpers, working on blocks of samples.
+ *
+ * There is one set per supported instruction set, the fastest one the CPU
+ * can run is picked at runtime. The vectorised sets may differ from the
+ * scalar one by rounding errors, as they use fused multiply-adds where
+ * available and sum the sources of addMultipliedMany() in a different order.
+ */
+struct KernelSet
+{
+	const char* name;
+	AddKernel add;
+	AddMultipliedKernel addMultiplied;
+	AddMultipliedByBufferKernel addMultipliedByBuffer;
+	AddMultipliedByBuffersKernel addMultipliedByBuffers;
+	MultiplyAndAddMultipliedKernel multiplyAndAddMultiplied;
+	AddMultipliedManyKernel addMultipliedMany;
+	IsSilentKernel isSilent;
+};
+
+//! The fastest set for this CPU. Detected on the first call, which
+//! Engine::init() makes before anything is rendered.
+LMMS_EXPORT const KernelSet& best();
+
+//! All sets this build and CPU can run, the scalar one first
+LMMS_EXPORT std::vector<const KernelSet*> supported();
+
+} // namespace lmms::MixKernels
+
+#endif // LMMS_MIX_KERNELS_H
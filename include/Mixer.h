@@ -62,7 +62,6 @@ public:
 	FloatModel m_volumeModel;
 	QString m_name;
 	QMutex m_lock;
-	bool m_queued; // are we queued up for rendering yet?
 	bool m_muted; // are we muted? updated per period so we don't have to call m_muteModel.value() twice
 
 	// pointers to other channels that this one sends to
@@ -76,7 +75,8 @@ public:
 
 	bool isMaster() { return m_channelIndex == 0; }
 
-	bool requiresProcessing() const override { return true; }
+	bool requiresProcessing() const override { return !m_muted; }
+	QString profilerName() const override { return QString("Mixer: %1").arg(m_name); }
 	void unmuteForSolo();
 	void unmuteSenderForSolo();
 	void unmuteReceiverForSolo();
@@ -84,8 +84,12 @@ public:
 	auto color() const -> const std::optional<QColor>& { return m_color; }
 	void setColor(const std::optional<QColor>& color) { m_color = color; }
 
-	std::atomic_size_t m_dependenciesMet;
-	void incrementDeps();
+	// routing compiled by Mixer::compileGraph()
+	std::vector<MixerChannel*> m_receivers; // channels this one sends to
+	std::size_t m_numSenders; // number of channels sending to this one
+	bool m_inLoop = false; // part of a routing loop, never processed
+
+	void senderDone();
 	void processed();
 
 private:
@@ -147,6 +151,15 @@ public:
 	void prepareMasterMix();
 	void masterMix( SampleFrame* _buf );
 
+	// masterMix() split up, for running the mixer as part of a bigger task
+	// graph: prepareChannels() makes every channel depend on its senders,
+	// further dependencies (e.g. AudioBusHandles) may be added afterwards.
+	// queueChannels() then queues all channels that are ready and
+	// finishMasterMix() writes the master output once all jobs are done.
+	void prepareChannels();
+	void queueChannels();
+	void finishMasterMix( SampleFrame* _buf );
+
 	void saveSettings( QDomDocument & _doc, QDomElement & _parent ) override;
 	void loadSettings( const QDomElement & _this ) override;
 
@@ -221,7 +234,15 @@ private:
 	// make sure we have at least num channels
 	void allocateChannelsTo(int num);
 
+	// compile the channel routing into a DAG sorted in topological order.
+	// Must be called with the audio engine locked whenever the routing changes.
+	void compileGraph();
+
 	int m_lastSoloed;
+
+	// all channels in topological order, i.e. every channel comes after
+	// all channels sending to it
+	std::vector<MixerChannel*> m_processingOrder;
 } ;
 
 
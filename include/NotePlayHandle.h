@@ -28,18 +28,17 @@
 
 #include <memory>
 
-#include "BasicFilters.h"
+#include "LocklessPool.h"
 #include "Note.h"
 #include "PlayHandle.h"
 #include "Track.h"
 
-class QReadWriteLock;
-
 namespace lmms
 {
 
 class InstrumentTrack;
 class NotePlayHandle;
+struct SoundShapingNoteState;
 
 using NotePlayHandleList = QList<NotePlayHandle*>;
 using ConstNotePlayHandleList = QList<const NotePlayHandle*>;
@@ -48,7 +47,7 @@ class LMMS_EXPORT NotePlayHandle : public PlayHandle, public Note
 {
 public:
 	void * m_pluginData;
-	std::unique_ptr<BasicFilters<>> m_filter;
+	std::unique_ptr<SoundShapingNoteState> m_soundShaping;
 
 	// length of the declicking fade in
 	f_cnt_t m_fadeInLength;
@@ -127,6 +126,8 @@ public:
 	/*! Returns whether the play handle plays on a certain track */
 	bool isFromTrack( const Track* _track ) const override;
 
+	QString profilerName() const override;
+
 	/*! Releases the note (and plays release frames) */
 	void noteOff( const f_cnt_t offset = 0 );
 
@@ -333,13 +334,21 @@ private:
 } ;
 
 
-const int INITIAL_NPH_CACHE = 256;
-const int NPH_CACHE_INCREMENT = 16;
-
+/**
+ * @brief Pool of NotePlayHandles.
+ *
+ * acquire() and release() are lock-free and don't allocate as long as the
+ * pool isn't exhausted, so notes can be started from any worker thread.
+ * The pool is grown outside of the audio threads, see LocklessPool.
+ */
 class NotePlayHandleManager
 {
 public:
-	static void init();
+	using Statistics = LocklessPool::Statistics;
+
+	//! Number of handles reserved if "audioengine"/"polyphony" isn't configured
+	static constexpr std::size_t DefaultPolyphony = 256;
+
 	static NotePlayHandle * acquire( InstrumentTrack* instrumentTrack,
 					const f_cnt_t offset,
 					const f_cnt_t frames,
@@ -348,14 +357,19 @@ public:
 					int midiEventChannel = -1,
 					NotePlayHandle::Origin origin = NotePlayHandle::Origin::MidiClip );
 	static void release( NotePlayHandle * nph );
-	static void extend( int i );
-	static void free();
+
+	//! Grow the pool to hold at least @p count handles. Not realtime-safe.
+	static void reserve( std::size_t count );
+	//! Grow the pool if it is running low. Not realtime-safe, call it
+	//! periodically from a non-audio thread.
+	static void refill();
+
+	static Statistics statistics();
 
 private:
-	static NotePlayHandle ** s_available;
-	static QReadWriteLock s_mutex;
-	static std::atomic_int s_availableIndex;
-	static int s_size;
+	static constexpr std::size_t ChunkSize = 64;
+
+	static LocklessPool& pool();
 };
 
 
@@ -84,10 +84,8 @@ public:
 			const float &phase_offset,
 			const float &volume,
 			Oscillator *m_subOsc = nullptr);
-	virtual ~Oscillator()
-	{
-		delete m_subOsc;
-	}
+	//! The sub oscillator isn't owned, it must outlive this one
+	virtual ~Oscillator() = default;
 
 	static void waveTableInit();
 	static void destroyFFTPlans();
@@ -109,6 +107,8 @@ public:
 	}
 
 	void update(SampleFrame* ab, const f_cnt_t frames, const ch_cnt_t chnl, bool modulator = false);
+	//! Renders into a mono buffer
+	void update(sample_t* buffer, const f_cnt_t frames, bool modulator = false);
 
 	// now follow the wave-shape-routines...
 	static inline sample_t sinSample( const float _sample )
@@ -274,44 +274,41 @@ private:
 	/* End Multiband wavetable */
 
 
-	void updateNoSub( SampleFrame* _ab, const f_cnt_t _frames,
-							const ch_cnt_t _chnl );
-	void updatePM( SampleFrame* _ab, const f_cnt_t _frames,
-							const ch_cnt_t _chnl );
-	void updateAM( SampleFrame* _ab, const f_cnt_t _frames,
-							const ch_cnt_t _chnl );
-	void updateMix( SampleFrame* _ab, const f_cnt_t _frames,
-							const ch_cnt_t _chnl );
-	void updateSync( SampleFrame* _ab, const f_cnt_t _frames,
-							const ch_cnt_t _chnl );
-	void updateFM( SampleFrame* _ab, const f_cnt_t _frames,
-							const ch_cnt_t _chnl );
-
-	float syncInit( SampleFrame* _ab, const f_cnt_t _frames,
-							const ch_cnt_t _chnl );
+	//! Number of frames rendered at once, all scratch buffers are on the stack
+	static constexpr f_cnt_t BlockSize = DEFAULT_BUFFER_SIZE;
+
+	//! Renders at most BlockSize frames
+	void updateBlock(sample_t* buffer, const f_cnt_t frames, bool modulator);
+
+	void updateNoSub( sample_t* _buf, const f_cnt_t _frames );
+	void updatePM( sample_t* _buf, const f_cnt_t _frames );
+	void updateAM( sample_t* _buf, const f_cnt_t _frames );
+	void updateMix( sample_t* _buf, const f_cnt_t _frames );
+	void updateSync( sample_t* _buf, const f_cnt_t _frames );
+	void updateFM( sample_t* _buf, const f_cnt_t _frames );
+
+	float syncInit( sample_t* _buf, const f_cnt_t _frames );
 	inline bool syncOk( float _osc_coeff );
 
 	template<WaveShape W>
-	void updateNoSub( SampleFrame* _ab, const f_cnt_t _frames,
-							const ch_cnt_t _chnl );
+	void updateNoSub( sample_t* _buf, const f_cnt_t _frames );
 	template<WaveShape W>
-	void updatePM( SampleFrame* _ab, const f_cnt_t _frames,
-							const ch_cnt_t _chnl );
+	void updatePM( sample_t* _buf, const f_cnt_t _frames );
 	template<WaveShape W>
-	void updateAM( SampleFrame* _ab, const f_cnt_t _frames,
-							const ch_cnt_t _chnl );
+	void updateAM( sample_t* _buf, const f_cnt_t _frames );
 	template<WaveShape W>
-	void updateMix( SampleFrame* _ab, const f_cnt_t _frames,
-							const ch_cnt_t _chnl );
+	void updateMix( sample_t* _buf, const f_cnt_t _frames );
 	template<WaveShape W>
-	void updateSync( SampleFrame* _ab, const f_cnt_t _frames,
-							const ch_cnt_t _chnl );
+	void updateSync( sample_t* _buf, const f_cnt_t _frames );
 	template<WaveShape W>
-	void updateFM( SampleFrame* _ab, const f_cnt_t _frames,
-							const ch_cnt_t _chnl );
+	void updateFM( sample_t* _buf, const f_cnt_t _frames );
 
+	//! Evaluates the wave shape at all @p phases using OscillatorKernels
 	template<WaveShape W>
-	inline sample_t getSample( const float _sample );
+	void sampleBlock( const float* _phases, sample_t* _out, const f_cnt_t _frames );
+
+	//! Band of the multiband wavetables to use at the current frequency
+	int waveTableBand() const;
 
 	inline void recalcPhase();
 
@@ -0,0 +1,71 @@
+/*
+ * OscillatorKernels.h - block wave shape functions used by Oscillator
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_OSCILLATOR_KERNELS_H
+#define LMMS_OSCILLATOR_KERNELS_H
+
+#include <cstddef>
+#include <vector>
+
+#include "LmmsTypes.h"
+#include "lmms_export.h"
+
+namespace lmms::OscillatorKernels
+{
+
+//! Evaluates a wave shape for @p count phases, given in periods
+using ShapeKernel = void (*)(const float* phases, sample_t* out, std::size_t count);
+
+//! Linearly interpolates a table of OscillatorConstants::WAVETABLE_LENGTH
+//! samples at @p count phases, given in periods
+using TableKernel = void (*)(const sample_t* table, const float* phases, sample_t* out, std::size_t count);
+
+/**
+ * @brief The wave shape functions of Oscillator, working on blocks of phases.
+ *
+ * There is one set per supported instruction set, the fastest one the CPU
+ * can run is picked at runtime. The scalar set uses the same per-sample
+ * functions as Oscillator::sinSample() etc., the vectorised ones may differ
+ * from them by rounding errors and use a polynomial approximation of sin().
+ */
+struct KernelSet
+{
+	const char* name;
+	ShapeKernel sine;
+	ShapeKernel triangle;
+	ShapeKernel saw;
+	ShapeKernel square;
+	ShapeKernel moogSaw;
+	ShapeKernel exponential;
+	TableKernel table;
+};
+
+//! The fastest set for this CPU. Detected on the first call, which
+//! Engine::init() makes before anything is rendered.
+LMMS_EXPORT const KernelSet& best();
+
+//! All sets this build and CPU can run, the scalar one first
+LMMS_EXPORT std::vector<const KernelSet*> supported();
+
+} // namespace lmms::OscillatorKernels
+
+#endif // LMMS_OSCILLATOR_KERNELS_H
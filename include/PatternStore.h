@@ -92,7 +92,7 @@ public:
 	void fixIncorrectPositions();
 	void createClipsForPattern(int pattern);
 
-	AutomatedValueMap automatedValuesAt(TimePos time, int clipNum) const override;
+	void collectAutomatedValues(TimePos time, int clipNum, AutomatedValueList& values) const override;
 
 public slots:
 	void play();
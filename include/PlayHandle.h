@@ -148,6 +148,17 @@ public:
 	
 	SampleFrame* buffer();
 
+	//! Whether the buffer rendered in the last period is silent, so it
+	//! doesn't need to be mixed
+	bool isBufferSilent() const
+	{
+		return m_bufferSilent;
+	}
+
+	//! Checks the buffer for silence again, after it was changed outside
+	//! of play() in the same period
+	void updateBufferSilence();
+
 private:
 	Type m_type;
 	f_cnt_t m_offset;
@@ -155,6 +166,7 @@ private:
 	QMutex m_processingLock;
 	SampleFrame* m_playHandleBuffer;
 	bool m_bufferReleased;
+	bool m_bufferSilent;
 	bool m_usesBuffer;
 	AudioBusHandle* m_audioBusHandle;
 } ;
@@ -52,6 +52,11 @@ public:
 
 	bool isFromTrack( const Track * _track ) const override;
 
+	QString profilerName() const override
+	{
+		return QStringLiteral( "Preset preview" );
+	}
+
 	static void init();
 	static void cleanup();
 	static ConstNotePlayHandleList nphsOfInstrumentTrack( const InstrumentTrack* instrumentTrack );
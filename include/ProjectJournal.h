@@ -25,6 +25,8 @@
 #ifndef LMMS_PROJECT_JOURNAL_H
 #define LMMS_PROJECT_JOURNAL_H
 
+#include <chrono>
+#include <QByteArray>
 #include <QHash>
 #include <QStack>
 
@@ -39,12 +41,31 @@ namespace lmms
 class JournallingObject;
 
 
-//! @warning many parts of this class may be rewritten soon
+/**
+ * @brief Undo and redo history of all journalling objects.
+ *
+ * The newest check point of an object holds its serialized state,
+ * compressed. Most edits only change a small part of an object, so an older
+ * check point of the same object only keeps the XML nodes that differ from
+ * the next newer one, in a compact binary form. The history is limited in
+ * memory as well as in steps. Callers making many small edits in quick
+ * succession (e.g. scrolling over a knob) can ask for their check points to
+ * be merged into one.
+ *
+ * What is kept grows with the size of the change, but making a check point
+ * and undoing one still serialize and restore the whole object, which costs
+ * O(size of the object).
+ *
+ * @warning many parts of this class may be rewritten soon
+ */
 class ProjectJournal
 {
 public:
 	static const int MAX_UNDO_STATES;
 
+	//! Coalesced check points of the same object closer together than this are merged
+	static constexpr auto CoalesceInterval = std::chrono::milliseconds{250};
+
 	ProjectJournal();
 	virtual ~ProjectJournal() = default;
 
@@ -54,7 +75,11 @@ public:
 	bool canUndo() const;
 	bool canRedo() const;
 
-	void addJournalCheckPoint( JournallingObject *jo );
+	//! Saves the state of @p jo for undo. With @p coalesce, a check point
+	//! made within CoalesceInterval of the previous coalesced check point of
+	//! the same object is merged into that one, so that e.g. scrolling over
+	//! a knob is undone in one step.
+	void addJournalCheckPoint( JournallingObject *jo, bool coalesce = false );
 
 	bool isJournalling() const
 	{
@@ -99,25 +124,51 @@ public:
 	}
 
 
+	//! Memory used by the undo history in bytes
+	qsizetype undoMemory() const
+	{
+		return m_undoBytes;
+	}
+
+
 private:
 	using JoIdMap = QHash<jo_id_t, JournallingObject*>;
+	using Clock = std::chrono::steady_clock;
 
 	struct CheckPoint
 	{
-		CheckPoint( jo_id_t initID = 0, const DataFile& initData = DataFile( DataFile::Type::JournalData ) ) :
-			joID( initID ),
-			data( initData )
-		{
-		}
-		jo_id_t joID;
-		DataFile data;
+		jo_id_t joID = 0;
+		//! The compressed state, or the nodes in which it differs from the
+		//! state of the next newer check point of the same object
+		QByteArray data;
+		bool isDelta = false;
 	} ;
 	using CheckPointStack = QStack<CheckPoint>;
 
+	//! app/undomemorylimit in bytes, it is given in MB
+	static qsizetype configuredUndoMemoryLimit();
+
+	static QByteArray saveObjectState( JournallingObject* jo );
+	void restoreObjectState( JournallingObject* jo, const QByteArray& state );
+
+	static CheckPoint fullCheckPoint( jo_id_t id, const QByteArray& state );
+	static CheckPoint deltaCheckPoint( jo_id_t id, const QByteArray& state, const QByteArray& newer );
+	static QByteArray applyDelta( const CheckPoint& delta, const QByteArray& newer );
+
+	//! Pushes the state of object @p id, the previous check point of the same object becomes a delta
+	void pushUndoCheckPoint( jo_id_t id, const QByteArray& state );
+	//! Pops the newest check point, @return its state
+	QByteArray popUndoCheckPoint( jo_id_t& id );
+	//! Removes the oldest check points until the history fits its limits
+	void trimUndoCheckPoints();
+
 	JoIdMap m_joIDs;
 
 	CheckPointStack m_undoCheckPoints;
 	CheckPointStack m_redoCheckPoints;
+	qsizetype m_undoBytes;
+	qsizetype m_undoMemoryLimit;
+	Clock::time_point m_lastCheckPoint; //!< of the newest check point, if it was coalesced
 
 	bool m_journalling;
 
@@ -25,6 +25,9 @@
 #ifndef LMMS_PROJECT_RENDERER_H
 #define LMMS_PROJECT_RENDERER_H
 
+#include <cstdint>
+#include <vector>
+
 #include "AudioFileDevice.h"
 #include "AudioEngine.h"
 #include "OutputSettings.h"
@@ -34,6 +37,7 @@
 namespace lmms
 {
 
+class AudioBusHandle;
 
 class LMMS_EXPORT ProjectRenderer : public QThread
 {
@@ -59,8 +63,18 @@ public:
 		AudioFileDeviceInstantiaton m_getDevInst;
 	} ;
 
+	//! Output of a single AudioBusHandle, written into its own file
+	struct Stem
+	{
+		AudioBusHandle* bus;
+		QString outputFile;
+	};
+
 	ProjectRenderer(const OutputSettings& _os, ExportFileFormat _file_format, const QString& _out_file);
-	~ProjectRenderer() override = default;
+	//! Renders every bus of @p stems into its own file in a single pass over the song
+	ProjectRenderer(const OutputSettings& outputSettings, ExportFileFormat exportFileFormat,
+		const std::vector<Stem>& stems);
+	~ProjectRenderer() override;
 
 	bool isReady() const
 	{
@@ -74,6 +88,11 @@ public:
 
 	static const std::array<FileEncodeDevice, 5> fileEncodeDevices;
 
+	//! Number of frames rendered by the last run
+	std::uint64_t framesRendered() const { return m_framesRendered; }
+	//! Wall clock time the last run took, in seconds
+	double renderTime() const { return m_renderTime; }
+
 public slots:
 	void startProcessing();
 	void abortProcessing();
@@ -86,13 +105,28 @@ signals:
 
 
 private:
+	struct StemOutput
+	{
+		AudioBusHandle* bus;
+		AudioFileDevice* fileDev;
+	};
+
+	static AudioFileDevice* createFileDevice(const OutputSettings& outputSettings,
+		ExportFileFormat exportFileFormat, const QString& outputFilename);
+
 	void run() override;
 
+	// in stem mode, this is the device of the first stem - it is handed to
+	// the audio engine, which takes its ownership
 	AudioFileDevice * m_fileDev;
+	std::vector<StemOutput> m_stems;
 
 	volatile int m_progress;
 	volatile bool m_abort;
 
+	std::uint64_t m_framesRendered;
+	double m_renderTime;
+
 } ;
 
 
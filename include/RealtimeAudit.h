@@ -0,0 +1,91 @@
+/*
+ * RealtimeAudit.h - detect realtime-unsafe calls on the audio threads
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_REALTIME_AUDIT_H
+#define LMMS_REALTIME_AUDIT_H
+
+#include <cstddef>
+
+#include "lmms_export.h"
+#include "lmmsconfig.h"
+
+class QString;
+
+namespace lmms
+{
+
+/**
+ * @brief Debug helper reporting realtime-unsafe calls made while rendering.
+ *
+ * When LMMS is built with WANT_DEBUG_RT_AUDIT, malloc(), free(),
+ * pthread_mutex_lock() and blocking futex waits (contended QMutex) are
+ * interposed. Every such call made by a thread inside a Scope is recorded
+ * together with its backtrace while auditing is enabled. Without the build
+ * option, Scope is a no-op and isSupported() returns false.
+ */
+class LMMS_EXPORT RealtimeAudit
+{
+public:
+	enum class Violation
+	{
+		Allocation,
+		Deallocation,
+		MutexLock,
+		FutexWait
+	};
+
+	//! Marks the current thread as realtime for the lifetime of the object
+	class Scope
+	{
+	public:
+#ifdef LMMS_DEBUG_RT_AUDIT
+		Scope() { enter(); }
+		~Scope() { leave(); }
+#else
+		Scope() {}
+		~Scope() {}
+#endif
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+	};
+
+	static bool isSupported();
+
+	//! Start recording violations. Not realtime-safe.
+	static void enable();
+	static bool isEnabled();
+
+	//! Number of violations recorded since enable(), including dropped ones
+	static std::size_t violationCount();
+
+	//! Writes all recorded violations, grouped by call stack, to @p file
+	static bool writeReport(const QString& file);
+
+private:
+	static void enter();
+	static void leave();
+};
+
+
+} // namespace lmms
+
+#endif // LMMS_REALTIME_AUDIT_H
@@ -25,11 +25,14 @@
 #ifndef LMMS_REMOTE_PLUGIN_H
 #define LMMS_REMOTE_PLUGIN_H
 
+#include <atomic>
+#include <memory>
 #include <QThread>
 #include <QProcess>
 #include <QRecursiveMutex>
 
 #include "RemotePluginBase.h"
+#include "RemoteProcessingRing.h"
 #include "SharedMemory.h"
 #include "LmmsTypes.h"
 
@@ -38,13 +41,14 @@ namespace lmms
 
 class MidiEvent;
 class RemotePlugin;
+class RemotePluginProcess;
 class SampleFrame;
 
 class ProcessWatcher : public QThread
 {
 	Q_OBJECT
 public:
-	ProcessWatcher( RemotePlugin * );
+	ProcessWatcher( RemotePluginProcess * );
 	~ProcessWatcher() override = default;
 
 	void stop()
@@ -61,12 +65,105 @@ public:
 private:
 	void run() override;
 
-	RemotePlugin * m_plugin;
+	RemotePluginProcess * m_process;
 	volatile bool m_quit;
 
 } ;
 
 
+/**
+ * @brief A remote plugin executable running in its own process, together
+ * with the channel LMMS talks to it through.
+ *
+ * Starting the process and waiting for it to connect are separate steps, so
+ * RemotePluginPool can start processes before they are needed. The process
+ * is handed to a RemotePlugin, which then owns it.
+ */
+class LMMS_EXPORT RemotePluginProcess
+{
+public:
+	RemotePluginProcess();
+	~RemotePluginProcess();
+
+	RemotePluginProcess( const RemotePluginProcess& ) = delete;
+	RemotePluginProcess& operator=( const RemotePluginProcess& ) = delete;
+
+	//! @return the path of the remote plugin executable @p pluginExecutable,
+	//! or an empty string if it doesn't exist
+	static QString executablePath( const QString& pluginExecutable );
+
+	//! Starts @p executable without waiting for it
+	void launch( const QString& executable, const QStringList& extraArgs );
+
+	const QString& executable() const
+	{
+		return m_exec;
+	}
+
+	const QStringList& extraArgs() const
+	{
+		return m_extraArgs;
+	}
+
+	bool matches( const QString& executable, const QStringList& extraArgs ) const
+	{
+		return m_exec == executable && m_extraArgs == extraArgs;
+	}
+
+	bool isRunning() const;
+
+	//! Whether the process failed to start or has finished. Unlike
+	//! isRunning(), this is false while the process is still starting.
+	bool hasExited() const
+	{
+		return m_exited;
+	}
+
+	//! Sets the plugin talking to the process, it is invalidated if the
+	//! process dies. The watcher thread reads it, so call stopWatching()
+	//! before taking the process away from a plugin.
+	void setPlugin( RemotePlugin* plugin )
+	{
+		m_plugin = plugin;
+	}
+
+	//! Stops watching the process, it isn't reported as dead from then on
+	void stopWatching();
+
+	//! Waits until the process quits, kills it if it doesn't within @p msecs
+	void finish( int msecs );
+
+private:
+	void processFinished( int exitCode, QProcess::ExitStatus exitStatus );
+
+	QProcess m_process;
+	ProcessWatcher m_watcher;
+	QThread* m_ownerThread;
+
+	QString m_exec;
+	QStringList m_extraArgs;
+	QStringList m_args;
+
+	std::atomic<RemotePlugin*> m_plugin;
+	std::atomic<bool> m_exited;
+
+#ifdef SYNC_WITH_SHM_FIFO
+	// the FIFOs as LMMS sees them, handed to the plugin by RemotePlugin::init()
+	shmFifo* m_in;
+	shmFifo* m_out;
+#else
+	//! Accepts the connection of the process, @return the socket or -1
+	int acceptConnection();
+
+	int m_server;
+	QString m_socketFile;
+#endif // not SYNC_WITH_SHM_FIFO
+
+	friend class ProcessWatcher;
+	friend class RemotePlugin;
+} ;
+
+
 class LMMS_EXPORT RemotePlugin : public QObject, public RemotePluginBase
 {
 	Q_OBJECT
@@ -79,7 +176,7 @@ public:
 #ifdef DEBUG_REMOTE_PLUGIN
 		return true;
 #else
-		return m_process.state() != QProcess::NotRunning;
+		return m_remoteProcess && m_remoteProcess->isRunning();
 #endif // DEBUG_REMOTE_PLUGIN
 	}
 
@@ -100,7 +197,8 @@ public:
 
 	bool process( const SampleFrame* _in_buf, SampleFrame* _out_buf );
 
-	void processMidiEvent( const MidiEvent&, const f_cnt_t _offset );
+	//! Sends a MIDI event, to instance @p instance if the remote hosts several
+	void processMidiEvent( const MidiEvent&, const f_cnt_t _offset, int instance = 0 );
 
 	void updateSampleRate( sample_rate_t _sr )
 	{
@@ -152,17 +250,33 @@ protected:
 		m_splitChannels = _on;
 	}
 
+	//! Copies the outputs of the last processed period to @p _out_buf.
+	//! Remotes with more outputs than a stereo buffer holds read them
+	//! through sharedOutputs() instead.
+	virtual void readOutputs( SampleFrame* _out_buf, f_cnt_t frames );
+
+	//! The outputs of the last processed period in the shared audio buffer
+	const float* sharedOutputs() const;
+
+	int outputCount() const
+	{
+		return m_outputCount;
+	}
+
 
 	bool m_failed;
 private:
 	void resizeSharedProcessingMemory();
+	void setUpProcessingRing();
 
+	void writeInputs( const SampleFrame* _in_buf, f_cnt_t frames );
 
-	QProcess m_process;
-	ProcessWatcher m_watcher;
+	bool processThroughRing( const SampleFrame* _in_buf, SampleFrame* _out_buf );
+	//! Waits until the remote completed the last period requested through the ring
+	bool waitForRing();
 
-	QString m_exec;
-	QStringList m_args;
+
+	std::unique_ptr<RemotePluginProcess> m_remoteProcess;
 
 	QRecursiveMutex m_commMutex;
 	bool m_splitChannels;
@@ -173,17 +287,19 @@ private:
 	int m_inputCount;
 	int m_outputCount;
 
-#ifndef SYNC_WITH_SHM_FIFO
-	int m_server;
-	QString m_socketFile;
-#endif // not SYNC_WITH_SHM_FIFO
+	// Periods and MIDI events can be exchanged through a lock-free ring
+	// instead of messages, if the remote supports it. In pipelined mode the
+	// remote renders a period while LMMS processes everything else, and its
+	// output is picked up one period later.
+	RemoteProcessingRing m_ring;
+	bool m_useRing;
+	bool m_ringPipelined;
+	bool m_ringActive;
+	bool m_ringPending;
+	std::uint32_t m_ringSequence;
 
 	friend class ProcessWatcher;
-
-
-private slots:
-	void processFinished( int exitCode, QProcess::ExitStatus exitStatus );
-	void processErrored(QProcess::ProcessError err );
+	friend class RemotePluginProcess;
 } ;
 
 inline std::string QSTR_TO_STDSTR(QString const& qstr)
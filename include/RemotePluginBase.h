@@ -344,6 +344,7 @@ enum RemoteMessageIDs
 	IdLoadPresetFile,
 	IdDebugMessage,
 	IdIdle,
+	IdChangeProcessingRingKey,
 	IdUserBase = 64
 } ;
 
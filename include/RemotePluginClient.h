@@ -27,6 +27,8 @@
 
 #include "RemotePluginBase.h"
 
+#include <atomic>
+#include <chrono>
 #include <stdexcept>
 
 #ifndef LMMS_BUILD_WIN32
@@ -40,6 +42,7 @@
 
 #include "LmmsTypes.h"
 #include "MidiEvent.h"
+#include "RemoteProcessingRing.h"
 #include "SharedMemory.h"
 #include "VstSyncData.h"
 
@@ -69,6 +72,13 @@ public:
 	{
 	}
 
+	//! Handles a MIDI event for instance @p instance, for remotes hosting
+	//! several instances. Remotes hosting one ignore the instance.
+	virtual void processInstanceMidiEvent( int /* instance */, const MidiEvent& event, const f_cnt_t offset )
+	{
+		processMidiEvent( event, offset );
+	}
+
 	virtual void updateSampleRate()
 	{
 	}
@@ -124,13 +134,54 @@ public:
 	}
 
 
+protected:
+	//! Whether the plugin can process periods requested through a
+	//! RemoteProcessingRing. process() and processMidiEvent() are then
+	//! called from a separate thread, concurrently with processMessage().
+	virtual bool supportsProcessingRing() const
+	{
+		return false;
+	}
+
+	//! Processes one period requested through the ring, called on the ring thread
+	virtual void processRingPeriod()
+	{
+		processRingMidiEvents();
+		doProcessing();
+	}
+
+	void processRingMidiEvents();
+
+	//! Stops the ring thread, plugins supporting the ring must call this
+	//! before they are destroyed
+	void stopProcessingRing();
+
+	//! Number of samples the shared audio buffer holds after the inputs.
+	//! It only grows once the host answered a larger output count.
+	std::size_t sharedOutputSize() const
+	{
+		const auto inputs = static_cast<std::size_t>(m_inputCount) * m_bufferSize;
+		return m_audioBuffer.size() > inputs ? m_audioBuffer.size() - inputs : 0;
+	}
+
+
 private:
 	void setShmKey(const std::string& key);
 	void doProcessing();
 
+	bool startProcessingRing(const std::string& key);
+	void processingRingLoop();
+
 	SharedMemory<float[]> m_audioBuffer;
 	SharedMemory<const VstSyncData> m_vstSyncData;
 
+	RemoteProcessingRing m_ring;
+#ifndef LMMS_BUILD_WIN32
+	// MinGW has no std::thread, the ring is only served on other systems
+	std::thread m_ringThread;
+#endif
+	std::atomic<bool> m_ringStop;
+
 	int m_inputCount;
 	int m_outputCount;
 
@@ -186,6 +237,7 @@ RemotePluginClient::RemotePluginClient( const std::string& _shm_in, const std::s
 RemotePluginClient::RemotePluginClient( const char * socketPath ) :
 	RemotePluginBase(),
 #endif
+	m_ringStop( false ),
 	m_inputCount( 0 ),
 	m_outputCount( 0 ),
 	m_sampleRate( 44100 ),
@@ -221,6 +273,7 @@ RemotePluginClient::RemotePluginClient( const char * socketPath ) :
 
 RemotePluginClient::~RemotePluginClient()
 {
+	stopProcessingRing();
 	sendMessage( IdQuit );
 
 #ifndef SYNC_WITH_SHM_FIFO
@@ -286,7 +339,7 @@ bool RemotePluginClient::processMessage( const message & _m )
 			return false;
 
 		case IdMidiEvent:
-			processMidiEvent(
+			processInstanceMidiEvent( _m.getInt( 5 ),
 				MidiEvent( static_cast<MidiEventTypes>(
 							_m.getInt( 0 ) ),
 						_m.getInt( 1 ),
@@ -305,6 +358,11 @@ bool RemotePluginClient::processMessage( const message & _m )
 			setShmKey(_m.getString(0));
 			break;
 
+		case IdChangeProcessingRingKey:
+			reply_message.addInt( startProcessingRing( _m.getString( 0 ) ) ? 1 : 0 );
+			reply = true;
+			break;
+
 		case IdInitDone:
 			break;
 
@@ -342,6 +400,80 @@ void RemotePluginClient::setShmKey(const std::string& key)
 
 
 
+bool RemotePluginClient::startProcessingRing(const std::string& key)
+{
+#ifdef LMMS_BUILD_WIN32
+	(void) key;
+	return false;
+#else
+	if (!supportsProcessingRing() || m_ringThread.joinable())
+	{
+		return false;
+	}
+
+	try
+	{
+		m_ring.attach(key);
+	}
+	catch (const std::runtime_error& error)
+	{
+		debugMessage(std::string{"failed attaching processing ring: "} + error.what() + '\n');
+		return false;
+	}
+
+	m_ringThread = std::thread{&RemotePluginClient::processingRingLoop, this};
+	return true;
+#endif
+}
+
+
+
+
+void RemotePluginClient::stopProcessingRing()
+{
+#ifndef LMMS_BUILD_WIN32
+	if (m_ringThread.joinable())
+	{
+		m_ringStop = true;
+		m_ringThread.join();
+	}
+#endif
+}
+
+
+
+
+void RemotePluginClient::processingRingLoop()
+{
+	using namespace std::chrono_literals;
+
+	while (!m_ringStop && !m_ring.hasQuit())
+	{
+		// time out now and then to notice m_ringStop
+		if (m_ring.waitForRequest(100ms))
+		{
+			processRingPeriod();
+			m_ring.complete();
+		}
+	}
+}
+
+
+
+
+void RemotePluginClient::processRingMidiEvents()
+{
+	auto event = RemoteProcessingRing::MidiEvent{};
+	while (m_ring.popMidiEvent(event))
+	{
+		processInstanceMidiEvent(event.instance, MidiEvent(static_cast<MidiEventTypes>(event.type),
+				event.channel, event.param0, event.param1), event.offset);
+	}
+}
+
+
+
+
 void RemotePluginClient::doProcessing()
 {
 	if (m_audioBuffer)
@@ -0,0 +1,97 @@
+/*
+ * RemotePluginPool.h - remote plugin processes started before they are needed
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_REMOTE_PLUGIN_POOL_H
+#define LMMS_REMOTE_PLUGIN_POOL_H
+
+#include <memory>
+#include <vector>
+
+#include <QObject>
+#include <QStringList>
+
+#include "lmms_export.h"
+
+namespace lmms
+{
+
+class RemotePluginProcess;
+
+/**
+ * @brief Starts remote plugin processes before they are needed.
+ *
+ * Starting a remote plugin process, especially one running under Wine, takes
+ * much longer than anything else when a plugin is loaded. Every time a
+ * process is taken for an executable, the pool starts spare ones for the same
+ * executable in the background. The next plugin using it then gets a process
+ * that is already up and waiting for its connection. While a project is
+ * loaded, more spare processes are kept, so the processes for the following
+ * tracks start in parallel rather than one after another.
+ *
+ * Spare processes haven't been told anything yet, so any plugin can use them.
+ * They are only started for executables that have been used before, and the
+ * extra ones kept during loading are quit once the project is loaded.
+ *
+ * Only starting the processes is done in advance. Each process still hosts a
+ * single plugin, because the remote plugin clients keep their state in
+ * globals. Song::loadProject() still creates the plugins one after another,
+ * and each one connects to its process and loads its plugin in turn.
+ */
+class LMMS_EXPORT RemotePluginPool : public QObject
+{
+	Q_OBJECT
+public:
+	RemotePluginPool();
+	~RemotePluginPool() override;
+
+	//! @return a process running @p pluginExecutable with @p extraArgs,
+	//! or nullptr if the executable doesn't exist
+	std::unique_ptr<RemotePluginProcess> take( const QString& pluginExecutable, const QStringList& extraArgs );
+
+	bool isEnabled() const
+	{
+		return m_enabled;
+	}
+
+	void setEnabled( bool enabled );
+
+	//! Quits all spare processes
+	void clear();
+
+private slots:
+	//! Quits the spare processes that were only kept for loading a project
+	void trim();
+
+private:
+	//! Spare processes kept per executable
+	static constexpr int Spares = 1;
+	static constexpr int SparesWhileLoading = 4;
+
+	void startSpares( const QString& executable, const QStringList& extraArgs, int count );
+
+	bool m_enabled;
+	std::vector<std::unique_ptr<RemotePluginProcess>> m_spares;
+} ;
+
+} // namespace lmms
+
+#endif // LMMS_REMOTE_PLUGIN_POOL_H
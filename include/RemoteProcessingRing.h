@@ -0,0 +1,133 @@
+/*
+ * RemoteProcessingRing.h - lock-free exchange of periods and MIDI events
+ *                          between LMMS and a remote plugin
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ */
+
+#ifndef LMMS_REMOTE_PROCESSING_RING_H
+#define LMMS_REMOTE_PROCESSING_RING_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "SharedMemory.h"
+
+namespace lmms {
+
+/**
+ * @brief Lets the host request periods from a remote plugin and send it MIDI
+ * events without going through the message channel.
+ *
+ * The host and the remote both map the same block of shared memory. Periods
+ * are requested and completed by bumping a sequence number, MIDI events go
+ * through a single producer, single consumer ring, so neither side takes a
+ * lock. The audio itself stays in the shared audio buffer of the plugin.
+ *
+ * A side waiting for the other spins briefly and then sleeps on the sequence
+ * number with a futex on Linux. It counts itself as a waiter while sleeping,
+ * so the other side only makes the wake system call when someone sleeps.
+ * Other systems have no futex that works across processes, there the waiting
+ * side sleeps in short steps instead.
+ */
+class RemoteProcessingRing
+{
+public:
+	//! A MIDI event as it is sent with IdMidiEvent
+	struct MidiEvent
+	{
+		std::int32_t type;
+		std::int32_t channel;
+		std::int32_t param0;
+		std::int32_t param1;
+		std::int32_t offset;
+		//! The instance the event is for, if the remote hosts several
+		std::int32_t instance;
+		//! The period the event belongs to, set by pushMidiEvent()
+		std::uint32_t sequence;
+	};
+
+	static constexpr std::size_t MidiCapacity = 1024;
+
+	//! Creates a new ring, for the host
+	void create();
+
+	//! Attaches to the ring created by the host with the given key
+	void attach(const std::string& key);
+
+	void detach() noexcept { m_data.detach(); }
+
+	const std::string& key() const noexcept { return m_data.key(); }
+	explicit operator bool() const noexcept { return static_cast<bool>(m_data); }
+
+	// host side
+
+	//! Queues @p event for the period requested next.
+	//! @return false if the ring is full
+	bool pushMidiEvent(const MidiEvent& event);
+
+	//! Requests the next period from the remote, @return its sequence number
+	std::uint32_t request();
+
+	bool isCompleted(std::uint32_t sequence) const;
+
+	//! Waits until the remote completed the period @p sequence.
+	//! @return false if it didn't within @p timeout
+	bool waitForCompletion(std::uint32_t sequence, std::chrono::milliseconds timeout);
+
+	//! Makes the remote leave waitForRequest() for good
+	void quit();
+
+	// remote side
+
+	//! Waits until the host requests a period. @return false if it didn't
+	//! within @p timeout or if the host called quit()
+	bool waitForRequest(std::chrono::milliseconds timeout);
+
+	bool hasQuit() const;
+
+	//! Takes the next event queued for the period last returned by
+	//! waitForRequest() or an earlier one. Events for later periods stay
+	//! queued. @return false if there are no more such events
+	bool popMidiEvent(MidiEvent& event);
+
+	//! Marks the period last returned by waitForRequest() as completed
+	void complete();
+
+private:
+	struct Data
+	{
+		std::uint32_t requested; //!< written by the host
+		std::uint32_t completed; //!< written by the remote
+		std::uint32_t requestedWaiters; //!< number of threads sleeping on requested
+		std::uint32_t completedWaiters; //!< number of threads sleeping on completed
+		std::uint32_t quit;      //!< written by the host
+		std::uint32_t midiWrite; //!< written by the host
+		std::uint32_t midiRead;  //!< written by the remote
+		MidiEvent midiEvents[MidiCapacity];
+	};
+
+	SharedMemory<Data> m_data;
+	std::uint32_t m_handled = 0; //!< remote side: the last period returned by waitForRequest()
+};
+
+} // namespace lmms
+
+#endif // LMMS_REMOTE_PROCESSING_RING_H
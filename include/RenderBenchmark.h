@@ -0,0 +1,95 @@
+/*
+ * RenderBenchmark.h - headless render benchmark over a set of projects
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_RENDER_BENCHMARK_H
+#define LMMS_RENDER_BENCHMARK_H
+
+#include <optional>
+#include <vector>
+#include <QJsonObject>
+#include <QStringList>
+
+#include "AudioEngineProfiler.h"
+#include "lmms_export.h"
+
+namespace lmms
+{
+
+/**
+ * Loads and renders every project of a corpus a number of times without
+ * writing any audio file, as fast as possible. For every run the load time,
+ * the time spent upgrading the project file, the realtime factor of the
+ * render, the peak memory usage and the time spent in each stage of the
+ * audio engine are reported.
+ *
+ * The output of every render is hashed (quantized to 16 bit, so that tiny
+ * differences in summation order don't matter) and can be compared against
+ * reference hashes. Projects using random numbers, e.g. noise oscillators,
+ * don't render reproducibly and should not be given references.
+ *
+ * Requires an initialized engine without GUI.
+ */
+class LMMS_EXPORT RenderBenchmark
+{
+public:
+	struct Settings
+	{
+		//! Project files or directories, which are searched recursively
+		QStringList paths;
+		int repetitions = 3;
+		//! JSON file mapping project paths, relative to the file, to hashes
+		QString referenceFile;
+		//! Write the hashes of this run into referenceFile instead of comparing them
+		bool updateReference = false;
+		//! Optional file to write all results into as JSON
+		QString outputFile;
+	};
+
+	explicit RenderBenchmark(Settings settings);
+
+	//! @returns false if a project couldn't be loaded or didn't match its reference
+	bool run();
+
+private:
+	struct Run
+	{
+		double loadTime = 0;
+		double upgradeTime = 0;
+		double renderTime = 0;
+		f_cnt_t frames = 0;
+		long peakRss = 0;
+		AudioEngineProfiler::Totals totals;
+		QString hash;
+	};
+
+	QStringList findProjects() const;
+	std::optional<Run> renderProject(const QString& file);
+	QString referenceKey(const QString& file) const;
+	QJsonObject report(const QString& file, const std::vector<Run>& runs, const QString& status) const;
+
+	Settings m_settings;
+	QJsonObject m_references;
+};
+
+} // namespace lmms
+
+#endif // LMMS_RENDER_BENCHMARK_H
@@ -47,33 +47,59 @@ public:
 	/// Export all unmuted tracks into a single file
 	void renderProject();
 
-	/// Export all unmuted tracks into individual file
-	void renderTracks();
+	/// Where the tracks exported by renderTracks() are taken from
+	enum class StemSource
+	{
+		/// After the track's own effects, before mixer channel and master effects.
+		/// All tracks are rendered in a single song pass.
+		TrackBus,
+		/// After mixer channel and master effects. All other tracks are muted and
+		/// the song is rendered once per track.
+		Master
+	};
+
+	/// Export all unmuted tracks into individual files
+	void renderTracks(StemSource source = StemSource::TrackBus);
 
 	void abortProcessing();
 
+	//! Total number of frames rendered so far, over all tracks
+	std::uint64_t framesRendered() const { return m_framesRendered; }
+	//! Total wall clock time spent rendering so far, in seconds
+	double renderTime() const { return m_renderTime; }
+
 signals:
 	void progressChanged( int );
 	void finished();
 
 private slots:
-	void renderNextTrack();
+	void renderFinished();
 	void updateConsoleProgress();
 
 private:
+	//! The tracks to export, all unmuted instrument and sample tracks
+	static std::vector<Track*> unmutedTracks();
 	QString pathForTrack( const Track *track, int num );
+
+	//! Renders the next track of m_tracksToRender with all others muted
+	void renderNextTrack();
 	void restoreMutedState();
 
-	void render( QString outputPath );
+	void start(std::unique_ptr<ProjectRenderer> renderer);
 
 	const OutputSettings m_outputSettings;
 	ProjectRenderer::ExportFileFormat m_format;
 	QString m_outputPath;
 
 	std::unique_ptr<ProjectRenderer> m_activeRenderer;
+	std::size_t m_numStems = 0;
 
+	// rendering one track after another, with StemSource::Master
 	std::vector<Track*> m_tracksToRender;
 	std::vector<Track*> m_unmuted;
+
+	std::uint64_t m_framesRendered = 0;
+	double m_renderTime = 0;
 } ;
 
 
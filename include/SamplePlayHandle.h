@@ -57,6 +57,8 @@ public:
 
 	bool isFromTrack( const Track * _track ) const override;
 
+	QString profilerName() const override;
+
 	f_cnt_t totalFrames() const;
 	inline f_cnt_t framesDone() const
 	{
@@ -53,6 +53,11 @@ public:
 
 	bool isFromTrack( const Track * _track ) const override;
 
+	QString profilerName() const override
+	{
+		return QStringLiteral( "Sample recording" );
+	}
+
 	f_cnt_t framesRecorded() const;
 	std::shared_ptr<const SampleBuffer> createSampleBuffer();
 
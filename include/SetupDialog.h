@@ -99,7 +99,12 @@ private slots:
 	void vstEmbedMethodChanged();
 	void toggleVSTAlwaysOnTop(bool en);
 	void toggleDisableAutoQuit(bool enabled);
+	void toggleRemoteProcessingRing(bool enabled);
+	void toggleRemotePipelining(bool enabled);
+	void toggleRemotePluginPool(bool enabled);
 	void toggleMixSanitization(bool enabled);
+	void toggleTaskGraph(bool enabled);
+	void toggleSampleExactAutomation(bool enabled);
 
 	// Audio settings widget.
 	void audioInterfaceChanged(const QString & driver);
@@ -110,6 +115,7 @@ private slots:
 	// MIDI settings widget.
 	void midiInterfaceChanged(const QString & driver);
 	void toggleMidiAutoQuantization(bool enabled);
+	void toggleMidiTimestampInput(bool enabled);
 
 	// Paths settings widget.
 	void openWorkingDir();
@@ -174,6 +180,9 @@ private:
 	QCheckBox * m_vstAlwaysOnTopCheckBox;
 	bool m_vstAlwaysOnTop;
 	bool m_disableAutoQuit;
+	bool m_remoteProcessingRing;
+	bool m_remotePipelining;
+	bool m_remotePluginPool;
 
 	using AswMap = QMap<QString, AudioDeviceSetupWidget*>;
 	using MswMap = QMap<QString, MidiSetupWidget*>;
@@ -188,6 +197,8 @@ private:
 	QLabel * m_bufferSizeLbl;
 	QLabel * m_bufferSizeWarnLbl;
 	bool m_mixSanitization;
+	bool m_taskGraph;
+	bool m_sampleExactAutomation;
 	int m_sampleRate;
 	QSlider* m_sampleRateSlider;
 
@@ -197,6 +208,7 @@ private:
 	trMap m_midiIfaceNames;
 	QComboBox * m_assignableMidiDevices;
 	bool m_midiAutoQuantize;
+	bool m_midiTimestampInput;
 
 	// Paths settings widgets.
 	QString m_workingDir;
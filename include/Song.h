@@ -26,7 +26,9 @@
 #define LMMS_SONG_H
 
 #include <array>
+#include <atomic>
 #include <memory>
+#include <vector>
 
 #include <QString>
 #include <QHash>  // IWYU pragma: keep
@@ -176,6 +178,13 @@ public:
 	{
 		return m_recording;
 	}
+
+	//! @returns true if automation is written to the models' value buffers sample by sample
+	bool sampleExactAutomation() const { return m_sampleExactAutomation.load(std::memory_order_relaxed); }
+
+	//! Enable/disable following the automation curves sample by sample. Otherwise models take one
+	//! value per tick, and their value buffers ramp linearly between those.
+	void setSampleExactAutomation(bool enabled) { m_sampleExactAutomation.store(enabled, std::memory_order_relaxed); }
 	
 	inline void setLoopRenderCount(int count)
 	{
@@ -242,7 +251,7 @@ public:
 	}
 
 	//TODO: Add Q_DECL_OVERRIDE when Qt4 is dropped
-	AutomatedValueMap automatedValuesAt(TimePos time, int clipNum = -1) const override;
+	void collectAutomatedValues(TimePos time, int clipNum, AutomatedValueList& values) const override;
 
 	// file management
 	void createNewProject();
@@ -396,6 +405,8 @@ private:
 	void restoreKeymapStates(const QDomElement &element);
 
 	void processAutomations(const TrackList& tracks, TimePos timeStart, f_cnt_t frames);
+	void processAutomationRamps(float frameOffsetInTick, f_cnt_t offset, f_cnt_t frames);
+	bool isRecordedModel(const AutomatableModel* model) const;
 	void processMetronome(size_t bufferOffset);
 
 	void setModified(bool value);
@@ -455,7 +466,14 @@ private:
 	std::shared_ptr<Scale> m_scales[MaxScaleCount];
 	std::shared_ptr<Keymap> m_keymaps[MaxKeymapCount];
 
-	AutomatedValueMap m_oldAutomatedValues;
+	std::atomic<bool> m_sampleExactAutomation;
+
+	// Reused from tick to tick, so processing automation doesn't allocate
+	AutomatedValueList m_automatedValues;
+	std::vector<AutomatableModel*> m_oldAutomatedModels; //!< the models automated in the last tick
+	std::vector<const AutomatableModel*> m_recordedModels;
+	Track::clipVector m_recordingClips;
+	std::vector<float> m_automationRamp;
 
 	Metronome m_metronome;
 
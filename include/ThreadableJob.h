@@ -29,6 +29,8 @@
 
 #include <atomic>
 
+#include <QString>
+
 namespace lmms
 {
 
@@ -45,7 +47,9 @@ public:
 	};
 
 	ThreadableJob() :
-		m_state(ProcessingState::Unstarted)
+		m_state(ProcessingState::Unstarted),
+		m_pendingDependencies(0),
+		m_dependent(nullptr)
 	{
 	}
 
@@ -81,11 +85,55 @@ public:
 
 	virtual bool requiresProcessing() const = 0;
 
+	//! Name shown in job traces of the profiler. Not realtime-safe.
+	virtual QString profilerName() const
+	{
+		return QStringLiteral("Job");
+	}
+
+	// task graph support: once a queued job is done, the job queue resolves
+	// one dependency of its dependent and queues the dependent if that was
+	// the last one
+	void setDependencies(std::size_t count)
+	{
+		m_pendingDependencies = count;
+	}
+
+	void addDependency()
+	{
+		++m_pendingDependencies;
+	}
+
+	std::size_t pendingDependencies() const
+	{
+		return m_pendingDependencies.load();
+	}
+
+	//! @returns true if this was the last pending dependency
+	bool resolveDependency()
+	{
+		return --m_pendingDependencies == 0;
+	}
+
+	ThreadableJob* dependent() const
+	{
+		return m_dependent;
+	}
+
+	void setDependent(ThreadableJob* job)
+	{
+		m_dependent = job;
+	}
+
 
 protected:
 	virtual void doProcessing() = 0;
 
 	std::atomic<ProcessingState> m_state;
+
+private:
+	std::atomic_size_t m_pendingDependencies;
+	ThreadableJob* m_dependent;
 } ;
 
 } // namespace lmms
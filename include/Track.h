@@ -30,6 +30,7 @@
 #include <QColor>
 
 #include "AutomatableModel.h"
+#include "ClipIndex.h"
 #include "JournallingObject.h"
 #include "LmmsTypes.h"
 #include <optional>
@@ -121,6 +122,8 @@ public:
 	// -- for usage by Clip only ---------------
 	Clip * addClip( Clip * clip );
 	void removeClip( Clip * clip );
+	//! Has to be called whenever a clip of this track is moved or resized
+	void invalidateClipIndex();
 	// -------------------------------------------------------
 	void deleteClips();
 
@@ -133,7 +136,7 @@ public:
 		return m_clips;
 	}
 	void getClipsInRange( clipVector & clipV, const TimePos & start,
-							const TimePos & end );
+							const TimePos & end, ClipIndex::Cursor * cursor = nullptr );
 	void swapPositionOfClips( int clipNum1, int clipNum2 );
 
 	void createClipsForPattern(int pattern);
@@ -221,10 +224,15 @@ protected:
 	BoolModel m_mutedModel;
 	BoolModel m_soloModel;
 
+	//! For the clip lookups of play(), see getClipsInRange()
+	ClipIndex::Cursor m_playCursor;
+
 private:
 	bool m_mutedBeforeSolo;
 
 	clipVector m_clips;
+	ClipIndex m_clipIndex;
+	bool m_loadingClips = false; //!< defers index updates until all clips are loaded
 
 	QMutex m_processingLock;
 	
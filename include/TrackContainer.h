@@ -28,6 +28,7 @@
 
 #include <QReadWriteLock>
 
+#include "AutomatedValueList.h"
 #include "Track.h"
 #include "JournallingObject.h"
 
@@ -96,7 +97,16 @@ public:
 		return m_TrackContainerType;
 	}
 
-	virtual AutomatedValueMap automatedValuesAt(TimePos time, int clipNum = -1) const;
+	AutomatedValueMap automatedValuesAt(TimePos time, int clipNum = -1) const;
+
+	/**
+	 * @brief Adds the models automated at @p time and the clips controlling
+	 * them to @p values. Call AutomatedValueList::evaluate() to get the values.
+	 *
+	 * @param clipNum the pattern to look at, or -1 to look at the clips in the
+	 *                tracks' timelines
+	 */
+	virtual void collectAutomatedValues(TimePos time, int clipNum, AutomatedValueList& values) const;
 
 signals:
 	void trackAdded( lmms::Track * _track );
@@ -104,7 +114,13 @@ signals:
 	void trackMoved();
 
 protected:
-	static AutomatedValueMap automatedValuesFromTracks(const TrackList &tracks, TimePos timeStart, int clipNum = -1);
+	//! Adds the clips of @p track that can automate something at @p time to
+	//! @p clips, keeping it sorted by precedence
+	static void gatherAutomationClips(Track* track, TimePos time, int clipNum, Track::clipVector& clips);
+
+	//! Adds the values of the gathered @p clips to @p values, the clips with
+	//! the highest precedence first
+	static void addAutomatedValues(const Track::clipVector& clips, TimePos time, AutomatedValueList& values);
 
 	mutable QReadWriteLock m_tracksMutex;
 
@@ -0,0 +1,100 @@
+/*
+ * VoiceArena.h - preallocated per-note state for instruments
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_VOICE_ARENA_H
+#define LMMS_VOICE_ARENA_H
+
+#include <cstddef>
+#include <new>
+#include <utility>
+
+#include "LocklessPool.h"
+
+namespace lmms
+{
+
+/**
+ * @brief Pool for the state an instrument keeps per note in
+ * NotePlayHandle::m_pluginData.
+ *
+ * Room for @p capacity voices, usually AudioEngine::polyphony(), is
+ * allocated up front, so that starting a note on an audio thread doesn't
+ * allocate memory. create() and destroy() are lock-free. If more voices are
+ * needed at once, they are allocated on the heap.
+ *
+ * The polyphony limits the notes played by all instruments together, so
+ * instruments share one arena per voice type through shared() instead of
+ * each reserving the full polyphony for itself.
+ */
+template<typename T>
+class VoiceArena
+{
+public:
+	//! T may still be incomplete where the arena is declared, but not here
+	explicit VoiceArena(std::size_t capacity) :
+		m_pool(slotSize(), capacity)
+	{
+		m_pool.reserve(capacity);
+	}
+
+	//! @return the arena used by all instruments with voices of type T. The
+	//! first call creates it with room for @p capacity voices.
+	static VoiceArena& shared(std::size_t capacity)
+	{
+		static VoiceArena arena(capacity);
+		return arena;
+	}
+
+	template<typename... Args>
+	T* create(Args&&... args)
+	{
+		void* memory = m_pool.alloc();
+		return new (memory) T(std::forward<Args>(args)...);
+	}
+
+	void destroy(T* voice)
+	{
+		if (!voice) { return; }
+		voice->~T();
+		m_pool.free(voice);
+	}
+
+	LocklessPool::Statistics statistics() const
+	{
+		return m_pool.statistics();
+	}
+
+private:
+	//! The pool's chunks are aligned like operator new, keep every slot that way
+	static constexpr std::size_t slotSize()
+	{
+		constexpr auto alignment = std::size_t{__STDCPP_DEFAULT_NEW_ALIGNMENT__};
+		static_assert(alignof(T) <= alignment, "over-aligned voices are not supported");
+		return (sizeof(T) + alignment - 1) / alignment * alignment;
+	}
+
+	LocklessPool m_pool;
+};
+
+} // namespace lmms
+
+#endif // LMMS_VOICE_ARENA_H
@@ -0,0 +1,135 @@
+/*
+ * WorkStealingDeque.h - bounded lock-free work-stealing deque
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_WORK_STEALING_DEQUE_H
+#define LMMS_WORK_STEALING_DEQUE_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "Hardware.h"
+
+namespace lmms
+{
+
+/**
+ * @brief Bounded Chase-Lev work-stealing deque of pointers.
+ *
+ * The owning thread pushes and pops at the bottom end, any other thread may
+ * steal from the top end. Only the owner may call push() and pop(), unless it
+ * is guaranteed that no other thread accesses the deque at the same time.
+ * The indices are never reset, so a thief that was preempted between two
+ * rounds can never pick up a stale slot.
+ *
+ * @see Lê, Pop, Cohen, Zappa Nardelli: "Correct and Efficient Work-Stealing
+ * for Weak Memory Models" (PPoPP 2013)
+ */
+template<typename T>
+class WorkStealingDeque
+{
+public:
+	//! @param capacity Maximum number of elements, must be a power of two
+	explicit WorkStealingDeque(std::size_t capacity) :
+		m_top(0),
+		m_bottom(0),
+		m_mask(static_cast<std::int64_t>(capacity) - 1),
+		m_items(std::make_unique<std::atomic<T*>[]>(capacity))
+	{
+	}
+
+	//! Owner only. @returns false if the deque is full
+	bool push(T* item)
+	{
+		const auto b = m_bottom.load(std::memory_order_relaxed);
+		const auto t = m_top.load(std::memory_order_acquire);
+		if (b - t > m_mask) { return false; }
+
+		m_items[b & m_mask].store(item, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		m_bottom.store(b + 1, std::memory_order_relaxed);
+		return true;
+	}
+
+	//! Owner only. Takes the most recently pushed element, nullptr if empty
+	T* pop()
+	{
+		const auto b = m_bottom.load(std::memory_order_relaxed) - 1;
+		m_bottom.store(b, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		auto t = m_top.load(std::memory_order_relaxed);
+
+		if (t > b)
+		{
+			// deque was empty
+			m_bottom.store(b + 1, std::memory_order_relaxed);
+			return nullptr;
+		}
+
+		T* item = m_items[b & m_mask].load(std::memory_order_relaxed);
+		if (t == b)
+		{
+			// last element - race against thieves
+			if (!m_top.compare_exchange_strong(t, t + 1,
+					std::memory_order_seq_cst, std::memory_order_relaxed))
+			{
+				item = nullptr;
+			}
+			m_bottom.store(b + 1, std::memory_order_relaxed);
+		}
+		return item;
+	}
+
+	//! Any thread. Takes the oldest element, nullptr if empty or if another thread won the race
+	T* steal()
+	{
+		auto t = m_top.load(std::memory_order_acquire);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		const auto b = m_bottom.load(std::memory_order_acquire);
+
+		if (t >= b) { return nullptr; }
+
+		T* item = m_items[t & m_mask].load(std::memory_order_relaxed);
+		if (!m_top.compare_exchange_strong(t, t + 1,
+				std::memory_order_seq_cst, std::memory_order_relaxed))
+		{
+			return nullptr;
+		}
+		return item;
+	}
+
+	bool empty() const
+	{
+		return m_bottom.load(std::memory_order_relaxed) <= m_top.load(std::memory_order_relaxed);
+	}
+
+private:
+	// top is written by thieves, bottom only by the owner - keep them apart
+	alignas(hardware_destructive_interference_size) std::atomic<std::int64_t> m_top;
+	alignas(hardware_destructive_interference_size) std::atomic<std::int64_t> m_bottom;
+	const std::int64_t m_mask;
+	std::unique_ptr<std::atomic<T*>[]> m_items;
+} ;
+
+} // namespace lmms
+
+#endif // LMMS_WORK_STEALING_DEQUE_H
@@ -25,6 +25,8 @@
 #ifndef LMMS_CONSTANTS_H
 #define LMMS_CONSTANTS_H
 
+#include <cstddef>
+
 #include "lmmsconfig.h"
 #include "LmmsTypes.h"
 
@@ -39,6 +41,10 @@ inline constexpr auto DEFAULT_CHANNELS = ch_cnt_t{2};
 inline constexpr auto MaxChannelsPerAudioBuffer = ch_cnt_t{128};
 inline constexpr auto MaxGroupsPerAudioBuffer = group_cnt_t{MaxChannelsPerAudioBuffer / 2};
 
+//! Alignment of audio buffers in bytes, enough for aligned AVX-512 loads and
+//! for buffers not to share cache lines
+inline constexpr auto AudioBufferAlignment = std::size_t{64};
+
 // Microtuner
 inline constexpr unsigned MaxScaleCount = 10;  //!< number of scales per project
 inline constexpr unsigned MaxKeymapCount = 10; //!< number of keyboard mappings per project
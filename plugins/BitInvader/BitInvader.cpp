@@ -137,7 +137,8 @@ BitInvader::BitInvader( InstrumentTrack * _instrument_track ) :
 	m_sampleLength(wavetableSize, 4, wavetableSize, 1, this, tr("Sample length")),
 	m_graph(-1.0f, 1.0f, wavetableSize, this),
 	m_interpolation(false, this, tr("Interpolation")),
-	m_normalize(false, this, tr("Normalize"))
+	m_normalize(false, this, tr("Normalize")),
+	m_voices(VoiceArena<BSynth>::shared(Engine::audioEngine()->polyphony()))
 {
 	m_graph.setWaveToSine();
 	lengthChanged();
@@ -260,7 +261,7 @@ void BitInvader::playNote( NotePlayHandle * _n,
 	if (!_n->m_pluginData)
 	{
 		float factor = !m_normalize.value() ? defaultNormalizationFactor : m_normalizeFactor;
-		_n->m_pluginData = new BSynth(
+		_n->m_pluginData = m_voices.create(
 					const_cast<float*>( m_graph.samples() ),
 					_n,
 					m_interpolation.value(), factor,
@@ -284,7 +285,7 @@ void BitInvader::playNote( NotePlayHandle * _n,
 
 void BitInvader::deleteNotePluginData( NotePlayHandle * _n )
 {
-	delete static_cast<BSynth *>( _n->m_pluginData );
+	m_voices.destroy( static_cast<BSynth *>( _n->m_pluginData ) );
 }
 
 
@@ -31,6 +31,7 @@
 #include "Instrument.h"
 #include "InstrumentView.h"
 #include "Graph.h"
+#include "VoiceArena.h"
 
 namespace lmms
 {
@@ -107,6 +108,8 @@ private:
 	BoolModel m_normalize;
 	
 	float m_normalizeFactor;
+
+	VoiceArena<BSynth>& m_voices;
 	
 	friend class gui::BitInvaderView;
 } ;
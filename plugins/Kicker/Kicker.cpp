@@ -63,6 +63,15 @@ Plugin::Descriptor PLUGIN_EXPORT kicker_plugin_descriptor =
 }
 
 
+using DistFX = DspEffectLibrary::Distortion;
+using SweepOsc = KickerOsc<DspEffectLibrary::MonoToStereoAdaptor<DistFX>>;
+
+struct KickerInstrument::Voice : SweepOsc
+{
+	using SweepOsc::SweepOsc;
+};
+
+
 KickerInstrument::KickerInstrument( InstrumentTrack * _instrument_track ) :
 	Instrument(_instrument_track, &kicker_plugin_descriptor, nullptr, Flag::IsNotBendable),
 	m_startFreqModel( 150.0f, 5.0f, 1000.0f, 1.0f, this, tr( "Start frequency" ) ),
@@ -77,7 +86,8 @@ KickerInstrument::KickerInstrument( InstrumentTrack * _instrument_track ) :
 	m_slopeModel( 0.06f, 0.001f, 1.0f, 0.001f, this, tr( "Frequency slope" ) ),
 	m_startNoteModel( true, this, tr( "Start from note" ) ),
 	m_endNoteModel( false, this, tr( "End to note" ) ),
-	m_versionModel( KICKER_PRESET_VERSION, 0, KICKER_PRESET_VERSION, this, "" )
+	m_versionModel( KICKER_PRESET_VERSION, 0, KICKER_PRESET_VERSION, this, "" ),
+	m_voices( VoiceArena<Voice>::shared( Engine::audioEngine()->polyphony() ) )
 {
 }
 
@@ -152,9 +162,6 @@ QString KickerInstrument::nodeName() const
 	return kicker_plugin_descriptor.name;
 }
 
-using DistFX = DspEffectLibrary::Distortion;
-using SweepOsc = KickerOsc<DspEffectLibrary::MonoToStereoAdaptor<DistFX>>;
-
 void KickerInstrument::playNote( NotePlayHandle * _n,
 						SampleFrame* _working_buffer )
 {
@@ -165,7 +172,7 @@ void KickerInstrument::playNote( NotePlayHandle * _n,
 
 	if (!_n->m_pluginData)
 	{
-		_n->m_pluginData = new SweepOsc(
+		_n->m_pluginData = m_voices.create(
 					DistFX( m_distModel.value(),
 							m_gainModel.value() ),
 					m_startNoteModel.value() ? _n->frequency() : m_startFreqModel.value(),
@@ -183,7 +190,7 @@ void KickerInstrument::playNote( NotePlayHandle * _n,
 		_n->noteOff();
 	}
 
-	auto so = static_cast<SweepOsc*>(_n->m_pluginData);
+	auto so = static_cast<Voice*>(_n->m_pluginData);
 	so->update( _working_buffer + offset, frames, Engine::audioEngine()->outputSampleRate() );
 
 	if( _n->isReleased() )
@@ -213,7 +220,7 @@ void KickerInstrument::playNote( NotePlayHandle * _n,
 
 void KickerInstrument::deleteNotePluginData( NotePlayHandle * _n )
 {
-	delete static_cast<SweepOsc *>( _n->m_pluginData );
+	m_voices.destroy( static_cast<Voice*>( _n->m_pluginData ) );
 }
 
 
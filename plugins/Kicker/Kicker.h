@@ -30,6 +30,7 @@
 #include "Instrument.h"
 #include "InstrumentView.h"
 #include "TempoSyncKnobModel.h"
+#include "VoiceArena.h"
 
 
 namespace lmms
@@ -89,6 +90,9 @@ private:
 
 	IntModel m_versionModel;
 
+	struct Voice;
+	VoiceArena<Voice>& m_voices;
+
 	friend class gui::KickerInstrumentView;
 
 } ;
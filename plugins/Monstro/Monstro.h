@@ -26,8 +26,9 @@
 #ifndef MONSTRO_H
 #define MONSTRO_H
 
-#include <vector>
+#include <array>
 
+#include "AudioEngine.h"
 #include "ComboBoxModel.h"
 #include "Instrument.h"
 #include "InstrumentView.h"
@@ -37,6 +38,7 @@
 #include "Oscillator.h"
 #include "lmms_math.h"
 #include "BandLimitedWave.h"
+#include "VoiceArena.h"
 
 namespace lmms
 {
@@ -287,8 +289,10 @@ private:
 	int m_counter3l;
 	int m_counter3r;
 
-	std::vector<float> m_lfo[2];
-	std::vector<float> m_env[2];
+	// the engine never renders more than DEFAULT_BUFFER_SIZE frames at once,
+	// so the voice can hold its modulator buffers without allocating them
+	std::array<float, DEFAULT_BUFFER_SIZE> m_lfo[2];
+	std::array<float, DEFAULT_BUFFER_SIZE> m_env[2];
 };
 
 class MonstroInstrument : public Instrument
@@ -406,7 +410,6 @@ protected:
 	f_cnt_t m_lfo2_att;
 
 	sample_rate_t m_samplerate;
-	f_cnt_t m_fpp;
 	
 	float m_integrator;
 	float m_fmCorrection;
@@ -550,6 +553,8 @@ private:
 	FloatModel	m_sub3lfo1;
 	FloatModel	m_sub3lfo2;
 
+	VoiceArena<MonstroSynth>& m_voices;
+
 	friend class MonstroSynth;
 	friend class gui::MonstroView;
 
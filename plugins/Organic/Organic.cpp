@@ -24,6 +24,9 @@
 
 #include "Organic.h"
 
+#include <array>
+#include <optional>
+
 #include <QDomElement>
 
 #include "Engine.h"
@@ -71,8 +74,21 @@ float * OrganicInstrument::s_harmonics = nullptr;
 ***********************************************************************/
 
 
+//! The oscillators of one note, each one is mixed with the next one
+struct OrganicInstrument::Voice
+{
+	std::array<std::optional<Oscillator>, NUM_OSCILLATORS> left;
+	std::array<std::optional<Oscillator>, NUM_OSCILLATORS> right;
+	float phaseOffsetLeft[NUM_OSCILLATORS];
+	float phaseOffsetRight[NUM_OSCILLATORS];
+};
+
+
+
+
 OrganicInstrument::OrganicInstrument( InstrumentTrack * _instrument_track ) :
 	Instrument( _instrument_track, &organic_plugin_descriptor ),
+	m_voices( VoiceArena<Voice>::shared( Engine::audioEngine()->polyphony() ) ),
 	m_modulationAlgo(static_cast<int>(Oscillator::ModulationAlgo::SignalMix),
 		static_cast<int>(Oscillator::ModulationAlgo::SignalMix),
 		static_cast<int>(Oscillator::ModulationAlgo::SignalMix)),
@@ -228,66 +244,38 @@ void OrganicInstrument::playNote( NotePlayHandle * _n,
 
 	if (!_n->m_pluginData)
 	{
-		auto oscs_l = std::array<Oscillator*, NUM_OSCILLATORS>{};
-		auto oscs_r = std::array<Oscillator*, NUM_OSCILLATORS>{};
-
-		auto newOsc = new oscPtr;
-		_n->m_pluginData = newOsc;
+		auto voice = m_voices.create();
+		_n->m_pluginData = voice;
 
 		for (int i = m_numOscillators - 1; i >= 0; --i)
 		{
-			newOsc->phaseOffsetLeft[i] = fastRand(1.f);
-			newOsc->phaseOffsetRight[i] = fastRand(1.f);
-
-			// initialise ocillators
-			if (i == m_numOscillators - 1)
-			{
-				// create left oscillator
-				oscs_l[i] = new Oscillator(
-					&m_osc[i]->m_waveShape,
-					&m_modulationAlgo,
-					_n->frequency(),
-					m_osc[i]->m_detuningLeft,
-					newOsc->phaseOffsetLeft[i],
-					m_osc[i]->m_volumeLeft);
-				// create right oscillator
-				oscs_r[i] = new Oscillator(
-					&m_osc[i]->m_waveShape,
-					&m_modulationAlgo,
-					_n->frequency(),
-					m_osc[i]->m_detuningRight,
-					newOsc->phaseOffsetRight[i],
-					m_osc[i]->m_volumeRight);
-			}
-			else
-			{
-				// create left oscillator
-				oscs_l[i] = new Oscillator(
-					&m_osc[i]->m_waveShape,
-					&m_modulationAlgo,
-					_n->frequency(),
-					m_osc[i]->m_detuningLeft,
-					newOsc->phaseOffsetLeft[i],
-					m_osc[i]->m_volumeLeft,
-					oscs_l[i + 1]);
-				// create right oscillator
-				oscs_r[i] = new Oscillator(
-					&m_osc[i]->m_waveShape,
-					&m_modulationAlgo,
-					_n->frequency(),
-					m_osc[i]->m_detuningRight,
-					newOsc->phaseOffsetRight[i],
-					m_osc[i]->m_volumeRight,
-					oscs_r[i + 1]);
-			}
+			voice->phaseOffsetLeft[i] = fastRand(1.f);
+			voice->phaseOffsetRight[i] = fastRand(1.f);
+
+			// initialise ocillators, the last one has no sub-osc
+			const bool hasSubOsc = i < m_numOscillators - 1;
+			voice->left[i].emplace(
+				&m_osc[i]->m_waveShape,
+				&m_modulationAlgo,
+				_n->frequency(),
+				m_osc[i]->m_detuningLeft,
+				voice->phaseOffsetLeft[i],
+				m_osc[i]->m_volumeLeft,
+				hasSubOsc ? &*voice->left[i + 1] : nullptr);
+			voice->right[i].emplace(
+				&m_osc[i]->m_waveShape,
+				&m_modulationAlgo,
+				_n->frequency(),
+				m_osc[i]->m_detuningRight,
+				voice->phaseOffsetRight[i],
+				m_osc[i]->m_volumeRight,
+				hasSubOsc ? &*voice->right[i + 1] : nullptr);
 		}
-		newOsc->oscLeft = oscs_l[0];
-		newOsc->oscRight = oscs_r[0];
 	}
 
-	auto osc = static_cast<oscPtr*>(_n->m_pluginData);
-	osc->oscLeft->update(_working_buffer + offset, frames, 0);
-	osc->oscRight->update(_working_buffer + offset, frames, 1);
+	auto voice = static_cast<Voice*>(_n->m_pluginData);
+	voice->left[0]->update(_working_buffer + offset, frames, 0);
+	voice->right[0]->update(_working_buffer + offset, frames, 1);
 
 	// -- fx section --
 
@@ -310,12 +298,7 @@ void OrganicInstrument::playNote( NotePlayHandle * _n,
 
 void OrganicInstrument::deleteNotePluginData( NotePlayHandle * _n )
 {
-	delete static_cast<Oscillator *>( static_cast<oscPtr *>(
-						_n->m_pluginData )->oscLeft );
-	delete static_cast<Oscillator *>( static_cast<oscPtr *>(
-						_n->m_pluginData )->oscRight );
-
-	delete static_cast<oscPtr *>( _n->m_pluginData );
+	m_voices.destroy(static_cast<Voice*>(_n->m_pluginData));
 }
 
 /*float inline OrganicInstrument::foldback(float in, float threshold)
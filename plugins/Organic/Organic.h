@@ -30,6 +30,7 @@
 #include "Instrument.h"
 #include "InstrumentView.h"
 #include "AutomatableModel.h"
+#include "VoiceArena.h"
 
 
 namespace lmms
@@ -153,13 +154,8 @@ private:
 
 	OscillatorObject ** m_osc;
 
-	struct oscPtr
-	{
-		Oscillator * oscLeft;
-		Oscillator * oscRight;
-		float phaseOffsetLeft[NUM_OSCILLATORS];
-		float phaseOffsetRight[NUM_OSCILLATORS];		
-	} ;
+	struct Voice;
+	VoiceArena<Voice>& m_voices;
 
 	const IntModel m_modulationAlgo;
 
@@ -33,6 +33,7 @@
 #include "AutomatableModel.h"
 #include "OscillatorConstants.h"
 #include "SampleBuffer.h"
+#include "VoiceArena.h"
 
 namespace lmms
 {
@@ -135,11 +136,8 @@ protected slots:
 private:
 	OscillatorObject * m_osc[NUM_OF_OSCILLATORS];
 
-	struct oscPtr
-	{
-		Oscillator * oscLeft;
-		Oscillator * oscRight;
-	} ;
+	struct Voice;
+	VoiceArena<Voice>& m_voices;
 
 
 	friend class gui::TripleOscillatorView;
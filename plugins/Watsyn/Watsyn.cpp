@@ -292,7 +292,9 @@ WatsynInstrument::WatsynInstrument( InstrumentTrack * _instrument_track ) :
 		m_amod( 0, 0, 3, this, tr( "A2-A1 modulation" ) ),
 		m_bmod( 0, 0, 3, this, tr( "B2-B1 modulation" ) ),
 
-		m_selectedGraph( 0, 0, 3, this, tr( "Selected graph" ) )
+		m_selectedGraph( 0, 0, 3, this, tr( "Selected graph" ) ),
+
+		m_voices( VoiceArena<WatsynObject>::shared( Engine::audioEngine()->polyphony() ) )
 {
 	connect( &a1_vol, SIGNAL( dataChanged() ), this, SLOT( updateVolumes() ) );
 	connect( &a2_vol, SIGNAL( dataChanged() ), this, SLOT( updateVolumes() ) );
@@ -346,7 +348,7 @@ void WatsynInstrument::playNote( NotePlayHandle * _n,
 {
 	if (!_n->m_pluginData)
 	{
-		auto w = new WatsynObject(&A1_wave[0], &A2_wave[0], &B1_wave[0], &B2_wave[0], m_amod.value(), m_bmod.value(),
+		auto w = m_voices.create(&A1_wave[0], &A2_wave[0], &B1_wave[0], &B2_wave[0], m_amod.value(), m_bmod.value(),
 			Engine::audioEngine()->outputSampleRate(), _n, Engine::audioEngine()->framesPerPeriod(), this);
 
 		_n->m_pluginData = w;
@@ -465,7 +467,7 @@ void WatsynInstrument::playNote( NotePlayHandle * _n,
 
 void WatsynInstrument::deleteNotePluginData( NotePlayHandle * _n )
 {
-	delete static_cast<WatsynObject *>( _n->m_pluginData );
+	m_voices.destroy( static_cast<WatsynObject *>( _n->m_pluginData ) );
 }
 
 
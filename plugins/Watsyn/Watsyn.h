@@ -32,6 +32,7 @@
 #include "Graph.h"
 #include "AutomatableModel.h"
 #include "TempoSyncKnob.h"
+#include "VoiceArena.h"
 #include <samplerate.h>
 
 namespace lmms
@@ -275,6 +276,8 @@ private:
 	float B1_wave [WAVELEN];
 	float B2_wave [WAVELEN];
 
+	VoiceArena<WatsynObject>& m_voices;
+
 	friend class WatsynObject;
 	friend class gui::WatsynView;
 };
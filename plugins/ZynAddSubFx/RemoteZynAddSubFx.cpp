@@ -29,20 +29,147 @@
 #include <winsock2.h>
 #endif
 
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
 #include <queue>
+#include <vector>
 #include "ThreadShims.h"
 
 #undef CursorShape // is, by mistake, not undefed in FL
 
 #include "RemotePluginClient.h"
 #include "LocalZynAddSubFx.h"
+#include "SampleFrame.h"
 
 #include <Nio/Nio.h>
 #include <UI/MasterUI.h>
 
 using namespace lmms;
 
-class RemoteZynAddSubFx : public RemotePluginClient, public LocalZynAddSubFx
+namespace
+{
+
+//! Runs the jobs of a period on a few threads, the calling thread included
+class ParallelJobs
+{
+public:
+	using Job = std::function<void(std::size_t)>;
+
+	explicit ParallelJobs( unsigned threads )
+	{
+		for( unsigned i = 0; i < threads; ++i )
+		{
+			m_threads.emplace_back( &ParallelJobs::work, this );
+		}
+	}
+
+	~ParallelJobs()
+	{
+		{
+			const auto lock = std::lock_guard{m_mutex};
+			m_quit = true;
+		}
+		m_start.notify_all();
+		for( auto& thread : m_threads )
+		{
+			thread.join();
+		}
+	}
+
+	//! Calls @p job for every index below @p count, returns once all calls returned
+	void run( std::size_t count, const Job& job )
+	{
+		if( count < 2 || m_threads.empty() )
+		{
+			for( std::size_t i = 0; i < count; ++i )
+			{
+				job( i );
+			}
+			return;
+		}
+
+		{
+			const auto lock = std::lock_guard{m_mutex};
+			m_job = &job;
+			m_count = count;
+			m_next = 0;
+			m_busy = m_threads.size();
+			++m_generation;
+		}
+		m_start.notify_all();
+
+		runJobs( job, count );
+
+		auto lock = std::unique_lock{m_mutex};
+		m_done.wait( lock, [this] { return m_busy == 0; } );
+		m_job = nullptr;
+	}
+
+private:
+	void runJobs( const Job& job, std::size_t count )
+	{
+		for( auto i = m_next++; i < count; i = m_next++ )
+		{
+			job( i );
+		}
+	}
+
+	void work()
+	{
+		auto generation = 0u;
+		auto lock = std::unique_lock{m_mutex};
+		while( true )
+		{
+			m_start.wait( lock, [&] { return m_quit || m_generation != generation; } );
+			if( m_quit )
+			{
+				return;
+			}
+			// run() waits for every thread, so no generation is skipped
+			generation = m_generation;
+			const auto job = m_job;
+			const auto count = m_count;
+
+			lock.unlock();
+			runJobs( *job, count );
+			lock.lock();
+
+			if( --m_busy == 0 )
+			{
+				m_done.notify_one();
+			}
+		}
+	}
+
+	std::vector<std::thread> m_threads;
+	std::mutex m_mutex;
+	std::condition_variable m_start;
+	std::condition_variable m_done;
+
+	const Job* m_job = nullptr;
+	std::size_t m_count = 0;
+	std::atomic<std::size_t> m_next = 0;
+	std::size_t m_busy = 0;
+	unsigned m_generation = 0;
+	bool m_quit = false;
+};
+
+
+//! Threads besides the one the host requests periods on. LMMS renders
+//! everything else in parallel, so leave it most of the cores.
+unsigned extraProcessingThreads()
+{
+	return std::min( std::max( std::thread::hardware_concurrency() / 2, 1u ), 4u ) - 1;
+}
+
+} // namespace
+
+
+
+//! Hosts the ZynAddSubFX instances of all instruments in LMMS whose editor is shown
+class RemoteZynAddSubFx : public RemotePluginClient
 {
 public:
 #ifdef SYNC_WITH_SHM_FIFO
@@ -52,12 +179,14 @@ public:
 	RemoteZynAddSubFx( const char * socketPath ) :
 		RemotePluginClient( socketPath ),
 #endif
-		LocalZynAddSubFx(),
 		m_guiSleepTime( 100 ),
-		m_guiExit( false )
+		m_openEditors( 0 ),
+		m_guiExit( false ),
+		m_nioStarted( false ),
+		m_jobs( extraProcessingThreads() ),
+		m_processInstance( [this]( std::size_t index ) { processInstance( index ); } ),
+		m_output( nullptr )
 	{
-		Nio::start();
-
 		setInputCount( 0 );
 		sendMessage( IdInitDone );
 		waitForMessage( IdInitDone );
@@ -67,18 +196,30 @@ public:
 
 	~RemoteZynAddSubFx() override
 	{
+		stopProcessingRing();
 		m_messageThread.join();
-		Nio::stop();
+		if( m_nioStarted )
+		{
+			Nio::stop();
+		}
+		m_instances.clear();
 	}
 
+	// the global ZynAddSubFX settings only exist while there are instances
 	void updateSampleRate() override
 	{
-		LocalZynAddSubFx::setSampleRate( sampleRate() );
+		if( const auto instance = anyInstance() )
+		{
+			instance->synth.setSampleRate( sampleRate() );
+		}
 	}
 
 	void updateBufferSize() override
 	{
-		LocalZynAddSubFx::setBufferSize( bufferSize() );
+		if( const auto instance = anyInstance() )
+		{
+			instance->synth.setBufferSize( bufferSize() );
+		}
 	}
 
 	void messageLoop()
@@ -86,12 +227,13 @@ public:
 		message m;
 		while( ( m = receiveMessage() ).id != IdQuit )
 		{
-			const auto lock = std::lock_guard{m_master->mutex};
+			const auto lock = std::lock_guard{m_processMutex};
 			processMessage( m );
 		}
 		m_guiExit = true;
 	}
 
+	// all functions up to guiLoop() are called while m_processMutex is held
 	bool processMessage( const message & _m ) override
 	{
 		switch( _m.id )
@@ -103,6 +245,7 @@ public:
 			case IdHideUI:
 			case IdLoadSettingsFromFile:
 			case IdLoadPresetFile:
+			case IdZasfRemoveInstance:
 				{
 					const auto lock = std::lock_guard{m_guiMutex};
 					m_guiMessages.push( _m );
@@ -111,21 +254,41 @@ public:
 
 			case IdSaveSettingsToFile:
 			{
-				LocalZynAddSubFx::saveXML( _m.getString() );
+				if( const auto instance = findInstance( _m.getInt( 1 ) ) )
+				{
+					const auto lock = std::lock_guard{instance->synth.master()->mutex};
+					instance->synth.saveXML( _m.getString() );
+				}
 				sendMessage( IdSaveSettingsToFile );
 				break;
 			}
 
+			case IdZasfAddInstance:
+				sendMessage( message( IdZasfAddInstance ).addInt( addInstance() ) );
+				break;
+
 			case IdZasfPresetDirectory:
-				LocalZynAddSubFx::setPresetDir( _m.getString() );
+				m_presetDir = _m.getString();
+				for( const auto& instance : m_instances )
+				{
+					if( instance ) { instance->synth.setPresetDir( m_presetDir ); }
+				}
 				break;
 
 			case IdZasfLmmsWorkingDirectory:
-				LocalZynAddSubFx::setLmmsWorkingDir( _m.getString() );
+				m_workingDir = _m.getString();
+				if( const auto instance = anyInstance() )
+				{
+					instance->synth.setLmmsWorkingDir( m_workingDir );
+				}
 				break;
 
 			case IdZasfSetPitchWheelBendRange:
-				LocalZynAddSubFx::setPitchWheelBendRange( _m.getInt() );
+				if( const auto instance = findInstance( _m.getInt( 1 ) ) )
+				{
+					const auto lock = std::lock_guard{instance->synth.master()->mutex};
+					instance->synth.setPitchWheelBendRange( _m.getInt( 0 ) );
+				}
 				break;
 
 			default:
@@ -134,27 +297,141 @@ public:
 		return true;
 	}
 
-	// all functions are called while m_master->mutex is held
-	void processMidiEvent( const MidiEvent& event, const f_cnt_t /* _offset */ ) override
+	void processInstanceMidiEvent( int index, const MidiEvent& event, const f_cnt_t /* _offset */ ) override
 	{
-		LocalZynAddSubFx::processMidiEvent( event );
+		if( const auto instance = findInstance( index ) )
+		{
+			const auto lock = std::lock_guard{instance->synth.master()->mutex};
+			instance->synth.processMidiEvent( event );
+		}
+	}
+
+	//! Renders all instances, each into its own stereo block of @p _out
+	void process( const SampleFrame* /* _in */, SampleFrame* _out ) override
+	{
+		if( bufferSize() == 0 )
+		{
+			return;
+		}
+		// the host may not have answered a larger output count yet
+		const auto blocks = sharedOutputSize() / ( DEFAULT_CHANNELS * bufferSize() );
+		m_output = _out;
+		m_jobs.run( std::min( m_instances.size(), blocks ), m_processInstance );
 	}
 
+	bool supportsProcessingRing() const override
+	{
+		return true;
+	}
 
-	void process( const SampleFrame* _in, SampleFrame* _out ) override
+	void processRingPeriod() override
 	{
-		LocalZynAddSubFx::processAudio( _out );
+		const auto lock = std::lock_guard{m_processMutex};
+		RemotePluginClient::processRingPeriod();
 	}
 
 	void guiLoop();
 
 private:
+	struct Instance
+	{
+		LocalZynAddSubFx synth;
+		MasterUI* ui = nullptr;
+		int exitProgram = 0;
+	};
+
+	Instance* findInstance( int index ) const
+	{
+		return index >= 0 && static_cast<std::size_t>( index ) < m_instances.size()
+			? m_instances[index].get()
+			: nullptr;
+	}
+
+	Instance* anyInstance() const
+	{
+		const auto it = std::find_if( m_instances.begin(), m_instances.end(),
+			[]( const auto& instance ) { return instance != nullptr; } );
+		return it != m_instances.end() ? it->get() : nullptr;
+	}
+
+	//! Only called on the GUI thread, which is the only one removing instances
+	Instance* lockedFindInstance( int index )
+	{
+		const auto lock = std::lock_guard{m_processMutex};
+		return findInstance( index );
+	}
+
+	int addInstance()
+	{
+		const bool first = anyInstance() == nullptr;
+		auto instance = std::make_unique<Instance>();
+		instance->synth.setSampleRate( sampleRate() );
+		instance->synth.setBufferSize( bufferSize() );
+		if( first )
+		{
+			if( !m_nioStarted )
+			{
+				Nio::start();
+				m_nioStarted = true;
+			}
+			// creating the first instance reset the global configuration
+			if( !m_workingDir.empty() )
+			{
+				instance->synth.setLmmsWorkingDir( m_workingDir );
+			}
+		}
+		if( !m_presetDir.empty() )
+		{
+			instance->synth.setPresetDir( m_presetDir );
+		}
+
+		auto slot = std::find( m_instances.begin(), m_instances.end(), nullptr );
+		if( slot == m_instances.end() )
+		{
+			m_instances.push_back( std::move( instance ) );
+			setOutputCount( DEFAULT_CHANNELS * static_cast<int>( m_instances.size() ) );
+			return static_cast<int>( m_instances.size() - 1 );
+		}
+		*slot = std::move( instance );
+		return static_cast<int>( slot - m_instances.begin() );
+	}
+
+	void processInstance( std::size_t index )
+	{
+		const auto frames = bufferSize();
+		const auto block = m_output + index * frames;
+		if( const auto& instance = m_instances[index] )
+		{
+			const auto lock = std::lock_guard{instance->synth.master()->mutex};
+			instance->synth.processAudio( block );
+		}
+		else
+		{
+			std::fill( block, block + frames, SampleFrame{} );
+		}
+	}
+
+	void processGuiMessage( const message& m );
+
 	const int m_guiSleepTime;
+	int m_openEditors; //!< only used on the GUI thread
 
 	std::thread m_messageThread;
 	std::mutex m_guiMutex;
 	std::queue<RemotePluginClient::message> m_guiMessages;
-	bool m_guiExit;
+	std::atomic<bool> m_guiExit;
+
+	//! Held while handling messages and rendering periods, and whenever
+	//! m_instances changes. Other threads send messages while holding it.
+	std::mutex m_processMutex;
+	std::vector<std::unique_ptr<Instance>> m_instances;
+	std::string m_presetDir;
+	std::string m_workingDir;
+	bool m_nioStarted;
+
+	ParallelJobs m_jobs;
+	const ParallelJobs::Job m_processInstance;
+	SampleFrame* m_output;
 
 } ;
 
@@ -163,12 +440,9 @@ private:
 
 void RemoteZynAddSubFx::guiLoop()
 {
-	int exitProgram = 0;
-	MasterUI * ui = nullptr;
-
 	while( !m_guiExit )
 	{
-		if( ui )
+		if( m_openEditors > 0 )
 		{
 			Fl::wait( m_guiSleepTime / 1000.0 );
 		}
@@ -180,65 +454,124 @@ void RemoteZynAddSubFx::guiLoop()
 			usleep( m_guiSleepTime*1000 );
 #endif
 		}
-		if( exitProgram == 1 )
+
 		{
-			const auto lock = std::lock_guard{m_master->mutex};
-			sendMessage( IdHideUI );
-			exitProgram = 0;
+			const auto lock = std::lock_guard{m_processMutex};
+			for( std::size_t i = 0; i < m_instances.size(); ++i )
+			{
+				const auto& instance = m_instances[i];
+				if( instance && instance->exitProgram == 1 )
+				{
+					sendMessage( message( IdHideUI ).addInt( static_cast<int>( i ) ) );
+					instance->exitProgram = 0;
+				}
+			}
+		}
+
+		// the message thread queues messages while holding m_processMutex,
+		// so don't hold m_guiMutex while taking it
+		auto messages = std::queue<RemotePluginClient::message>{};
+		{
+			const auto lock = std::lock_guard{m_guiMutex};
+			std::swap( messages, m_guiMessages );
+		}
+		while( !messages.empty() )
+		{
+			processGuiMessage( messages.front() );
+			messages.pop();
 		}
-		const auto lock = std::lock_guard{m_guiMutex};
-		while( m_guiMessages.size() )
+	}
+	Fl::flush();
+
+	for( const auto& instance : m_instances )
+	{
+		if( instance )
 		{
-			RemotePluginClient::message m = m_guiMessages.front();
-			m_guiMessages.pop();
-			switch( m.id )
+			delete instance->ui;
+			instance->ui = nullptr;
+		}
+	}
+}
+
+
+
+
+void RemoteZynAddSubFx::processGuiMessage( const message& m )
+{
+	switch( m.id )
+	{
+		case IdShowUI:
+			if( const auto instance = lockedFindInstance( m.getInt( 0 ) ) )
 			{
-				case IdShowUI:
-					// we only create GUI
-					if( !ui )
-					{
-						Fl::scheme( "plastic" );
-						ui = new MasterUI( m_master, &exitProgram );
-					}
-					ui->showUI();
-					ui->refresh_master_ui();
-					break;
+				// we only create GUI
+				if( !instance->ui )
+				{
+					Fl::scheme( "plastic" );
+					instance->ui = new MasterUI( instance->synth.master(), &instance->exitProgram );
+					++m_openEditors;
+				}
+				instance->ui->showUI();
+				instance->ui->refresh_master_ui();
+			}
+			break;
+
+		case IdLoadSettingsFromFile:
+		{
+			if( const auto instance = lockedFindInstance( m.getInt( 1 ) ) )
+			{
+				instance->synth.loadXML( m.getString( 0 ) );
+				if( instance->ui )
+				{
+					instance->ui->refresh_master_ui();
+				}
+			}
+			const auto lock = std::lock_guard{m_processMutex};
+			sendMessage( IdLoadSettingsFromFile );
+			break;
+		}
 
-				case IdLoadSettingsFromFile:
+		case IdLoadPresetFile:
+		{
+			if( const auto instance = lockedFindInstance( m.getInt( 1 ) ) )
+			{
+				const auto ui = instance->ui;
+				instance->synth.loadPreset( m.getString( 0 ), ui ? ui->npartcounter->value()-1 : 0 );
+				if( ui )
 				{
-					LocalZynAddSubFx::loadXML( m.getString() );
-					if( ui )
-					{
-						ui->refresh_master_ui();
-					}
-					const auto lock = std::lock_guard{m_master->mutex};
-					sendMessage( IdLoadSettingsFromFile );
-					break;
+					ui->npartcounter->do_callback();
+					ui->updatepanel();
+					ui->refresh_master_ui();
 				}
+			}
+			const auto lock = std::lock_guard{m_processMutex};
+			sendMessage( IdLoadPresetFile );
+			break;
+		}
 
-				case IdLoadPresetFile:
+		case IdZasfRemoveInstance:
+		{
+			const auto index = m.getInt( 0 );
+			if( const auto instance = lockedFindInstance( index ) )
+			{
+				// the editor refers to the instance
+				if( instance->ui )
 				{
-					LocalZynAddSubFx::loadPreset( m.getString(), ui ?
-											ui->npartcounter->value()-1 : 0 );
-					if( ui )
-					{
-						ui->npartcounter->do_callback();
-						ui->updatepanel();
-						ui->refresh_master_ui();
-					}
-					const auto lock = std::lock_guard{m_master->mutex};
-					sendMessage( IdLoadPresetFile );
-					break;
+					delete instance->ui;
+					instance->ui = nullptr;
+					--m_openEditors;
 				}
 
-				default:
-					break;
+				// instances share global state, which the message thread
+				// changes while holding m_processMutex
+				const auto lock = std::lock_guard{m_processMutex};
+				m_instances[index].reset();
 			}
+			break;
 		}
-	}
-	Fl::flush();
 
-	delete ui;
+		default:
+			break;
+	}
 }
 
 
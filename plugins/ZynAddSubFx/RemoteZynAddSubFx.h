@@ -31,11 +31,21 @@ namespace lmms
 {
 
 
+/*
+ * One RemoteZynAddSubFx process hosts several ZynAddSubFX instances. Each
+ * instance renders into its own stereo block of the shared audio buffer, and
+ * a single IdStartProcessing (or ring request) renders all of them. Messages
+ * for a single instance (IdMidiEvent, IdShowUI, IdHideUI,
+ * IdSaveSettingsToFile, IdLoadSettingsFromFile, IdLoadPresetFile and
+ * IdZasfSetPitchWheelBendRange) carry its index as their last parameter.
+ */
 enum ZasfRemoteMessageIDs
 {
 	IdZasfPresetDirectory = RemoteMessageIDs::IdUserBase,
 	IdZasfLmmsWorkingDirectory,
-	IdZasfSetPitchWheelBendRange
+	IdZasfSetPitchWheelBendRange,
+	IdZasfAddInstance,    //!< answered with the index of the new instance
+	IdZasfRemoveInstance
 } ;
 
 
@@ -35,6 +35,7 @@
 
 #include "ZynAddSubFx.h"
 #include "ConfigManager.h"
+#include "Controller.h"
 #include "Engine.h"
 #include "Knob.h"
 #include "LedCheckBox.h"
@@ -78,19 +79,188 @@ Plugin::Descriptor PLUGIN_EXPORT zynaddsubfx_plugin_descriptor =
 
 
 ZynAddSubFxRemotePlugin::ZynAddSubFxRemotePlugin() :
-	RemotePlugin()
+	RemotePlugin(),
+	m_renderedPeriod( -1 ),
+	m_rendered( false )
 {
 	init( "RemoteZynAddSubFx", false );
 }
 
 
 
+
+std::shared_ptr<ZynAddSubFxRemotePlugin> ZynAddSubFxRemotePlugin::acquire()
+{
+	static auto s_running = std::weak_ptr<ZynAddSubFxRemotePlugin>{};
+
+	if( auto running = s_running.lock(); running && !running->failed() && running->isRunning() )
+	{
+		return running;
+	}
+
+	auto remote = std::shared_ptr<ZynAddSubFxRemotePlugin>( new ZynAddSubFxRemotePlugin );
+	remote->lock();
+	remote->waitForInitDone( false );
+
+	remote->sendMessage(
+		RemotePlugin::message( IdZasfLmmsWorkingDirectory ).
+			addString(
+				QSTR_TO_STDSTR(
+					QString( ConfigManager::inst()->workingDir() ) ) ) );
+	remote->sendMessage(
+		RemotePlugin::message( IdZasfPresetDirectory ).
+			addString(
+				QSTR_TO_STDSTR(
+					QDir( ConfigManager::inst()->factoryPresetsDir() +
+							"/ZynAddSubFX" ).absolutePath() ) ) );
+
+	// temporary workaround until the VST synchronization feature gets stripped out of the RemotePluginClient class
+	// causing not to send buffer size information requests
+	remote->sendMessage( RemotePlugin::message( IdBufferSizeInformation ).addInt( Engine::audioEngine()->framesPerPeriod() ) );
+	remote->unlock();
+
+	if( remote->failed() )
+	{
+		return nullptr;
+	}
+	s_running = remote;
+	return remote;
+}
+
+
+
+
+int ZynAddSubFxRemotePlugin::addInstance()
+{
+	lock();
+	// instruments add their instance again when the sample rate changes
+	updateSampleRate( Engine::audioEngine()->outputSampleRate() );
+	sendMessage( IdZasfAddInstance );
+	const message reply = waitForMessage( IdZasfAddInstance );
+	unlock();
+
+	const int instance = reply.id == IdZasfAddInstance ? reply.getInt( 0 ) : -1;
+	if( instance >= 0 )
+	{
+		const auto frames = static_cast<std::size_t>( Engine::audioEngine()->framesPerPeriod() );
+		QMutexLocker outputLock( &m_outputMutex );
+		m_outputs.resize( std::max( m_outputs.size(), ( instance + 1 ) * frames ) );
+	}
+	return instance;
+}
+
+
+
+
+void ZynAddSubFxRemotePlugin::removeInstance( int instance )
+{
+	lock();
+	sendMessage( message( IdZasfRemoveInstance ).addInt( instance ) );
+	unlock();
+}
+
+
+
+
+void ZynAddSubFxRemotePlugin::processInstance( int instance, SampleFrame* _buf )
+{
+	const auto frames = static_cast<std::size_t>( Engine::audioEngine()->framesPerPeriod() );
+
+	QMutexLocker outputLock( &m_outputMutex );
+	// one request renders the instances of all instruments
+	if( m_renderedPeriod != Controller::runningPeriods() )
+	{
+		m_renderedPeriod = Controller::runningPeriods();
+		m_rendered = process( nullptr, m_outputs.data() );
+	}
+
+	const auto offset = static_cast<std::size_t>( instance ) * frames;
+	if( m_rendered && instance >= 0 && offset + frames <= m_outputs.size() )
+	{
+		std::copy_n( m_outputs.data() + offset, frames, _buf );
+	}
+	else
+	{
+		zeroSampleFrames( _buf, frames );
+	}
+}
+
+
+
+
+void ZynAddSubFxRemotePlugin::readOutputs( SampleFrame* /* _out_buf */, f_cnt_t frames )
+{
+	// Called by process() with m_outputMutex held. Adding an instance
+	// resizes the shared memory while holding the lock.
+	lock();
+	const auto blocks = std::min<std::size_t>( outputCount() / DEFAULT_CHANNELS, m_outputs.size() / frames );
+	copyToSampleFrames( m_outputs.data(), sharedOutputs(), blocks * frames );
+	std::fill( m_outputs.begin() + blocks * frames, m_outputs.end(), SampleFrame{} );
+	unlock();
+}
+
+
+
+
+void ZynAddSubFxRemotePlugin::showInstanceUI( int instance )
+{
+	lock();
+	sendMessage( message( IdShowUI ).addInt( instance ) );
+	unlock();
+}
+
+
+
+
+void ZynAddSubFxRemotePlugin::saveSettingsToFile( int instance, const std::string& file )
+{
+	lock();
+	sendMessage( message( IdSaveSettingsToFile ).addString( file ).addInt( instance ) );
+	waitForMessage( IdSaveSettingsToFile );
+	unlock();
+}
+
+
+
+
+void ZynAddSubFxRemotePlugin::loadSettingsFromFile( int instance, const std::string& file )
+{
+	lock();
+	sendMessage( message( IdLoadSettingsFromFile ).addString( file ).addInt( instance ) );
+	waitForMessage( IdLoadSettingsFromFile );
+	unlock();
+}
+
+
+
+
+void ZynAddSubFxRemotePlugin::loadPresetFile( int instance, const std::string& file )
+{
+	lock();
+	sendMessage( message( IdLoadPresetFile ).addString( file ).addInt( instance ) );
+	waitForMessage( IdLoadPresetFile );
+	unlock();
+}
+
+
+
+
+void ZynAddSubFxRemotePlugin::setPitchWheelBendRange( int instance, int semitones )
+{
+	lock();
+	sendMessage( message( IdZasfSetPitchWheelBendRange ).addInt( semitones ).addInt( instance ) );
+	unlock();
+}
+
+
+
+
 bool ZynAddSubFxRemotePlugin::processMessage( const message & _m )
 {
 	switch( _m.id )
 	{
 		case IdHideUI:
-			emit clickedCloseButton();
+			emit clickedCloseButton( _m.getInt( 0 ) );
 			return true;
 		default:
 			break;
@@ -108,7 +278,7 @@ ZynAddSubFxInstrument::ZynAddSubFxInstrument(
 	Instrument(_instrumentTrack, &zynaddsubfx_plugin_descriptor, nullptr, Flag::IsSingleStreamed | Flag::IsMidiBased),
 	m_hasGUI( false ),
 	m_plugin( nullptr ),
-	m_remotePlugin( nullptr ),
+	m_remoteInstance( -1 ),
 	m_portamentoModel( 0, 0, 127, 1, this, tr( "Portamento" ) ),
 	m_filterFreqModel( 64, 0, 127, 1, this, tr( "Filter frequency" ) ),
 	m_filterQModel( 64, 0, 127, 1, this, tr( "Filter resonance" ) ),
@@ -157,9 +327,8 @@ ZynAddSubFxInstrument::~ZynAddSubFxInstrument()
 
 	m_pluginMutex.lock();
 	delete m_plugin;
-	delete m_remotePlugin;
 	m_plugin = nullptr;
-	m_remotePlugin = nullptr;
+	releaseRemotePlugin();
 	m_pluginMutex.unlock();
 }
 
@@ -198,10 +367,7 @@ void ZynAddSubFxInstrument::saveSettings( QDomDocument & _doc,
 		m_pluginMutex.lock();
 		if( m_remotePlugin )
 		{
-			m_remotePlugin->lock();
-			m_remotePlugin->sendMessage( RemotePlugin::message( IdSaveSettingsToFile ).addString( fn ) );
-			m_remotePlugin->waitForMessage( IdSaveSettingsToFile );
-			m_remotePlugin->unlock();
+			m_remotePlugin->saveSettingsToFile( m_remoteInstance, fn );
 		}
 		else
 		{
@@ -256,10 +422,7 @@ void ZynAddSubFxInstrument::loadSettings( const QDomElement & _this )
 		m_pluginMutex.lock();
 		if( m_remotePlugin )
 		{
-			m_remotePlugin->lock();
-			m_remotePlugin->sendMessage( RemotePlugin::message( IdLoadSettingsFromFile ).addString( fn ) );
-			m_remotePlugin->waitForMessage( IdLoadSettingsFromFile );
-			m_remotePlugin->unlock();
+			m_remotePlugin->loadSettingsFromFile( m_remoteInstance, fn );
 		}
 		else
 		{
@@ -300,10 +463,7 @@ void ZynAddSubFxInstrument::loadFile( const QString & _file )
 	const std::string fn = QSTR_TO_STDSTR( _file );
 	if( m_remotePlugin )
 	{
-		m_remotePlugin->lock();
-		m_remotePlugin->sendMessage( RemotePlugin::message( IdLoadPresetFile ).addString( fn ) );
-		m_remotePlugin->waitForMessage( IdLoadPresetFile );
-		m_remotePlugin->unlock();
+		m_remotePlugin->loadPresetFile( m_remoteInstance, fn );
 	}
 	else
 	{
@@ -335,7 +495,7 @@ void ZynAddSubFxInstrument::play( SampleFrame* _buf )
 	if (!m_pluginMutex.tryLock(Engine::getSong()->isExporting() ? -1 : 0)) {return;}
 	if( m_remotePlugin )
 	{
-		m_remotePlugin->process( nullptr, _buf );
+		m_remotePlugin->processInstance( m_remoteInstance, _buf );
 	}
 	else
 	{
@@ -363,7 +523,7 @@ bool ZynAddSubFxInstrument::handleMidiEvent( const MidiEvent& event, const TimeP
 	m_pluginMutex.lock();
 	if( m_remotePlugin )
 	{
-		m_remotePlugin->processMidiEvent( localEvent, 0 );
+		m_remotePlugin->processMidiEvent( localEvent, 0, m_remoteInstance );
 	}
 	else
 	{
@@ -397,8 +557,7 @@ void ZynAddSubFxInstrument::updatePitchRange()
 	m_pluginMutex.lock();
 	if( m_remotePlugin )
 	{
-		m_remotePlugin->sendMessage( RemotePlugin::message( IdZasfSetPitchWheelBendRange ).
-											addInt( instrumentTrack()->midiPitchRange() ) );
+		m_remotePlugin->setPitchWheelBendRange( m_remoteInstance, instrumentTrack()->midiPitchRange() );
 	}
 	else
 	{
@@ -431,38 +590,30 @@ void ZynAddSubFxInstrument::initPlugin()
 {
 	m_pluginMutex.lock();
 	delete m_plugin;
-	delete m_remotePlugin;
 	m_plugin = nullptr;
-	m_remotePlugin = nullptr;
+	releaseRemotePlugin();
 
 	if( m_hasGUI )
 	{
-		m_remotePlugin = new ZynAddSubFxRemotePlugin();
-		m_remotePlugin->lock();
-		m_remotePlugin->waitForInitDone( false );
-
-		m_remotePlugin->sendMessage(
-			RemotePlugin::message( IdZasfLmmsWorkingDirectory ).
-				addString(
-					QSTR_TO_STDSTR(
-						QString( ConfigManager::inst()->workingDir() ) ) ) );
-		m_remotePlugin->sendMessage(
-			RemotePlugin::message( IdZasfPresetDirectory ).
-				addString(
-					QSTR_TO_STDSTR(
-						QDir( ConfigManager::inst()->factoryPresetsDir() +
-								"/ZynAddSubFX" ).absolutePath() ) ) );
-
-		m_remotePlugin->updateSampleRate( Engine::audioEngine()->outputSampleRate() );
-
-		// temporary workaround until the VST synchronization feature gets stripped out of the RemotePluginClient class
-		// causing not to send buffer size information requests
-		m_remotePlugin->sendMessage( RemotePlugin::message( IdBufferSizeInformation ).addInt( Engine::audioEngine()->framesPerPeriod() ) );
-
-		m_remotePlugin->showUI();
-		m_remotePlugin->unlock();
+		m_remotePlugin = ZynAddSubFxRemotePlugin::acquire();
+		m_remoteInstance = m_remotePlugin ? m_remotePlugin->addInstance() : -1;
+		if( m_remoteInstance >= 0 )
+		{
+			connect( m_remotePlugin.get(), &ZynAddSubFxRemotePlugin::clickedCloseButton, this,
+				[this]( int instance )
+				{
+					if( instance == m_remoteInstance ) { emit remoteUIClosed(); }
+				} );
+			m_remotePlugin->showInstanceUI( m_remoteInstance );
+		}
+		else
+		{
+			// play without the editor rather than not at all
+			m_remotePlugin.reset();
+		}
 	}
-	else
+
+	if( !m_remotePlugin )
 	{
 		m_plugin = new LocalZynAddSubFx;
 		m_plugin->setSampleRate( Engine::audioEngine()->outputSampleRate() );
@@ -475,6 +626,22 @@ void ZynAddSubFxInstrument::initPlugin()
 
 
 
+void ZynAddSubFxInstrument::releaseRemotePlugin()
+{
+	if( !m_remotePlugin )
+	{
+		return;
+	}
+	m_remotePlugin->disconnect( this );
+	m_remotePlugin->removeInstance( m_remoteInstance );
+	// quits the process if no other instrument uses it
+	m_remotePlugin.reset();
+	m_remoteInstance = -1;
+}
+
+
+
+
 void ZynAddSubFxInstrument::sendControlChange( MidiControllers midiCtl, float value )
 {
 	handleMidiEvent( MidiEvent( MidiControlChange, instrumentTrack()->midiPort()->realOutputChannel(), midiCtl, (int) value, this ) );
@@ -620,6 +787,7 @@ void ZynAddSubFxView::modelChanged()
 	m_forwardMidiCC->setModel( &m->m_forwardMidiCcModel );
 
 	m_toggleUIButton->setChecked( m->m_hasGUI );
+	connect( m, SIGNAL( remoteUIClosed() ), m_toggleUIButton, SLOT( toggle() ), Qt::UniqueConnection );
 }
 
 
@@ -632,12 +800,6 @@ void ZynAddSubFxView::toggleUI()
 	{
 		model->m_hasGUI = m_toggleUIButton->isChecked();
 		model->reloadPlugin();
-
-		if( model->m_remotePlugin )
-		{
-			connect( model->m_remotePlugin, SIGNAL( clickedCloseButton() ),
-						m_toggleUIButton, SLOT( toggle() ) );
-		}
 	}
 }
 
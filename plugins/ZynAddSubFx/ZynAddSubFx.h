@@ -25,6 +25,9 @@
 #ifndef ZYNADDSUBFX_H
 #define ZYNADDSUBFX_H
 
+#include <memory>
+#include <vector>
+
 #include <QMap>
 #include <QMutex>
 
@@ -34,6 +37,7 @@
 #include "Instrument.h"
 #include "InstrumentView.h"
 #include "RemotePlugin.h"
+#include "SampleFrame.h"
 
 class QPushButton;
 
@@ -51,17 +55,53 @@ class LedCheckBox;
 class ZynAddSubFxView;
 }
 
+/**
+ * @brief The RemoteZynAddSubFx process, hosting the instances of all
+ * ZynAddSubFX instruments whose editor is shown.
+ *
+ * The first instrument played in a period renders all instances with a
+ * single request, the others only pick up their output.
+ */
 class ZynAddSubFxRemotePlugin : public RemotePlugin
 {
 	Q_OBJECT
 public:
-	ZynAddSubFxRemotePlugin();
+	//! @return the running process, started if there is none, or nullptr if it failed to start
+	static std::shared_ptr<ZynAddSubFxRemotePlugin> acquire();
+
+	//! @return the index of a new instance, or -1 if the process failed
+	int addInstance();
+	void removeInstance( int instance );
+
+	//! Writes the output of @p instance in the current period to @p _buf,
+	//! rendering all instances if this period wasn't rendered yet
+	void processInstance( int instance, SampleFrame* _buf );
+
+	void showInstanceUI( int instance );
+	void saveSettingsToFile( int instance, const std::string& file );
+	void loadSettingsFromFile( int instance, const std::string& file );
+	void loadPresetFile( int instance, const std::string& file );
+	void setPitchWheelBendRange( int instance, int semitones );
 
 	bool processMessage( const message & _m ) override;
 
 
 signals:
-	void clickedCloseButton();
+	void clickedCloseButton( int instance );
+
+
+protected:
+	void readOutputs( SampleFrame* _out_buf, f_cnt_t frames ) override;
+
+
+private:
+	ZynAddSubFxRemotePlugin();
+
+	//! A block of framesPerPeriod() frames per instance
+	std::vector<SampleFrame> m_outputs;
+	QMutex m_outputMutex;
+	long m_renderedPeriod;
+	bool m_rendered;
 
 } ;
 
@@ -105,12 +145,15 @@ private slots:
 
 private:
 	void initPlugin();
+	void releaseRemotePlugin();
 	void sendControlChange( MidiControllers midiCtl, float value );
 
 	bool m_hasGUI;
 	QMutex m_pluginMutex;
 	LocalZynAddSubFx * m_plugin;
-	ZynAddSubFxRemotePlugin * m_remotePlugin;
+	//! Shared with the other instruments showing their editor
+	std::shared_ptr<ZynAddSubFxRemotePlugin> m_remotePlugin;
+	int m_remoteInstance;
 
 	FloatModel m_portamentoModel;
 	FloatModel m_filterFreqModel;
@@ -128,6 +171,8 @@ private:
 
 signals:
 	void settingsChanged();
+	//! The editor of the remote instance was closed
+	void remoteUIClosed();
 
 } ;
 
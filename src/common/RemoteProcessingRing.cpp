@@ -0,0 +1,241 @@
+/*
+ * RemoteProcessingRing.cpp - lock-free exchange of periods and MIDI events
+ *                            between LMMS and a remote plugin
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ */
+
+#include "RemoteProcessingRing.h"
+
+#include <atomic>
+
+#include "lmmsconfig.h"
+
+#ifdef LMMS_BUILD_LINUX
+#	include <ctime>
+#	include <linux/futex.h>
+#	include <sys/syscall.h>
+#	include <unistd.h>
+#elif defined(LMMS_BUILD_WIN32)
+#	include <windows.h>
+#else
+#	include <thread>
+#endif
+
+namespace lmms {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+std::atomic_ref<std::uint32_t> atomic(std::uint32_t& value)
+{
+	return std::atomic_ref<std::uint32_t>{value};
+}
+
+std::uint32_t load(const std::uint32_t& value)
+{
+	return std::atomic_ref<std::uint32_t>{const_cast<std::uint32_t&>(value)}.load(std::memory_order_acquire);
+}
+
+// The waits below must work across processes, which rules out
+// std::atomic::wait() and private futexes
+
+//! Sets @p word to @p value and wakes a thread sleeping on it, if any
+void publish(std::uint32_t& word, std::uint32_t& waiters, std::uint32_t value)
+{
+	// Sequentially consistent, so either we see the waiter or the waiter's
+	// futex call sees the new value
+	atomic(word).store(value);
+#ifdef LMMS_BUILD_LINUX
+	if (atomic(waiters).load() != 0)
+	{
+		syscall(SYS_futex, &word, FUTEX_WAKE, 1, nullptr, nullptr, 0);
+	}
+#else
+	(void) waiters;
+#endif
+}
+
+//! Waits until @p word differs from @p old, @return false on timeout
+bool waitWhileEqual(std::uint32_t& word, std::uint32_t& waiters, std::uint32_t old,
+	std::chrono::milliseconds timeout)
+{
+	// the other side usually answers within a few microseconds
+	for (int i = 0; i < 256; ++i)
+	{
+		if (load(word) != old) { return true; }
+	}
+
+	const auto deadline = Clock::now() + timeout;
+	while (load(word) == old)
+	{
+		const auto now = Clock::now();
+		if (now >= deadline) { return false; }
+#ifdef LMMS_BUILD_LINUX
+		const auto left = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - now);
+		auto time = timespec{};
+		time.tv_sec = static_cast<time_t>(left.count() / 1000000000);
+		time.tv_nsec = static_cast<long>(left.count() % 1000000000);
+		atomic(waiters).fetch_add(1);
+		// returns right away if the word already changed
+		syscall(SYS_futex, &word, FUTEX_WAIT, old, &time, nullptr, 0);
+		atomic(waiters).fetch_sub(1);
+#elif defined(LMMS_BUILD_WIN32)
+		// MinGW has no std::this_thread
+		Sleep(1);
+#else
+		std::this_thread::sleep_for(std::chrono::microseconds{50});
+#endif
+	}
+	return true;
+}
+
+} // namespace
+
+
+
+
+void RemoteProcessingRing::create()
+{
+	m_data.create();
+	*m_data = {};
+	m_handled = 0;
+}
+
+
+
+
+void RemoteProcessingRing::attach(const std::string& key)
+{
+	m_data.attach(key);
+	// periods requested before attaching are still handled
+	m_handled = load(m_data->completed);
+}
+
+
+
+
+bool RemoteProcessingRing::pushMidiEvent(const MidiEvent& event)
+{
+	const auto write = m_data->midiWrite;
+	if (write - load(m_data->midiRead) == MidiCapacity) { return false; }
+
+	// only the host writes the requested sequence
+	auto& slot = m_data->midiEvents[write % MidiCapacity];
+	slot = event;
+	slot.sequence = m_data->requested + 1;
+	atomic(m_data->midiWrite).store(write + 1, std::memory_order_release);
+	return true;
+}
+
+
+
+
+std::uint32_t RemoteProcessingRing::request()
+{
+	const auto sequence = m_data->requested + 1;
+	publish(m_data->requested, m_data->requestedWaiters, sequence);
+	return sequence;
+}
+
+
+
+
+bool RemoteProcessingRing::isCompleted(std::uint32_t sequence) const
+{
+	return load(m_data->completed) == sequence;
+}
+
+
+
+
+bool RemoteProcessingRing::waitForCompletion(std::uint32_t sequence, std::chrono::milliseconds timeout)
+{
+	const auto deadline = Clock::now() + timeout;
+	for (auto completed = load(m_data->completed); completed != sequence; completed = load(m_data->completed))
+	{
+		const auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Clock::now());
+		if (left.count() <= 0 || !waitWhileEqual(m_data->completed, m_data->completedWaiters, completed, left))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+
+
+
+void RemoteProcessingRing::quit()
+{
+	atomic(m_data->quit).store(1, std::memory_order_release);
+	// wake the remote with a request it never handles
+	request();
+}
+
+
+
+
+bool RemoteProcessingRing::waitForRequest(std::chrono::milliseconds timeout)
+{
+	if (!waitWhileEqual(m_data->requested, m_data->requestedWaiters, m_handled, timeout) || hasQuit())
+	{
+		return false;
+	}
+
+	m_handled = load(m_data->requested);
+	return true;
+}
+
+
+
+
+bool RemoteProcessingRing::hasQuit() const
+{
+	return load(m_data->quit) != 0;
+}
+
+
+
+
+bool RemoteProcessingRing::popMidiEvent(MidiEvent& event)
+{
+	const auto read = m_data->midiRead;
+	if (read == load(m_data->midiWrite)) { return false; }
+
+	// In pipelined mode the host queues events for the next period while
+	// this one is rendered. Sequence numbers wrap around.
+	const auto& slot = m_data->midiEvents[read % MidiCapacity];
+	if (static_cast<std::int32_t>(slot.sequence - m_handled) > 0) { return false; }
+
+	event = slot;
+	atomic(m_data->midiRead).store(read + 1, std::memory_order_release);
+	return true;
+}
+
+
+
+
+void RemoteProcessingRing::complete()
+{
+	publish(m_data->completed, m_data->completedWaiters, m_handled);
+}
+
+
+} // namespace lmms
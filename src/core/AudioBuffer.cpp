@@ -24,7 +24,10 @@
 
 #include "AudioBuffer.h"
 
-#include "ConfigManager.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
 #include "MixHelpers.h"
 #include "SharedMemory.h"
 
@@ -55,6 +58,28 @@ auto createMask(ch_cnt_t pos) noexcept -> AudioBuffer::ChannelFlags
 	return mask;
 }
 
+constexpr auto AlignmentFloats = static_cast<f_cnt_t>(AudioBufferAlignment / sizeof(float));
+
+//! @returns the distance between the starts of two channel buffers, so every channel is aligned
+constexpr auto channelStride(f_cnt_t frames) -> f_cnt_t
+{
+	return (frames + AlignmentFloats - 1) / AlignmentFloats * AlignmentFloats;
+}
+
+//! @returns the number of floats the source buffer needs for @p channels aligned channels
+constexpr auto sourceBufferSize(f_cnt_t frames, ch_cnt_t channels) -> std::size_t
+{
+	// the allocation is only guaranteed to be aligned for floats
+	return static_cast<std::size_t>(channelStride(frames)) * channels + AlignmentFloats - 1;
+}
+
+//! @returns the offset of the first aligned float in @p buffer
+auto alignedOffset(const float* buffer) -> std::size_t
+{
+	const auto misalignment = reinterpret_cast<std::uintptr_t>(buffer) % AudioBufferAlignment;
+	return misalignment == 0 ? 0 : (AudioBufferAlignment - misalignment) / sizeof(float);
+}
+
 } // namespace
 
 
@@ -64,7 +89,7 @@ AudioBuffer::AudioBuffer(f_cnt_t frames, ch_cnt_t channels,
 	, m_accessBuffer{bufferResource}
 	, m_interleavedBuffer{bufferResource}
 	, m_frames{frames}
-	, m_silenceTrackingEnabled{ConfigManager::inst()->value("ui", "disableautoquit", "1").toInt() == 0}
+	, m_silenceTrackingEnabled{true}
 {
 	if (channels == 0)
 	{
@@ -85,7 +110,7 @@ void AudioBuffer::allocateInterleavedBuffer()
 
 auto AudioBuffer::allocationSize(f_cnt_t frames, ch_cnt_t channels, bool withInterleavedBuffer) -> std::size_t
 {
-	auto bytes = frames * channels * sizeof(float) // for m_sourceBuffer
+	auto bytes = sourceBufferSize(frames, channels) * sizeof(float) // for m_sourceBuffer
 		+ channels * sizeof(float*); // for m_accessBuffer
 
 	if (withInterleavedBuffer)
@@ -125,6 +150,10 @@ auto AudioBuffer::addGroup(ch_cnt_t channels) -> ChannelGroup*
 
 	const auto usesInterleavedBuffer = hasInterleavedBuffer();
 
+	// The channels are aligned within the source buffer, so their offset
+	// may change when it is reallocated
+	const auto oldOffset = m_sourceBuffer.empty() ? 0 : alignedOffset(m_sourceBuffer.data());
+
 	if (usesSharedMemory)
 	{
 		// Shared memory must be reallocated without any over-allocations,
@@ -139,20 +168,31 @@ auto AudioBuffer::addGroup(ch_cnt_t channels) -> ChannelGroup*
 	// with stricter padding requirements (m_accessBuffer) gets allocated first.
 	static_assert(alignof(float*) >= alignof(float));
 	m_accessBuffer.resize(newTotalChannels);
-	m_sourceBuffer.resize(newTotalChannels * m_frames);
+	m_sourceBuffer.resize(sourceBufferSize(m_frames, newTotalChannels));
 	if (usesInterleavedBuffer)
 	{
 		m_interleavedBuffer.resize(2 * m_frames);
 	}
 
+	const auto stride = channelStride(m_frames);
+	const auto offset = alignedOffset(m_sourceBuffer.data());
+	if (offset != oldOffset && !usesSharedMemory)
+	{
+		// Move the existing channels to the new aligned position
+		// and clear whatever they leave behind in the new channels
+		float* data = m_sourceBuffer.data();
+		std::memmove(data + offset, data + oldOffset, oldTotalChannels * stride * sizeof(float));
+		std::fill(data + offset + oldTotalChannels * stride, data + offset + newTotalChannels * stride, 0.f);
+	}
+
 	// Fix channel buffers
-	float* ptr = m_sourceBuffer.data();
+	float* ptr = m_sourceBuffer.data() + offset;
 	ch_cnt_t channel = 0;
 	while (channel < newTotalChannels)
 	{
 		m_accessBuffer[channel] = ptr;
 
-		ptr += m_frames;
+		ptr += stride;
 		++channel;
 	}
 
@@ -221,12 +261,6 @@ auto AudioBuffer::sanitize(const ChannelFlags& channels, ch_cnt_t upperBound) ->
 		}
 	}
 
-	if (changesMade && hasInterleavedBuffer() && (channels[0] || channels[1]))
-	{
-		// Keep the temporary interleaved buffer in sync
-		toInterleaved(groupBuffers(0), interleavedBuffer());
-	}
-
 	return changesMade;
 }
 
@@ -244,12 +278,6 @@ auto AudioBuffer::sanitizeAll() -> bool
 		}
 	}
 
-	if (changesMade && hasInterleavedBuffer())
-	{
-		// Keep the temporary interleaved buffer in sync
-		toInterleaved(groupBuffers(0), interleavedBuffer());
-	}
-
 	return changesMade;
 }
 
@@ -282,6 +310,10 @@ auto AudioBuffer::updateSilenceFlags(const ChannelFlags& channels, ch_cnt_t uppe
 			// This channel needs to be updated
 			const auto quiet = MixHelpers::isSilent(buffer(ch));
 
+			// A silent flag means the samples are exactly zero, so flush any
+			// residue below the threshold rather than letting it accumulate
+			if (quiet) { std::ranges::fill(buffer(ch), 0.f); }
+
 			m_silenceFlags[ch] = quiet;
 			allQuiet = allQuiet && quiet;
 		}
@@ -309,6 +341,7 @@ auto AudioBuffer::updateAllSilenceFlags() -> bool
 	for (ch_cnt_t ch = 0; ch < totalChannels(); ++ch)
 	{
 		const auto quiet = MixHelpers::isSilent(buffer(ch));
+		if (quiet) { std::ranges::fill(buffer(ch), 0.f); }
 
 		m_silenceFlags[ch] = quiet;
 		allQuiet = allQuiet && quiet;
@@ -331,19 +364,18 @@ void AudioBuffer::silenceChannels(const ChannelFlags& channels, ch_cnt_t upperBo
 		}
 	}
 
-	if (hasInterleavedBuffer() && (needSilenced[0] || needSilenced[1]))
-	{
-		// Keep the temporary interleaved buffer in sync
-		toInterleaved(groupBuffers(0), interleavedBuffer());
-	}
-
 	m_silenceFlags |= channels;
 }
 
 void AudioBuffer::silenceAllChannels()
 {
-	std::ranges::fill(m_sourceBuffer, 0);
-	std::ranges::fill(m_interleavedBuffer, 0);
+	for (ch_cnt_t ch = 0; ch < totalChannels(); ++ch)
+	{
+		if (!m_silenceFlags[ch])
+		{
+			std::ranges::fill(buffer(ch), 0.f);
+		}
+	}
 
 	m_silenceFlags.set();
 }
@@ -30,6 +30,7 @@
 #include "AudioDevice.h"
 #include "AudioEngine.h"
 #include "EffectChain.h"
+#include "EncoderThread.h"
 #include "Mixer.h"
 #include "Engine.h"
 #include "MixHelpers.h"
@@ -109,14 +110,18 @@ bool AudioBusHandle::processEffects()
 
 void AudioBusHandle::doProcessing()
 {
+	const f_cnt_t fpp = Engine::audioEngine()->framesPerPeriod();
+
+	// even when muted, so nothing is left over for the next period
+	if (m_voiceProcessor) { m_voiceProcessor->processVoices(); }
+
 	if (m_mutedModel && m_mutedModel->value())
 	{
+		if (m_tap) { m_tap->writeSilence(fpp); }
 		return;
 	}
 
-	const f_cnt_t fpp = Engine::audioEngine()->framesPerPeriod();
-
-	// clear the buffer
+	// clear the buffer, this only touches the channels that weren't silent
 	m_buffer.silenceAllChannels();
 
 	//qDebug( "Playhandles: %d", m_playHandles.size() );
@@ -124,14 +129,12 @@ void AudioBusHandle::doProcessing()
 	{
 		if (ph->buffer())
 		{
-			if (ph->usesBuffer()
-				&& (ph->type() == PlayHandle::Type::NotePlayHandle
-					|| !MixHelpers::isSilent(ph->buffer(), fpp)))
+			if (ph->usesBuffer() && !ph->isBufferSilent())
 			{
 				m_bufferUsage = true;
 
-				// Writing to temporary interleaved buffer until PlayHandle and MixHelpers switch to planar
-				MixHelpers::add(m_buffer.interleavedBuffer().asSampleFrames().data(), ph->buffer(), fpp);
+				// play handles still render interleaved, they are deinterleaved while mixing
+				MixHelpers::add(m_buffer.groupBuffers(0), ph->buffer());
 			}
 			ph->releaseBuffer(); 	// gets rid of playhandle's buffer and sets
 									// pointer to null, so if it doesn't get re-acquired we know to skip it next time
@@ -140,8 +143,8 @@ void AudioBusHandle::doProcessing()
 
 	if (m_bufferUsage)
 	{
-		// PlayHandle buffers were written to the temporary interleaved buffer
-		auto buffer = m_buffer.interleavedBuffer();
+		auto left = m_buffer.buffer(0);
+		auto right = m_buffer.buffer(1);
 
 		// handle volume and panning
 		// has both vol and pan models
@@ -157,8 +160,8 @@ void AudioBusHandle::doProcessing()
 				{
 					float v = volBuf->values()[f] * 0.01f;
 					float p = panBuf->values()[f] * 0.01f;
-					buffer[f][0] *= (p <= 0 ? 1.0f : 1.0f - p) * v;
-					buffer[f][1] *= (p >= 0 ? 1.0f : 1.0f + p) * v;
+					left[f] *= (p <= 0 ? 1.0f : 1.0f - p) * v;
+					right[f] *= (p >= 0 ? 1.0f : 1.0f + p) * v;
 				}
 			}
 
@@ -171,8 +174,8 @@ void AudioBusHandle::doProcessing()
 				for (f_cnt_t f = 0; f < fpp; ++f)
 				{
 					float v = volBuf->values()[f] * 0.01f;
-					buffer[f][0] *= v * l;
-					buffer[f][1] *= v * r;
+					left[f] *= v * l;
+					right[f] *= v * r;
 				}
 			}
 
@@ -183,8 +186,8 @@ void AudioBusHandle::doProcessing()
 				for (f_cnt_t f = 0; f < fpp; ++f)
 				{
 					float p = panBuf->values()[f] * 0.01f;
-					buffer[f][0] *= (p <= 0 ? 1.0f : 1.0f - p) * v;
-					buffer[f][1] *= (p >= 0 ? 1.0f : 1.0f + p) * v;
+					left[f] *= (p <= 0 ? 1.0f : 1.0f - p) * v;
+					right[f] *= (p >= 0 ? 1.0f : 1.0f + p) * v;
 				}
 			}
 
@@ -195,8 +198,8 @@ void AudioBusHandle::doProcessing()
 				float v = m_volumeModel->value() * 0.01f;
 				for (f_cnt_t f = 0; f < fpp; ++f)
 				{
-					buffer[f][0] *= (p <= 0 ? 1.0f : 1.0f - p) * v;
-					buffer[f][1] *= (p >= 0 ? 1.0f : 1.0f + p) * v;
+					left[f] *= (p <= 0 ? 1.0f : 1.0f - p) * v;
+					right[f] *= (p >= 0 ? 1.0f : 1.0f + p) * v;
 				}
 			}
 		}
@@ -211,8 +214,8 @@ void AudioBusHandle::doProcessing()
 				for (f_cnt_t f = 0; f < fpp; ++f)
 				{
 					float v = volBuf->values()[f] * 0.01f;
-					buffer[f][0] *= v;
-					buffer[f][1] *= v;
+					left[f] *= v;
+					right[f] *= v;
 				}
 			}
 			else
@@ -220,16 +223,12 @@ void AudioBusHandle::doProcessing()
 				float v = m_volumeModel->value() * 0.01f;
 				for (f_cnt_t f = 0; f < fpp; ++f)
 				{
-					buffer[f][0] *= v;
-					buffer[f][1] *= v;
+					left[f] *= v;
+					right[f] *= v;
 				}
 			}
 		}
 
-		// Copy from temporary interleaved buffer to the main planar buffer
-		// so they stay in sync
-		toPlanar(buffer, m_buffer.groupBuffers(0));
-
 		const auto sanitized = Engine::audioEngine()->sanitizationEnabled() ? m_buffer.sanitizeAll() : false;
 		m_corrupted.store(sanitized, std::memory_order_relaxed);
 
@@ -240,12 +239,26 @@ void AudioBusHandle::doProcessing()
 	// if we have neither, we don't have to do anything here - just pass the audio as is
 
 	// handle effects
-	const bool anyOutputAfterEffects = processEffects();
-	if (anyOutputAfterEffects || m_bufferUsage)
+	processEffects();
+	m_bufferUsage = false;
+
+	// the silence flags are up to date after the play handles and each
+	// effect, so silent output doesn't need to be mixed
+	if (m_buffer.hasAnySignal())
 	{
 		// TODO: improve the flow here - convert to pull model
 		Engine::mixer()->mixToChannel(m_buffer, m_nextMixerChannel); // send output to mixer
-		m_bufferUsage = false;
+
+		if (m_tap)
+		{
+			// the encoder takes interleaved audio
+			toInterleaved(m_buffer.groupBuffers(0), m_buffer.interleavedBuffer());
+			m_tap->write(m_buffer.interleavedBuffer().asSampleFrames().data(), fpp);
+		}
+	}
+	else if (m_tap)
+	{
+		m_tap->writeSilence(fpp);
 	}
 }
 
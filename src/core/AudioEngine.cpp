@@ -31,6 +31,8 @@
 #include "AudioEngineWorkerThread.h"
 #include "AudioBusHandle.h"
 #include "Hardware.h"
+#include "MidiInputQueue.h"
+#include "MidiPort.h"
 #include "Mixer.h"
 #include "Song.h"
 #include "EnvelopeAndLfoParameters.h"
@@ -59,6 +61,7 @@
 #include "MidiDummy.h"
 
 #include "BufferManager.h"
+#include "RealtimeAudit.h"
 
 namespace lmms
 {
@@ -90,6 +93,10 @@ AudioEngine::AudioEngine(bool renderOnly)
 	, m_profiler()
 	, m_clearSignal(false)
 	, m_sanitizationEnabled(ConfigManager::inst()->value("audioengine", "sanitizemix", "1").toInt())
+	, m_taskGraphEnabled(ConfigManager::inst()->value("audioengine", "taskgraph", "0").toInt())
+	, m_midiInputTimestamping(ConfigManager::inst()->value("midi", "timestampinput", "0").toInt())
+	, m_polyphony(ConfigManager::inst()->value("audioengine", "polyphony",
+		QString::number(NotePlayHandleManager::DefaultPolyphony)).toULongLong())
 {
 	for( int i = 0; i < 2; ++i )
 	{
@@ -100,6 +107,7 @@ AudioEngine::AudioEngine(bool renderOnly)
 	}
 
 	BufferManager::init( m_framesPerPeriod );
+	NotePlayHandleManager::reserve( m_polyphony );
 	m_outputBufferRead = std::make_unique<SampleFrame[]>(m_framesPerPeriod);
 	m_outputBufferWrite = std::make_unique<SampleFrame[]>(m_framesPerPeriod);
 
@@ -113,6 +121,9 @@ AudioEngine::AudioEngine(bool renderOnly)
 		}
 		m_workers.push_back( wt );
 	}
+
+	m_profiler.setNumThreads( m_workers.size() );
+	AudioEngineWorkerThread::setProfiler( &m_profiler );
 }
 
 
@@ -131,6 +142,7 @@ AudioEngine::~AudioEngine()
 	{
 		m_workers[w]->wait( 500 );
 	}
+	AudioEngineWorkerThread::setProfiler( nullptr );
 
 	delete m_midiClient;
 	delete m_audioDev;
@@ -236,6 +248,9 @@ void AudioEngine::renderStageNoteSetup()
 	Mixer * mixer = Engine::mixer();
 	mixer->prepareMasterMix();
 
+	// play live MIDI input before the song, like it arrived before
+	processMidiInput();
+
 	// create play-handles for new notes, samples etc.
 	Engine::getSong()->processNextBuffer();
 
@@ -251,6 +266,38 @@ void AudioEngine::renderStageNoteSetup()
 
 
 
+void AudioEngine::processMidiInput()
+{
+	using Clock = MidiInputQueue::Clock;
+
+	const auto now = Clock::now();
+	const auto frameDuration = std::chrono::duration<double>{1.0 / outputSampleRate()};
+
+	auto entry = MidiInputQueue::Entry{};
+	for (const auto port : m_midiInputPorts)
+	{
+		while (port->inputQueue().pop(entry))
+		{
+			const auto offset = MidiInputQueue::frameOffset(entry.arrival, m_lastMidiInputPeriod, now, m_framesPerPeriod);
+			port->dispatchInEvent(entry.event, entry.time, offset);
+			m_profiler.recordMidiInputLatency(
+				now - entry.arrival + std::chrono::duration_cast<Clock::duration>(offset * frameDuration));
+		}
+	}
+	m_lastMidiInputPeriod = now;
+}
+
+
+
+void AudioEngine::resetMidiInputTiming()
+{
+	// latencies measured with another device or period size don't apply anymore
+	m_profiler.resetMidiInputLatency();
+	m_lastMidiInputPeriod = MidiInputQueue::Clock::now();
+}
+
+
+
 void AudioEngine::renderStageInstruments()
 {
 	AudioEngineProfiler::Probe profilerProbe(m_profiler, AudioEngineProfiler::DetailType::Instruments);
@@ -269,6 +316,89 @@ void AudioEngine::renderStageEffects()
 	AudioEngineWorkerThread::fillJobQueue(m_audioBusHandles);
 	AudioEngineWorkerThread::startAndWaitForJobs();
 
+	removeFinishedPlayHandles();
+}
+
+
+
+void AudioEngine::renderStageMix()
+{
+	AudioEngineProfiler::Probe profilerProbe(m_profiler, AudioEngineProfiler::DetailType::Mixing);
+
+	Mixer *mixer = Engine::mixer();
+	mixer->masterMix(m_outputBufferWrite.get());
+
+	finishPeriod();
+}
+
+
+
+void AudioEngine::renderStageGraph()
+{
+	// The profiler can't tell the stages apart here, so everything up to
+	// the master output is accounted to the instruments
+	AudioEngineProfiler::Probe profilerProbe(m_profiler, AudioEngineProfiler::DetailType::Instruments);
+
+	Mixer* mixer = Engine::mixer();
+
+	AudioEngineWorkerThread::resetJobQueue(AudioEngineWorkerThread::JobQueue::OperationMode::Dynamic);
+	mixer->prepareChannels();
+
+	// every bus handle waits for its play handles and is itself a dependency
+	// of the mixer channel it feeds. The queue is not started yet, so no job
+	// can resolve a dependency before all of them are counted.
+	for (AudioBusHandle* busHandle : m_audioBusHandles)
+	{
+		MixerChannel* channel = mixer->mixerChannel(busHandle->nextMixerChannel());
+		busHandle->setDependencies(0);
+		busHandle->setDependent(channel);
+		channel->addDependency();
+	}
+	for (PlayHandle* handle : m_playHandles)
+	{
+		AudioBusHandle* busHandle = handle->audioBusHandle();
+		handle->setDependent(busHandle);
+		if (AudioEngineWorkerThread::addJob(handle))
+		{
+			busHandle->addDependency();
+		}
+	}
+	for (AudioBusHandle* busHandle : m_audioBusHandles)
+	{
+		if (busHandle->pendingDependencies() == 0)
+		{
+			AudioEngineWorkerThread::addJob(busHandle);
+		}
+	}
+	mixer->queueChannels();
+
+	AudioEngineWorkerThread::startAndWaitForJobs();
+
+	// don't leave dangling dependents around in case the graph changes
+	for (PlayHandle* handle : m_playHandles) { handle->setDependent(nullptr); }
+	for (AudioBusHandle* busHandle : m_audioBusHandles) { busHandle->setDependent(nullptr); }
+
+	removeFinishedPlayHandles();
+}
+
+
+
+void AudioEngine::renderStageGraphMix()
+{
+	AudioEngineProfiler::Probe profilerProbe(m_profiler, AudioEngineProfiler::DetailType::Mixing);
+
+	Engine::mixer()->finishMasterMix(m_outputBufferWrite.get());
+
+	finishPeriod();
+}
+
+
+
+void AudioEngine::removeFinishedPlayHandles()
+{
+	// the profiler still refers to the play handles processed in this period
+	if (m_profiler.jobTracing()) { m_profiler.collectJobSamples(); }
+
 	// removed all play handles which are done
 	for( PlayHandleList::Iterator it = m_playHandles.begin();
 						it != m_playHandles.end(); )
@@ -298,13 +428,8 @@ void AudioEngine::renderStageEffects()
 
 
 
-void AudioEngine::renderStageMix()
+void AudioEngine::finishPeriod()
 {
-	AudioEngineProfiler::Probe profilerProbe(m_profiler, AudioEngineProfiler::DetailType::Mixing);
-
-	Mixer *mixer = Engine::mixer();
-	mixer->masterMix(m_outputBufferWrite.get());
-
 	MixHelpers::multiply(m_outputBufferWrite.get(), m_masterGain, m_framesPerPeriod);
 
 	emit nextAudioBuffer(m_outputBufferRead.get());
@@ -322,14 +447,25 @@ std::span<const SampleFrame> AudioEngine::renderNextPeriod()
 	const auto lock = std::lock_guard{m_changeMutex};
 
 	m_profiler.startPeriod();
-	s_renderingThread = true;
+	{
+		const auto audit = RealtimeAudit::Scope{};
+		s_renderingThread = true;
 
-	renderStageNoteSetup();     // STAGE 0: clear old play handles and buffers, setup new play handles
-	renderStageInstruments();   // STAGE 1: run and render all play handles
-	renderStageEffects();       // STAGE 2: process effects of all instrument- and sampletracks
-	renderStageMix();           // STAGE 3: do master mix in mixer
+		renderStageNoteSetup();     // STAGE 0: clear old play handles and buffers, setup new play handles
+		if (taskGraphEnabled())
+		{
+			renderStageGraph();     // STAGES 1-3: play handles, effects and mixer channels as one task graph
+			renderStageGraphMix();  // write master output
+		}
+		else
+		{
+			renderStageInstruments();   // STAGE 1: run and render all play handles
+			renderStageEffects();       // STAGE 2: process effects of all instrument- and sampletracks
+			renderStageMix();           // STAGE 3: do master mix in mixer
+		}
 
-	s_renderingThread = false;
+		s_renderingThread = false;
+	}
 	m_profiler.finishPeriod(outputSampleRate(), m_framesPerPeriod);
 	m_outputBufferReadIndex = 0;
 
@@ -407,6 +543,7 @@ void AudioEngine::setAudioDevice(AudioDevice* _dev, bool startNow)
 	stopProcessing();
 
 	doSetAudioDevice( _dev );
+	resetMidiInputTiming();
 
 	emit qualitySettingsChanged();
 	emit sampleRateChanged();
@@ -436,6 +573,7 @@ void AudioEngine::restoreAudioDevice()
 		delete m_audioDev;
 
 		m_audioDev = m_oldAudioDev;
+		resetMidiInputTiming();
 		emit sampleRateChanged();
 
 		startProcessing();
@@ -566,6 +704,24 @@ void AudioEngine::removePlayHandlesOfTypes(Track * track, PlayHandle::Types type
 
 
 
+void AudioEngine::addMidiInputPort(MidiPort* port)
+{
+	const auto guard = requestChangesGuard();
+	m_midiInputPorts.push_back(port);
+}
+
+
+
+
+void AudioEngine::removeMidiInputPort(MidiPort* port)
+{
+	const auto guard = requestChangesGuard();
+	std::erase(m_midiInputPorts, port);
+}
+
+
+
+
 void AudioEngine::requestChangeInModel()
 {
 	if (s_renderingThread) { return; }
@@ -24,11 +24,30 @@
 
 #include "AudioEngineProfiler.h"
 
+#include <algorithm>
 #include <cstdint>
+#include <numeric>
+
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include "ThreadableJob.h"
 
 namespace lmms
 {
 
+namespace
+{
+
+double microseconds(AudioEngineProfiler::Clock::duration d)
+{
+	return std::chrono::duration<double, std::micro>(d).count();
+}
+
+} // namespace
+
+
+
 AudioEngineProfiler::AudioEngineProfiler() :
 	m_periodTimer(),
 	m_cpuLoad( 0 ),
@@ -38,6 +57,13 @@ AudioEngineProfiler::AudioEngineProfiler() :
 
 
 
+AudioEngineProfiler::~AudioEngineProfiler()
+{
+	closeOutputFile();
+}
+
+
+
 void AudioEngineProfiler::finishPeriod( sample_rate_t sampleRate, f_cnt_t framesPerPeriod )
 {
 	// Time taken to process all data and fill the audio buffer.
@@ -51,15 +77,23 @@ void AudioEngineProfiler::finishPeriod( sample_rate_t sampleRate, f_cnt_t frames
 	const auto newCpuLoad = 100.f * periodElapsed / timeLimit;
 	m_cpuLoad = newCpuLoad * 0.1f + m_cpuLoad * 0.9f;
 
+	++m_totals.periods;
+	m_totals.periodTime += periodElapsed;
+
 	// Compute detailed load analysis. Can use stronger averaging to get more stable readout.
 	for (std::size_t i = 0; i < DetailCount; i++)
 	{
 		const auto newLoad = 100.f * m_detailTime[i] / timeLimit;
 		const auto oldLoad = m_detailLoad[i].load(std::memory_order_relaxed);
 		m_detailLoad[i].store(newLoad * 0.05f + oldLoad * 0.95f, std::memory_order_relaxed);
+		m_totals.detailTime[i] += m_detailTime[i];
 	}
 
-	if( m_outputFile.isOpen() )
+	if( jobTracing() )
+	{
+		writeTraceEvents( sampleRate, framesPerPeriod );
+	}
+	else if( m_outputFile.isOpen() )
 	{
 		m_outputFile.write( QString( "%1\n" ).arg( periodElapsed ).toLatin1() );
 	}
@@ -69,9 +103,167 @@ void AudioEngineProfiler::finishPeriod( sample_rate_t sampleRate, f_cnt_t frames
 
 void AudioEngineProfiler::setOutputFile( const QString& outputFile )
 {
-	m_outputFile.close();
+	closeOutputFile();
 	m_outputFile.setFileName( outputFile );
-	m_outputFile.open( QFile::WriteOnly | QFile::Truncate );
+	if( !m_outputFile.open( QFile::WriteOnly | QFile::Truncate ) ) { return; }
+
+	if( outputFile.endsWith( ".json", Qt::CaseInsensitive ) )
+	{
+		m_jobRings.clear();
+		for( std::size_t i = 0; i < m_numThreads; ++i )
+		{
+			m_jobRings.push_back( std::make_unique<JobRing>( JobRingSize ) );
+		}
+		m_droppedJobs = 0;
+		m_traceStart = Clock::now();
+
+		m_outputFile.write( "[\n" );
+		for( std::size_t i = 0; i < m_numThreads; ++i )
+		{
+			// the last worker is processed inline by the audio engine thread
+			const auto threadName = i + 1 == m_numThreads
+				? QStringLiteral( "Audio engine" )
+				: QStringLiteral( "Worker %1" ).arg( i );
+			const auto event = QJsonObject{
+				{ "name", "thread_name" }, { "ph", "M" }, { "pid", 1 }, { "tid", static_cast<int>( i ) },
+				{ "args", QJsonObject{ { "name", threadName } } }
+			};
+			m_outputFile.write( QJsonDocument( event ).toJson( QJsonDocument::Compact ) + ",\n" );
+		}
+		m_jobTracing = true;
+	}
+}
+
+
+
+void AudioEngineProfiler::recordJob( std::size_t worker, const ThreadableJob* job, Clock::time_point start, Clock::time_point end )
+{
+	if( worker >= m_jobRings.size() || !m_jobRings[worker]->push( { job, start, end } ) )
+	{
+		++m_droppedJobs;
+	}
+}
+
+
+
+void AudioEngineProfiler::recordMidiInputLatency( Clock::duration latency )
+{
+	const auto us = std::max<std::int64_t>( 0, std::chrono::duration_cast<std::chrono::microseconds>( latency ).count() );
+	const auto bucket = std::min<std::uint64_t>( us / MidiLatencyHistogram::BucketWidth, MidiLatencyHistogram::Buckets - 1 );
+	m_midiLatency[bucket].fetch_add( 1, std::memory_order_relaxed );
+}
+
+
+
+AudioEngineProfiler::MidiLatencyHistogram AudioEngineProfiler::midiInputLatency() const
+{
+	auto histogram = MidiLatencyHistogram{};
+	for( std::size_t i = 0; i < MidiLatencyHistogram::Buckets; ++i )
+	{
+		histogram.counts[i] = m_midiLatency[i].load( std::memory_order_relaxed );
+	}
+	return histogram;
+}
+
+
+
+void AudioEngineProfiler::resetMidiInputLatency()
+{
+	for( auto& count : m_midiLatency )
+	{
+		count.store( 0, std::memory_order_relaxed );
+	}
+}
+
+
+
+std::uint64_t AudioEngineProfiler::MidiLatencyHistogram::events() const
+{
+	return std::accumulate( counts.begin(), counts.end(), std::uint64_t{0} );
+}
+
+
+
+double AudioEngineProfiler::MidiLatencyHistogram::percentile( double fraction ) const
+{
+	const auto total = events();
+	if( total == 0 ) { return 0.0; }
+
+	// interpolate within the bucket the percentile falls into
+	const auto target = fraction * total;
+	auto below = std::uint64_t{0};
+	for( std::size_t i = 0; i < Buckets; ++i )
+	{
+		if( counts[i] > 0 && below + counts[i] >= target )
+		{
+			return ( i + ( target - below ) / counts[i] ) * BucketWidth;
+		}
+		below += counts[i];
+	}
+	return static_cast<double>( Buckets * BucketWidth );
+}
+
+
+
+void AudioEngineProfiler::collectJobSamples()
+{
+	// play handles finished in this period are deleted or recycled right
+	// after the jobs that rendered them, so their names have to be resolved
+	// before that happens
+	for( std::size_t worker = 0; worker < m_jobRings.size(); ++worker )
+	{
+		JobSample sample;
+		while( m_jobRings[worker]->pop( sample ) )
+		{
+			const auto event = QJsonObject{
+				{ "name", sample.job->profilerName() }, { "cat", "job" }, { "ph", "X" }, { "pid", 1 },
+				{ "tid", static_cast<int>( worker ) },
+				{ "ts", microseconds( sample.start - m_traceStart ) },
+				{ "dur", microseconds( sample.end - sample.start ) }
+			};
+			m_traceEvents += QJsonDocument( event ).toJson( QJsonDocument::Compact ) + ",\n";
+		}
+	}
+}
+
+
+
+void AudioEngineProfiler::writeTraceEvents( sample_rate_t sampleRate, f_cnt_t framesPerPeriod )
+{
+	// picks up the jobs run after the last collectJobSamples(), e.g. the
+	// mixer channels, which are never deleted while a period is rendered
+	collectJobSamples();
+
+	const auto periodEnd = Clock::now();
+	const auto budget = 1000000.0 * framesPerPeriod / sampleRate;
+	const auto periodEvent = QJsonObject{
+		{ "name", "Period" }, { "cat", "period" }, { "ph", "X" }, { "pid", 1 },
+		{ "tid", static_cast<int>( m_numThreads - 1 ) },
+		{ "ts", microseconds( m_periodStart - m_traceStart ) },
+		{ "dur", microseconds( periodEnd - m_periodStart ) },
+		{ "args", QJsonObject{ { "budget_us", budget } } }
+	};
+	m_outputFile.write( QJsonDocument( periodEvent ).toJson( QJsonDocument::Compact ) + ",\n" );
+	m_outputFile.write( m_traceEvents );
+	m_traceEvents.clear();
+}
+
+
+
+void AudioEngineProfiler::closeOutputFile()
+{
+	if( jobTracing() )
+	{
+		m_jobTracing = false;
+		// every event is followed by a comma, so finish with one that isn't
+		// to keep the file valid JSON
+		const auto event = QJsonObject{
+			{ "name", "process_name" }, { "ph", "M" }, { "pid", 1 },
+			{ "args", QJsonObject{ { "name", "LMMS" }, { "dropped_jobs", static_cast<qint64>( m_droppedJobs.load() ) } } }
+		};
+		m_outputFile.write( QJsonDocument( event ).toJson( QJsonDocument::Compact ) + "\n]\n" );
+	}
+	m_outputFile.close();
 }
 
 } // namespace lmms
@@ -24,12 +24,16 @@
 
 #include "AudioEngineWorkerThread.h"
 
+#include <algorithm>
+
 #include <QDebug>
 #include <QMutex>
 #include <QWaitCondition>
 
 #include "AudioEngine.h"
+#include "AudioEngineProfiler.h"
 #include "Hardware.h"
+#include "RealtimeAudit.h"
 #include "ThreadableJob.h"
 
 
@@ -40,55 +44,182 @@ AudioEngineWorkerThread::JobQueue AudioEngineWorkerThread::globalJobQueue;
 QWaitCondition * AudioEngineWorkerThread::queueReadyWaitCond = nullptr;
 QList<AudioEngineWorkerThread *> AudioEngineWorkerThread::workerThreads;
 
+thread_local size_t AudioEngineWorkerThread::JobQueue::s_currentWorker =
+	AudioEngineWorkerThread::JobQueue::InlineWorker;
+
 // implementation of internal JobQueue
+AudioEngineWorkerThread::JobQueue::JobQueue( size_t numWorkers ) :
+	m_deques(),
+	m_jobsQueued( 0 ),
+	m_jobsDone( 0 ),
+	m_activeWorkers( 0 ),
+	m_open( false ),
+	m_nextDeque( 0 ),
+	m_opMode( OperationMode::Static ),
+	m_profiler( nullptr )
+{
+	setNumWorkers( numWorkers );
+}
+
+
+
+
+void AudioEngineWorkerThread::JobQueue::setNumWorkers( size_t numWorkers )
+{
+	numWorkers = std::max<size_t>( numWorkers, 1 );
+	while( m_deques.size() < numWorkers )
+	{
+		m_deques.push_back( std::make_unique<Deque>( JOB_QUEUE_SIZE ) );
+	}
+	m_deques.resize( numWorkers );
+	m_nextDeque = 0;
+}
+
+
+
+
 void AudioEngineWorkerThread::JobQueue::reset( OperationMode _opMode )
 {
-	m_writeIndex = 0;
-	m_itemsDone = 0;
+	m_jobsQueued = 0;
+	m_jobsDone = 0;
 	m_opMode = _opMode;
 }
 
 
 
 
-void AudioEngineWorkerThread::JobQueue::addJob( ThreadableJob * _job )
+bool AudioEngineWorkerThread::JobQueue::addJob( ThreadableJob * _job )
 {
 	if( _job->requiresProcessing() )
 	{
 		// update job state
 		_job->queue();
-		// actually queue the job via atomic operations
-		auto index = m_writeIndex++;
-		if (index < JOB_QUEUE_SIZE) {
-			m_items[index] = _job;
-		} else {
+		++m_jobsQueued;
+
+		size_t index;
+		if( s_currentWorker < m_deques.size() )
+		{
+			// added by a running job - keep it local to this worker
+			index = s_currentWorker;
+		}
+		else
+		{
+			// queue is closed, so it is safe to push to other workers' deques
+			index = m_nextDeque;
+			m_nextDeque = ( m_nextDeque + 1 ) % m_deques.size();
+		}
+
+		if( !m_deques[index]->push( _job ) )
+		{
 			qWarning() << "Job queue is full!";
-			++m_itemsDone;
+			++m_jobsDone;
 		}
+		return true;
 	}
+	return false;
 }
 
 
 
-void AudioEngineWorkerThread::JobQueue::run()
+
+ThreadableJob * AudioEngineWorkerThread::JobQueue::takeJob( size_t worker )
 {
-	bool processedJob = true;
-	while (processedJob && m_itemsDone < m_writeIndex)
+	if( ThreadableJob * job = m_deques[worker]->pop() )
+	{
+		return job;
+	}
+
+	// own deque is empty - try to steal from the others, starting with
+	// our neighbour so that thieves spread across the victims
+	const auto numDeques = m_deques.size();
+	for( size_t i = 1; i < numDeques; ++i )
 	{
-		processedJob = false;
-		for (auto i = std::size_t{0}; i < m_writeIndex && i < JOB_QUEUE_SIZE; ++i)
+		if( ThreadableJob * job = m_deques[( worker + i ) % numDeques]->steal() )
 		{
-			ThreadableJob * job = m_items[i].exchange(nullptr);
-			if( job )
+			return job;
+		}
+	}
+	return nullptr;
+}
+
+
+
+
+void AudioEngineWorkerThread::JobQueue::processJob( ThreadableJob * job, size_t worker )
+{
+	if( m_profiler && m_profiler->jobTracing() )
+	{
+		const auto start = AudioEngineProfiler::Clock::now();
+		job->process();
+		m_profiler->recordJob( worker, job, start, AudioEngineProfiler::Clock::now() );
+	}
+	else
+	{
+		job->process();
+	}
+}
+
+
+
+
+bool AudioEngineWorkerThread::JobQueue::empty() const
+{
+	return std::all_of( m_deques.begin(), m_deques.end(),
+		[]( const auto & deque ) { return deque->empty(); } );
+}
+
+
+
+
+void AudioEngineWorkerThread::JobQueue::start()
+{
+	m_open = true;
+}
+
+
+
+
+void AudioEngineWorkerThread::JobQueue::run( size_t worker )
+{
+	// register as active before checking whether the queue is open, the
+	// reverse order in wait() makes sure one of both sees the other
+	++m_activeWorkers;
+	if( m_open )
+	{
+		worker = std::min( worker, m_deques.size() - 1 );
+		s_currentWorker = worker;
+
+		while( m_jobsDone < m_jobsQueued )
+		{
+			if( ThreadableJob * job = takeJob( worker ) )
 			{
-				job->process();
-				processedJob = true;
-				++m_itemsDone;
+				processJob( job, worker );
+
+				// queue the next job of a task graph before marking this
+				// one as done, so the queue never looks finished too early
+				ThreadableJob * dependent = job->dependent();
+				if( dependent && dependent->resolveDependency() )
+				{
+					addJob( dependent );
+				}
+				++m_jobsDone;
+			}
+			else if( m_opMode == OperationMode::Static && empty() )
+			{
+				// nothing left to take and no new jobs will show up
+				break;
+			}
+			else
+			{
+				// lost a race against another thief, or another worker
+				// may still add jobs
+				busyWaitHint();
 			}
 		}
-		// always exit loop if we're not in dynamic mode
-		processedJob = processedJob && ( m_opMode == OperationMode::Dynamic );
+
+		s_currentWorker = InlineWorker;
 	}
+	--m_activeWorkers;
 }
 
 
@@ -96,7 +227,12 @@ void AudioEngineWorkerThread::JobQueue::run()
 
 void AudioEngineWorkerThread::JobQueue::wait()
 {
-	while (m_itemsDone < m_writeIndex) { busyWaitHint(); }
+	while( m_jobsDone < m_jobsQueued ) { busyWaitHint(); }
+
+	// close the queue and wait for stragglers, so that the deques are not
+	// touched by any worker until the next start()
+	m_open = false;
+	while( m_activeWorkers > 0 ) { busyWaitHint(); }
 }
 
 
@@ -107,6 +243,7 @@ void AudioEngineWorkerThread::JobQueue::wait()
 
 AudioEngineWorkerThread::AudioEngineWorkerThread( AudioEngine* audioEngine ) :
 	QThread( audioEngine ),
+	m_index( 0 ),
 	m_quit( false )
 {
 	// initialize global static data
@@ -118,8 +255,12 @@ AudioEngineWorkerThread::AudioEngineWorkerThread( AudioEngine* audioEngine ) :
 	// keep track of all instantiated worker threads - this is used for
 	// processing the last worker thread "inline", see comments in
 	// AudioEngineWorkerThread::startAndWaitForJobs() for details
+	m_index = workerThreads.size();
 	workerThreads << this;
 
+	// every worker (including the inline one) gets its own deque
+	globalJobQueue.setNumWorkers( workerThreads.size() );
+
 	resetJobQueue();
 }
 
@@ -145,6 +286,7 @@ void AudioEngineWorkerThread::quit()
 
 void AudioEngineWorkerThread::startAndWaitForJobs()
 {
+	globalJobQueue.start();
 	queueReadyWaitCond->wakeAll();
 	// The last worker-thread is never started. Instead it's processed "inline"
 	// i.e. within the global AudioEngine thread. This way we can reduce latencies
@@ -165,7 +307,10 @@ void AudioEngineWorkerThread::run()
 	{
 		m.lock();
 		queueReadyWaitCond->wait( &m );
-		globalJobQueue.run();
+		{
+			const auto audit = RealtimeAudit::Scope{};
+			globalJobQueue.run( m_index );
+		}
 		m.unlock();
 	}
 }
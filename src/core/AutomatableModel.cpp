@@ -24,6 +24,9 @@
 
 #include "AutomatableModel.h"
 
+#include <algorithm>
+#include <array>
+
 #include <QRegularExpression>
 
 #include "lmms_math.h"
@@ -31,6 +34,7 @@
 #include "AudioEngine.h"
 #include "AutomationClip.h"
 #include "ControllerConnection.h"
+#include "Hardware.h"
 #include "LocaleHelper.h"
 #include "ProjectJournal.h"
 #include "Song.h"
@@ -38,7 +42,32 @@
 namespace lmms
 {
 
-long AutomatableModel::s_periodCounter = 0;
+std::atomic<long> AutomatableModel::s_periodCounter = 0;
+std::atomic<int> AutomatableModel::s_recomputedLastPeriod = 0;
+
+namespace
+{
+
+// Every thread counts the value buffers it calculated on a cache line of its
+// own, so that the workers don't contend on a single counter
+struct alignas(64) RecomputeCounter
+{
+	std::atomic<int> count = 0;
+};
+
+constexpr auto RecomputeCounters = std::size_t{64};
+std::array<RecomputeCounter, RecomputeCounters> s_recomputedThisPeriod;
+std::atomic<std::size_t> s_nextRecomputeCounter = 0;
+
+RecomputeCounter& recomputeCounter()
+{
+	// threads beyond the last counter share one, which is still correct
+	thread_local auto& counter
+		= s_recomputedThisPeriod[s_nextRecomputeCounter.fetch_add(1, std::memory_order_relaxed) % RecomputeCounters];
+	return counter;
+}
+
+} // namespace
 
 
 
@@ -59,6 +88,7 @@ AutomatableModel::AutomatableModel(
 	m_controllerConnection( nullptr ),
 	m_valueBuffer( static_cast<int>( Engine::audioEngine()->framesPerPeriod() ) ),
 	m_lastUpdatedPeriod( -1 ),
+	m_claimedPeriod( -1 ),
 	m_hasSampleExactData(false),
 	m_useControllerValue(true)
 
@@ -529,15 +559,51 @@ float AutomatableModel::controllerValue( int frameOffset ) const
 
 ValueBuffer * AutomatableModel::valueBuffer()
 {
-	QMutexLocker m( &m_valueBufferMutex );
+	const long period = s_periodCounter.load(std::memory_order_relaxed);
+
 	// if we've already calculated the valuebuffer this period, return the cached buffer
-	if( m_lastUpdatedPeriod == s_periodCounter )
+	if (m_lastUpdatedPeriod.load(std::memory_order_acquire) != period)
 	{
-		return m_hasSampleExactData
-			? &m_valueBuffer
-			: nullptr;
+		auto claimed = m_claimedPeriod.load(std::memory_order_relaxed);
+		if (claimed != period && m_claimedPeriod.compare_exchange_strong(claimed, period, std::memory_order_acquire))
+		{
+			m_hasSampleExactData = updateValueBuffer(m_valueBuffer, m_oldValue);
+			recomputeCounter().count.fetch_add(1, std::memory_order_relaxed);
+			m_lastUpdatedPeriod.store(period, std::memory_order_release);
+		}
+		else
+		{
+			// Another thread is calculating it right now. That only takes one
+			// buffer's worth of work, so wait for it to be published instead
+			// of reading the model's state while it is being changed.
+			while (m_lastUpdatedPeriod.load(std::memory_order_acquire) != period) { busyWaitHint(); }
+		}
 	}
 
+	return m_hasSampleExactData
+		? &m_valueBuffer
+		: nullptr;
+}
+
+
+
+
+void AutomatableModel::incrementPeriodCounter()
+{
+	int recomputed = 0;
+	for (auto& counter : s_recomputedThisPeriod)
+	{
+		recomputed += counter.count.exchange(0, std::memory_order_relaxed);
+	}
+	s_recomputedLastPeriod.store(recomputed, std::memory_order_relaxed);
+	s_periodCounter.fetch_add(1, std::memory_order_relaxed);
+}
+
+
+
+
+bool AutomatableModel::updateValueBuffer(ValueBuffer& buffer, float& oldValue)
+{
 	float val = m_value; // make sure our m_value doesn't change midway
 
 	// TODO
@@ -551,17 +617,17 @@ ValueBuffer * AutomatableModel::valueBuffer()
 		if( vb )
 		{
 			float * values = vb->values();
-			float * nvalues = m_valueBuffer.values();
+			float * nvalues = buffer.values();
 			switch( m_scaleType )
 			{
 			case ScaleType::Linear:
-				for( int i = 0; i < m_valueBuffer.length(); i++ )
+				for( int i = 0; i < buffer.length(); i++ )
 				{
 					nvalues[i] = minValue<float>() + ( range() * values[i] );
 				}
 				break;
 			case ScaleType::Logarithmic:
-				for( int i = 0; i < m_valueBuffer.length(); i++ )
+				for( int i = 0; i < buffer.length(); i++ )
 				{
 					nvalues[i] = logToLinearScale( values[i] );
 				}
@@ -571,9 +637,7 @@ ValueBuffer * AutomatableModel::valueBuffer()
 					"lacks implementation for a scale type");
 				break;
 			}
-			m_lastUpdatedPeriod = s_periodCounter;
-			m_hasSampleExactData = true;
-			return &m_valueBuffer;
+			return true;
 		}
 	}
 
@@ -587,14 +651,12 @@ ValueBuffer * AutomatableModel::valueBuffer()
 				{
 					auto vb = next->valueBuffer();
 					float* values = vb->values();
-					float* nvalues = m_valueBuffer.values();
+					float* nvalues = buffer.values();
 					for (int i = 0; i < vb->length(); i++)
 					{
 						nvalues[i] = fittedValue(values[i]);
 					}
-					m_lastUpdatedPeriod = s_periodCounter;
-					m_hasSampleExactData = true;
-					return &m_valueBuffer;
+					return true;
 				}
 		}
 	}
@@ -604,20 +666,59 @@ ValueBuffer * AutomatableModel::valueBuffer()
 	// will be the same (even if it is calculated separatly for each model).
 
 	// Populate value buffer by interpolatating between the old and new value
-	if (m_oldValue != val)
+	if (oldValue != val)
 	{
-		m_valueBuffer.interpolate(m_oldValue, val);
-		m_oldValue = val;
-		m_lastUpdatedPeriod = s_periodCounter;
-		m_hasSampleExactData = true;
-		return &m_valueBuffer;
+		buffer.interpolate(oldValue, val);
+		oldValue = val;
+		return true;
 	}
 
 	// if we have no sample-exact source for a ValueBuffer, return NULL to signify that no data is available at the moment
 	// in which case the recipient knows to use the static value() instead
-	m_lastUpdatedPeriod = s_periodCounter;
-	m_hasSampleExactData = false;
-	return nullptr;
+	return false;
+}
+
+
+void AutomatableModel::setAutomatedValues(f_cnt_t offset, std::span<const float> values)
+{
+	setAutomatedValuesInternal(offset, values);
+	for (auto model = m_nextLink; model != this; model = model->m_nextLink)
+	{
+		model->setAutomatedValuesInternal(offset, values);
+	}
+}
+
+
+
+
+void AutomatableModel::setAutomatedValuesInternal(f_cnt_t offset, std::span<const float> values)
+{
+	// Automation is applied while the song is processed, before any other
+	// thread reads the buffer of this period
+	const long period = s_periodCounter.load(std::memory_order_relaxed);
+	const bool firstWrite = m_lastUpdatedPeriod.load(std::memory_order_relaxed) != period;
+	m_claimedPeriod.store(period, std::memory_order_relaxed);
+
+	const auto length = static_cast<f_cnt_t>(m_valueBuffer.length());
+	float* buffer = m_valueBuffer.values();
+	offset = std::min(offset, length);
+
+	// The frames before the first write of a period keep the value they had
+	if (firstWrite || !m_hasSampleExactData)
+	{
+		std::fill_n(buffer, offset, m_oldValue);
+	}
+
+	const auto frames = std::min(static_cast<f_cnt_t>(values.size()), length - offset);
+	for (f_cnt_t i = 0; i < frames; ++i)
+	{
+		buffer[offset + i] = fittedValue(values[i]);
+	}
+
+	m_hasSampleExactData = true;
+	m_lastUpdatedPeriod.store(period, std::memory_order_release);
+	// the buffer already leads to the current value, don't ramp towards it again
+	m_oldValue = m_value;
 }
 
 
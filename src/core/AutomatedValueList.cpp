@@ -0,0 +1,138 @@
+/*
+ * AutomatedValueList.cpp - the models automation clips control at one point in
+ *                          time, gathered without allocating
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "AutomatedValueList.h"
+
+#include <algorithm>
+#include <cstdint>
+
+#include "AutomationClip.h"
+
+namespace lmms
+{
+
+
+void AutomatedValueList::clear()
+{
+	m_entries.clear();
+	std::fill(m_models.begin(), m_models.end(), nullptr);
+}
+
+
+
+
+void AutomatedValueList::add(AutomatableModel* model, const AutomationClip* clip, float time, float end)
+{
+	if (m_models.size() < 2 * (m_entries.size() + 1)) { grow(); }
+
+	auto& slotModel = m_models[slot(model)];
+	if (slotModel == model) { return; }
+
+	slotModel = model;
+	m_entries.push_back({model, clip, time, end, 0.f});
+}
+
+
+
+
+bool AutomatedValueList::contains(const AutomatableModel* model) const
+{
+	return !m_models.empty() && m_models[slot(model)] == model;
+}
+
+
+
+
+void AutomatedValueList::evaluate()
+{
+	// the models of one clip are next to each other
+	const Entry* previous = nullptr;
+	for (auto& entry : m_entries)
+	{
+		if (previous && previous->clip == entry.clip && previous->time == entry.time && previous->end == entry.end)
+		{
+			entry.value = previous->value;
+		}
+		else
+		{
+			entry.value = entry.clip->valueAt(std::min(entry.time, entry.end));
+		}
+		previous = &entry;
+	}
+}
+
+
+
+
+void AutomatedValueList::valuesAfter(const Entry& entry, float ticks, float ticksPerFrame, std::span<float> out)
+{
+	entry.clip->valuesAt(entry.time + ticks, ticksPerFrame, entry.end, out);
+}
+
+
+
+
+AutomatedValueMap AutomatedValueList::toMap() const
+{
+	auto map = AutomatedValueMap{};
+	for (const auto& entry : m_entries)
+	{
+		map[entry.model] = entry.value;
+	}
+	return map;
+}
+
+
+
+
+std::size_t AutomatedValueList::slot(const AutomatableModel* model) const
+{
+	// models are allocated on the heap, so the low bits carry little information
+	auto hash = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(model));
+	hash ^= hash >> 33;
+	hash *= 0xff51afd7ed558ccdULL;
+	hash ^= hash >> 33;
+
+	const auto mask = m_models.size() - 1;
+	auto index = static_cast<std::size_t>(hash) & mask;
+	while (m_models[index] != nullptr && m_models[index] != model)
+	{
+		index = (index + 1) & mask;
+	}
+	return index;
+}
+
+
+
+
+void AutomatedValueList::grow()
+{
+	m_models.assign(std::max(std::size_t{16}, 2 * m_models.size()), nullptr);
+	for (const auto& entry : m_entries)
+	{
+		m_models[slot(entry.model)] = entry.model;
+	}
+}
+
+
+} // namespace lmms
@@ -49,6 +49,11 @@ AutomationClip::AutomationClip( AutomationTrack * _auto_track ) :
 	Clip( _auto_track ),
 	m_autoTrack( _auto_track ),
 	m_objects(),
+	m_curve( nullptr ),
+	m_curveReaders( 0 ),
+	m_curveHint( 0 ),
+	m_curveEdits( 0 ),
+	m_curveDirty( true ),
 	m_tension( 1.0 ),
 	m_progressionType( ProgressionType::Discrete ),
 	m_dragging( false ),
@@ -65,6 +70,11 @@ AutomationClip::AutomationClip( const AutomationClip & _clip_to_copy ) :
 	Clip(_clip_to_copy),
 	m_autoTrack( _clip_to_copy.m_autoTrack ),
 	m_objects( _clip_to_copy.m_objects ),
+	m_curve( nullptr ),
+	m_curveReaders( 0 ),
+	m_curveHint( 0 ),
+	m_curveEdits( 0 ),
+	m_curveDirty( true ),
 	m_tension( _clip_to_copy.m_tension ),
 	m_progressionType(_clip_to_copy.m_progressionType),
 	m_dragging(false),
@@ -83,6 +93,17 @@ AutomationClip::AutomationClip( const AutomationClip & _clip_to_copy ) :
 		// Sets the node's clip to this one
 		m_timeMap[POS(it)].setClip(this);
 	}
+	invalidateCurve();
+}
+
+
+
+
+AutomationClip::~AutomationClip()
+{
+	// Playback doesn't read a clip that's being deleted anymore
+	delete m_curve.load();
+	for (const auto curve : m_retiredCurves) { delete curve; }
 }
 
 bool AutomationClip::addObject( AutomatableModel * _obj, bool _search_dup )
@@ -125,6 +146,7 @@ void AutomationClip::setProgressionType(
 		_new_progression_type == ProgressionType::CubicHermite )
 	{
 		m_progressionType = _new_progression_type;
+		invalidateCurve();
 		emit dataChanged();
 	}
 }
@@ -142,6 +164,7 @@ void AutomationClip::setTension( QString _new_tension )
 	if( ok && nt > -0.01 && nt < 1.01 )
 	{
 		m_tension = nt;
+		invalidateCurve();
 	}
 }
 
@@ -371,10 +394,12 @@ void AutomationClip::removeNodes(const int tick0, const int tick1)
 		nodesToRemove.push_back(POS(it));
 	}
 
+	beginCurveEdit();
 	for (auto node: nodesToRemove)
 	{
 		removeNode(node);
 	}
+	endCurveEdit();
 }
 
 
@@ -397,10 +422,12 @@ void AutomationClip::resetNodes(const int tick0, const int tick1)
 	auto start = TimePos(std::min(tick0, tick1));
 	auto end = TimePos(std::max(tick0, tick1));
 
+	beginCurveEdit();
 	for (auto it = m_timeMap.lowerBound(start), endIt = m_timeMap.upperBound(end); it != endIt; ++it)
 	{
 		it.value().resetOutValue();
 	}
+	endCurveEdit();
 }
 
 
@@ -408,6 +435,8 @@ void AutomationClip::resetNodes(const int tick0, const int tick1)
 
 void AutomationClip::resetTangents(const int tick0, const int tick1)
 {
+	QMutexLocker m(&m_clipMutex);
+
 	if (tick0 == tick1)
 	{
 		auto it = m_timeMap.find(TimePos(tick0));
@@ -422,11 +451,13 @@ void AutomationClip::resetTangents(const int tick0, const int tick1)
 	TimePos start = TimePos(std::min(tick0, tick1));
 	TimePos end = TimePos(std::max(tick0, tick1));
 
+	beginCurveEdit();
 	for (auto it = m_timeMap.lowerBound(start), endIt = m_timeMap.upperBound(end); it != endIt; ++it)
 	{
 		it.value().setLockedTangents(false);
 		generateTangents(it, 1);
 	}
+	endCurveEdit();
 }
 
 
@@ -469,6 +500,9 @@ TimePos AutomationClip::setDragValue(
 {
 	QMutexLocker m(&m_clipMutex);
 
+	// The node is removed and put back, only the result is compiled
+	beginCurveEdit();
+
 	if (m_dragging == false)
 	{
 		TimePos newTime = quantPos ? Note::quantized(time, quantization()) : time;
@@ -538,6 +572,8 @@ TimePos AutomationClip::setDragValue(
 		}
 	}
 
+	endCurveEdit();
+
 	return returnedPos;
 }
 
@@ -558,40 +594,177 @@ void AutomationClip::applyDragValue()
 
 
 float AutomationClip::valueAt( const TimePos & _time ) const
+{
+	return valueAt(static_cast<float>(_time.getTicks()));
+}
+
+
+
+
+float AutomationClip::valueAt(float ticks) const
+{
+	// Counted before loading the curve, so an update can't free it while we read it
+	m_curveReaders.fetch_add(1);
+	const auto curve = m_curve.load();
+	const float value = curve ? curveValueAt(*curve, ticks) : 0.f;
+	m_curveReaders.fetch_sub(1, std::memory_order_release);
+
+	return value;
+}
+
+
+
+
+void AutomationClip::valuesAt(float ticks, float step, float end, std::span<float> out) const
+{
+	m_curveReaders.fetch_add(1);
+	const auto curve = m_curve.load();
+	for (std::size_t i = 0; i < out.size(); ++i)
+	{
+		out[i] = curve ? curveValueAt(*curve, std::min(ticks + step * i, end)) : 0.f;
+	}
+	m_curveReaders.fetch_sub(1, std::memory_order_release);
+}
+
+
+
+
+void AutomationClip::invalidateCurve()
+{
+	QMutexLocker m(&m_clipMutex);
+
+	m_curveDirty = true;
+	if (m_curveEdits == 0) { updateCurve(); }
+}
+
+
+
+
+void AutomationClip::beginCurveEdit()
+{
+	QMutexLocker m(&m_clipMutex);
+
+	++m_curveEdits;
+}
+
+
+
+
+void AutomationClip::endCurveEdit()
 {
 	QMutexLocker m(&m_clipMutex);
 
-	if( m_timeMap.isEmpty() )
+	if (--m_curveEdits == 0 && m_curveDirty) { updateCurve(); }
+}
+
+
+
+
+void AutomationClip::updateCurve()
+{
+	QMutexLocker m(&m_clipMutex);
+
+	auto curve = new CompiledCurve{{}, m_progressionType};
+	curve->points.reserve(m_timeMap.size());
+
+	for (auto it = m_timeMap.begin(); it != m_timeMap.end(); ++it)
 	{
-		return 0;
+		auto point = CurvePoint{
+			static_cast<float>(POS(it)), INVAL(it), OUTVAL(it), 0.f, 0.f, 0.f, 0.f, 0.f
+		};
+
+		// Computed like the old per-value code did, so the results don't change
+		const auto nit = std::next(it);
+		if (nit != m_timeMap.end())
+		{
+			const int numValues = POS(nit) - POS(it);
+			point.length = static_cast<float>(numValues);
+			point.slope = (INVAL(nit) - OUTVAL(it)) / numValues;
+			point.nextInValue = INVAL(nit);
+			point.outTangent = OUTTAN(it) * numValues * m_tension;
+			point.nextInTangent = INTAN(nit) * numValues * m_tension;
+		}
+		curve->points.push_back(point);
 	}
 
-	// If we have a node at that time, just return its value
-	if (m_timeMap.contains(_time))
+	if (const auto old = m_curve.exchange(curve))
 	{
-		// When the time is exactly the node's time, we want the inValue
-		return m_timeMap[_time].getInValue();
+		m_retiredCurves.push_back(old);
 	}
+	m_curveDirty = false;
 
-	// lowerBound returns next value with equal or greater key. Since we already
-	// checked if the key contains a node, we know the returned node has a greater
-	// key than _time. Therefore we take the previous element to calculate the current value
-	timeMap::const_iterator v = m_timeMap.lowerBound(_time);
+	freeRetiredCurves();
+}
+
+
+
+
+void AutomationClip::freeRetiredCurves()
+{
+	QMutexLocker m(&m_clipMutex);
+
+	// A lookup that started before the exchange might still read a retired
+	// curve. Once no lookup is running, new ones only see the current curve.
+	if (m_curveReaders.load() != 0) { return; }
 
-	if( v == m_timeMap.begin() )
+	for (const auto curve : m_retiredCurves) { delete curve; }
+	m_retiredCurves.clear();
+}
+
+
+
+
+float AutomationClip::curveValueAt(const CompiledCurve& curve, float ticks) const
+{
+	const auto& points = curve.points;
+	if (points.empty() || ticks < points.front().pos)
 	{
 		return 0;
 	}
 
-	const auto pv = std::prev(v);
-
-	if( v == m_timeMap.end() )
+	// Playback asks for increasing positions, so the point we need is usually
+	// the last one or the one after it. The hint may be left over from
+	// another curve or racing lookup, it only has to be in range.
+	auto i = std::min(m_curveHint.load(std::memory_order_relaxed), points.size() - 1);
+	if (points[i].pos > ticks || (i + 2 < points.size() && points[i + 2].pos <= ticks))
+	{
+		const auto it = std::upper_bound(points.begin(), points.end(), ticks,
+			[](float t, const CurvePoint& point) { return t < point.pos; });
+		i = static_cast<std::size_t>(it - points.begin()) - 1;
+	}
+	else if (i + 1 < points.size() && points[i + 1].pos <= ticks)
 	{
-		// When the time is after the last node, we want the outValue of it
-		return OUTVAL(pv);
+		++i;
 	}
+	m_curveHint.store(i, std::memory_order_relaxed);
+
+	const auto& point = points[i];
+
+	// When the time is exactly the node's time, we want the inValue
+	if (ticks == point.pos) { return point.inValue; }
+
+	// When the time is after the last node, we want the outValue of it
+	if (point.length == 0.f) { return point.outValue; }
 
-	return valueAt(pv, _time - POS(pv));
+	const float offset = ticks - point.pos;
+	switch (curve.type)
+	{
+	case ProgressionType::Discrete:
+		return point.outValue;
+	case ProgressionType::Linear:
+		return point.outValue + offset * point.slope;
+	case ProgressionType::CubicHermite:
+	default:
+	{
+		// See valueAt(timeMap::const_iterator, int) for how this works
+		const float t = offset / point.length;
+		const float t2 = t * t, t3 = t2 * t;
+		return (2 * t3 - 3 * t2 + 1) * point.outValue
+			+ (t3 - 2 * t2 + t) * point.outTangent
+			+ (-2 * t3 + 3 * t2) * point.nextInValue
+			+ (t3 - t2) * point.nextInTangent;
+	}
+	}
 }
 
 
@@ -680,6 +853,7 @@ void AutomationClip::flipY(int min, int max)
 
 	bool changedTimeMap = false;
 
+	beginCurveEdit();
 	for (auto it = m_timeMap.begin(); it != m_timeMap.end(); ++it)
 	{
 		// Get distance from IN/OUT values to max value
@@ -697,6 +871,11 @@ void AutomationClip::flipY(int min, int max)
 	if (changedTimeMap)
 	{
 		generateTangents();
+	}
+	endCurveEdit();
+
+	if (changedTimeMap)
+	{
 		emit dataChanged();
 	}
 }
@@ -831,6 +1010,9 @@ void AutomationClip::loadSettings( const QDomElement & _this )
 {
 	QMutexLocker m(&m_clipMutex);
 
+	// Compiled once all nodes are loaded
+	beginCurveEdit();
+
 	// Legacy compatibility: Previously tangents were not stored in
 	// the project file. So if any node doesn't have tangent information
 	// we will generate the tangents
@@ -902,6 +1084,8 @@ void AutomationClip::loadSettings( const QDomElement & _this )
 	}
 
 	if (shouldGenerateTangents) { generateTangents(); }
+	invalidateCurve();
+	endCurveEdit();
 }
 
 
@@ -1086,6 +1270,7 @@ void AutomationClip::clear()
 	QMutexLocker m(&m_clipMutex);
 
 	m_timeMap.clear();
+	invalidateCurve();
 
 	emit dataChanged();
 }
@@ -1156,6 +1341,10 @@ void AutomationClip::generateTangents(timeMap::iterator it, int numToGenerate)
 {
 	QMutexLocker m(&m_clipMutex);
 
+	// Every edit of the nodes ends up here. Setting the tangents doesn't
+	// compile the curve for each node, only the result is.
+	beginCurveEdit();
+
 	for (int i = 0; i < numToGenerate && it != m_timeMap.end(); ++i, ++it)
 	{
 		// Skip the node if it has locked tangents (were manually edited)
@@ -1211,6 +1400,9 @@ void AutomationClip::generateTangents(timeMap::iterator it, int numToGenerate)
 			}
 		}
 	}
+
+	invalidateCurve();
+	endCurveEdit();
 }
 
 std::vector<Track*> AutomationClip::combineAllTracks()
@@ -104,6 +104,19 @@ void AutomationNode::setOutValue(float value)
 	m_clip->generateTangents(it, 3);
 }
 
+// The tangents shape the curve, so the clip has to compile it again
+void AutomationNode::setInTangent(float tangent)
+{
+	m_inTangent = tangent;
+	if (m_clip) { m_clip->invalidateCurve(); }
+}
+
+void AutomationNode::setOutTangent(float tangent)
+{
+	m_outTangent = tangent;
+	if (m_clip) { m_clip->invalidateCurve(); }
+}
+
 /**
  * @brief Resets the outValue so it matches inValue
 */
@@ -26,6 +26,9 @@
 
 #include "BufferManager.h"
 
+#include <memory>
+
+#include "lmms_constants.h"
 #include "SampleFrame.h"
 
 
@@ -33,23 +36,50 @@ namespace lmms
 {
 
 f_cnt_t BufferManager::s_framesPerPeriod;
+std::unique_ptr<LocklessPool> BufferManager::s_pool;
 
 void BufferManager::init( f_cnt_t fpp )
 {
 	s_framesPerPeriod = fpp;
+	s_pool = std::make_unique<LocklessPool>( sizeof( SampleFrame ) * fpp, ChunkSize, AudioBufferAlignment );
+	reserve( InitialCapacity );
 }
 
 
 SampleFrame* BufferManager::acquire()
 {
-	return new SampleFrame[s_framesPerPeriod];
+	auto frames = static_cast<SampleFrame*>( s_pool->alloc() );
+	std::uninitialized_default_construct_n( frames, s_framesPerPeriod );
+	return frames;
 }
 
 
 
 void BufferManager::release( SampleFrame* buf )
 {
-	delete[] buf;
+	// SampleFrame is trivially destructible, no need to call destructors
+	s_pool->free( buf );
+}
+
+
+
+void BufferManager::reserve( std::size_t count )
+{
+	s_pool->reserve( count );
+}
+
+
+
+void BufferManager::refill()
+{
+	s_pool->refill();
+}
+
+
+
+BufferManager::Statistics BufferManager::statistics()
+{
+	return s_pool->statistics();
 }
 
 } // namespace lmms
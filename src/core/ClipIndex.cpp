@@ -0,0 +1,222 @@
+/*
+ * ClipIndex.cpp - interval index over the clips of a track
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "ClipIndex.h"
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+
+#include "Clip.h"
+
+namespace lmms
+{
+
+namespace
+{
+
+constexpr auto NoEnd = std::numeric_limits<tick_t>::min();
+
+std::size_t leavesFor(std::size_t clips)
+{
+	return std::bit_ceil(std::max(clips, std::size_t{1}));
+}
+
+} // namespace
+
+
+
+
+ClipIndex::~ClipIndex()
+{
+	delete m_snapshot.load();
+	for (const auto snapshot : m_retired) { delete snapshot; }
+}
+
+
+
+
+void ClipIndex::update(const std::vector<Clip*>& clips)
+{
+	const auto lock = std::lock_guard{m_updateMutex};
+	if (!m_dirty.load(std::memory_order_acquire)) { return; }
+
+	const auto old = m_snapshot.exchange(new Snapshot{clips, ++m_generation});
+	m_dirty.store(false, std::memory_order_release);
+
+	if (old) { m_retired.push_back(old); }
+	freeRetired();
+}
+
+
+
+
+void ClipIndex::freeRetired()
+{
+	// a query that starts after this check loads the new snapshot, because
+	// both the counter and the pointer are sequentially consistent
+	if (m_readers.load() != 0) { return; }
+	for (const auto snapshot : m_retired) { delete snapshot; }
+	m_retired.clear();
+}
+
+
+
+
+void ClipIndex::clipsInRange(const std::vector<Clip*>& clips, std::vector<Clip*>& out, tick_t start, tick_t end,
+	Cursor* cursor) const
+{
+	if (m_dirty.load(std::memory_order_acquire))
+	{
+		for (Clip* clip : clips)
+		{
+			if (clip->startPosition() <= end && clip->endPosition() >= start) { addClip(clip, out); }
+		}
+		return;
+	}
+
+	m_readers.fetch_add(1);
+	const Snapshot* snapshot = m_snapshot.load();
+
+	if (cursor)
+	{
+		// during playback each range starts right where the last one ended,
+		// allow for one tick lost to rounding
+		if (cursor->m_generation == snapshot->generation && start >= cursor->m_start
+			&& end >= cursor->m_end && start <= cursor->m_end + 1)
+		{
+			snapshot->advance(*cursor, start, end);
+		}
+		else
+		{
+			snapshot->seek(*cursor, start, end);
+		}
+		for (const auto index : cursor->m_active) { addClip(snapshot->entries[index].clip, out); }
+	}
+	else
+	{
+		snapshot->collect([&](std::size_t index) { addClip(snapshot->entries[index].clip, out); },
+			1, 0, snapshot->leaves, snapshot->upperBound(end), start);
+	}
+
+	m_readers.fetch_sub(1, std::memory_order_release);
+}
+
+
+
+
+void ClipIndex::addClip(Clip* clip, std::vector<Clip*>& out)
+{
+	if (out.empty() || !Clip::comparePosition(clip, out.back())) { out.push_back(clip); }
+	else { out.insert(std::upper_bound(out.begin(), out.end(), clip, Clip::comparePosition), clip); }
+}
+
+
+
+
+ClipIndex::Snapshot::Snapshot(const std::vector<Clip*>& clips, std::uint64_t generation) :
+	generation{generation},
+	leaves{leavesFor(clips.size())}
+{
+	entries.reserve(clips.size());
+	for (std::size_t i = 0; i < clips.size(); ++i)
+	{
+		const Clip* clip = clips[i];
+		entries.push_back({clip->startPosition(), clip->endPosition(), i, clips[i]});
+	}
+	std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+		return a.start != b.start ? a.start < b.start : a.order < b.order;
+	});
+
+	maxEnd.assign(2 * leaves, NoEnd);
+	for (std::size_t i = 0; i < entries.size(); ++i)
+	{
+		maxEnd[leaves + i] = entries[i].end;
+	}
+	for (std::size_t node = leaves - 1; node > 0; --node)
+	{
+		maxEnd[node] = std::max(maxEnd[2 * node], maxEnd[2 * node + 1]);
+	}
+}
+
+
+
+
+void ClipIndex::Snapshot::seek(Cursor& cursor, tick_t start, tick_t end) const
+{
+	cursor.m_active.clear();
+	const auto limit = upperBound(end);
+	collect([&](std::size_t index) { cursor.m_active.push_back(index); }, 1, 0, leaves, limit, start);
+
+	cursor.m_generation = generation;
+	cursor.m_start = start;
+	cursor.m_end = end;
+	cursor.m_next = limit;
+}
+
+
+
+
+void ClipIndex::Snapshot::advance(Cursor& cursor, tick_t start, tick_t end) const
+{
+	std::erase_if(cursor.m_active, [&](std::size_t index) { return entries[index].end < start; });
+
+	for (; cursor.m_next < entries.size() && entries[cursor.m_next].start <= end; ++cursor.m_next)
+	{
+		// clips shorter than the gap between two ranges are skipped entirely
+		if (entries[cursor.m_next].end >= start) { cursor.m_active.push_back(cursor.m_next); }
+	}
+
+	cursor.m_start = start;
+	cursor.m_end = end;
+}
+
+
+
+
+template<typename Visitor>
+void ClipIndex::Snapshot::collect(Visitor&& visit, std::size_t node, std::size_t first,
+	std::size_t last, std::size_t limit, tick_t start) const
+{
+	if (first >= limit || maxEnd[node] < start) { return; }
+	if (last - first == 1)
+	{
+		visit(first);
+		return;
+	}
+	const auto middle = first + (last - first) / 2;
+	collect(visit, 2 * node, first, middle, limit, start);
+	collect(visit, 2 * node + 1, middle, last, limit, start);
+}
+
+
+
+
+std::size_t ClipIndex::Snapshot::upperBound(tick_t time) const
+{
+	const auto it = std::upper_bound(entries.begin(), entries.end(), time,
+		[](tick_t t, const Entry& entry) { return t < entry.start; });
+	return static_cast<std::size_t>(it - entries.begin());
+}
+
+
+} // namespace lmms
@@ -2202,7 +2202,12 @@ void DataFile::loadData( const QByteArray & _data, const QString & _sourceFile )
 	}
 
 	// Perform upgrade routines
-	if (m_fileVersion < UPGRADE_METHODS.size()) { upgrade(); }
+	if (m_fileVersion < UPGRADE_METHODS.size())
+	{
+		const auto upgradeStart = std::chrono::steady_clock::now();
+		upgrade();
+		m_upgradeTime = std::chrono::steady_clock::now() - upgradeStart;
+	}
 
 	m_content = root.elementsByTagName(typeName(m_type)).item(0).toElement();
 }
@@ -26,12 +26,15 @@
 #include "Effect.h"
 
 #include <QDomElement>
+#include <algorithm>
+#include <cmath>
 
 #include "AudioBuffer.h"
 #include "ConfigManager.h"
 #include "EffectChain.h"
 #include "EffectControls.h"
 #include "EffectView.h"
+#include "MixHelpers.h"
 #include "SampleFrame.h"
 
 namespace lmms
@@ -92,17 +95,16 @@ void Effect::loadSettings( const QDomElement & _this )
 
 
 
-bool Effect::processAudioBuffer(AudioBuffer& inOut)
+bool Effect::processAudioBuffer(AudioBuffer& inOut, bool& silent)
 {
 	if (!isAwake())
 	{
-		if (!inOut.hasSignal(0b11))
+		if (silent)
 		{
-			// Sleeping plugins need to zero any track channels their output is routed to in order to
+			// Sleeping plugins need to leave any track channels their output is routed to silent in order to
 			// prevent sudden track channel passthrough behavior when the plugin is put to sleep.
 			// Otherwise auto-quit could become audibly noticeable, which is not intended.
-
-			inOut.silenceChannels(0b11);
+			// Silent channels are zero already.
 
 			return false;
 		}
@@ -117,23 +119,23 @@ bool Effect::processAudioBuffer(AudioBuffer& inOut)
 		return false;
 	}
 
-	const auto status = processImpl(inOut.interleavedBuffer().asSampleFrames().data(), inOut.frames());
-
-	// Copy interleaved plugin output to planar
-	toPlanar(inOut.interleavedBuffer(), inOut.groupBuffers(0));
+	const auto buffer = inOut.interleavedBuffer().asSampleFrames();
+	const auto status = processImpl(buffer.data(), inOut.frames());
 
-	const auto sanitized = Engine::audioEngine()->sanitizationEnabled() ? inOut.sanitize(0b11) : false;
+	const auto sanitized = Engine::audioEngine()->sanitizationEnabled() ? sanitizeChannels(buffer) : false;
 	m_corrupted.store(sanitized, std::memory_order_relaxed);
 
-	// Update silence status for track channels the processor wrote to
-	const bool silentOutput = inOut.updateSilenceFlags(0b11);
+	// Update silence status for track channels the processor wrote to. A silent
+	// buffer is exactly zero, so any residue below the threshold is flushed.
+	silent = inOut.silenceTrackingEnabled() && MixHelpers::isSilent(buffer.data(), inOut.frames());
+	if (silent) { zeroSampleFrames(buffer.data(), buffer.size()); }
 
 	switch (status)
 	{
 		case ProcessStatus::Continue:
 			break;
 		case ProcessStatus::ContinueIfNotQuiet:
-			handleAutoQuit(silentOutput);
+			handleAutoQuit(silent);
 			break;
 		case ProcessStatus::Sleep:
 			goToSleep();
@@ -148,6 +150,24 @@ bool Effect::processAudioBuffer(AudioBuffer& inOut)
 
 
 
+bool Effect::sanitizeChannels(std::span<SampleFrame> buffer)
+{
+	bool changesMade = false;
+	for (ch_cnt_t ch = 0; ch < DEFAULT_CHANNELS; ++ch)
+	{
+		if (std::ranges::any_of(buffer, [ch](const SampleFrame& frame) { return !std::isfinite(frame[ch]); }))
+		{
+			// Inf/NaN detected and channel cleared
+			for (auto& frame : buffer) { frame[ch] = 0.f; }
+			changesMade = true;
+		}
+	}
+	return changesMade;
+}
+
+
+
+
 Effect * Effect::instantiate( const QString& pluginName,
 				Model * _parent,
 				Descriptor::SubPluginFeatures::Key * _key )
@@ -26,6 +26,7 @@
 #include "EffectChain.h"
 
 #include <QDomElement>
+#include <algorithm>
 #include <cassert>
 
 #include "AudioBuffer.h"
@@ -191,12 +192,27 @@ bool EffectChain::processAudioBuffer(AudioBuffer& buffer)
 		return false;
 	}
 
+	// Sleeping effects would only silence their outputs, which are silent already
+	if (!buffer.hasAnySignal()
+		&& std::none_of(m_effects.begin(), m_effects.end(), [](const Effect* e) { return e->isAwake(); }))
+	{
+		return false;
+	}
+
+	// Effect plugins process interleaved audio, so the main channels are
+	// converted once for the whole chain. The rest of the signal path is planar.
+	toInterleaved(buffer.groupBuffers(0), buffer.interleavedBuffer());
+
+	bool silent = !buffer.hasSignal(0b11);
 	bool moreEffects = false;
 	for (Effect* effect : m_effects)
 	{
-		moreEffects |= effect->processAudioBuffer(buffer);
+		moreEffects |= effect->processAudioBuffer(buffer, silent);
 	}
 
+	toPlanar(buffer.interleavedBuffer(), buffer.groupBuffers(0));
+	buffer.updateSilenceFlags(0b11);
+
 	return moreEffects;
 }
 
@@ -0,0 +1,133 @@
+/*
+ * EncoderThread.cpp - writes rendered audio to a file device on its own thread
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "EncoderThread.h"
+
+#include <algorithm>
+
+#include "AudioEngine.h"
+#include "AudioFileDevice.h"
+
+namespace lmms
+{
+
+EncoderThread::EncoderThread(AudioFileDevice* fileDev) :
+	m_fileDev(fileDev)
+{
+	for (auto& block : m_blocks) { block.frames.resize(MAXIMUM_BUFFER_SIZE); }
+}
+
+
+
+
+void EncoderThread::write(const SampleFrame* frames, f_cnt_t count)
+{
+	while (count > 0)
+	{
+		auto& block = m_blocks[m_writeIndex % BlockCount];
+		const auto n = std::min<f_cnt_t>(count, MAXIMUM_BUFFER_SIZE - block.size);
+		std::copy_n(frames, n, block.frames.begin() + block.size);
+		block.size += n;
+		frames += n;
+		count -= n;
+
+		if (block.size == MAXIMUM_BUFFER_SIZE) { submit(); }
+	}
+}
+
+
+
+
+void EncoderThread::writeSilence(f_cnt_t count)
+{
+	while (count > 0)
+	{
+		auto& block = m_blocks[m_writeIndex % BlockCount];
+		const auto n = std::min<f_cnt_t>(count, MAXIMUM_BUFFER_SIZE - block.size);
+		std::fill_n(block.frames.begin() + block.size, n, SampleFrame{});
+		block.size += n;
+		count -= n;
+
+		if (block.size == MAXIMUM_BUFFER_SIZE) { submit(); }
+	}
+}
+
+
+
+
+void EncoderThread::finish()
+{
+	if (m_blocks[m_writeIndex % BlockCount].size > 0) { submit(); }
+
+	m_mutex.lock();
+	m_done = true;
+	m_blockReady.wakeOne();
+	m_mutex.unlock();
+
+	wait();
+}
+
+
+
+
+void EncoderThread::submit()
+{
+	m_mutex.lock();
+	++m_writeIndex;
+	m_blockReady.wakeOne();
+	while (m_writeIndex - m_readIndex == BlockCount)
+	{
+		m_blockFree.wait(&m_mutex);
+	}
+	m_mutex.unlock();
+
+	// the encoder is done with this block
+	m_blocks[m_writeIndex % BlockCount].size = 0;
+}
+
+
+
+
+void EncoderThread::run()
+{
+	while (true)
+	{
+		m_mutex.lock();
+		while (m_readIndex == m_writeIndex && !m_done)
+		{
+			m_blockReady.wait(&m_mutex);
+		}
+		const bool finished = m_readIndex == m_writeIndex;
+		m_mutex.unlock();
+		if (finished) { break; }
+
+		const auto& block = m_blocks[m_readIndex % BlockCount];
+		m_fileDev->writeBuffer(block.frames.data(), block.size);
+
+		m_mutex.lock();
+		++m_readIndex;
+		m_blockFree.wakeOne();
+		m_mutex.unlock();
+	}
+}
+
+} // namespace lmms
@@ -27,12 +27,14 @@
 #include "AudioEngine.h"
 #include "ConfigManager.h"
 #include "Mixer.h"
+#include "MixKernels.h"
 #include "Ladspa2LMMS.h"
 #include "Lv2Manager.h"
 #include "PatternStore.h"
 #include "Plugin.h"
 #include "PresetPreviewPlayHandle.h"
 #include "ProjectJournal.h"
+#include "RemotePluginPool.h"
 #include "Song.h"
 #include "BandLimitedWave.h"
 #include "Oscillator.h"
@@ -50,6 +52,7 @@ ProjectJournal * Engine::s_projectJournal = nullptr;
 Lv2Manager * Engine::s_lv2Manager = nullptr;
 #endif
 Ladspa2LMMS * Engine::s_ladspaManager = nullptr;
+RemotePluginPool * Engine::s_remotePluginPool = nullptr;
 void* Engine::s_dndPluginKey = nullptr;
 
 
@@ -64,6 +67,8 @@ void Engine::init( bool renderOnly )
 	BandLimitedWave::generateWaves();
 	//initialize oscillators
 	Oscillator::waveTableInit();
+	// pick the mixing kernels before anything is rendered
+	MixKernels::best();
 
 	emit engine->initProgress(tr("Initializing data structures"));
 	s_projectJournal = new ProjectJournal;
@@ -77,6 +82,7 @@ void Engine::init( bool renderOnly )
 	s_lv2Manager->initPlugins();
 #endif
 	s_ladspaManager = new Ladspa2LMMS;
+	s_remotePluginPool = new RemotePluginPool;
 
 	s_projectJournal->setJournalling( true );
 
@@ -101,6 +107,8 @@ void Engine::destroy()
 
 	s_song->clearProject();
 
+	deleteHelper( &s_remotePluginPool );
+
 	deleteHelper( &s_patternStore );
 
 	deleteHelper( &s_mixer );
@@ -74,5 +74,11 @@ bool InstrumentPlayHandle::isFromTrack(const Track* track) const
 	return m_instrument->isFromTrack(track);
 }
 
+QString InstrumentPlayHandle::profilerName() const
+{
+	const auto track = m_instrument->instrumentTrack();
+	return QString("%1 (%2)").arg(track->name(), track->instrumentName());
+}
+
 
 } // namespace lmms
@@ -37,6 +37,17 @@ namespace lmms
 {
 
 
+SoundShapingNoteState::SoundShapingNoteState( sample_rate_t sampleRate, f_cnt_t framesPerPeriod ) :
+	filter( sampleRate ),
+	cutoff( framesPerPeriod ),
+	resonance( framesPerPeriod ),
+	volume( framesPerPeriod )
+{
+}
+
+
+
+
 const float CUT_FREQ_MULTIPLIER = 6000.0f;
 const float RES_MULTIPLIER = 2.0f;
 const float RES_PRECISION = 1000.0f;
@@ -107,7 +118,8 @@ float InstrumentSoundShaping::volumeLevel( NotePlayHandle* n, const f_cnt_t fram
 
 void InstrumentSoundShaping::processAudioBuffer( SampleFrame* buffer,
 							const f_cnt_t frames,
-							NotePlayHandle* n )
+							NotePlayHandle* n,
+							const StereoVolumeVector& gain )
 {
 	const f_cnt_t envTotalFrames = n->totalFramesPlayed();
 	f_cnt_t envReleaseBegin = envTotalFrames - n->releaseFramesDone() + n->framesBeforeRelease();
@@ -118,139 +130,154 @@ void InstrumentSoundShaping::processAudioBuffer( SampleFrame* buffer,
 		envReleaseBegin += frames;
 	}
 
-	// because of optimizations, there's special code for several cases:
-	// 	- cut- and res-lfo/envelope active
-	// 	- cut-lfo/envelope active
-	// 	- res-lfo/envelope active
-	//	- no lfo/envelope active but filter is used
+	auto& volumeParameters = getVolumeParameters();
 
 	// only use filter, if it is really needed
+	if( !m_filterEnabledModel.value() )
+	{
+		if (volumeParameters.isUsed())
+		{
+			QVarLengthArray<float> volBuffer(frames);
+			volumeParameters.fillLevel(volBuffer.data(), envTotalFrames, envReleaseBegin, frames);
+			applyVolumeAndGain( buffer, frames, volBuffer.data(), gain );
+		}
+		else
+		{
+			applyVolumeAndGain( buffer, frames, nullptr, gain );
+		}
+		return;
+	}
+
+	if( n->m_soundShaping == nullptr )
+	{
+		n->m_soundShaping = std::make_unique<SoundShapingNoteState>(
+			Engine::audioEngine()->outputSampleRate(), Engine::audioEngine()->framesPerPeriod() );
+	}
+	SoundShapingNoteState& state = *n->m_soundShaping;
+	if( state.cutoff.size() < static_cast<std::size_t>( frames ) )
+	{
+		state.cutoff.resize( frames );
+		state.resonance.resize( frames );
+		state.volume.resize( frames );
+	}
+	state.filter.setFilterType( static_cast<BasicFilters<>::FilterType>(m_filterModel.value()) );
 
 	auto& cutoffParameters = getCutoffParameters();
 	auto& resonanceParameters = getResonanceParameters();
+	const bool cutUsed = cutoffParameters.isUsed();
+	const bool resUsed = resonanceParameters.isUsed();
 
-	if( m_filterEnabledModel.value() )
+	if (cutUsed)
 	{
-		QVarLengthArray<float> cutBuffer(frames);
-		QVarLengthArray<float> resBuffer(frames);
-
-		int old_filter_cut = 0;
-		int old_filter_res = 0;
+		cutoffParameters.fillLevel(state.cutoff.data(), envTotalFrames, envReleaseBegin, frames);
+	}
 
-		if( n->m_filter == nullptr )
-		{
-			n->m_filter = std::make_unique<BasicFilters<>>( Engine::audioEngine()->outputSampleRate() );
-		}
-		n->m_filter->setFilterType( static_cast<BasicFilters<>::FilterType>(m_filterModel.value()) );
+	if (resUsed)
+	{
+		resonanceParameters.fillLevel(state.resonance.data(), envTotalFrames, envReleaseBegin, frames);
+	}
 
-		if (cutoffParameters.isUsed())
+	// the coefficients are only recalculated when the rounded cutoff or
+	// resonance changes, in between the values of that frame are held
+	const float fcv = m_filterCutModel.value();
+	const float frv = m_filterResModel.value();
+	int old_filter_cut = 0;
+	int old_filter_res = 0;
+	float cut = fcv;
+	float res = frv;
+	for( f_cnt_t frame = 0; frame < frames; ++frame )
+	{
+		const float new_cut_val = cutUsed
+			? EnvelopeAndLfoParameters::expKnobVal( state.cutoff[frame] ) * CUT_FREQ_MULTIPLIER + fcv
+			: fcv;
+		const float new_res_val = resUsed ? frv + RES_MULTIPLIER * state.resonance[frame] : frv;
+
+		if( frame == 0 ||
+			static_cast<int>( new_cut_val ) != old_filter_cut ||
+			static_cast<int>( new_res_val*RES_PRECISION ) != old_filter_res )
 		{
-			cutoffParameters.fillLevel(cutBuffer.data(), envTotalFrames, envReleaseBegin, frames);
+			cut = new_cut_val;
+			res = new_res_val;
+			old_filter_cut = static_cast<int>( new_cut_val );
+			old_filter_res = static_cast<int>( new_res_val*RES_PRECISION );
 		}
+		state.cutoff[frame] = cut;
+		state.resonance[frame] = res;
+	}
 
-		if (resonanceParameters.isUsed())
-		{
-			resonanceParameters.fillLevel(resBuffer.data(), envTotalFrames, envReleaseBegin, frames);
-		}
+	state.useVolume = volumeParameters.isUsed();
+	if( state.useVolume )
+	{
+		volumeParameters.fillLevel(state.volume.data(), envTotalFrames, envReleaseBegin, frames);
+	}
+	state.buffer = buffer;
+	state.frames = frames;
+	state.gain = gain;
 
-		const float fcv = m_filterCutModel.value();
-		const float frv = m_filterResModel.value();
+	const std::size_t slot = m_bankedNoteCount.fetch_add( 1, std::memory_order_relaxed );
+	if( slot < MaxBankedNotes )
+	{
+		m_bankedNotes[slot] = n;
+		return;
+	}
 
-		if (cutoffParameters.isUsed() && resonanceParameters.isUsed())
-		{
-			for( f_cnt_t frame = 0; frame < frames; ++frame )
-			{
-				const float new_cut_val = EnvelopeAndLfoParameters::expKnobVal( cutBuffer[frame] ) *
-								CUT_FREQ_MULTIPLIER + fcv;
+	// the bank is full, so this note is filtered on its own right away
+	BasicFilterBank<>::process( BasicFilterBank<>::Voice{ &state.filter, buffer->data(), frames, state.cutoff.data(), state.resonance.data() } );
+	applyVolumeAndGain( buffer, frames, state.useVolume ? state.volume.data() : nullptr, gain );
+}
 
-				const float new_res_val = frv + RES_MULTIPLIER * resBuffer[frame];
 
-				if( static_cast<int>( new_cut_val ) != old_filter_cut ||
-					static_cast<int>( new_res_val*RES_PRECISION ) != old_filter_res )
-				{
-					n->m_filter->calcFilterCoeffs( new_cut_val, new_res_val );
-					old_filter_cut = static_cast<int>( new_cut_val );
-					old_filter_res = static_cast<int>( new_res_val*RES_PRECISION );
-				}
 
-				buffer[frame][0] = n->m_filter->update( buffer[frame][0], 0 );
-				buffer[frame][1] = n->m_filter->update( buffer[frame][1], 1 );
-			}
-		}
-		else if (cutoffParameters.isUsed())
-		{
-			for( f_cnt_t frame = 0; frame < frames; ++frame )
-			{
-				float new_cut_val = EnvelopeAndLfoParameters::expKnobVal( cutBuffer[frame] ) *
-								CUT_FREQ_MULTIPLIER + fcv;
 
-				if( static_cast<int>( new_cut_val ) != old_filter_cut )
-				{
-					n->m_filter->calcFilterCoeffs( new_cut_val, frv );
-					old_filter_cut = static_cast<int>( new_cut_val );
-				}
+void InstrumentSoundShaping::processVoices()
+{
+	const std::size_t count = std::min( m_bankedNoteCount.exchange( 0, std::memory_order_relaxed ), MaxBankedNotes );
+	if( count == 0 )
+	{
+		return;
+	}
 
-				buffer[frame][0] = n->m_filter->update( buffer[frame][0], 0 );
-				buffer[frame][1] = n->m_filter->update( buffer[frame][1], 1 );
-			}
-		}
-		else if(resonanceParameters.isUsed() )
-		{
-			for( f_cnt_t frame = 0; frame < frames; ++frame )
-			{
-				float new_res_val = frv + RES_MULTIPLIER * resBuffer[frame];
+	for( std::size_t i = 0; i < count; ++i )
+	{
+		SoundShapingNoteState& state = *m_bankedNotes[i]->m_soundShaping;
+		m_voices[i] = { &state.filter, state.buffer->data(), state.frames, state.cutoff.data(), state.resonance.data() };
+	}
+	m_filterBank.process( std::span{ m_voices.data(), count } );
 
-				if( static_cast<int>( new_res_val*RES_PRECISION ) != old_filter_res )
-				{
-					n->m_filter->calcFilterCoeffs( fcv, new_res_val );
-					old_filter_res = static_cast<int>( new_res_val*RES_PRECISION );
-				}
+	for( std::size_t i = 0; i < count; ++i )
+	{
+		NotePlayHandle* n = m_bankedNotes[i];
+		const SoundShapingNoteState& state = *n->m_soundShaping;
+		applyVolumeAndGain( state.buffer, state.frames, state.useVolume ? state.volume.data() : nullptr, state.gain );
+		// filters ring on after their input became silent
+		n->updateBufferSilence();
+	}
+}
 
-				buffer[frame][0] = n->m_filter->update( buffer[frame][0], 0 );
-				buffer[frame][1] = n->m_filter->update( buffer[frame][1], 1 );
-			}
-		}
-		else
-		{
-			n->m_filter->calcFilterCoeffs( fcv, frv );
 
-			for( f_cnt_t frame = 0; frame < frames; ++frame )
-			{
-				buffer[frame][0] = n->m_filter->update( buffer[frame][0], 0 );
-				buffer[frame][1] = n->m_filter->update( buffer[frame][1], 1 );
-			}
-		}
-	}
 
-	auto& volumeParameters = getVolumeParameters();
 
-	if (volumeParameters.isUsed())
+void InstrumentSoundShaping::applyVolumeAndGain( SampleFrame* buffer, f_cnt_t frames, const float* volume,
+	const StereoVolumeVector& gain )
+{
+	if( volume != nullptr )
 	{
-		QVarLengthArray<float> volBuffer(frames);
-		volumeParameters.fillLevel(volBuffer.data(), envTotalFrames, envReleaseBegin, frames);
-
 		for( f_cnt_t frame = 0; frame < frames; ++frame )
 		{
-			float vol_level = volBuffer[frame];
+			float vol_level = volume[frame];
 			vol_level = vol_level * vol_level;
 			buffer[frame][0] = vol_level * buffer[frame][0];
 			buffer[frame][1] = vol_level * buffer[frame][1];
 		}
 	}
 
-/*	else if( m_envLfoParameters[static_cast<std::size_t>(Target::Volume)]->isUsed() == false && m_envLfoParameters[PANNING]->isUsed() )
+	for( f_cnt_t frame = 0; frame < frames; ++frame )
 	{
-		// only use panning-envelope...
-		for( f_cnt_t frame = 0; frame < frames; ++frame )
+		for( int c = 0; c < 2; ++c )
 		{
-			float vol_level = pan_buf[frame];
-			vol_level = vol_level*vol_level;
-			for( ch_cnt_t chnl = 0; chnl < DEFAULT_CHANNELS; ++chnl )
-			{
-				buffer[frame][chnl] = vol_level * buffer[frame][chnl];
-			}
+			buffer[frame][c] *= gain.vol[c];
 		}
-	}*/
+	}
 }
 
 
@@ -0,0 +1,132 @@
+/*
+ * LocklessPool.cpp - growable pool of fixed-size elements for the audio threads
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "LocklessPool.h"
+
+#include <algorithm>
+#include <new>
+
+#include "LocklessAllocator.h"
+
+
+namespace lmms
+{
+
+LocklessPool::LocklessPool(std::size_t elementSize, std::size_t chunkSize, std::size_t alignment) :
+	m_elementSize(elementSize),
+	m_chunkSize(chunkSize),
+	m_alignment(alignment)
+{
+}
+
+
+
+LocklessPool::~LocklessPool() = default;
+
+
+
+void* LocklessPool::alloc()
+{
+	const auto inUse = ++m_inUse;
+	auto highWaterMark = m_highWaterMark.load(std::memory_order_relaxed);
+	while (inUse > highWaterMark
+		&& !m_highWaterMark.compare_exchange_weak(highWaterMark, inUse, std::memory_order_relaxed)) {}
+
+	const auto numChunks = m_numChunks.load(std::memory_order_acquire);
+	for (std::size_t i = 0; i < numChunks; ++i)
+	{
+		if (void* ptr = m_chunks[i]->tryAlloc()) { return ptr; }
+	}
+
+	++m_fallbackAllocations;
+	return ::operator new(m_elementSize, std::align_val_t{m_alignment});
+}
+
+
+
+void LocklessPool::free(void* ptr)
+{
+	if (!ptr) { return; }
+	--m_inUse;
+
+	const auto numChunks = m_numChunks.load(std::memory_order_acquire);
+	for (std::size_t i = 0; i < numChunks; ++i)
+	{
+		if (m_chunks[i]->contains(ptr))
+		{
+			m_chunks[i]->free(ptr);
+			return;
+		}
+	}
+
+	::operator delete(ptr, std::align_val_t{m_alignment});
+}
+
+
+
+void LocklessPool::reserve(std::size_t count)
+{
+	const auto lock = std::lock_guard{m_growMutex};
+	const auto capacity = m_capacity.load();
+	if (count > capacity)
+	{
+		addChunk(std::max(count - capacity, m_chunkSize));
+	}
+}
+
+
+
+void LocklessPool::refill()
+{
+	// keep at least a quarter of a chunk free for sudden bursts
+	const auto lock = std::lock_guard{m_growMutex};
+	if (m_inUse.load() + m_chunkSize / 4 > m_capacity.load())
+	{
+		addChunk(m_chunkSize);
+	}
+}
+
+
+
+void LocklessPool::addChunk(std::size_t count)
+{
+	const auto numChunks = m_numChunks.load();
+	if (numChunks == MaxChunks) { return; }
+
+	m_chunks[numChunks] = std::make_unique<LocklessAllocator>(count, m_elementSize, m_alignment);
+	m_capacity += m_chunks[numChunks]->capacity();
+	m_numChunks.store(numChunks + 1, std::memory_order_release);
+}
+
+
+
+auto LocklessPool::statistics() const -> Statistics
+{
+	return Statistics{
+		m_capacity.load(),
+		m_inUse.load(),
+		m_highWaterMark.load(),
+		m_fallbackAllocations.load()
+	};
+}
+
+} // namespace lmms
@@ -25,8 +25,10 @@
 #include "MixHelpers.h"
 
 #include <algorithm>
-#include <cmath>
+#include <array>
 
+#include "lmms_constants.h"
+#include "MixKernels.h"
 #include "ValueBuffer.h"
 #include "SampleFrame.h"
 
@@ -37,6 +39,20 @@ namespace {
 
 constexpr auto SilenceThreshold = 0.000001f; // -120 dBFS
 
+//! The most sources addMultipliedMany() passes to one kernel call
+constexpr auto MaxSourcesPerPass = std::size_t{8};
+
+const MixKernels::KernelSet& kernels()
+{
+	return MixKernels::best();
+}
+
+//! Number of samples in an interleaved stereo buffer of @p frames frames
+std::size_t samples(int frames)
+{
+	return static_cast<std::size_t>(frames) * DEFAULT_CHANNELS;
+}
+
 /*! \brief Function for applying MIXOP on all sample frames */
 template<typename MIXOP>
 inline void run(SampleFrame* dst, const SampleFrame* src, int frames, const MIXOP& OP)
@@ -62,25 +78,17 @@ inline void run(SampleFrame* dst, const sample_t* srcLeft, const sample_t* srcRi
 
 bool isSilent(const SampleFrame* src, int frames)
 {
-	return isSilent({&src[0][0], static_cast<std::size_t>(frames * 2)});
+	return isSilent({src->data(), samples(frames)});
 }
 
 bool isSilent(std::span<const sample_t> buffer)
 {
-	return std::ranges::all_of(buffer, [&](const sample_t s) { return std::abs(s) < SilenceThreshold; });
+	return kernels().isSilent(buffer.data(), buffer.size(), SilenceThreshold);
 }
 
-struct AddOp
-{
-	void operator()( SampleFrame& dst, const SampleFrame& src ) const
-	{
-		dst += src;
-	}
-} ;
-
 void add( SampleFrame* dst, const SampleFrame* src, int frames )
 {
-	run<>( dst, src, frames, AddOp() );
+	kernels().add(dst->data(), src->data(), samples(frames));
 }
 
 
@@ -89,36 +97,112 @@ void add(PlanarBufferView<sample_t> dst, PlanarBufferView<const sample_t> src)
 	assert(dst.channels() == src.channels());
 	assert(dst.frames() == src.frames());
 
-	const auto channels = dst.channels();
+	for (ch_cnt_t channel = 0; channel < dst.channels(); ++channel)
+	{
+		kernels().add(dst.bufferPtr(channel), src.bufferPtr(channel), dst.frames());
+	}
+}
+
+
+void add(PlanarBufferView<sample_t> dst, const SampleFrame* src)
+{
+	assert(dst.channels() == DEFAULT_CHANNELS);
+
 	const auto frames = dst.frames();
-	for (ch_cnt_t channel = 0; channel < channels; ++channel)
+	for (ch_cnt_t channel = 0; channel < DEFAULT_CHANNELS; ++channel)
 	{
 		auto* dstPtr = dst.bufferPtr(channel);
-		const auto* srcPtr = src.bufferPtr(channel);
 		for (f_cnt_t frame = 0; frame < frames; ++frame)
 		{
-			dstPtr[frame] += srcPtr[frame];
+			dstPtr[frame] += src[frame][channel];
 		}
 	}
 }
 
 
-struct AddMultipliedOp
+void addMultiplied(SampleFrame* dst, PlanarBufferView<const sample_t> src, float coeffSrc)
 {
-	AddMultipliedOp( float coeff ) : m_coeff( coeff ) { }
+	assert(src.channels() == DEFAULT_CHANNELS);
 
-	void operator()( SampleFrame& dst, const SampleFrame& src ) const
+	const auto frames = src.frames();
+	const auto* left = src.bufferPtr(0);
+	const auto* right = src.bufferPtr(1);
+	for (f_cnt_t frame = 0; frame < frames; ++frame)
 	{
-		dst += src * m_coeff;
+		dst[frame][0] += left[frame] * coeffSrc;
+		dst[frame][1] += right[frame] * coeffSrc;
 	}
+}
 
-	const float m_coeff;
-} ;
+
+void addMultiplied(PlanarBufferView<sample_t> dst, PlanarBufferView<const sample_t> src, float coeffSrc)
+{
+	assert(dst.channels() == src.channels());
+	assert(dst.frames() == src.frames());
+
+	for (ch_cnt_t channel = 0; channel < dst.channels(); ++channel)
+	{
+		kernels().addMultiplied(dst.bufferPtr(channel), src.bufferPtr(channel), coeffSrc, dst.frames());
+	}
+}
+
+
+void addMultipliedMany(PlanarBufferView<sample_t> dst, std::span<const PlanarBufferView<const sample_t>> srcs,
+	std::span<const float> coeffsSrc)
+{
+	assert(srcs.size() == coeffsSrc.size());
+
+	// dst is read and written once per pass instead of once per source
+	for (std::size_t first = 0; first < srcs.size(); first += MaxSourcesPerPass)
+	{
+		const auto count = std::min(srcs.size() - first, MaxSourcesPerPass);
+		for (ch_cnt_t channel = 0; channel < dst.channels(); ++channel)
+		{
+			auto srcPtrs = std::array<const sample_t*, MaxSourcesPerPass>{};
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				assert(srcs[first + i].channels() == dst.channels());
+				assert(srcs[first + i].frames() == dst.frames());
+				srcPtrs[i] = srcs[first + i].bufferPtr(channel);
+			}
+			kernels().addMultipliedMany(dst.bufferPtr(channel), srcPtrs.data(), coeffsSrc.data() + first,
+				count, dst.frames());
+		}
+	}
+}
+
+
+void addMultipliedByBuffer(PlanarBufferView<sample_t> dst, PlanarBufferView<const sample_t> src,
+	float coeffSrc, const ValueBuffer* coeffSrcBuf)
+{
+	assert(dst.channels() == src.channels());
+	assert(dst.frames() == src.frames());
+
+	for (ch_cnt_t channel = 0; channel < dst.channels(); ++channel)
+	{
+		kernels().addMultipliedByBuffer(dst.bufferPtr(channel), src.bufferPtr(channel), coeffSrc,
+			coeffSrcBuf->values(), dst.frames());
+	}
+}
+
+
+void addMultipliedByBuffers(PlanarBufferView<sample_t> dst, PlanarBufferView<const sample_t> src,
+	const ValueBuffer* coeffSrcBuf1, const ValueBuffer* coeffSrcBuf2)
+{
+	assert(dst.channels() == src.channels());
+	assert(dst.frames() == src.frames());
+
+	for (ch_cnt_t channel = 0; channel < dst.channels(); ++channel)
+	{
+		kernels().addMultipliedByBuffers(dst.bufferPtr(channel), src.bufferPtr(channel),
+			coeffSrcBuf1->values(), coeffSrcBuf2->values(), dst.frames());
+	}
+}
 
 
 void addMultiplied( SampleFrame* dst, const SampleFrame* src, float coeffSrc, int frames )
 {
-	run<>( dst, src, frames, AddMultipliedOp(coeffSrc) );
+	kernels().addMultiplied(dst->data(), src->data(), coeffSrc, samples(frames));
 }
 
 
@@ -216,7 +300,7 @@ struct MultiplyAndAddMultipliedOp
 
 void multiplyAndAddMultiplied( SampleFrame* dst, const SampleFrame* src, float coeffDst, float coeffSrc, int frames )
 {
-	run<>( dst, src, frames, MultiplyAndAddMultipliedOp(coeffDst, coeffSrc) );
+	kernels().multiplyAndAddMultiplied(dst->data(), src->data(), coeffDst, coeffSrc, samples(frames));
 }
 
 
@@ -0,0 +1,126 @@
+/*
+ * MixKernels.cpp - scalar and SSE2 mixing kernels, runtime dispatch
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "MixKernels.h"
+
+#include <cmath>
+
+#include "MixKernelsImpl.h"
+#include "SimdDispatch.h"
+#include "SimdVector.h"
+
+namespace lmms::MixKernels
+{
+
+namespace
+{
+
+void scalarAdd(float* dst, const float* src, std::size_t count)
+{
+	for (std::size_t i = 0; i < count; ++i) { dst[i] += src[i]; }
+}
+
+void scalarAddMultiplied(float* dst, const float* src, float coeff, std::size_t count)
+{
+	for (std::size_t i = 0; i < count; ++i) { dst[i] += src[i] * coeff; }
+}
+
+void scalarAddMultipliedByBuffer(float* dst, const float* src, float coeff, const float* coeffs, std::size_t count)
+{
+	for (std::size_t i = 0; i < count; ++i) { dst[i] += src[i] * coeff * coeffs[i]; }
+}
+
+void scalarAddMultipliedByBuffers(float* dst, const float* src,
+	const float* coeffs1, const float* coeffs2, std::size_t count)
+{
+	for (std::size_t i = 0; i < count; ++i) { dst[i] += src[i] * coeffs1[i] * coeffs2[i]; }
+}
+
+void scalarMultiplyAndAddMultiplied(float* dst, const float* src, float coeffDst, float coeffSrc, std::size_t count)
+{
+	for (std::size_t i = 0; i < count; ++i) { dst[i] = dst[i] * coeffDst + src[i] * coeffSrc; }
+}
+
+void scalarAddMultipliedMany(float* dst, const float* const* srcs, const float* coeffs,
+	std::size_t sources, std::size_t count)
+{
+	for (std::size_t s = 0; s < sources; ++s) { scalarAddMultiplied(dst, srcs[s], coeffs[s], count); }
+}
+
+bool scalarIsSilent(const float* src, std::size_t count, float threshold)
+{
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		if (!(std::abs(src[i]) < threshold)) { return false; }
+	}
+	return true;
+}
+
+const auto s_scalarKernels = KernelSet{
+	"scalar",
+	scalarAdd,
+	scalarAddMultiplied,
+	scalarAddMultipliedByBuffer,
+	scalarAddMultipliedByBuffers,
+	scalarMultiplyAndAddMultiplied,
+	scalarAddMultipliedMany,
+	scalarIsSilent
+};
+
+simd::KernelSets<KernelSet> kernelSets()
+{
+	return {&s_scalarKernels, sse2Kernels(), avx2Kernels(), avx512Kernels()};
+}
+
+} // namespace
+
+
+
+
+const KernelSet* sse2Kernels()
+{
+#ifdef __SSE2__
+	return &Kernels<simd::Sse2>::kernelSet("sse2");
+#else
+	return nullptr;
+#endif
+}
+
+
+
+
+const KernelSet& best()
+{
+	static const KernelSet& kernels = kernelSets().best();
+	return kernels;
+}
+
+
+
+
+std::vector<const KernelSet*> supported()
+{
+	return kernelSets().supported();
+}
+
+
+} // namespace lmms::MixKernels
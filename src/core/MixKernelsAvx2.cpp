@@ -0,0 +1,41 @@
+/*
+ * MixKernelsAvx2.cpp - AVX2 mixing kernels
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+// This file is compiled with AVX2 and FMA enabled, see src/CMakeLists.txt.
+// Don't include anything here that defines functions with external linkage.
+
+#include "MixKernelsImpl.h"
+#include "SimdVector.h"
+
+namespace lmms::MixKernels
+{
+
+const KernelSet* avx2Kernels()
+{
+#ifdef LMMS_SIMD_AVX2
+	return &Kernels<simd::Avx2>::kernelSet("avx2");
+#else
+	return nullptr;
+#endif
+}
+
+} // namespace lmms::MixKernels
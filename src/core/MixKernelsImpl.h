@@ -0,0 +1,189 @@
+/*
+ * MixKernelsImpl.h - vectorised mixing kernels, generic over the instruction set
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_MIX_KERNELS_IMPL_H
+#define LMMS_MIX_KERNELS_IMPL_H
+
+#include <cstddef>
+
+#include "MixKernels.h"
+
+namespace lmms::MixKernels
+{
+
+// see simd::KernelSets
+const KernelSet* sse2Kernels();
+const KernelSet* avx2Kernels();
+const KernelSet* avx512Kernels();
+
+// internal linkage only, see SimdVector.h
+namespace
+{
+
+//! V is one of the register wrappers from SimdVector.h
+template<typename V>
+struct Kernels
+{
+	using Vec = typename V::Vec;
+
+	//! Calls @p vec for every full vector and @p scalar for the remaining
+	//! elements, both with the index of the first element
+	template<typename VecOp, typename ScalarOp>
+	static void forEach(std::size_t count, VecOp vec, ScalarOp scalar)
+	{
+		std::size_t i = 0;
+		for (; i + V::Width <= count; i += V::Width) { vec(i); }
+		for (; i < count; ++i) { scalar(i); }
+	}
+
+	static void add(float* dst, const float* src, std::size_t count)
+	{
+		forEach(count,
+			[=](std::size_t i) { V::store(dst + i, V::add(V::load(dst + i), V::load(src + i))); },
+			[=](std::size_t i) { dst[i] += src[i]; });
+	}
+
+	static void addMultiplied(float* dst, const float* src, float coeff, std::size_t count)
+	{
+		const Vec c = V::set1(coeff);
+		forEach(count,
+			[=](std::size_t i) { V::store(dst + i, V::mulAdd(V::load(src + i), c, V::load(dst + i))); },
+			[=](std::size_t i) { dst[i] += src[i] * coeff; });
+	}
+
+	static void addMultipliedByBuffer(float* dst, const float* src, float coeff,
+		const float* coeffs, std::size_t count)
+	{
+		const Vec c = V::set1(coeff);
+		forEach(count,
+			[=](std::size_t i) {
+				V::store(dst + i, V::mulAdd(V::mul(V::load(src + i), c), V::load(coeffs + i), V::load(dst + i)));
+			},
+			[=](std::size_t i) { dst[i] += src[i] * coeff * coeffs[i]; });
+	}
+
+	static void addMultipliedByBuffers(float* dst, const float* src,
+		const float* coeffs1, const float* coeffs2, std::size_t count)
+	{
+		forEach(count,
+			[=](std::size_t i) {
+				const Vec c = V::mul(V::load(coeffs1 + i), V::load(coeffs2 + i));
+				V::store(dst + i, V::mulAdd(V::load(src + i), c, V::load(dst + i)));
+			},
+			[=](std::size_t i) { dst[i] += src[i] * coeffs1[i] * coeffs2[i]; });
+	}
+
+	static void multiplyAndAddMultiplied(float* dst, const float* src,
+		float coeffDst, float coeffSrc, std::size_t count)
+	{
+		const Vec cd = V::set1(coeffDst);
+		const Vec cs = V::set1(coeffSrc);
+		forEach(count,
+			[=](std::size_t i) { V::store(dst + i, V::mulAdd(V::load(src + i), cs, V::mul(V::load(dst + i), cd))); },
+			[=](std::size_t i) { dst[i] = dst[i] * coeffDst + src[i] * coeffSrc; });
+	}
+
+	static void addMultipliedMany(float* dst, const float* const* srcs, const float* coeffs,
+		std::size_t sources, std::size_t count)
+	{
+		// a few vectors at once, so the source pointers and coefficients
+		// are loaded once for all of them
+		constexpr auto Unroll = std::size_t{4};
+		std::size_t i = 0;
+		for (; i + Unroll * V::Width <= count; i += Unroll * V::Width)
+		{
+			Vec acc[Unroll];
+			for (std::size_t u = 0; u < Unroll; ++u) { acc[u] = V::load(dst + i + u * V::Width); }
+			for (std::size_t s = 0; s < sources; ++s)
+			{
+				const float* src = srcs[s] + i;
+				const Vec c = V::set1(coeffs[s]);
+				for (std::size_t u = 0; u < Unroll; ++u)
+				{
+					acc[u] = V::mulAdd(V::load(src + u * V::Width), c, acc[u]);
+				}
+			}
+			for (std::size_t u = 0; u < Unroll; ++u) { V::store(dst + i + u * V::Width, acc[u]); }
+		}
+		for (; i < count; ++i)
+		{
+			float acc = dst[i];
+			for (std::size_t s = 0; s < sources; ++s) { acc += srcs[s][i] * coeffs[s]; }
+			dst[i] = acc;
+		}
+	}
+
+	static bool isSilent(const float* src, std::size_t count, float threshold)
+	{
+		// checked in chunks of a few vectors, so loud buffers return early
+		constexpr auto Chunk = 4 * V::Width;
+		const Vec zero = V::set1(0.f);
+		const Vec one = V::set1(1.f);
+		const Vec limit = V::set1(threshold);
+
+		std::size_t i = 0;
+		for (; i + Chunk <= count; i += Chunk)
+		{
+			Vec loud = zero;
+			for (std::size_t j = i; j < i + Chunk; j += V::Width)
+			{
+				const Vec x = V::load(src + j);
+				const Vec magnitude = V::max(x, V::sub(zero, x));
+				// NaNs compare false and count as loud
+				loud = V::max(loud, V::select(V::lt(magnitude, limit), zero, one));
+			}
+
+			alignas(64) float flags[V::Width];
+			V::store(flags, loud);
+			for (const float flag : flags)
+			{
+				if (flag != 0.f) { return false; }
+			}
+		}
+		for (; i < count; ++i)
+		{
+			if (!(src[i] < threshold && src[i] > -threshold)) { return false; }
+		}
+		return true;
+	}
+
+	static const KernelSet& kernelSet(const char* name)
+	{
+		static const auto set = KernelSet{
+			name,
+			&add,
+			&addMultiplied,
+			&addMultipliedByBuffer,
+			&addMultipliedByBuffers,
+			&multiplyAndAddMultiplied,
+			&addMultipliedMany,
+			&isSilent
+		};
+		return set;
+	}
+};
+
+} // namespace
+
+} // namespace lmms::MixKernels
+
+#endif // LMMS_MIX_KERNELS_IMPL_H
@@ -26,6 +26,7 @@
 
 #include <QDomElement>
 
+#include "ArrayVector.h"
 #include "AudioEngine.h"
 #include "AudioEngineWorkerThread.h"
 #include "Mixer.h"
@@ -70,8 +71,7 @@ MixerChannel::MixerChannel( int idx, Model * _parent ) :
 	m_volumeModel(1.f, 0.f, 2.f, 0.001f, _parent),
 	m_name(),
 	m_lock(),
-	m_queued( false ),
-	m_dependenciesMet(0),
+	m_numSenders(0),
 	m_channelIndex(idx)
 {
 	m_buffer.allocateInterleavedBuffer();
@@ -87,22 +87,18 @@ MixerChannel::~MixerChannel()
 
 inline void MixerChannel::processed()
 {
-	for( const MixerRoute * receiverRoute : m_sends )
+	for (MixerChannel* receiver : m_receivers)
 	{
-		if( receiverRoute->receiver()->m_muted == false )
-		{
-			receiverRoute->receiver()->incrementDeps();
-		}
+		receiver->senderDone();
 	}
 }
 
-void MixerChannel::incrementDeps()
+void MixerChannel::senderDone()
 {
-	const auto i = m_dependenciesMet++ + 1;
-	if( i >= m_receives.size() && ! m_queued )
+	// the last sender to finish queues us - muted channels are never queued
+	if (resolveDependency())
 	{
-		m_queued = true;
-		AudioEngineWorkerThread::addJob( this );
+		AudioEngineWorkerThread::addJob(this);
 	}
 }
 
@@ -163,51 +159,63 @@ void MixerChannel::unmuteReceiverForSolo()
 
 void MixerChannel::doProcessing()
 {
-	const f_cnt_t fpp = Engine::audioEngine()->framesPerPeriod();
-
 	if( m_muted == false )
 	{
+		auto buffer = m_buffer.groupBuffers(0);
+
+		// senders with constant gains are summed together, so the buffer is
+		// only read and written once per group instead of once per sender
+		auto constantSenders = ArrayVector<PlanarBufferView<const sample_t>, 8>{};
+		auto constantGains = ArrayVector<float, 8>{};
+		const auto mixConstantSenders = [&] {
+			MixHelpers::addMultipliedMany(buffer, constantSenders, constantGains);
+			constantSenders.clear();
+			constantGains.clear();
+		};
+
 		for( MixerRoute * senderRoute : m_receives )
 		{
 			MixerChannel * sender = senderRoute->sender();
 			FloatModel * sendModel = senderRoute->amount();
 			if( ! sendModel ) qFatal( "Error: no send model found from %d to %d", senderRoute->senderIndex(), m_channelIndex );
 
-			if (sender->m_buffer.hasAnySignal() || sender->m_stillRunning)
+			// the silence flags are kept up to date by the effects, so senders
+			// whose effects are still running but produce silence are skipped too.
+			// Muted senders may still hold what tracks mixed into them.
+			if (!sender->m_muted && sender->m_buffer.hasAnySignal())
 			{
-				auto buffer = m_buffer.interleavedBuffer().asSampleFrames();
-
 				// figure out if we're getting sample-exact input
 				ValueBuffer * sendBuf = sendModel->valueBuffer();
 				ValueBuffer * volBuf = sender->m_volumeModel.valueBuffer();
 
 				// mix it's output with this one's output
-				auto ch_buf = sender->m_buffer.interleavedBuffer().asSampleFrames();
+				const auto ch_buf = sender->m_buffer.groupBuffers(0);
 
 				// use sample-exact mixing if sample-exact values are available
 				if( ! volBuf && ! sendBuf ) // neither volume nor send has sample-exact data...
 				{
-					const float v = sender->m_volumeModel.value() * sendModel->value();
-					MixHelpers::addMultiplied(buffer.data(), ch_buf.data(), v, fpp);
+					constantSenders.push_back(ch_buf);
+					constantGains.push_back(sender->m_volumeModel.value() * sendModel->value());
+					if (constantSenders.full()) { mixConstantSenders(); }
 				}
 				else if( volBuf && sendBuf ) // both volume and send have sample-exact data
 				{
-					MixHelpers::addMultipliedByBuffers(buffer.data(), ch_buf.data(), volBuf, sendBuf, fpp);
+					MixHelpers::addMultipliedByBuffers(buffer, ch_buf, volBuf, sendBuf);
 				}
 				else if( volBuf ) // volume has sample-exact data but send does not
 				{
 					const float v = sendModel->value();
-					MixHelpers::addMultipliedByBuffer(buffer.data(), ch_buf.data(), v, volBuf, fpp);
+					MixHelpers::addMultipliedByBuffer(buffer, ch_buf, v, volBuf);
 				}
 				else // vice versa
 				{
 					const float v = sender->m_volumeModel.value();
-					MixHelpers::addMultipliedByBuffer(buffer.data(), ch_buf.data(), v, sendBuf, fpp);
+					MixHelpers::addMultipliedByBuffer(buffer, ch_buf, v, sendBuf);
 				}
-				toPlanar(m_buffer.interleavedBuffer(), m_buffer.groupBuffers(0));
 				m_buffer.mixSilenceFlags(sender->m_buffer);
 			}
 		}
+		mixConstantSenders();
 
 
 		const float v = m_volumeModel.value();
@@ -261,7 +269,10 @@ int Mixer::createChannel()
 {
 	const int index = m_mixerChannels.size();
 	// create new channel
+	Engine::audioEngine()->requestChangeInModel();
 	m_mixerChannels.push_back( new MixerChannel( index, this ) );
+	compileGraph();
+	Engine::audioEngine()->doneChangeInModel();
 
 	// reset channel state
 	clearChannel( index );
@@ -416,6 +427,7 @@ void Mixer::deleteChannel( int index )
 		}
 	}
 
+	compileGraph();
 	Engine::audioEngine()->doneChangeInModel();
 }
 
@@ -529,6 +541,7 @@ MixerRoute * Mixer::createRoute( MixerChannel * from, MixerChannel * to, float a
 
 	// add us to mixer's list
 	Engine::mixer()->m_mixerRoutes.push_back(route);
+	Engine::mixer()->compileGraph();
 	Engine::audioEngine()->doneChangeInModel();
 
 	return route;
@@ -572,6 +585,7 @@ void Mixer::deleteChannelSend( MixerRoute * route )
 
 	// remove us from mixer's list
 	removeFromMixerRoute(Engine::mixer()->m_mixerRoutes);
+	Engine::mixer()->compileGraph();
 
 	delete route;
 	Engine::audioEngine()->doneChangeInModel();
@@ -642,14 +656,10 @@ FloatModel * Mixer::channelSendModel( mix_ch_t fromChannel, mix_ch_t toChannel )
 void Mixer::mixToChannel(const AudioBuffer& buffer, mix_ch_t dest)
 {
 	const auto channel = m_mixerChannels[dest];
-	if (!channel->m_muteModel.value())
+	if (!channel->m_muteModel.value() && buffer.hasAnySignal())
 	{
 		channel->m_lock.lock();
 		MixHelpers::add(channel->m_buffer.groupBuffers(0), buffer.groupBuffers(0));
-
-		// Copy the planar buffer to the temporary interleaved buffer so they stay in sync
-		toInterleaved(channel->m_buffer.groupBuffers(0), channel->m_buffer.interleavedBuffer());
-
 		channel->m_buffer.mixSilenceFlags(buffer);
 		channel->m_lock.unlock();
 	}
@@ -667,68 +677,87 @@ void Mixer::prepareMasterMix()
 
 void Mixer::masterMix( SampleFrame* _buf )
 {
-	const int fpp = Engine::audioEngine()->framesPerPeriod();
-
-	// add the channels that have no dependencies (no incoming senders, ie.
-	// no receives) to the jobqueue. The channels that have receives get
-	// added when their senders get processed, which is detected by
-	// dependency counting.
-	// also instantly add all muted channels as they don't need to care
-	// about their senders, and can just increment the deps of their
-	// recipients right away.
 	AudioEngineWorkerThread::resetJobQueue( AudioEngineWorkerThread::JobQueue::OperationMode::Dynamic );
-	for( MixerChannel * ch : m_mixerChannels )
+	prepareChannels();
+	queueChannels();
+
+	// as the routing is acyclic, the whole graph is done after one go
+	AudioEngineWorkerThread::startAndWaitForJobs();
+
+	finishMasterMix(_buf);
+}
+
+
+
+
+void Mixer::prepareChannels()
+{
+	// the graph itself is compiled whenever the routing changes, see compileGraph()
+	for (MixerChannel* ch : m_processingOrder)
 	{
-		ch->m_muted = ch->m_muteModel.value();
-		if( ch->m_muted ) // instantly "process" muted channels
-		{
-			ch->processed();
-			ch->done();
-		}
-		else if( ch->m_receives.size() == 0 )
-		{
-			ch->m_queued = true;
-			AudioEngineWorkerThread::addJob( ch );
-		}
+		// channels in a routing loop can't be processed, treat them as muted
+		ch->m_muted = ch->m_muteModel.value() || ch->m_inLoop;
+		ch->setDependencies(ch->m_numSenders);
 	}
-	while (m_mixerChannels[0]->state() != ThreadableJob::ProcessingState::Done)
+}
+
+
+
+
+void Mixer::queueChannels()
+{
+	// every channel waits for all of its dependencies: channels without any
+	// are queued right away, all others get queued by the last of them to
+	// finish (see MixerChannel::senderDone()). Muted channels don't need to
+	// wait for anything, so they are "processed" instantly which releases
+	// their receivers.
+	for (MixerChannel* ch : m_processingOrder)
 	{
-		bool found = false;
-		for( MixerChannel * ch : m_mixerChannels )
+		if (ch->m_muted)
 		{
-			const auto s = ch->state();
-			if (s == ThreadableJob::ProcessingState::Queued
-				|| s == ThreadableJob::ProcessingState::InProgress)
-			{
-				found = true;
-				break;
-			}
+			ch->done();
+			ch->processed();
 		}
-		if( !found )
+		else if (ch->m_numSenders == 0 && ch->pendingDependencies() == 0)
 		{
-			break;
+			AudioEngineWorkerThread::addJob(ch);
 		}
-		AudioEngineWorkerThread::startAndWaitForJobs();
 	}
+}
+
+
 
-	auto buffer = m_mixerChannels[0]->m_buffer.interleavedBuffer().asSampleFrames();
 
-	// handle sample-exact data in master volume fader
-	ValueBuffer * volBuf = m_mixerChannels[0]->m_volumeModel.valueBuffer();
+void Mixer::finishMasterMix( SampleFrame* _buf )
+{
+	const int fpp = Engine::audioEngine()->framesPerPeriod();
+
+	auto& master = m_mixerChannels[0]->m_buffer;
 
-	if( volBuf )
+	// a silent master leaves the output buffer as it is
+	if (master.hasAnySignal())
 	{
-		for( int f = 0; f < fpp; f++ )
+		// handle sample-exact data in master volume fader
+		ValueBuffer * volBuf = m_mixerChannels[0]->m_volumeModel.valueBuffer();
+
+		if( volBuf )
 		{
-			buffer[f][0] *= volBuf->values()[f];
-			buffer[f][1] *= volBuf->values()[f];
+			for( ch_cnt_t ch = 0; ch < DEFAULT_CHANNELS; ++ch )
+			{
+				auto buffer = master.buffer(ch);
+				for( int f = 0; f < fpp; f++ )
+				{
+					buffer[f] *= volBuf->values()[f];
+				}
+			}
 		}
-	}
 
-	const float v = volBuf
-		? 1.0f
-		: m_mixerChannels[0]->m_volumeModel.value();
-	MixHelpers::addMultiplied(_buf, buffer.data(), v, fpp);
+		const float v = volBuf
+			? 1.0f
+			: m_mixerChannels[0]->m_volumeModel.value();
+		// the master channel is interleaved only here, straight into the output buffer
+		MixHelpers::addMultiplied(_buf, master.groupBuffers(0), v);
+	}
 
 	// clear all channel buffers and
 	// reset channel process state
@@ -736,8 +765,74 @@ void Mixer::masterMix( SampleFrame* _buf )
 	{
 		m_mixerChannels[i]->m_buffer.silenceAllChannels();
 		m_mixerChannels[i]->reset();
-		m_mixerChannels[i]->m_queued = false;
-		m_mixerChannels[i]->m_dependenciesMet = 0;
+	}
+}
+
+
+
+
+void Mixer::compileGraph()
+{
+	// Called by everything that changes the routing while the audio engine is
+	// locked by requestChangeInModel(), so the render thread only ever sees a
+	// complete graph and never allocates for it.
+	for (MixerChannel* ch : m_mixerChannels) { ch->m_inLoop = false; }
+
+	auto inDegree = std::vector<std::size_t>(m_mixerChannels.size());
+	while (true)
+	{
+		m_processingOrder.clear();
+		m_processingOrder.reserve(m_mixerChannels.size());
+
+		for (MixerChannel* ch : m_mixerChannels)
+		{
+			// channels in a loop don't wait for their senders and only release
+			// receivers outside of the loop
+			ch->m_receivers.clear();
+			for (const MixerRoute* route : ch->m_sends)
+			{
+				if (!route->receiver()->m_inLoop) { ch->m_receivers.push_back(route->receiver()); }
+			}
+			ch->m_numSenders = ch->m_inLoop ? 0 : ch->m_receives.size();
+
+			inDegree[ch->index()] = ch->m_numSenders;
+			if (ch->m_numSenders == 0) { m_processingOrder.push_back(ch); }
+		}
+
+		// Kahn's algorithm - channels get appended once all their senders are in
+		for (std::size_t i = 0; i < m_processingOrder.size(); ++i)
+		{
+			for (MixerChannel* receiver : m_processingOrder[i]->m_receivers)
+			{
+				if (--inDegree[receiver->index()] == 0) { m_processingOrder.push_back(receiver); }
+			}
+		}
+
+		if (m_processingOrder.size() == m_mixerChannels.size()) { break; }
+
+		// Should be prevented by isInfiniteLoop(), but a broken project could contain a loop.
+		// Everything behind the loop is left over as well, so only mark the channels that
+		// can reach themselves. They stay silent, but the channels they feed (e.g. master)
+		// don't wait for them any more.
+		qWarning("Mixer: routing contains a loop, channels in it will stay silent");
+		for (MixerChannel* ch : m_mixerChannels)
+		{
+			if (inDegree[ch->index()] == 0) { continue; }
+
+			auto visited = std::vector<bool>(m_mixerChannels.size());
+			auto pending = std::vector<MixerChannel*>(ch->m_receivers);
+			while (!pending.empty() && !ch->m_inLoop)
+			{
+				MixerChannel* next = pending.back();
+				pending.pop_back();
+				if (next == ch) { ch->m_inLoop = true; }
+				else if (inDegree[next->index()] > 0 && !visited[next->index()])
+				{
+					visited[next->index()] = true;
+					pending.insert(pending.end(), next->m_receivers.begin(), next->m_receivers.end());
+				}
+			}
+		}
 	}
 }
 
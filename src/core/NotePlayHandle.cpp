@@ -366,6 +366,14 @@ bool NotePlayHandle::isFromTrack( const Track * _track ) const
 
 
 
+QString NotePlayHandle::profilerName() const
+{
+	return QString( "%1 (%2) note" ).arg( m_instrumentTrack->name(), m_instrumentTrack->instrumentName() );
+}
+
+
+
+
 void NotePlayHandle::noteOff( const f_cnt_t _s )
 {
 	if( m_released )
@@ -602,25 +610,10 @@ void NotePlayHandle::resize( const bpm_t _new_tempo )
 }
 
 
-NotePlayHandle ** NotePlayHandleManager::s_available;
-QReadWriteLock NotePlayHandleManager::s_mutex;
-std::atomic_int NotePlayHandleManager::s_availableIndex;
-int NotePlayHandleManager::s_size;
-
-
-void NotePlayHandleManager::init()
+LocklessPool& NotePlayHandleManager::pool()
 {
-	s_available = new NotePlayHandle*[INITIAL_NPH_CACHE];
-
-	auto n = static_cast<NotePlayHandle *>(std::malloc(sizeof(NotePlayHandle) * INITIAL_NPH_CACHE));
-
-	for( int i=0; i < INITIAL_NPH_CACHE; ++i )
-	{
-		s_available[ i ] = n;
-		++n;
-	}
-	s_availableIndex = INITIAL_NPH_CACHE - 1;
-	s_size = INITIAL_NPH_CACHE;
+	static LocklessPool s_pool( sizeof( NotePlayHandle ), ChunkSize );
+	return s_pool;
 }
 
 
@@ -632,45 +625,33 @@ NotePlayHandle * NotePlayHandleManager::acquire( InstrumentTrack* instrumentTrac
 				int midiEventChannel,
 				NotePlayHandle::Origin origin )
 {
-	// TODO: use some lockless data structures
-	s_mutex.lockForWrite();
-	if (s_availableIndex < 0) { extend(NPH_CACHE_INCREMENT); }
-	NotePlayHandle * nph = s_available[s_availableIndex--];
-	s_mutex.unlock();
-
-	new( (void*)nph ) NotePlayHandle( instrumentTrack, offset, frames, noteToPlay, parent, midiEventChannel, origin );
-	return nph;
+	void* memory = pool().alloc();
+	return new( memory ) NotePlayHandle( instrumentTrack, offset, frames, noteToPlay, parent, midiEventChannel, origin );
 }
 
 
 void NotePlayHandleManager::release( NotePlayHandle * nph )
 {
 	nph->NotePlayHandle::~NotePlayHandle();
-	s_mutex.lockForRead();
-	s_available[++s_availableIndex] = nph;
-	s_mutex.unlock();
+	pool().free( nph );
 }
 
 
-void NotePlayHandleManager::extend( int c )
+void NotePlayHandleManager::reserve( std::size_t count )
 {
-	s_size += c;
-	auto tmp = new NotePlayHandle*[s_size];
-	delete[] s_available;
-	s_available = tmp;
+	pool().reserve( count );
+}
 
-	auto n = static_cast<NotePlayHandle *>(std::malloc(sizeof(NotePlayHandle) * c));
 
-	for( int i=0; i < c; ++i )
-	{
-		s_available[++s_availableIndex] = n;
-		++n;
-	}
+void NotePlayHandleManager::refill()
+{
+	pool().refill();
 }
 
-void NotePlayHandleManager::free()
+
+NotePlayHandleManager::Statistics NotePlayHandleManager::statistics()
 {
-	delete[] s_available;
+	return pool().statistics();
 }
 
 
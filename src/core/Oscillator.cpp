@@ -26,6 +26,7 @@
 #include "Oscillator.h"
 
 #include <algorithm>
+#include <array>
 #if !defined(__MINGW32__) && !defined(__MINGW64__)
 	#include <thread>
 #endif
@@ -36,6 +37,7 @@
 #include "AutomatableModel.h"
 #include "fftw3.h"
 #include "fft_helpers.h"
+#include "OscillatorKernels.h"
 
 
 namespace lmms
@@ -46,6 +48,8 @@ void Oscillator::waveTableInit()
 {
 	createFFTPlans();
 	generateWaveTables();
+	// detect the CPU's instruction sets now rather than on the audio thread
+	OscillatorKernels::best();
 	// The oscillator FFT plans remain throughout the application lifecycle
 	// due to being expensive to create, and being used whenever a userwave form is changed
 	// deleted in main.cpp main()
@@ -84,6 +88,41 @@ void Oscillator::update(SampleFrame* ab, const f_cnt_t frames, const ch_cnt_t ch
 		zeroSampleFrames(ab, frames);
 		return;
 	}
+
+	auto block = std::array<sample_t, BlockSize>{};
+	for (f_cnt_t offset = 0; offset < frames; offset += BlockSize)
+	{
+		const auto count = std::min(BlockSize, frames - offset);
+		updateBlock(block.data(), count, modulator);
+		for (f_cnt_t frame = 0; frame < count; ++frame)
+		{
+			ab[offset + frame][chnl] = block[frame];
+		}
+	}
+}
+
+
+
+
+void Oscillator::update(sample_t* buffer, const f_cnt_t frames, bool modulator)
+{
+	for (f_cnt_t offset = 0; offset < frames; offset += BlockSize)
+	{
+		updateBlock(buffer + offset, std::min(BlockSize, frames - offset), modulator);
+	}
+}
+
+
+
+
+void Oscillator::updateBlock(sample_t* buffer, const f_cnt_t frames, bool modulator)
+{
+	assert(frames <= BlockSize);
+	if (m_freq >= Engine::audioEngine()->outputSampleRate() / 2)
+	{
+		std::fill_n(buffer, frames, 0.f);
+		return;
+	}
 	// If this oscillator is used to PM or PF modulate another oscillator, take a note.
 	// The sampling functions will check this variable and avoid using band-limited
 	// wavetables, since they contain ringing that would lead to unexpected results.
@@ -93,25 +132,25 @@ void Oscillator::update(SampleFrame* ab, const f_cnt_t frames, const ch_cnt_t ch
 		switch (static_cast<ModulationAlgo>(m_modulationAlgoModel->value()))
 		{
 			case ModulationAlgo::PhaseModulation:
-				updatePM(ab, frames, chnl);
+				updatePM(buffer, frames);
 				break;
 			case ModulationAlgo::AmplitudeModulation:
-				updateAM(ab, frames, chnl);
+				updateAM(buffer, frames);
 				break;
 			case ModulationAlgo::SignalMix:
 			default:
-				updateMix(ab, frames, chnl);
+				updateMix(buffer, frames);
 				break;
 			case ModulationAlgo::SynchronizedBySubOsc:
-				updateSync(ab, frames, chnl);
+				updateSync(buffer, frames);
 				break;
 			case ModulationAlgo::FrequencyModulation:
-				updateFM(ab, frames, chnl);
+				updateFM(buffer, frames);
 		}
 	}
 	else
 	{
-		updateNoSub(ab, frames, chnl);
+		updateNoSub(buffer, frames);
 	}
 }
 
@@ -322,35 +361,34 @@ void Oscillator::generateWaveTables()
 
 
 
-void Oscillator::updateNoSub( SampleFrame* _ab, const f_cnt_t _frames,
-							const ch_cnt_t _chnl )
+void Oscillator::updateNoSub( sample_t* _buf, const f_cnt_t _frames )
 {
 	switch( static_cast<WaveShape>(m_waveShapeModel->value()) )
 	{
 		case WaveShape::Sine:
 		default:
-			updateNoSub<WaveShape::Sine>( _ab, _frames, _chnl );
+			updateNoSub<WaveShape::Sine>( _buf, _frames );
 			break;
 		case WaveShape::Triangle:
-			updateNoSub<WaveShape::Triangle>( _ab, _frames, _chnl );
+			updateNoSub<WaveShape::Triangle>( _buf, _frames );
 			break;
 		case WaveShape::Saw:
-			updateNoSub<WaveShape::Saw>( _ab, _frames, _chnl );
+			updateNoSub<WaveShape::Saw>( _buf, _frames );
 			break;
 		case WaveShape::Square:
-			updateNoSub<WaveShape::Square>( _ab, _frames, _chnl );
+			updateNoSub<WaveShape::Square>( _buf, _frames );
 			break;
 		case WaveShape::MoogSaw:
-			updateNoSub<WaveShape::MoogSaw>( _ab, _frames, _chnl );
+			updateNoSub<WaveShape::MoogSaw>( _buf, _frames );
 			break;
 		case WaveShape::Exponential:
-			updateNoSub<WaveShape::Exponential>( _ab, _frames, _chnl );
+			updateNoSub<WaveShape::Exponential>( _buf, _frames );
 			break;
 		case WaveShape::WhiteNoise:
-			updateNoSub<WaveShape::WhiteNoise>( _ab, _frames, _chnl );
+			updateNoSub<WaveShape::WhiteNoise>( _buf, _frames );
 			break;
 		case WaveShape::UserDefined:
-			updateNoSub<WaveShape::UserDefined>( _ab, _frames, _chnl );
+			updateNoSub<WaveShape::UserDefined>( _buf, _frames );
 			break;
 	}
 }
@@ -358,35 +396,34 @@ void Oscillator::updateNoSub( SampleFrame* _ab, const f_cnt_t _frames,
 
 
 
-void Oscillator::updatePM( SampleFrame* _ab, const f_cnt_t _frames,
-							const ch_cnt_t _chnl )
+void Oscillator::updatePM( sample_t* _buf, const f_cnt_t _frames )
 {
 	switch( static_cast<WaveShape>(m_waveShapeModel->value()) )
 	{
 		case WaveShape::Sine:
 		default:
-			updatePM<WaveShape::Sine>( _ab, _frames, _chnl );
+			updatePM<WaveShape::Sine>( _buf, _frames );
 			break;
 		case WaveShape::Triangle:
-			updatePM<WaveShape::Triangle>( _ab, _frames, _chnl );
+			updatePM<WaveShape::Triangle>( _buf, _frames );
 			break;
 		case WaveShape::Saw:
-			updatePM<WaveShape::Saw>( _ab, _frames, _chnl );
+			updatePM<WaveShape::Saw>( _buf, _frames );
 			break;
 		case WaveShape::Square:
-			updatePM<WaveShape::Square>( _ab, _frames, _chnl );
+			updatePM<WaveShape::Square>( _buf, _frames );
 			break;
 		case WaveShape::MoogSaw:
-			updatePM<WaveShape::MoogSaw>( _ab, _frames, _chnl );
+			updatePM<WaveShape::MoogSaw>( _buf, _frames );
 			break;
 		case WaveShape::Exponential:
-			updatePM<WaveShape::Exponential>( _ab, _frames, _chnl );
+			updatePM<WaveShape::Exponential>( _buf, _frames );
 			break;
 		case WaveShape::WhiteNoise:
-			updatePM<WaveShape::WhiteNoise>( _ab, _frames, _chnl );
+			updatePM<WaveShape::WhiteNoise>( _buf, _frames );
 			break;
 		case WaveShape::UserDefined:
-			updatePM<WaveShape::UserDefined>( _ab, _frames, _chnl );
+			updatePM<WaveShape::UserDefined>( _buf, _frames );
 			break;
 	}
 }
@@ -394,35 +431,34 @@ void Oscillator::updatePM( SampleFrame* _ab, const f_cnt_t _frames,
 
 
 
-void Oscillator::updateAM( SampleFrame* _ab, const f_cnt_t _frames,
-							const ch_cnt_t _chnl )
+void Oscillator::updateAM( sample_t* _buf, const f_cnt_t _frames )
 {
 	switch( static_cast<WaveShape>(m_waveShapeModel->value()) )
 	{
 		case WaveShape::Sine:
 		default:
-			updateAM<WaveShape::Sine>( _ab, _frames, _chnl );
+			updateAM<WaveShape::Sine>( _buf, _frames );
 			break;
 		case WaveShape::Triangle:
-			updateAM<WaveShape::Triangle>( _ab, _frames, _chnl );
+			updateAM<WaveShape::Triangle>( _buf, _frames );
 			break;
 		case WaveShape::Saw:
-			updateAM<WaveShape::Saw>( _ab, _frames, _chnl );
+			updateAM<WaveShape::Saw>( _buf, _frames );
 			break;
 		case WaveShape::Square:
-			updateAM<WaveShape::Square>( _ab, _frames, _chnl );
+			updateAM<WaveShape::Square>( _buf, _frames );
 			break;
 		case WaveShape::MoogSaw:
-			updateAM<WaveShape::MoogSaw>( _ab, _frames, _chnl );
+			updateAM<WaveShape::MoogSaw>( _buf, _frames );
 			break;
 		case WaveShape::Exponential:
-			updateAM<WaveShape::Exponential>( _ab, _frames, _chnl );
+			updateAM<WaveShape::Exponential>( _buf, _frames );
 			break;
 		case WaveShape::WhiteNoise:
-			updateAM<WaveShape::WhiteNoise>( _ab, _frames, _chnl );
+			updateAM<WaveShape::WhiteNoise>( _buf, _frames );
 			break;
 		case WaveShape::UserDefined:
-			updateAM<WaveShape::UserDefined>( _ab, _frames, _chnl );
+			updateAM<WaveShape::UserDefined>( _buf, _frames );
 			break;
 	}
 }
@@ -430,35 +466,34 @@ void Oscillator::updateAM( SampleFrame* _ab, const f_cnt_t _frames,
 
 
 
-void Oscillator::updateMix( SampleFrame* _ab, const f_cnt_t _frames,
-							const ch_cnt_t _chnl )
+void Oscillator::updateMix( sample_t* _buf, const f_cnt_t _frames )
 {
 	switch( static_cast<WaveShape>(m_waveShapeModel->value()) )
 	{
 		case WaveShape::Sine:
 		default:
-			updateMix<WaveShape::Sine>( _ab, _frames, _chnl );
+			updateMix<WaveShape::Sine>( _buf, _frames );
 			break;
 		case WaveShape::Triangle:
-			updateMix<WaveShape::Triangle>( _ab, _frames, _chnl );
+			updateMix<WaveShape::Triangle>( _buf, _frames );
 			break;
 		case WaveShape::Saw:
-			updateMix<WaveShape::Saw>( _ab, _frames, _chnl );
+			updateMix<WaveShape::Saw>( _buf, _frames );
 			break;
 		case WaveShape::Square:
-			updateMix<WaveShape::Square>( _ab, _frames, _chnl );
+			updateMix<WaveShape::Square>( _buf, _frames );
 			break;
 		case WaveShape::MoogSaw:
-			updateMix<WaveShape::MoogSaw>( _ab, _frames, _chnl );
+			updateMix<WaveShape::MoogSaw>( _buf, _frames );
 			break;
 		case WaveShape::Exponential:
-			updateMix<WaveShape::Exponential>( _ab, _frames, _chnl );
+			updateMix<WaveShape::Exponential>( _buf, _frames );
 			break;
 		case WaveShape::WhiteNoise:
-			updateMix<WaveShape::WhiteNoise>( _ab, _frames, _chnl );
+			updateMix<WaveShape::WhiteNoise>( _buf, _frames );
 			break;
 		case WaveShape::UserDefined:
-			updateMix<WaveShape::UserDefined>( _ab, _frames, _chnl );
+			updateMix<WaveShape::UserDefined>( _buf, _frames );
 			break;
 	}
 }
@@ -466,35 +501,34 @@ void Oscillator::updateMix( SampleFrame* _ab, const f_cnt_t _frames,
 
 
 
-void Oscillator::updateSync( SampleFrame* _ab, const f_cnt_t _frames,
-							const ch_cnt_t _chnl )
+void Oscillator::updateSync( sample_t* _buf, const f_cnt_t _frames )
 {
 	switch( static_cast<WaveShape>(m_waveShapeModel->value()) )
 	{
 		case WaveShape::Sine:
 		default:
-			updateSync<WaveShape::Sine>( _ab, _frames, _chnl );
+			updateSync<WaveShape::Sine>( _buf, _frames );
 			break;
 		case WaveShape::Triangle:
-			updateSync<WaveShape::Triangle>( _ab, _frames, _chnl );
+			updateSync<WaveShape::Triangle>( _buf, _frames );
 			break;
 		case WaveShape::Saw:
-			updateSync<WaveShape::Saw>( _ab, _frames, _chnl );
+			updateSync<WaveShape::Saw>( _buf, _frames );
 			break;
 		case WaveShape::Square:
-			updateSync<WaveShape::Square>( _ab, _frames, _chnl );
+			updateSync<WaveShape::Square>( _buf, _frames );
 			break;
 		case WaveShape::MoogSaw:
-			updateSync<WaveShape::MoogSaw>( _ab, _frames, _chnl );
+			updateSync<WaveShape::MoogSaw>( _buf, _frames );
 			break;
 		case WaveShape::Exponential:
-			updateSync<WaveShape::Exponential>( _ab, _frames, _chnl );
+			updateSync<WaveShape::Exponential>( _buf, _frames );
 			break;
 		case WaveShape::WhiteNoise:
-			updateSync<WaveShape::WhiteNoise>( _ab, _frames, _chnl );
+			updateSync<WaveShape::WhiteNoise>( _buf, _frames );
 			break;
 		case WaveShape::UserDefined:
-			updateSync<WaveShape::UserDefined>( _ab, _frames, _chnl );
+			updateSync<WaveShape::UserDefined>( _buf, _frames );
 			break;
 	}
 }
@@ -502,35 +536,34 @@ void Oscillator::updateSync( SampleFrame* _ab, const f_cnt_t _frames,
 
 
 
-void Oscillator::updateFM( SampleFrame* _ab, const f_cnt_t _frames,
-							const ch_cnt_t _chnl )
+void Oscillator::updateFM( sample_t* _buf, const f_cnt_t _frames )
 {
 	switch( static_cast<WaveShape>(m_waveShapeModel->value()) )
 	{
 		case WaveShape::Sine:
 		default:
-			updateFM<WaveShape::Sine>( _ab, _frames, _chnl );
+			updateFM<WaveShape::Sine>( _buf, _frames );
 			break;
 		case WaveShape::Triangle:
-			updateFM<WaveShape::Triangle>( _ab, _frames, _chnl );
+			updateFM<WaveShape::Triangle>( _buf, _frames );
 			break;
 		case WaveShape::Saw:
-			updateFM<WaveShape::Saw>( _ab, _frames, _chnl );
+			updateFM<WaveShape::Saw>( _buf, _frames );
 			break;
 		case WaveShape::Square:
-			updateFM<WaveShape::Square>( _ab, _frames, _chnl );
+			updateFM<WaveShape::Square>( _buf, _frames );
 			break;
 		case WaveShape::MoogSaw:
-			updateFM<WaveShape::MoogSaw>( _ab, _frames, _chnl );
+			updateFM<WaveShape::MoogSaw>( _buf, _frames );
 			break;
 		case WaveShape::Exponential:
-			updateFM<WaveShape::Exponential>( _ab, _frames, _chnl );
+			updateFM<WaveShape::Exponential>( _buf, _frames );
 			break;
 		case WaveShape::WhiteNoise:
-			updateFM<WaveShape::WhiteNoise>( _ab, _frames, _chnl );
+			updateFM<WaveShape::WhiteNoise>( _buf, _frames );
 			break;
 		case WaveShape::UserDefined:
-			updateFM<WaveShape::UserDefined>( _ab, _frames, _chnl );
+			updateFM<WaveShape::UserDefined>( _buf, _frames );
 			break;
 	}
 }
@@ -564,12 +597,11 @@ inline bool Oscillator::syncOk( float _osc_coeff )
 
 
 
-float Oscillator::syncInit( SampleFrame* _ab, const f_cnt_t _frames,
-						const ch_cnt_t _chnl )
+float Oscillator::syncInit( sample_t* _buf, const f_cnt_t _frames )
 {
 	if( m_subOsc != nullptr )
 	{
-		m_subOsc->update( _ab, _frames, _chnl );
+		m_subOsc->updateBlock( _buf, _frames, false );
 	}
 	recalcPhase();
 	return m_freq * m_detuning_div_samplerate;
@@ -578,19 +610,38 @@ float Oscillator::syncInit( SampleFrame* _ab, const f_cnt_t _frames,
 
 
 
+int Oscillator::waveTableBand() const
+{
+	return waveTableBandFromFreq(m_freq * m_detuning_div_samplerate * Engine::audioEngine()->outputSampleRate());
+}
+
+
+
+
+// The update functions below first work out the phase of every frame, which
+// depends on the modulation algorithm, and then let sampleBlock() evaluate
+// the wave shape for the whole block at once.
+
 // if we have no sub-osc, we can't do any modulation... just get our samples
 template<Oscillator::WaveShape W>
-void Oscillator::updateNoSub( SampleFrame* _ab, const f_cnt_t _frames,
-							const ch_cnt_t _chnl )
+void Oscillator::updateNoSub( sample_t* _buf, const f_cnt_t _frames )
 {
 	recalcPhase();
 	const float osc_coeff = m_freq * m_detuning_div_samplerate;
 
+	std::array<float, BlockSize> phases;
 	for( f_cnt_t frame = 0; frame < _frames; ++frame )
 	{
-		_ab[frame][_chnl] = getSample<W>( m_phase ) * m_volume;
+		phases[frame] = m_phase;
 		m_phase += osc_coeff;
 	}
+
+	sampleBlock<W>( phases.data(), _buf, _frames );
+	const float volume = m_volume;
+	for( f_cnt_t frame = 0; frame < _frames; ++frame )
+	{
+		_buf[frame] *= volume;
+	}
 }
 
 
@@ -598,20 +649,25 @@ void Oscillator::updateNoSub( SampleFrame* _ab, const f_cnt_t _frames,
 
 // do pm by using sub-osc as modulator
 template<Oscillator::WaveShape W>
-void Oscillator::updatePM( SampleFrame* _ab, const f_cnt_t _frames,
-							const ch_cnt_t _chnl )
+void Oscillator::updatePM( sample_t* _buf, const f_cnt_t _frames )
 {
-	m_subOsc->update( _ab, _frames, _chnl, true );
+	m_subOsc->updateBlock( _buf, _frames, true );
 	recalcPhase();
 	const float osc_coeff = m_freq * m_detuning_div_samplerate;
 
+	std::array<float, BlockSize> phases;
 	for( f_cnt_t frame = 0; frame < _frames; ++frame )
 	{
-		_ab[frame][_chnl] = getSample<W>( m_phase +
-					_ab[frame][_chnl] )
-							* m_volume;
+		phases[frame] = m_phase + _buf[frame];
 		m_phase += osc_coeff;
 	}
+
+	sampleBlock<W>( phases.data(), _buf, _frames );
+	const float volume = m_volume;
+	for( f_cnt_t frame = 0; frame < _frames; ++frame )
+	{
+		_buf[frame] *= volume;
+	}
 }
 
 
@@ -619,18 +675,26 @@ void Oscillator::updatePM( SampleFrame* _ab, const f_cnt_t _frames,
 
 // do am by using sub-osc as modulator
 template<Oscillator::WaveShape W>
-void Oscillator::updateAM( SampleFrame* _ab, const f_cnt_t _frames,
-							const ch_cnt_t _chnl )
+void Oscillator::updateAM( sample_t* _buf, const f_cnt_t _frames )
 {
-	m_subOsc->update( _ab, _frames, _chnl, false );
+	m_subOsc->updateBlock( _buf, _frames, false );
 	recalcPhase();
 	const float osc_coeff = m_freq * m_detuning_div_samplerate;
 
+	std::array<float, BlockSize> phases;
 	for( f_cnt_t frame = 0; frame < _frames; ++frame )
 	{
-		_ab[frame][_chnl] *= getSample<W>( m_phase ) * m_volume;
+		phases[frame] = m_phase;
 		m_phase += osc_coeff;
 	}
+
+	std::array<sample_t, BlockSize> samples;
+	sampleBlock<W>( phases.data(), samples.data(), _frames );
+	const float volume = m_volume;
+	for( f_cnt_t frame = 0; frame < _frames; ++frame )
+	{
+		_buf[frame] *= samples[frame] * volume;
+	}
 }
 
 
@@ -638,18 +702,26 @@ void Oscillator::updateAM( SampleFrame* _ab, const f_cnt_t _frames,
 
 // do mix by using sub-osc as mix-sample
 template<Oscillator::WaveShape W>
-void Oscillator::updateMix( SampleFrame* _ab, const f_cnt_t _frames,
-							const ch_cnt_t _chnl )
+void Oscillator::updateMix( sample_t* _buf, const f_cnt_t _frames )
 {
-	m_subOsc->update( _ab, _frames, _chnl, false );
+	m_subOsc->updateBlock( _buf, _frames, false );
 	recalcPhase();
 	const float osc_coeff = m_freq * m_detuning_div_samplerate;
 
+	std::array<float, BlockSize> phases;
 	for( f_cnt_t frame = 0; frame < _frames; ++frame )
 	{
-		_ab[frame][_chnl] += getSample<W>( m_phase ) * m_volume;
+		phases[frame] = m_phase;
 		m_phase += osc_coeff;
 	}
+
+	std::array<sample_t, BlockSize> samples;
+	sampleBlock<W>( phases.data(), samples.data(), _frames );
+	const float volume = m_volume;
+	for( f_cnt_t frame = 0; frame < _frames; ++frame )
+	{
+		_buf[frame] += samples[frame] * volume;
+	}
 }
 
 
@@ -658,22 +730,29 @@ void Oscillator::updateMix( SampleFrame* _ab, const f_cnt_t _frames,
 // sync with sub-osc (every time sub-osc starts new period, we also start new
 // period)
 template<Oscillator::WaveShape W>
-void Oscillator::updateSync( SampleFrame* _ab, const f_cnt_t _frames,
-							const ch_cnt_t _chnl )
+void Oscillator::updateSync( sample_t* _buf, const f_cnt_t _frames )
 {
-	const float sub_osc_coeff = m_subOsc->syncInit( _ab, _frames, _chnl );
+	const float sub_osc_coeff = m_subOsc->syncInit( _buf, _frames );
 	recalcPhase();
 	const float osc_coeff = m_freq * m_detuning_div_samplerate;
 
+	std::array<float, BlockSize> phases;
 	for( f_cnt_t frame = 0; frame < _frames ; ++frame )
 	{
 		if( m_subOsc->syncOk( sub_osc_coeff ) )
 		{
 			m_phase = m_phaseOffset;
 		}
-		_ab[frame][_chnl] = getSample<W>( m_phase ) * m_volume;
+		phases[frame] = m_phase;
 		m_phase += osc_coeff;
 	}
+
+	sampleBlock<W>( phases.data(), _buf, _frames );
+	const float volume = m_volume;
+	for( f_cnt_t frame = 0; frame < _frames; ++frame )
+	{
+		_buf[frame] *= volume;
+	}
 }
 
 
@@ -681,37 +760,45 @@ void Oscillator::updateSync( SampleFrame* _ab, const f_cnt_t _frames,
 
 // do fm by using sub-osc as modulator
 template<Oscillator::WaveShape W>
-void Oscillator::updateFM( SampleFrame* _ab, const f_cnt_t _frames,
-							const ch_cnt_t _chnl )
+void Oscillator::updateFM( sample_t* _buf, const f_cnt_t _frames )
 {
-	m_subOsc->update( _ab, _frames, _chnl, true );
+	m_subOsc->updateBlock( _buf, _frames, true );
 	recalcPhase();
 	const float osc_coeff = m_freq * m_detuning_div_samplerate;
 	const float sampleRateCorrection = 44100.0f / Engine::audioEngine()->outputSampleRate();
 
+	std::array<float, BlockSize> phases;
 	for( f_cnt_t frame = 0; frame < _frames; ++frame )
 	{
-		m_phase += _ab[frame][_chnl] * sampleRateCorrection;
-		_ab[frame][_chnl] = getSample<W>( m_phase ) * m_volume;
+		m_phase += _buf[frame] * sampleRateCorrection;
+		phases[frame] = m_phase;
 		m_phase += osc_coeff;
 	}
+
+	sampleBlock<W>( phases.data(), _buf, _frames );
+	const float volume = m_volume;
+	for( f_cnt_t frame = 0; frame < _frames; ++frame )
+	{
+		_buf[frame] *= volume;
+	}
 }
 
 
 
 
 template<>
-inline sample_t Oscillator::getSample<Oscillator::WaveShape::Sine>(const float sample)
+void Oscillator::sampleBlock<Oscillator::WaveShape::Sine>(
+		const float* _phases, sample_t* _out, const f_cnt_t _frames )
 {
 	const float current_freq = m_freq * m_detuning_div_samplerate * Engine::audioEngine()->outputSampleRate();
 
 	if (!m_useWaveTable || current_freq < OscillatorConstants::MAX_FREQ)
 	{
-		return sinSample(sample);
+		OscillatorKernels::best().sine(_phases, _out, _frames);
 	}
 	else
 	{
-		return 0;
+		std::fill_n(_out, _frames, 0.f);
 	}
 }
 
@@ -719,16 +806,18 @@ inline sample_t Oscillator::getSample<Oscillator::WaveShape::Sine>(const float s
 
 
 template<>
-inline sample_t Oscillator::getSample<Oscillator::WaveShape::Triangle>(
-		const float _sample )
+void Oscillator::sampleBlock<Oscillator::WaveShape::Triangle>(
+		const float* _phases, sample_t* _out, const f_cnt_t _frames )
 {
+	const auto& kernels = OscillatorKernels::best();
 	if (m_useWaveTable && !m_isModulator)
 	{
-		return wtSample(s_waveTables[static_cast<std::size_t>(WaveShape::Triangle) - FirstWaveShapeTable],_sample);
+		const auto table = s_waveTables[static_cast<std::size_t>(WaveShape::Triangle) - FirstWaveShapeTable];
+		kernels.table(table[waveTableBand()], _phases, _out, _frames);
 	}
 	else
 	{
-		return triangleSample(_sample);
+		kernels.triangle(_phases, _out, _frames);
 	}
 }
 
@@ -736,16 +825,18 @@ inline sample_t Oscillator::getSample<Oscillator::WaveShape::Triangle>(
 
 
 template<>
-inline sample_t Oscillator::getSample<Oscillator::WaveShape::Saw>(
-		const float _sample )
+void Oscillator::sampleBlock<Oscillator::WaveShape::Saw>(
+		const float* _phases, sample_t* _out, const f_cnt_t _frames )
 {
+	const auto& kernels = OscillatorKernels::best();
 	if (m_useWaveTable && !m_isModulator)
 	{
-		return wtSample(s_waveTables[static_cast<std::size_t>(WaveShape::Saw) - FirstWaveShapeTable], _sample);
+		const auto table = s_waveTables[static_cast<std::size_t>(WaveShape::Saw) - FirstWaveShapeTable];
+		kernels.table(table[waveTableBand()], _phases, _out, _frames);
 	}
 	else
 	{
-		return sawSample(_sample);
+		kernels.saw(_phases, _out, _frames);
 	}
 }
 
@@ -753,16 +844,18 @@ inline sample_t Oscillator::getSample<Oscillator::WaveShape::Saw>(
 
 
 template<>
-inline sample_t Oscillator::getSample<Oscillator::WaveShape::Square>(
-		const float _sample )
+void Oscillator::sampleBlock<Oscillator::WaveShape::Square>(
+		const float* _phases, sample_t* _out, const f_cnt_t _frames )
 {
+	const auto& kernels = OscillatorKernels::best();
 	if (m_useWaveTable && !m_isModulator)
 	{
-		return wtSample(s_waveTables[static_cast<std::size_t>(WaveShape::Square) - FirstWaveShapeTable], _sample);
+		const auto table = s_waveTables[static_cast<std::size_t>(WaveShape::Square) - FirstWaveShapeTable];
+		kernels.table(table[waveTableBand()], _phases, _out, _frames);
 	}
 	else
 	{
-		return squareSample(_sample);
+		kernels.square(_phases, _out, _frames);
 	}
 }
 
@@ -770,16 +863,18 @@ inline sample_t Oscillator::getSample<Oscillator::WaveShape::Square>(
 
 
 template<>
-inline sample_t Oscillator::getSample<Oscillator::WaveShape::MoogSaw>(
-							const float _sample )
+void Oscillator::sampleBlock<Oscillator::WaveShape::MoogSaw>(
+		const float* _phases, sample_t* _out, const f_cnt_t _frames )
 {
+	const auto& kernels = OscillatorKernels::best();
 	if (m_useWaveTable && !m_isModulator)
 	{
-		return wtSample(s_waveTables[static_cast<std::size_t>(WaveShape::MoogSaw) - FirstWaveShapeTable], _sample);
+		const auto table = s_waveTables[static_cast<std::size_t>(WaveShape::MoogSaw) - FirstWaveShapeTable];
+		kernels.table(table[waveTableBand()], _phases, _out, _frames);
 	}
 	else
 	{
-		return moogSawSample(_sample);
+		kernels.moogSaw(_phases, _out, _frames);
 	}
 }
 
@@ -787,16 +882,18 @@ inline sample_t Oscillator::getSample<Oscillator::WaveShape::MoogSaw>(
 
 
 template<>
-inline sample_t Oscillator::getSample<Oscillator::WaveShape::Exponential>(
-							const float _sample )
+void Oscillator::sampleBlock<Oscillator::WaveShape::Exponential>(
+		const float* _phases, sample_t* _out, const f_cnt_t _frames )
 {
+	const auto& kernels = OscillatorKernels::best();
 	if (m_useWaveTable && !m_isModulator)
 	{
-		return wtSample(s_waveTables[static_cast<std::size_t>(WaveShape::Exponential) - FirstWaveShapeTable], _sample);
+		const auto table = s_waveTables[static_cast<std::size_t>(WaveShape::Exponential) - FirstWaveShapeTable];
+		kernels.table(table[waveTableBand()], _phases, _out, _frames);
 	}
 	else
 	{
-		return expSample(_sample);
+		kernels.exponential(_phases, _out, _frames);
 	}
 }
 
@@ -804,26 +901,32 @@ inline sample_t Oscillator::getSample<Oscillator::WaveShape::Exponential>(
 
 
 template<>
-inline sample_t Oscillator::getSample<Oscillator::WaveShape::WhiteNoise>(
-							const float _sample )
+void Oscillator::sampleBlock<Oscillator::WaveShape::WhiteNoise>(
+		const float* _phases, sample_t* _out, const f_cnt_t _frames )
 {
-	return( noiseSample( _sample ) );
+	for( f_cnt_t frame = 0; frame < _frames; ++frame )
+	{
+		_out[frame] = noiseSample( _phases[frame] );
+	}
 }
 
 
 
 
 template<>
-inline sample_t Oscillator::getSample<Oscillator::WaveShape::UserDefined>(
-							const float _sample )
+void Oscillator::sampleBlock<Oscillator::WaveShape::UserDefined>(
+		const float* _phases, sample_t* _out, const f_cnt_t _frames )
 {
 	if (m_useWaveTable && m_userAntiAliasWaveTable && !m_isModulator)
 	{
-		return wtSample(m_userAntiAliasWaveTable.get(), _sample);
+		OscillatorKernels::best().table((*m_userAntiAliasWaveTable)[waveTableBand()].data(), _phases, _out, _frames);
 	}
 	else
 	{
-		return userWaveSample(m_userWave.get(), _sample);
+		for( f_cnt_t frame = 0; frame < _frames; ++frame )
+		{
+			_out[frame] = userWaveSample(m_userWave.get(), _phases[frame]);
+		}
 	}
 }
 
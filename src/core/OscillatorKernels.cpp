@@ -0,0 +1,105 @@
+/*
+ * OscillatorKernels.cpp - scalar and SSE2 oscillator kernels, runtime dispatch
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "OscillatorKernels.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "Oscillator.h"
+#include "OscillatorKernelsImpl.h"
+#include "SimdDispatch.h"
+#include "SimdVector.h"
+
+namespace lmms::OscillatorKernels
+{
+
+namespace
+{
+
+template<sample_t (*F)(const float)>
+void scalarShape(const float* phases, sample_t* out, std::size_t count)
+{
+	for (std::size_t i = 0; i < count; ++i) { out[i] = F(phases[i]); }
+}
+
+void scalarTable(const sample_t* table, const float* phases, sample_t* out, std::size_t count)
+{
+	using OscillatorConstants::WAVETABLE_LENGTH;
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		const float frame = absFraction(phases[i]) * WAVETABLE_LENGTH;
+		const auto f1 = std::min(static_cast<int>(frame), WAVETABLE_LENGTH - 1);
+		const auto f2 = f1 < WAVETABLE_LENGTH - 1 ? f1 + 1 : 0;
+		out[i] = std::lerp(table[f1], table[f2], frame - f1);
+	}
+}
+
+const auto s_scalarKernels = KernelSet{
+	"scalar",
+	scalarShape<&Oscillator::sinSample>,
+	scalarShape<&Oscillator::triangleSample>,
+	scalarShape<&Oscillator::sawSample>,
+	scalarShape<&Oscillator::squareSample>,
+	scalarShape<&Oscillator::moogSawSample>,
+	scalarShape<&Oscillator::expSample>,
+	scalarTable
+};
+
+simd::KernelSets<KernelSet> kernelSets()
+{
+	return {&s_scalarKernels, sse2Kernels(), avx2Kernels(), avx512Kernels()};
+}
+
+} // namespace
+
+
+
+
+const KernelSet* sse2Kernels()
+{
+#ifdef __SSE2__
+	return &Kernels<simd::Sse2>::kernelSet("sse2");
+#else
+	return nullptr;
+#endif
+}
+
+
+
+
+const KernelSet& best()
+{
+	static const KernelSet& kernels = kernelSets().best();
+	return kernels;
+}
+
+
+
+
+std::vector<const KernelSet*> supported()
+{
+	return kernelSets().supported();
+}
+
+
+} // namespace lmms::OscillatorKernels
@@ -0,0 +1,168 @@
+/*
+ * OscillatorKernelsImpl.h - vectorised oscillator kernels, generic over the
+ *                           instruction set
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_OSCILLATOR_KERNELS_IMPL_H
+#define LMMS_OSCILLATOR_KERNELS_IMPL_H
+
+#include <cstddef>
+#include <numbers>
+
+#include "OscillatorConstants.h"
+#include "OscillatorKernels.h"
+
+namespace lmms::OscillatorKernels
+{
+
+// see simd::KernelSets
+const KernelSet* sse2Kernels();
+const KernelSet* avx2Kernels();
+const KernelSet* avx512Kernels();
+
+// internal linkage only, see SimdVector.h
+namespace
+{
+
+//! V is one of the register wrappers from SimdVector.h
+template<typename V>
+struct Kernels
+{
+	using Vec = typename V::Vec;
+
+	static Vec fraction(Vec x)
+	{
+		return V::sub(x, V::floor(x));
+	}
+
+	//! sin(2 * pi * x), with an error below 2e-7
+	static Vec sine(Vec x)
+	{
+		// fold into y in [-0.5, 0.5], sin(2 pi x) = sin(pi y)
+		const Vec one = V::set1(1.f);
+		const Vec half = V::set1(0.5f);
+		Vec t = V::sub(fraction(x), half);           // [-0.5, 0.5), sin(2 pi x) = -sin(2 pi t)
+		Vec a = V::max(t, V::sub(V::set1(0.f), t));  // |t|
+		a = V::min(V::add(a, a), V::sub(one, V::add(a, a))); // fold 2|t| around 0.5
+		const Vec y = V::select(V::gt(t, V::set1(0.f)), V::sub(V::set1(0.f), a), a);
+
+		// Taylor series of sin(pi y) up to y^11
+		constexpr auto pi = std::numbers::pi_v<float>;
+		const Vec y2 = V::mul(y, y);
+		Vec p = V::set1(-pi * pi * pi * pi * pi * pi * pi * pi * pi * pi * pi / 39916800.f);
+		p = V::mulAdd(p, y2, V::set1(pi * pi * pi * pi * pi * pi * pi * pi * pi / 362880.f));
+		p = V::mulAdd(p, y2, V::set1(-pi * pi * pi * pi * pi * pi * pi / 5040.f));
+		p = V::mulAdd(p, y2, V::set1(pi * pi * pi * pi * pi / 120.f));
+		p = V::mulAdd(p, y2, V::set1(-pi * pi * pi / 6.f));
+		p = V::mulAdd(p, y2, V::set1(pi));
+		return V::mul(p, y);
+	}
+
+	static Vec triangle(Vec x)
+	{
+		const Vec ph = fraction(x);
+		const Vec t = V::mul(ph, V::set1(4.f));
+		const Vec falling = V::sub(V::set1(2.f), t);
+		const Vec rising = V::sub(t, V::set1(4.f));
+		return V::select(V::le(ph, V::set1(0.25f)), t,
+			V::select(V::le(ph, V::set1(0.75f)), falling, rising));
+	}
+
+	static Vec saw(Vec x)
+	{
+		return V::mulAdd(fraction(x), V::set1(2.f), V::set1(-1.f));
+	}
+
+	static Vec square(Vec x)
+	{
+		return V::select(V::gt(fraction(x), V::set1(0.5f)), V::set1(-1.f), V::set1(1.f));
+	}
+
+	static Vec moogSaw(Vec x)
+	{
+		const Vec ph = fraction(x);
+		return V::select(V::lt(ph, V::set1(0.5f)),
+			V::mulAdd(ph, V::set1(4.f), V::set1(-1.f)),
+			V::mulAdd(ph, V::set1(-2.f), V::set1(1.f)));
+	}
+
+	static Vec exponential(Vec x)
+	{
+		Vec ph = fraction(x);
+		ph = V::select(V::gt(ph, V::set1(0.5f)), V::sub(V::set1(1.f), ph), ph);
+		return V::mulAdd(V::mul(ph, ph), V::set1(8.f), V::set1(-1.f));
+	}
+
+	static Vec table(const sample_t* table, Vec x)
+	{
+		constexpr auto length = static_cast<float>(OscillatorConstants::WAVETABLE_LENGTH);
+		const Vec frame = V::mul(fraction(x), V::set1(length));
+		const Vec f1 = V::min(V::floor(frame), V::set1(length - 1));
+		Vec f2 = V::add(f1, V::set1(1.f));
+		f2 = V::select(V::ge(f2, V::set1(length)), V::set1(0.f), f2);
+
+		const Vec a = V::gather(table, f1);
+		const Vec b = V::gather(table, f2);
+		return V::mulAdd(V::sub(b, a), V::sub(frame, f1), a);
+	}
+
+	//! Runs @p f over all phases, the last partial vector is padded
+	template<typename F>
+	static void forEach(const float* phases, sample_t* out, std::size_t count, F f)
+	{
+		std::size_t i = 0;
+		for (; i + V::Width <= count; i += V::Width)
+		{
+			V::store(out + i, f(V::load(phases + i)));
+		}
+		if (i < count)
+		{
+			alignas(64) float in[V::Width] = {};
+			alignas(64) float result[V::Width];
+			for (std::size_t j = 0; j < count - i; ++j) { in[j] = phases[i + j]; }
+			V::store(result, f(V::load(in)));
+			for (std::size_t j = 0; j < count - i; ++j) { out[i + j] = result[j]; }
+		}
+	}
+
+	static const KernelSet& kernelSet(const char* name)
+	{
+		static const auto set = KernelSet{
+			name,
+			[](const float* p, sample_t* o, std::size_t n) { forEach(p, o, n, [](Vec x) { return sine(x); }); },
+			[](const float* p, sample_t* o, std::size_t n) { forEach(p, o, n, [](Vec x) { return triangle(x); }); },
+			[](const float* p, sample_t* o, std::size_t n) { forEach(p, o, n, [](Vec x) { return saw(x); }); },
+			[](const float* p, sample_t* o, std::size_t n) { forEach(p, o, n, [](Vec x) { return square(x); }); },
+			[](const float* p, sample_t* o, std::size_t n) { forEach(p, o, n, [](Vec x) { return moogSaw(x); }); },
+			[](const float* p, sample_t* o, std::size_t n) { forEach(p, o, n, [](Vec x) { return exponential(x); }); },
+			[](const sample_t* t, const float* p, sample_t* o, std::size_t n) {
+				forEach(p, o, n, [t](Vec x) { return table(t, x); });
+			}
+		};
+		return set;
+	}
+};
+
+} // namespace
+
+} // namespace lmms::OscillatorKernels
+
+#endif // LMMS_OSCILLATOR_KERNELS_IMPL_H
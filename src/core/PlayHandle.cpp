@@ -26,6 +26,7 @@
 #include "AudioEngine.h"
 #include "BufferManager.h"
 #include "Engine.h"
+#include "MixHelpers.h"
 
 #include <QThread>
 
@@ -39,6 +40,7 @@ PlayHandle::PlayHandle(const Type type, f_cnt_t offset) :
 		m_affinity(QThread::currentThread()),
 		m_playHandleBuffer(BufferManager::acquire()),
 		m_bufferReleased(true),
+		m_bufferSilent(true),
 		m_usesBuffer(true)
 {
 }
@@ -54,9 +56,13 @@ void PlayHandle::doProcessing()
 {
 	if( m_usesBuffer )
 	{
+		const auto fpp = Engine::audioEngine()->framesPerPeriod();
 		m_bufferReleased = false;
-		zeroSampleFrames(m_playHandleBuffer, Engine::audioEngine()->framesPerPeriod());
+		zeroSampleFrames(m_playHandleBuffer, fpp);
 		play( buffer() );
+		// checked here so it runs in parallel with the other play handles,
+		// the check stops at the first loud sample
+		m_bufferSilent = MixHelpers::isSilent(m_playHandleBuffer, fpp);
 	}
 	else
 	{
@@ -65,6 +71,15 @@ void PlayHandle::doProcessing()
 }
 
 
+void PlayHandle::updateBufferSilence()
+{
+	if (m_usesBuffer && !m_bufferReleased)
+	{
+		m_bufferSilent = MixHelpers::isSilent(m_playHandleBuffer, Engine::audioEngine()->framesPerPeriod());
+	}
+}
+
+
 void PlayHandle::releaseBuffer()
 {
 	m_bufferReleased = true;
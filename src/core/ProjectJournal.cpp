@@ -22,10 +22,15 @@
  *
  */
 
+#include <algorithm>
 #include <cstdlib>
+#include <vector>
+#include <QDataStream>
 #include <QDomElement>
+#include <QTextStream>
 
 #include "ProjectJournal.h"
+#include "ConfigManager.h"
 #include "Engine.h"
 #include "JournallingObject.h"
 #include "lmms_math.h"
@@ -45,6 +50,9 @@ ProjectJournal::ProjectJournal() :
 	m_joIDs(),
 	m_undoCheckPoints(),
 	m_redoCheckPoints(),
+	m_undoBytes( 0 ),
+	m_undoMemoryLimit( configuredUndoMemoryLimit() ),
+	m_lastCheckPoint(),
 	m_journalling( false )
 {
 }
@@ -54,28 +62,19 @@ ProjectJournal::ProjectJournal() :
 
 void ProjectJournal::undo()
 {
+	// an edit right after this isn't merged with the one before it
+	m_lastCheckPoint = {};
+
 	while( !m_undoCheckPoints.isEmpty() )
 	{
-		CheckPoint c = m_undoCheckPoints.pop();
-		JournallingObject *jo = m_joIDs[c.joID];
+		jo_id_t id;
+		const QByteArray state = popUndoCheckPoint( id );
+		JournallingObject *jo = m_joIDs[id];
 
 		if( jo )
 		{
-			DataFile curState( DataFile::Type::JournalData );
-			jo->saveState( curState, curState.content() );
-			m_redoCheckPoints.push( CheckPoint( c.joID, curState ) );
-
-			bool prev = isJournalling();
-			setJournalling( false );
-			jo->restoreState( c.data.content().firstChildElement() );
-			setJournalling( prev );
-			Engine::getSong()->setModified();
-
-			// loading AutomationClip connections correctly
-			if (!c.data.content().elementsByTagName("automationclip").isEmpty())
-			{
-				AutomationClip::resolveAllIDs();
-			}
+			m_redoCheckPoints.push( fullCheckPoint( id, saveObjectState( jo ) ) );
+			restoreObjectState( jo, state );
 			break;
 		}
 	}
@@ -85,6 +84,8 @@ void ProjectJournal::undo()
 
 void ProjectJournal::redo()
 {
+	m_lastCheckPoint = {};
+
 	while( !m_redoCheckPoints.isEmpty() )
 	{
 		CheckPoint c = m_redoCheckPoints.pop();
@@ -92,15 +93,9 @@ void ProjectJournal::redo()
 
 		if( jo )
 		{
-			DataFile curState( DataFile::Type::JournalData );
-			jo->saveState( curState, curState.content() );
-			m_undoCheckPoints.push( CheckPoint( c.joID, curState ) );
-
-			bool prev = isJournalling();
-			setJournalling( false );
-			jo->restoreState( c.data.content().firstChildElement() );
-			setJournalling( prev );
-			Engine::getSong()->setModified();
+			pushUndoCheckPoint( c.joID, saveObjectState( jo ) );
+			trimUndoCheckPoints();
+			restoreObjectState( jo, qUncompress( c.data ) );
 			break;
 		}
 	}
@@ -118,21 +113,370 @@ bool ProjectJournal::canRedo() const
 
 
 
-void ProjectJournal::addJournalCheckPoint( JournallingObject *jo )
+void ProjectJournal::addJournalCheckPoint( JournallingObject *jo, bool coalesce )
 {
 	if( isJournalling() )
 	{
 		m_redoCheckPoints.clear();
 
-		DataFile dataFile( DataFile::Type::JournalData );
-		jo->saveState( dataFile, dataFile.content() );
+		// the newest check point already holds the state from before the
+		// first of several quick edits. m_lastCheckPoint is only set while
+		// the newest check point may be merged with.
+		const auto now = Clock::now();
+		const bool merge = coalesce && !m_undoCheckPoints.isEmpty() && m_undoCheckPoints.top().joID == jo->id()
+			&& now - m_lastCheckPoint < CoalesceInterval;
+		m_lastCheckPoint = coalesce ? now : Clock::time_point{};
+		if( merge )
+		{
+			return;
+		}
+
+		pushUndoCheckPoint( jo->id(), saveObjectState( jo ) );
+		trimUndoCheckPoints();
+	}
+}
+
+
+
+
+qsizetype ProjectJournal::configuredUndoMemoryLimit()
+{
+	return static_cast<qsizetype>(
+		ConfigManager::inst()->value( "app", "undomemorylimit", "64" ).toDouble() * 1024 * 1024 );
+}
+
+
+
+
+QByteArray ProjectJournal::saveObjectState( JournallingObject* jo )
+{
+	DataFile dataFile( DataFile::Type::JournalData );
+	jo->saveState( dataFile, dataFile.content() );
+	return dataFile.toByteArray( -1 );
+}
+
+
+
+
+void ProjectJournal::restoreObjectState( JournallingObject* jo, const QByteArray& state )
+{
+	DataFile dataFile( state );
+
+	bool prev = isJournalling();
+	setJournalling( false );
+	jo->restoreState( dataFile.content().firstChildElement() );
+	setJournalling( prev );
+	Engine::getSong()->setModified();
+
+	// loading AutomationClip connections correctly
+	if (!dataFile.content().elementsByTagName("automationclip").isEmpty())
+	{
+		AutomationClip::resolveAllIDs();
+	}
+}
+
+
+
+
+ProjectJournal::CheckPoint ProjectJournal::fullCheckPoint( jo_id_t id, const QByteArray& state )
+{
+	auto c = CheckPoint{};
+	c.joID = id;
+	c.data = qCompress( state );
+	return c;
+}
+
+
+
+
+namespace
+{
+
+QDomDocument parseState( const QByteArray& state )
+{
+	QDomDocument doc;
+	doc.setContent( state );
+	return doc;
+}
+
+
+
+
+QString nodeText( const QDomNode& node )
+{
+	QString text;
+	QTextStream stream( &text );
+	node.save( stream, -1 );
+	return text;
+}
+
+
+
+
+std::vector<QString> childTexts( const QDomElement& element )
+{
+	const QDomNodeList children = element.childNodes();
+	auto texts = std::vector<QString>{};
+	texts.reserve( children.size() );
+	for( int i = 0; i < children.size(); ++i )
+	{
+		texts.push_back( nodeText( children.item( i ) ) );
+	}
+	return texts;
+}
+
+
+
+
+/*
+ * A delta turns the newer element into the older one: the attributes of the
+ * older element if they differ, then the children that differ. Children at the start and at
+ * the end that are the same in both are kept. The ones in between are either
+ * paired up, if both have the same number of elements with the same names,
+ * and then written as deltas themselves, or written out in full.
+ */
+void writeElementDelta( QDataStream& out, const QDomElement& older, const QDomElement& newer )
+{
+	const QDomNamedNodeMap attributes = older.attributes();
+	bool attributesChanged = attributes.count() != newer.attributes().count();
+	for( int i = 0; !attributesChanged && i < attributes.count(); ++i )
+	{
+		const QDomAttr attribute = attributes.item( i ).toAttr();
+		attributesChanged = !newer.hasAttribute( attribute.name() )
+			|| newer.attribute( attribute.name() ) != attribute.value();
+	}
+	out << attributesChanged;
+	if( attributesChanged )
+	{
+		out << static_cast<qint32>( attributes.count() );
+		for( int i = 0; i < attributes.count(); ++i )
+		{
+			const QDomAttr attribute = attributes.item( i ).toAttr();
+			out << attribute.name() << attribute.value();
+		}
+	}
+
+	const auto olderTexts = childTexts( older );
+	const auto newerTexts = childTexts( newer );
+	const auto length = std::min( olderTexts.size(), newerTexts.size() );
+	auto prefix = std::size_t{0};
+	while( prefix < length && olderTexts[prefix] == newerTexts[prefix] )
+	{
+		++prefix;
+	}
+	auto suffix = std::size_t{0};
+	while( suffix < length - prefix &&
+		olderTexts[olderTexts.size() - 1 - suffix] == newerTexts[newerTexts.size() - 1 - suffix] )
+	{
+		++suffix;
+	}
+	const auto olderCount = olderTexts.size() - prefix - suffix;
+	const auto newerCount = newerTexts.size() - prefix - suffix;
+
+	const QDomNodeList olderChildren = older.childNodes();
+	const QDomNodeList newerChildren = newer.childNodes();
+	bool paired = olderCount == newerCount;
+	for( auto i = prefix; paired && i < prefix + olderCount; ++i )
+	{
+		const QDomNode o = olderChildren.item( i );
+		const QDomNode n = newerChildren.item( i );
+		paired = o.isElement() && n.isElement() && o.nodeName() == n.nodeName();
+	}
+
+	out << static_cast<qint32>( prefix ) << static_cast<qint32>( newerCount ) << paired;
+	if( paired )
+	{
+		for( auto i = prefix; i < prefix + olderCount; ++i )
+		{
+			const bool changed = olderTexts[i] != newerTexts[i];
+			out << changed;
+			if( changed )
+			{
+				writeElementDelta( out, olderChildren.item( i ).toElement(), newerChildren.item( i ).toElement() );
+			}
+		}
+	}
+	else
+	{
+		auto text = QString{};
+		for( auto i = prefix; i < prefix + olderCount; ++i )
+		{
+			text += olderTexts[i];
+		}
+		out << text;
+	}
+}
+
+
+
+
+void applyElementDelta( QDataStream& in, QDomElement& element )
+{
+	bool attributesChanged;
+	in >> attributesChanged;
+	if( attributesChanged )
+	{
+		const QDomNamedNodeMap attributes = element.attributes();
+		auto names = QStringList{};
+		for( int i = 0; i < attributes.count(); ++i )
+		{
+			names << attributes.item( i ).nodeName();
+		}
+		for( const auto& name : names )
+		{
+			element.removeAttribute( name );
+		}
+		qint32 attributeCount;
+		in >> attributeCount;
+		for( qint32 i = 0; i < attributeCount; ++i )
+		{
+			QString name, value;
+			in >> name >> value;
+			element.setAttribute( name, value );
+		}
+	}
+
+	qint32 prefix, newerCount;
+	bool paired;
+	in >> prefix >> newerCount >> paired;
+
+	const QDomNodeList children = element.childNodes();
+	auto changed = std::vector<QDomNode>{};
+	for( qint32 i = prefix; i < prefix + newerCount; ++i )
+	{
+		changed.push_back( children.item( i ) );
+	}
+
+	if( paired )
+	{
+		for( auto& node : changed )
+		{
+			bool isChanged;
+			in >> isChanged;
+			if( isChanged )
+			{
+				QDomElement child = node.toElement();
+				applyElementDelta( in, child );
+			}
+		}
+		return;
+	}
+
+	QString text;
+	in >> text;
+	const QDomNode next = children.item( prefix + newerCount );
+	for( auto& node : changed )
+	{
+		element.removeChild( node );
+	}
+	QDomDocument fragment;
+	fragment.setContent( "<delta>" + text + "</delta>" );
+	for( QDomNode node = fragment.documentElement().firstChild(); !node.isNull(); node = node.nextSibling() )
+	{
+		element.insertBefore( element.ownerDocument().importNode( node, true ), next );
+	}
+}
+
+} // namespace
+
+
+
+
+ProjectJournal::CheckPoint ProjectJournal::deltaCheckPoint( jo_id_t id, const QByteArray& state,
+	const QByteArray& newer )
+{
+	QByteArray delta;
+	QDataStream out( &delta, QIODevice::WriteOnly );
+	writeElementDelta( out, parseState( state ).documentElement(), parseState( newer ).documentElement() );
+
+	auto c = CheckPoint{};
+	c.joID = id;
+	c.data = qCompress( delta );
+	c.isDelta = true;
+	return c;
+}
+
+
+
+
+QByteArray ProjectJournal::applyDelta( const CheckPoint& delta, const QByteArray& newer )
+{
+	QDomDocument doc = parseState( newer );
+	QDomElement root = doc.documentElement();
+	const QByteArray data = qUncompress( delta.data );
+	QDataStream in( data );
+	applyElementDelta( in, root );
+	return doc.toByteArray( -1 );
+}
+
+
+
+
+void ProjectJournal::pushUndoCheckPoint( jo_id_t id, const QByteArray& state )
+{
+	// the newest check point of an object is always complete
+	for( auto i = m_undoCheckPoints.size() - 1; i >= 0; --i )
+	{
+		CheckPoint& older = m_undoCheckPoints[i];
+		if( older.joID != id )
+		{
+			continue;
+		}
+		if( !older.isDelta )
+		{
+			m_undoBytes -= older.data.size();
+			older = deltaCheckPoint( id, qUncompress( older.data ), state );
+			m_undoBytes += older.data.size();
+		}
+		break;
+	}
+
+	m_undoCheckPoints.push( fullCheckPoint( id, state ) );
+	m_undoBytes += m_undoCheckPoints.top().data.size();
+}
+
 
-		m_undoCheckPoints.push( CheckPoint( jo->id(), dataFile ) );
-		if( m_undoCheckPoints.size() > MAX_UNDO_STATES )
+
+
+QByteArray ProjectJournal::popUndoCheckPoint( jo_id_t& id )
+{
+	const CheckPoint c = m_undoCheckPoints.pop();
+	m_undoBytes -= c.data.size();
+	id = c.joID;
+	const QByteArray state = qUncompress( c.data );
+
+	// the next older check point of the object is now its newest one
+	for( auto i = m_undoCheckPoints.size() - 1; i >= 0; --i )
+	{
+		CheckPoint& older = m_undoCheckPoints[i];
+		if( older.joID == id )
 		{
-			m_undoCheckPoints.remove( 0, m_undoCheckPoints.size() - MAX_UNDO_STATES );
+			m_undoBytes -= older.data.size();
+			older = fullCheckPoint( id, applyDelta( older, state ) );
+			m_undoBytes += older.data.size();
+			break;
 		}
 	}
+
+	return state;
+}
+
+
+
+
+void ProjectJournal::trimUndoCheckPoints()
+{
+	// deltas only refer to newer check points, so the oldest can always go
+	auto remove = qsizetype{0};
+	auto bytes = m_undoBytes;
+	while( m_undoCheckPoints.size() - remove > 1 &&
+		( m_undoCheckPoints.size() - remove > MAX_UNDO_STATES || bytes > m_undoMemoryLimit ) )
+	{
+		bytes -= m_undoCheckPoints[remove].data.size();
+		++remove;
+	}
+	m_undoCheckPoints.remove( 0, remove );
+	m_undoBytes = bytes;
 }
 
 
@@ -174,6 +518,10 @@ void ProjectJournal::clearJournal()
 {
 	m_undoCheckPoints.clear();
 	m_redoCheckPoints.clear();
+	m_undoBytes = 0;
+	m_lastCheckPoint = {};
+	// a changed limit applies from the next project on
+	m_undoMemoryLimit = configuredUndoMemoryLimit();
 
 	for( JoIdMap::Iterator it = m_joIDs.begin(); it != m_joIDs.end(); )
 	{
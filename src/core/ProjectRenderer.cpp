@@ -25,7 +25,14 @@
 
 #include <QFile>
 
+#include <chrono>
+#include <memory>
+
 #include "ProjectRenderer.h"
+#include "AudioBusHandle.h"
+#include "BufferManager.h"
+#include "EncoderThread.h"
+#include "NotePlayHandle.h"
 #include "Song.h"
 #include "PerfLog.h"
 
@@ -78,25 +85,71 @@ const std::array<ProjectRenderer::FileEncodeDevice, 5> ProjectRenderer::fileEnco
 ProjectRenderer::ProjectRenderer(
 	const OutputSettings& outputSettings, ExportFileFormat exportFileFormat, const QString& outputFilename)
 	: QThread(Engine::audioEngine())
-	, m_fileDev(nullptr)
+	, m_fileDev(createFileDevice(outputSettings, exportFileFormat, outputFilename))
 	, m_progress(0)
 	, m_abort(false)
+	, m_framesRendered(0)
+	, m_renderTime(0)
 {
-	AudioFileDeviceInstantiaton audioEncoderFactory = fileEncodeDevices[static_cast<std::size_t>(exportFileFormat)].m_getDevInst;
+}
+
 
-	if (audioEncoderFactory)
-	{
-		bool successful = false;
 
-		m_fileDev = audioEncoderFactory(
-					outputFilename, outputSettings, DEFAULT_CHANNELS,
-					Engine::audioEngine(), successful );
-		if( !successful )
+
+ProjectRenderer::ProjectRenderer(const OutputSettings& outputSettings, ExportFileFormat exportFileFormat,
+		const std::vector<Stem>& stems)
+	: QThread(Engine::audioEngine())
+	, m_fileDev(nullptr)
+	, m_progress(0)
+	, m_abort(false)
+	, m_framesRendered(0)
+	, m_renderTime(0)
+{
+	for (const auto& stem : stems)
+	{
+		const auto fileDev = createFileDevice(outputSettings, exportFileFormat, stem.outputFile);
+		if (!fileDev)
 		{
-			delete m_fileDev;
-			m_fileDev = nullptr;
+			for (const auto& output : m_stems) { delete output.fileDev; }
+			m_stems.clear();
+			return;
 		}
+		m_stems.push_back({stem.bus, fileDev});
+	}
+
+	if (!m_stems.empty()) { m_fileDev = m_stems.front().fileDev; }
+}
+
+
+
+
+ProjectRenderer::~ProjectRenderer()
+{
+	for (const auto& output : m_stems)
+	{
+		if (output.fileDev != m_fileDev) { delete output.fileDev; }
+	}
+}
+
+
+
+
+AudioFileDevice* ProjectRenderer::createFileDevice(const OutputSettings& outputSettings,
+	ExportFileFormat exportFileFormat, const QString& outputFilename)
+{
+	AudioFileDeviceInstantiaton audioEncoderFactory = fileEncodeDevices[static_cast<std::size_t>(exportFileFormat)].m_getDevInst;
+	if (!audioEncoderFactory) { return nullptr; }
+
+	bool successful = false;
+	AudioFileDevice* fileDev = audioEncoderFactory(
+				outputFilename, outputSettings, DEFAULT_CHANNELS,
+				Engine::audioEngine(), successful );
+	if( !successful )
+	{
+		delete fileDev;
+		return nullptr;
 	}
+	return fileDev;
 }
 
 
@@ -160,6 +213,22 @@ void ProjectRenderer::run()
 	Engine::audioEngine()->renderNextPeriod();
 
 	m_progress = 0;
+	m_framesRendered = 0;
+	const auto renderStart = std::chrono::steady_clock::now();
+
+	// in stem mode the master output is not needed, every stem gets its
+	// own encoder fed by its bus instead
+	auto encoders = std::vector<std::unique_ptr<EncoderThread>>{};
+	if (m_stems.empty())
+	{
+		encoders.push_back(std::make_unique<EncoderThread>(m_fileDev));
+	}
+	for (const auto& output : m_stems)
+	{
+		encoders.push_back(std::make_unique<EncoderThread>(output.fileDev));
+		output.bus->setTap(encoders.back().get());
+	}
+	for (const auto& encoder : encoders) { encoder->start(); }
 
 	// Now start processing
 	Engine::audioEngine()->startProcessing();
@@ -168,7 +237,12 @@ void ProjectRenderer::run()
 	while (!Engine::getSong()->isExportDone() && !m_abort)
 	{
 		const auto buffer = Engine::audioEngine()->renderNextPeriod();
-		m_fileDev->writeBuffer(buffer.data(), buffer.size());
+		if (m_stems.empty()) { encoders.front()->write(buffer.data(), buffer.size()); }
+		m_framesRendered += buffer.size();
+
+		// we are between two periods, so it is safe to grow the buffer pool here
+		BufferManager::refill();
+		NotePlayHandleManager::refill();
 
 		const int nprog = Engine::getSong()->getExportProgress();
 		if (m_progress != nprog)
@@ -178,6 +252,10 @@ void ProjectRenderer::run()
 		}
 	}
 
+	for (const auto& output : m_stems) { output.bus->setTap(nullptr); }
+	for (const auto& encoder : encoders) { encoder->finish(); }
+	m_renderTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - renderStart).count();
+
 	// Notify the audio engine of the end of processing.
 	Engine::audioEngine()->stopProcessing();
 
@@ -185,11 +263,28 @@ void ProjectRenderer::run()
 
 	perfLog.end();
 
+	const auto bufferStats = BufferManager::statistics();
+	if (bufferStats.fallbackAllocations > 0)
+	{
+		qWarning("BufferManager: %zu of %zu play handle buffers had to be allocated outside the pool",
+			bufferStats.fallbackAllocations, bufferStats.highWaterMark);
+	}
+	const auto noteStats = NotePlayHandleManager::statistics();
+	if (noteStats.fallbackAllocations > 0)
+	{
+		qWarning("NotePlayHandleManager: %zu notes exceeded the polyphony budget of %zu, "
+			"consider raising audioengine/polyphony to %zu",
+			noteStats.fallbackAllocations, noteStats.capacity, noteStats.highWaterMark);
+	}
+
 	// If the user aborted export-process, the file has to be deleted.
-	const QString f = m_fileDev->outputFile();
 	if( m_abort )
 	{
-		QFile( f ).remove();
+		QFile( m_fileDev->outputFile() ).remove();
+		for (const auto& output : m_stems)
+		{
+			QFile(output.fileDev->outputFile()).remove();
+		}
 	}
 }
 
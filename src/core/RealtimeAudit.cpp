@@ -0,0 +1,326 @@
+/*
+ * RealtimeAudit.cpp - detect realtime-unsafe calls on the audio threads
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "RealtimeAudit.h"
+
+#include <QFile>
+#include <QString>
+#include <QTextStream>
+
+#ifdef LMMS_DEBUG_RT_AUDIT
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <cstdarg>
+#include <cstdlib>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <linux/futex.h>
+#include <pthread.h>
+#include <sys/syscall.h>
+
+namespace lmms
+{
+
+namespace
+{
+
+using Violation = RealtimeAudit::Violation;
+
+constexpr std::size_t MaxRecords = 4096;
+constexpr int MaxFrames = 32;
+// record() and the interposed function
+constexpr int SkippedFrames = 2;
+
+struct Record
+{
+	std::atomic_bool valid;
+	Violation kind;
+	int numFrames;
+	std::array<void*, MaxFrames> frames;
+};
+
+// records are written from inside malloc(), so they must be preallocated
+std::array<Record, MaxRecords> s_records;
+std::atomic_size_t s_numViolations = 0;
+std::atomic_bool s_enabled = false;
+
+thread_local int t_realtimeDepth = 0;
+thread_local bool t_inHook = false;
+
+using MutexLockFunc = int (*)(pthread_mutex_t*);
+using SyscallFunc = long (*)(long, ...);
+std::atomic<MutexLockFunc> s_realMutexLock = nullptr;
+std::atomic<SyscallFunc> s_realSyscall = nullptr;
+
+template<typename Func>
+Func resolveNext(std::atomic<Func>& func, const char* name)
+{
+	auto f = func.load(std::memory_order_acquire);
+	if (f == nullptr)
+	{
+		f = reinterpret_cast<Func>(dlsym(RTLD_NEXT, name));
+		func.store(f, std::memory_order_release);
+	}
+	return f;
+}
+
+void record(Violation kind)
+{
+	if (t_realtimeDepth == 0 || t_inHook || !s_enabled.load(std::memory_order_relaxed)) { return; }
+
+	// backtrace() may allocate itself
+	t_inHook = true;
+	const auto index = s_numViolations.fetch_add(1, std::memory_order_relaxed);
+	if (index < MaxRecords)
+	{
+		auto& r = s_records[index];
+		r.kind = kind;
+		r.numFrames = backtrace(r.frames.data(), MaxFrames);
+		r.valid.store(true, std::memory_order_release);
+	}
+	t_inHook = false;
+}
+
+const char* violationName(Violation kind)
+{
+	switch (kind)
+	{
+		case Violation::Allocation: return "allocation";
+		case Violation::Deallocation: return "deallocation";
+		case Violation::MutexLock: return "mutex lock";
+		case Violation::FutexWait: return "blocking wait";
+	}
+	return "unknown";
+}
+
+} // namespace
+
+
+
+
+bool RealtimeAudit::isSupported()
+{
+	return true;
+}
+
+
+
+
+void RealtimeAudit::enable()
+{
+	// resolve everything that could allocate or lock before the first
+	// realtime call gets recorded
+	resolveNext(s_realMutexLock, "pthread_mutex_lock");
+	resolveNext(s_realSyscall, "syscall");
+	void* frame;
+	backtrace(&frame, 1);
+
+	s_numViolations = 0;
+	s_enabled = true;
+}
+
+
+
+
+bool RealtimeAudit::isEnabled()
+{
+	return s_enabled;
+}
+
+
+
+
+std::size_t RealtimeAudit::violationCount()
+{
+	return s_numViolations;
+}
+
+
+
+
+bool RealtimeAudit::writeReport(const QString& file)
+{
+	QFile out(file);
+	if (!out.open(QFile::WriteOnly | QFile::Truncate | QFile::Text)) { return false; }
+
+	// group identical call stacks
+	using Key = std::pair<Violation, std::vector<void*>>;
+	auto stacks = std::map<Key, std::size_t>{};
+	const auto numRecords = std::min<std::size_t>(s_numViolations, MaxRecords);
+	for (auto i = std::size_t{0}; i < numRecords; ++i)
+	{
+		const auto& r = s_records[i];
+		if (!r.valid.load(std::memory_order_acquire)) { continue; }
+		const auto first = r.frames.begin() + std::min(SkippedFrames, r.numFrames);
+		++stacks[{r.kind, std::vector<void*>(first, r.frames.begin() + r.numFrames)}];
+	}
+
+	auto sorted = std::vector<std::pair<const Key*, std::size_t>>{};
+	for (const auto& [key, count] : stacks) { sorted.emplace_back(&key, count); }
+	std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) { return a.second > b.second; });
+
+	QTextStream ts(&out);
+	ts << "Realtime audit: " << s_numViolations << " violation(s), "
+		<< sorted.size() << " distinct call stack(s)";
+	if (s_numViolations > MaxRecords) { ts << ", only the first " << MaxRecords << " recorded"; }
+	ts << "\n";
+
+	for (const auto& [key, count] : sorted)
+	{
+		const auto& frames = key->second;
+		ts << "\n[" << violationName(key->first) << "] " << count << "x\n";
+		char** symbols = backtrace_symbols(frames.data(), static_cast<int>(frames.size()));
+		for (auto i = std::size_t{0}; i < frames.size(); ++i)
+		{
+			ts << "  #" << i << " " << (symbols ? symbols[i] : "??") << "\n";
+		}
+		std::free(symbols);
+	}
+
+	return true;
+}
+
+
+
+
+void RealtimeAudit::enter()
+{
+	++t_realtimeDepth;
+}
+
+
+
+
+void RealtimeAudit::leave()
+{
+	--t_realtimeDepth;
+}
+
+
+} // namespace lmms
+
+
+// Interposed libc functions. LMMS' core is linked into the executable, so
+// these definitions take precedence over libc for all loaded libraries too.
+extern "C"
+{
+
+void* __libc_malloc(std::size_t size);
+void* __libc_calloc(std::size_t count, std::size_t size);
+void* __libc_realloc(void* ptr, std::size_t size);
+void* __libc_memalign(std::size_t alignment, std::size_t size);
+void __libc_free(void* ptr);
+
+void* malloc(std::size_t size)
+{
+	lmms::record(lmms::Violation::Allocation);
+	return __libc_malloc(size);
+}
+
+void* calloc(std::size_t count, std::size_t size)
+{
+	lmms::record(lmms::Violation::Allocation);
+	return __libc_calloc(count, size);
+}
+
+void* realloc(void* ptr, std::size_t size)
+{
+	lmms::record(lmms::Violation::Allocation);
+	return __libc_realloc(ptr, size);
+}
+
+void* memalign(std::size_t alignment, std::size_t size)
+{
+	lmms::record(lmms::Violation::Allocation);
+	return __libc_memalign(alignment, size);
+}
+
+void* aligned_alloc(std::size_t alignment, std::size_t size)
+{
+	lmms::record(lmms::Violation::Allocation);
+	return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** ptr, std::size_t alignment, std::size_t size)
+{
+	if (alignment % sizeof(void*) != 0 || (alignment & (alignment - 1)) != 0) { return EINVAL; }
+	lmms::record(lmms::Violation::Allocation);
+	*ptr = __libc_memalign(alignment, size);
+	return *ptr ? 0 : ENOMEM;
+}
+
+void free(void* ptr)
+{
+	if (ptr) { lmms::record(lmms::Violation::Deallocation); }
+	__libc_free(ptr);
+}
+
+int pthread_mutex_lock(pthread_mutex_t* mutex)
+{
+	lmms::record(lmms::Violation::MutexLock);
+	return lmms::resolveNext(lmms::s_realMutexLock, "pthread_mutex_lock")(mutex);
+}
+
+// QMutex doesn't use pthreads on Linux, it only ends up in the kernel once
+// it is contended
+long syscall(long number, ...)
+{
+	va_list ap;
+	va_start(ap, number);
+	long args[6];
+	for (auto& arg : args) { arg = va_arg(ap, long); }
+	va_end(ap);
+
+	if (number == SYS_futex)
+	{
+		const auto op = static_cast<int>(args[1]) & FUTEX_CMD_MASK;
+		if (op == FUTEX_WAIT || op == FUTEX_WAIT_BITSET) { lmms::record(lmms::Violation::FutexWait); }
+	}
+	return lmms::resolveNext(lmms::s_realSyscall, "syscall")(number,
+		args[0], args[1], args[2], args[3], args[4], args[5]);
+}
+
+} // extern "C"
+
+#else // LMMS_DEBUG_RT_AUDIT
+
+namespace lmms
+{
+
+bool RealtimeAudit::isSupported() { return false; }
+void RealtimeAudit::enable() {}
+bool RealtimeAudit::isEnabled() { return false; }
+std::size_t RealtimeAudit::violationCount() { return 0; }
+bool RealtimeAudit::writeReport(const QString&) { return false; }
+void RealtimeAudit::enter() {}
+void RealtimeAudit::leave() {}
+
+} // namespace lmms
+
+#endif // LMMS_DEBUG_RT_AUDIT
@@ -34,8 +34,10 @@
 #endif
 
 #include "AudioEngine.h"
+#include "ConfigManager.h"
 #include "Engine.h"
 #include "MidiEvent.h"
+#include "RemotePluginPool.h"
 #include "Song.h"
 
 #include <QCoreApplication>
@@ -77,9 +79,9 @@ namespace lmms
 
 // simple helper thread monitoring our RemotePlugin - if process terminates
 // unexpectedly invalidate plugin so LMMS doesn't lock up
-ProcessWatcher::ProcessWatcher( RemotePlugin * _p ) :
+ProcessWatcher::ProcessWatcher( RemotePluginProcess * _p ) :
 	QThread(),
-	m_plugin( _p ),
+	m_process( _p ),
 	m_quit( false )
 {
 }
@@ -87,8 +89,8 @@ ProcessWatcher::ProcessWatcher( RemotePlugin * _p ) :
 
 void ProcessWatcher::run()
 {
-	auto& process = m_plugin->m_process;
-	process.start(m_plugin->m_exec, m_plugin->m_args);
+	auto& process = m_process->m_process;
+	process.start(m_process->m_exec, m_process->m_args);
 
 #ifdef LMMS_BUILD_WIN32
 	// Add the process to our job so it is killed if we crash
@@ -114,15 +116,19 @@ void ProcessWatcher::run()
 #endif // LMMS_BUILD_WIN32
 
 	exec();
-	process.moveToThread(m_plugin->thread());
-	while (!m_quit && m_plugin->messagesLeft())
+	process.moveToThread(m_process->m_ownerThread);
+	// A process that was never handed to a plugin has nobody to report to.
+	// The pool may hand the process over while it dies, but a plugin only
+	// lets go of it after stopping this thread, see RemotePlugin::init().
+	RemotePlugin* plugin = m_process->m_plugin;
+	while (!m_quit && plugin && plugin->messagesLeft())
 	{
 		msleep(200);
 	}
-	if (!m_quit)
+	if (!m_quit && plugin)
 	{
 		fprintf(stderr, "remote plugin died! invalidating now.\n");
-		m_plugin->invalidate();
+		plugin->invalidate();
 	}
 }
 
@@ -130,21 +136,16 @@ void ProcessWatcher::run()
 
 
 
-RemotePlugin::RemotePlugin() :
-	QObject(),
-#ifdef SYNC_WITH_SHM_FIFO
-	RemotePluginBase( new shmFifo(), new shmFifo() ),
-#else
-	RemotePluginBase(),
-#endif
-	m_failed( true ),
+RemotePluginProcess::RemotePluginProcess() :
 	m_watcher( this ),
-	m_splitChannels( false ),
-	m_audioBufferSize( 0 ),
-	m_inputCount( DEFAULT_CHANNELS ),
-	m_outputCount( DEFAULT_CHANNELS )
+	m_ownerThread( QThread::currentThread() ),
+	m_plugin( nullptr ),
+	m_exited( false )
 {
-#ifndef SYNC_WITH_SHM_FIFO
+#ifdef SYNC_WITH_SHM_FIFO
+	m_in = new shmFifo();
+	m_out = new shmFifo();
+#else
 	struct sockaddr_un sa;
 	sa.sun_family = AF_LOCAL;
 
@@ -173,42 +174,34 @@ RemotePlugin::RemotePlugin() :
 	}
 #endif
 
-	connect( &m_process, SIGNAL(finished(int,QProcess::ExitStatus)),
-		this, SLOT(processFinished(int,QProcess::ExitStatus)),
-		Qt::DirectConnection );
-	connect( &m_process, SIGNAL(errorOccurred(QProcess::ProcessError)),
-			 this, SLOT(processErrored(QProcess::ProcessError)),
-		Qt::DirectConnection );
-	connect( &m_process, SIGNAL(finished(int,QProcess::ExitStatus)),
+	QObject::connect( &m_process, qOverload<int, QProcess::ExitStatus>( &QProcess::finished ),
+		[this]( int exitCode, QProcess::ExitStatus exitStatus ) { processFinished( exitCode, exitStatus ); } );
+	QObject::connect( &m_process, &QProcess::errorOccurred,
+		[this]( QProcess::ProcessError err )
+		{
+			qCritical() << "Process error: " << err;
+			if( err == QProcess::FailedToStart )
+			{
+				m_exited = true;
+			}
+		} );
+	QObject::connect( &m_process, SIGNAL(finished(int,QProcess::ExitStatus)),
 		&m_watcher, SLOT(quit()), Qt::DirectConnection );
 }
 
 
 
 
-RemotePlugin::~RemotePlugin()
+RemotePluginProcess::~RemotePluginProcess()
 {
-	m_watcher.stop();
-	m_watcher.wait();
-
-	if( m_failed == false )
-	{
-		if( isRunning() )
-		{
-			lock();
-			sendMessage( IdQuit );
+	stopWatching();
+	finish( m_plugin ? 1000 : 0 );
 
-			m_process.waitForFinished( 1000 );
-			if( m_process.state() != QProcess::NotRunning )
-			{
-				m_process.terminate();
-				m_process.kill();
-			}
-			unlock();
-		}
-	}
-
-#ifndef SYNC_WITH_SHM_FIFO
+#ifdef SYNC_WITH_SHM_FIFO
+	// the plugin took the FIFOs if it connected
+	delete m_in;
+	delete m_out;
+#else
 	if ( close( m_server ) == -1)
 	{
 		qWarning( "Error freeing resources." );
@@ -220,17 +213,8 @@ RemotePlugin::~RemotePlugin()
 
 
 
-bool RemotePlugin::init(const QString &pluginExecutable,
-							bool waitForInitDoneMsg , QStringList extraArgs)
+QString RemotePluginProcess::executablePath( const QString& pluginExecutable )
 {
-	lock();
-	if( m_failed )
-	{
-#ifdef SYNC_WITH_SHM_FIFO
-		reset( new shmFifo(), new shmFifo() );
-#endif
-		m_failed = false;
-	}
 	QString exec = QFileInfo(QDir("plugins:"), pluginExecutable).absoluteFilePath();
 
 	// We may have received a directory via a environment variable
@@ -256,22 +240,24 @@ bool RemotePlugin::init(const QString &pluginExecutable,
 	{
 		qWarning( "Remote plugin '%s' not found",
 						exec.toUtf8().constData() );
-		m_failed = true;
-		invalidate();
-		unlock();
-		return failed();
+		return {};
 	}
+	return exec;
+}
 
-	// ensure the watcher is ready in case we're running again
-	// (e.g. 32-bit VST plugins on Windows)
-	m_watcher.wait();
-	m_watcher.reset();
+
+
+
+void RemotePluginProcess::launch( const QString& executable, const QStringList& extraArgs )
+{
+	m_exec = executable;
+	m_extraArgs = extraArgs;
 
 	QStringList args;
 #ifdef SYNC_WITH_SHM_FIFO
 	// swap in and out for bidirectional communication
-	args << QString::fromStdString(out()->shmKey());
-	args << QString::fromStdString(in()->shmKey());
+	args << QString::fromStdString(m_out->shmKey());
+	args << QString::fromStdString(m_in->shmKey());
 #else
 	args << m_socketFile;
 #endif
@@ -279,16 +265,78 @@ bool RemotePlugin::init(const QString &pluginExecutable,
 #ifndef DEBUG_REMOTE_PLUGIN
 	m_process.setProcessChannelMode( QProcess::ForwardedChannels );
 	m_process.setWorkingDirectory( QCoreApplication::applicationDirPath() );
-	m_exec = exec;
 	m_args = args;
 	// we start the process on the watcher thread to work around QTBUG-8819
 	m_process.moveToThread( &m_watcher );
 	m_watcher.start( QThread::LowestPriority );
 #else
-	qDebug() << exec << args;
+	qDebug() << executable << args;
 #endif
+}
+
+
+
+
+bool RemotePluginProcess::isRunning() const
+{
+	return m_process.state() != QProcess::NotRunning;
+}
+
+
+
+
+void RemotePluginProcess::stopWatching()
+{
+	m_watcher.stop();
+	m_watcher.wait();
+}
+
+
 
+
+void RemotePluginProcess::finish( int msecs )
+{
+	if( m_process.state() == QProcess::NotRunning )
+	{
+		return;
+	}
+	m_process.waitForFinished( msecs );
+	if( m_process.state() != QProcess::NotRunning )
+	{
+		m_process.terminate();
+		m_process.kill();
+	}
+}
+
+
+
+
+void RemotePluginProcess::processFinished( int exitCode,
+					QProcess::ExitStatus exitStatus )
+{
+	m_exited = true;
+	if ( exitStatus == QProcess::CrashExit )
+	{
+		qCritical() << "Remote plugin crashed";
+	}
+	else if ( exitCode )
+	{
+		qCritical() << "Remote plugin exit code: " << exitCode;
+	}
 #ifndef SYNC_WITH_SHM_FIFO
+	if( RemotePlugin* plugin = m_plugin )
+	{
+		plugin->invalidate();
+	}
+#endif
+}
+
+
+
+
+#ifndef SYNC_WITH_SHM_FIFO
+int RemotePluginProcess::acceptConnection()
+{
 	struct pollfd pollin;
 	pollin.fd = m_server;
 	pollin.events = POLLIN;
@@ -304,16 +352,108 @@ bool RemotePlugin::init(const QString &pluginExecutable,
 			break;
 
 		default:
-			m_socket = accept( m_server, nullptr, nullptr );
-			if ( m_socket == -1 )
+			const int socket = accept( m_server, nullptr, nullptr );
+			if ( socket == -1 )
 			{
 				qWarning( "Unexpected socket error." );
 			}
+			return socket;
 	}
+	return -1;
+}
+#endif
+
+
+
+
+RemotePlugin::RemotePlugin() :
+	QObject(),
+#ifdef SYNC_WITH_SHM_FIFO
+	RemotePluginBase( new shmFifo(), new shmFifo() ),
+#else
+	RemotePluginBase(),
+#endif
+	m_failed( true ),
+	m_splitChannels( false ),
+	m_audioBufferSize( 0 ),
+	m_inputCount( DEFAULT_CHANNELS ),
+	m_outputCount( DEFAULT_CHANNELS ),
+	m_useRing( ConfigManager::inst()->value( "audioengine", "remoteprocessingring", "0" ).toInt() ),
+	m_ringPipelined( ConfigManager::inst()->value( "audioengine", "remotepipelining", "0" ).toInt() ),
+	m_ringActive( false ),
+	m_ringPending( false ),
+	m_ringSequence( 0 )
+{
+}
+
+
+
+
+RemotePlugin::~RemotePlugin()
+{
+	if( !m_remoteProcess )
+	{
+		return;
+	}
+
+	m_remoteProcess->stopWatching();
+
+	if( m_failed == false )
+	{
+		if( isRunning() )
+		{
+			lock();
+			if( m_ring )
+			{
+				m_ring.quit();
+			}
+			sendMessage( IdQuit );
+
+			m_remoteProcess->finish( 1000 );
+			unlock();
+		}
+	}
+	m_remoteProcess->setPlugin( nullptr );
+}
+
+
+
+
+bool RemotePlugin::init(const QString &pluginExecutable,
+							bool waitForInitDoneMsg , QStringList extraArgs)
+{
+	lock();
+	m_failed = false;
+
+	// a process started in advance by the pool, or a new one. Replacing a
+	// previous process quits it (e.g. 32-bit VST plugins on Windows)
+	if( m_remoteProcess )
+	{
+		// the watcher must not report to us once the process is replaced
+		m_remoteProcess->stopWatching();
+		m_remoteProcess->setPlugin( nullptr );
+	}
+	m_remoteProcess = Engine::remotePluginPool()->take( pluginExecutable, extraArgs );
+	if( !m_remoteProcess )
+	{
+		m_failed = true;
+		invalidate();
+		unlock();
+		return failed();
+	}
+	m_remoteProcess->setPlugin( this );
+
+#ifdef SYNC_WITH_SHM_FIFO
+	reset( m_remoteProcess->m_in, m_remoteProcess->m_out );
+	m_remoteProcess->m_in = nullptr;
+	m_remoteProcess->m_out = nullptr;
+#else
+	m_socket = m_remoteProcess->acceptConnection();
 #endif
 
 	sendMessage(message(IdSyncKey).addString(Engine::getSong()->syncKey()));
 	resizeSharedProcessingMemory();
+	setUpProcessingRing();
 
 	if( waitForInitDoneMsg )
 	{
@@ -359,6 +499,106 @@ bool RemotePlugin::process( const SampleFrame* _in_buf, SampleFrame* _out_buf )
 		return false;
 	}
 
+	if( m_ringActive )
+	{
+		return processThroughRing( _in_buf, _out_buf );
+	}
+
+	writeInputs( _in_buf, frames );
+
+	lock();
+	sendMessage( IdStartProcessing );
+
+	if( m_failed || _out_buf == nullptr || m_outputCount == 0 )
+	{
+		unlock();
+		return false;
+	}
+
+	waitForMessage( IdProcessingDone );
+	unlock();
+
+	readOutputs( _out_buf, frames );
+
+	return true;
+}
+
+
+
+
+bool RemotePlugin::processThroughRing( const SampleFrame* _in_buf, SampleFrame* _out_buf )
+{
+	const f_cnt_t frames = Engine::audioEngine()->framesPerPeriod();
+	bool rendered = false;
+
+	lock();
+	// in pipelined mode, the remote rendered the last period in the meantime
+	if( m_ringPending )
+	{
+		if( !waitForRing() )
+		{
+			unlock();
+			if( _out_buf != nullptr )
+			{
+				zeroSampleFrames(_out_buf, frames);
+			}
+			return false;
+		}
+		rendered = true;
+		if( _out_buf != nullptr )
+		{
+			readOutputs( _out_buf, frames );
+		}
+	}
+
+	// the remote is idle, so the buffers may be resized now
+	fetchAndProcessAllMessages();
+
+	writeInputs( _in_buf, frames );
+	m_ringSequence = m_ring.request();
+	m_ringPending = true;
+
+	if( !m_ringPipelined )
+	{
+		rendered = waitForRing();
+		if( rendered && _out_buf != nullptr )
+		{
+			readOutputs( _out_buf, frames );
+		}
+	}
+	unlock();
+
+	if( !rendered && _out_buf != nullptr )
+	{
+		zeroSampleFrames(_out_buf, frames);
+	}
+
+	return rendered && _out_buf != nullptr && m_outputCount > 0;
+}
+
+
+
+
+bool RemotePlugin::waitForRing()
+{
+	using namespace std::chrono_literals;
+
+	while( !m_ring.waitForCompletion( m_ringSequence, 100ms ) )
+	{
+		if( m_failed || isInvalid() || !isRunning() )
+		{
+			return false;
+		}
+	}
+	m_ringPending = false;
+	return true;
+}
+
+
+
+
+void RemotePlugin::writeInputs( const SampleFrame* _in_buf, f_cnt_t frames )
+{
 	memset( m_audioBuffer.get(), 0, m_audioBufferSize );
 
 	ch_cnt_t inputs = std::min<ch_cnt_t>(m_inputCount, DEFAULT_CHANNELS);
@@ -393,19 +633,13 @@ bool RemotePlugin::process( const SampleFrame* _in_buf, SampleFrame* _out_buf )
 			}
 		}
 	}
+}
 
-	lock();
-	sendMessage( IdStartProcessing );
 
-	if( m_failed || _out_buf == nullptr || m_outputCount == 0 )
-	{
-		unlock();
-		return false;
-	}
 
-	waitForMessage( IdProcessingDone );
-	unlock();
 
+void RemotePlugin::readOutputs( SampleFrame* _out_buf, f_cnt_t frames )
+{
 	const ch_cnt_t outputs = std::min<ch_cnt_t>(m_outputCount,
 							DEFAULT_CHANNELS);
 	if( m_splitChannels )
@@ -439,22 +673,41 @@ bool RemotePlugin::process( const SampleFrame* _in_buf, SampleFrame* _out_buf )
 			}
 		}
 	}
+}
 
-	return true;
+
+
+
+const float* RemotePlugin::sharedOutputs() const
+{
+	return m_audioBuffer.get() + m_inputCount * Engine::audioEngine()->framesPerPeriod();
 }
 
 
 
 
 void RemotePlugin::processMidiEvent( const MidiEvent & _e,
-							const f_cnt_t _offset )
+							const f_cnt_t _offset, int instance )
 {
+	if( m_ringActive )
+	{
+		lock();
+		const bool queued = m_ring.pushMidiEvent( { static_cast<std::int32_t>( _e.type() ), _e.channel(),
+				_e.param( 0 ), _e.param( 1 ), static_cast<std::int32_t>( _offset ), instance } );
+		unlock();
+		if( queued )
+		{
+			return;
+		}
+	}
+
 	message m( IdMidiEvent );
 	m.addInt( _e.type() );
 	m.addInt( _e.channel() );
 	m.addInt( _e.param( 0 ) );
 	m.addInt( _e.param( 1 ) );
 	m.addInt( _offset );
+	m.addInt( instance );
 	lock();
 	sendMessage( m );
 	unlock();
@@ -497,25 +750,27 @@ void RemotePlugin::resizeSharedProcessingMemory()
 
 
 
-void RemotePlugin::processFinished( int exitCode,
-					QProcess::ExitStatus exitStatus )
+void RemotePlugin::setUpProcessingRing()
 {
-	if ( exitStatus == QProcess::CrashExit )
+	m_ringActive = false;
+	m_ringPending = false;
+	if( !m_useRing )
 	{
-		qCritical() << "Remote plugin crashed";
+		return;
 	}
-	else if ( exitCode )
+
+	try
 	{
-		qCritical() << "Remote plugin exit code: " << exitCode;
+		m_ring.create();
 	}
-#ifndef SYNC_WITH_SHM_FIFO
-	invalidate();
-#endif
-}
-
-void RemotePlugin::processErrored( QProcess::ProcessError err )
-{
-	qCritical() << "Process error: " << err;
+	catch (const std::runtime_error& error)
+	{
+		qWarning() << "Failed to allocate processing ring, using messages:" << error.what();
+		m_ring.detach();
+		return;
+	}
+	// the remote answers whether it supports the ring
+	sendMessage(message(IdChangeProcessingRingKey).addString(m_ring.key()));
 }
 
 
@@ -562,6 +817,10 @@ bool RemotePlugin::processMessage( const message & _m )
 			resizeSharedProcessingMemory();
 			break;
 
+		case IdChangeProcessingRingKey:
+			m_ringActive = m_ring && _m.getInt( 0 ) != 0;
+			break;
+
 		case IdDebugMessage:
 			fprintf( stderr, "RemotePlugin::DebugMessage: %s",
 						_m.getString( 0 ).c_str() );
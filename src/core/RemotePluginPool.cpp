@@ -0,0 +1,138 @@
+/*
+ * RemotePluginPool.cpp - remote plugin processes started before they are needed
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "RemotePluginPool.h"
+
+#include <algorithm>
+
+#include "ConfigManager.h"
+#include "Engine.h"
+#include "RemotePlugin.h"
+#include "Song.h"
+
+namespace lmms
+{
+
+
+RemotePluginPool::RemotePluginPool() :
+	m_enabled( ConfigManager::inst()->value( "audioengine", "remotepluginpool", "0" ).toInt() )
+{
+	connect( Engine::getSong(), SIGNAL(projectLoaded()), this, SLOT(trim()) );
+}
+
+
+
+
+RemotePluginPool::~RemotePluginPool()
+{
+	clear();
+}
+
+
+
+
+std::unique_ptr<RemotePluginProcess> RemotePluginPool::take( const QString& pluginExecutable,
+	const QStringList& extraArgs )
+{
+	const QString executable = RemotePluginProcess::executablePath( pluginExecutable );
+	if( executable.isEmpty() )
+	{
+		return nullptr;
+	}
+
+	std::erase_if( m_spares, []( const auto& process ) { return process->hasExited(); } );
+
+	auto process = std::unique_ptr<RemotePluginProcess>{};
+	const auto it = std::find_if( m_spares.begin(), m_spares.end(),
+		[&]( const auto& spare ) { return spare->matches( executable, extraArgs ); } );
+	if( it != m_spares.end() )
+	{
+		process = std::move( *it );
+		m_spares.erase( it );
+	}
+	else
+	{
+		process = std::make_unique<RemotePluginProcess>();
+		process->launch( executable, extraArgs );
+	}
+
+	if( m_enabled )
+	{
+		const int spares = std::count_if( m_spares.begin(), m_spares.end(),
+			[&]( const auto& spare ) { return spare->matches( executable, extraArgs ); } );
+		const int wanted = Engine::getSong()->isLoadingProject() ? SparesWhileLoading : Spares;
+		startSpares( executable, extraArgs, wanted - spares );
+	}
+
+	return process;
+}
+
+
+
+
+void RemotePluginPool::setEnabled( bool enabled )
+{
+	m_enabled = enabled;
+	if( !m_enabled )
+	{
+		clear();
+	}
+}
+
+
+
+
+void RemotePluginPool::clear()
+{
+	m_spares.clear();
+}
+
+
+
+
+void RemotePluginPool::trim()
+{
+	for( auto it = m_spares.begin(); it != m_spares.end(); )
+	{
+		const auto& process = *it;
+		const auto before = std::count_if( m_spares.begin(), it, [&]( const auto& spare ) {
+			return spare->matches( process->executable(), process->extraArgs() );
+		} );
+		it = before >= Spares ? m_spares.erase( it ) : it + 1;
+	}
+}
+
+
+
+
+void RemotePluginPool::startSpares( const QString& executable, const QStringList& extraArgs, int count )
+{
+	for( int i = 0; i < count; ++i )
+	{
+		auto process = std::make_unique<RemotePluginProcess>();
+		process->launch( executable, extraArgs );
+		m_spares.push_back( std::move( process ) );
+	}
+}
+
+
+} // namespace lmms
@@ -0,0 +1,358 @@
+/*
+ * RenderBenchmark.cpp - headless render benchmark over a set of projects
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "RenderBenchmark.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+#include <QCryptographicHash>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+
+#include "AudioEngine.h"
+#include "BufferManager.h"
+#include "DataFile.h"
+#include "Engine.h"
+#include "NotePlayHandle.h"
+#include "Song.h"
+#include "lmmsconfig.h"
+#include "lmmsversion.h"
+
+#ifndef LMMS_BUILD_WIN32
+#include <sys/resource.h>
+#endif
+
+namespace lmms
+{
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+double seconds(Clock::duration d)
+{
+	return std::chrono::duration<double>(d).count();
+}
+
+//! Peak resident set size of the process in KiB, 0 if unknown
+long peakRss()
+{
+#ifdef LMMS_BUILD_WIN32
+	return 0;
+#else
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0) { return 0; }
+#ifdef LMMS_BUILD_APPLE
+	// bytes instead of KiB
+	return usage.ru_maxrss / 1024;
+#else
+	return usage.ru_maxrss;
+#endif
+#endif
+}
+
+const char* detailName(std::size_t detail)
+{
+	switch (static_cast<AudioEngineProfiler::DetailType>(detail))
+	{
+		case AudioEngineProfiler::DetailType::NoteSetup: return "note_setup";
+		case AudioEngineProfiler::DetailType::Instruments: return "instruments";
+		case AudioEngineProfiler::DetailType::Effects: return "effects";
+		case AudioEngineProfiler::DetailType::Mixing: return "mixing";
+		default: return "unknown";
+	}
+}
+
+} // namespace
+
+
+
+RenderBenchmark::RenderBenchmark(Settings settings) :
+	m_settings(std::move(settings))
+{
+}
+
+
+
+bool RenderBenchmark::run()
+{
+	const auto projects = findProjects();
+	if (projects.isEmpty())
+	{
+		std::printf("No projects found\n");
+		return false;
+	}
+
+	if (!m_settings.referenceFile.isEmpty() && !m_settings.updateReference)
+	{
+		QFile file(m_settings.referenceFile);
+		if (!file.open(QFile::ReadOnly))
+		{
+			std::printf("Could not open reference file %s\n", qPrintable(m_settings.referenceFile));
+			return false;
+		}
+		m_references = QJsonDocument::fromJson(file.readAll()).object();
+	}
+
+	auto audioEngine = Engine::audioEngine();
+
+	// render on this thread as fast as possible instead of letting the dummy
+	// audio device render in realtime
+	audioEngine->stopProcessing();
+
+	bool success = true;
+	auto results = QJsonArray{};
+	for (const auto& project : projects)
+	{
+		std::printf("%s\n", qPrintable(project));
+
+		auto runs = std::vector<Run>{};
+		for (int i = 0; i < m_settings.repetitions; ++i)
+		{
+			const auto result = renderProject(project);
+			if (!result) { break; }
+
+			const auto rtf = result->renderTime > 0
+				? result->frames / static_cast<double>(audioEngine->outputSampleRate()) / result->renderTime
+				: 0.0;
+			std::printf("  run %d: load %.1f ms (upgrade %.1f ms), render %.2f s, %.1fx realtime, peak RSS %ld MiB\n",
+				i + 1, result->loadTime * 1000, result->upgradeTime * 1000, result->renderTime, rtf,
+				result->peakRss / 1024);
+			runs.push_back(*result);
+		}
+
+		auto status = QString{"ok"};
+		if (runs.empty())
+		{
+			std::printf("  could not be loaded\n");
+			status = "load failed";
+			success = false;
+		}
+		else
+		{
+			const auto& totals = runs.back().totals;
+			if (totals.periodTime > 0)
+			{
+				std::printf("  stages:");
+				for (auto i = std::size_t{0}; i < AudioEngineProfiler::DetailCount; ++i)
+				{
+					std::printf(" %s %.0f%%", detailName(i), 100.0 * totals.detailTime[i] / totals.periodTime);
+				}
+				std::printf("\n");
+			}
+
+			const auto& hash = runs.front().hash;
+			const bool reproducible = std::all_of(runs.begin(), runs.end(),
+				[&hash](const Run& run) { return run.hash == hash; });
+			const auto key = referenceKey(project);
+
+			if (!reproducible)
+			{
+				status = "not reproducible";
+			}
+			else if (m_settings.updateReference)
+			{
+				m_references[key] = hash;
+			}
+			else if (m_references.contains(key))
+			{
+				status = m_references[key].toString() == hash ? "matches reference" : "differs from reference";
+				success = success && status == "matches reference";
+			}
+			std::printf("  output %s: %s\n", qPrintable(hash.left(16)), qPrintable(status));
+		}
+
+		results.append(report(project, runs, status));
+	}
+
+	audioEngine->startProcessing();
+
+	if (m_settings.updateReference && !m_settings.referenceFile.isEmpty())
+	{
+		QFile file(m_settings.referenceFile);
+		if (!file.open(QFile::WriteOnly | QFile::Truncate))
+		{
+			std::printf("Could not write reference file %s\n", qPrintable(m_settings.referenceFile));
+			return false;
+		}
+		file.write(QJsonDocument{m_references}.toJson());
+	}
+
+	if (!m_settings.outputFile.isEmpty())
+	{
+		QFile file(m_settings.outputFile);
+		if (!file.open(QFile::WriteOnly | QFile::Truncate))
+		{
+			std::printf("Could not write %s\n", qPrintable(m_settings.outputFile));
+			return false;
+		}
+		file.write(QJsonDocument{QJsonObject{
+			{"lmms_version", LMMS_VERSION},
+			{"sample_rate", static_cast<int>(audioEngine->outputSampleRate())},
+			{"frames_per_period", static_cast<int>(audioEngine->framesPerPeriod())},
+			{"projects", results}
+		}}.toJson());
+	}
+
+	return success;
+}
+
+
+
+QStringList RenderBenchmark::findProjects() const
+{
+	const auto filters = QStringList{"*.mmp", "*.mmpz"};
+
+	auto projects = QStringList{};
+	for (const auto& path : m_settings.paths)
+	{
+		if (!QFileInfo{path}.isDir())
+		{
+			projects << path;
+			continue;
+		}
+
+		auto found = QStringList{};
+		QDirIterator it(path, filters, QDir::Files, QDirIterator::Subdirectories);
+		while (it.hasNext()) { found << it.next(); }
+		found.sort();
+		projects << found;
+	}
+	return projects;
+}
+
+
+
+auto RenderBenchmark::renderProject(const QString& file) -> std::optional<Run>
+{
+	auto result = Run{};
+	auto song = Engine::getSong();
+	auto audioEngine = Engine::audioEngine();
+
+	// Song::loadProject() doesn't expose the file it parsed, nor whether it refused to load it
+	DataFile dataFile(file);
+	if (dataFile.head().isNull() || dataFile.hasLocalPlugins()) { return std::nullopt; }
+	result.upgradeTime = seconds(dataFile.upgradeTime());
+
+	const auto loadStart = Clock::now();
+	song->loadProject(file);
+	result.loadTime = seconds(Clock::now() - loadStart);
+
+	auto hash = QCryptographicHash{QCryptographicHash::Sha256};
+
+	// an empty project is a valid benchmark case with nothing to render
+	if (song->tracks().empty())
+	{
+		result.peakRss = peakRss();
+		result.hash = QString::fromLatin1(hash.result().toHex());
+		return result;
+	}
+
+	song->setExportLoop(false);
+	song->startExport();
+	// skip the first empty buffer like ProjectRenderer does
+	audioEngine->renderNextPeriod();
+	audioEngine->profiler().resetTotals();
+
+	auto samples = std::vector<int_sample_t>(audioEngine->framesPerPeriod() * DEFAULT_CHANNELS);
+	auto renderTime = Clock::duration::zero();
+	while (!song->isExportDone())
+	{
+		const auto periodStart = Clock::now();
+		const auto buffer = audioEngine->renderNextPeriod();
+		renderTime += Clock::now() - periodStart;
+
+		samples.resize(buffer.size() * DEFAULT_CHANNELS);
+		for (auto f = std::size_t{0}; f < buffer.size(); ++f)
+		{
+			for (ch_cnt_t ch = 0; ch < DEFAULT_CHANNELS; ++ch)
+			{
+				const auto sample = std::clamp(buffer[f][ch], -1.f, 1.f);
+				samples[f * DEFAULT_CHANNELS + ch] = static_cast<int_sample_t>(std::lrint(sample * 32767.f));
+			}
+		}
+		hash.addData(QByteArray::fromRawData(reinterpret_cast<const char*>(samples.data()),
+			static_cast<int>(samples.size() * sizeof(int_sample_t))));
+		result.frames += buffer.size();
+
+		BufferManager::refill();
+		NotePlayHandleManager::refill();
+	}
+	song->stopExport();
+
+	result.renderTime = seconds(renderTime);
+	result.totals = audioEngine->profiler().totals();
+	result.peakRss = peakRss();
+	result.hash = QString::fromLatin1(hash.result().toHex());
+	return result;
+}
+
+
+
+QString RenderBenchmark::referenceKey(const QString& file) const
+{
+	const auto base = m_settings.referenceFile.isEmpty()
+		? QDir::current()
+		: QFileInfo{m_settings.referenceFile}.absoluteDir();
+	return base.relativeFilePath(QFileInfo{file}.absoluteFilePath());
+}
+
+
+
+QJsonObject RenderBenchmark::report(const QString& file, const std::vector<Run>& runs, const QString& status) const
+{
+	auto jsonRuns = QJsonArray{};
+	for (const auto& run : runs)
+	{
+		auto stages = QJsonObject{};
+		for (auto i = std::size_t{0}; i < AudioEngineProfiler::DetailCount; ++i)
+		{
+			stages[detailName(i)] = static_cast<double>(run.totals.detailTime[i]) / 1e6;
+		}
+
+		jsonRuns.append(QJsonObject{
+			{"load_time", run.loadTime},
+			{"upgrade_time", run.upgradeTime},
+			{"render_time", run.renderTime},
+			{"frames", static_cast<double>(run.frames)},
+			{"peak_rss_kib", static_cast<double>(run.peakRss)},
+			{"stage_times", stages},
+			{"hash", run.hash}
+		});
+	}
+
+	return QJsonObject{
+		{"project", file},
+		{"status", status},
+		{"runs", jsonRuns}
+	};
+}
+
+} // namespace lmms
@@ -25,9 +25,14 @@
 #include <QDir>
 #include <QRegularExpression>
 
+#include <array>
+
 #include "RenderManager.h"
 
+#include "AudioBusHandle.h"
+#include "InstrumentTrack.h"
 #include "PatternStore.h"
+#include "SampleTrack.h"
 #include "Song.h"
 
 
@@ -52,89 +57,126 @@ void RenderManager::abortProcessing()
 {
 	if ( m_activeRenderer ) {
 		disconnect( m_activeRenderer.get(), SIGNAL(finished()),
-				this, SLOT(renderNextTrack()));
+				this, SLOT(renderFinished()));
 		m_activeRenderer->abortProcessing();
 	}
+	m_tracksToRender.clear();
 	restoreMutedState();
 }
 
-// Called to render each new track when rendering tracks individually.
-void RenderManager::renderNextTrack()
+void RenderManager::renderFinished()
 {
+	if (m_activeRenderer)
+	{
+		m_framesRendered += m_activeRenderer->framesRendered();
+		m_renderTime += m_activeRenderer->renderTime();
+	}
 	m_activeRenderer.reset();
+	m_numStems = 0;
 
-	if (m_tracksToRender.empty())
+	if (!m_tracksToRender.empty())
 	{
-		// nothing left to render
-		restoreMutedState();
-		emit finished();
+		renderNextTrack();
+		return;
 	}
-	else
-	{
-		// pop the next track from our rendering queue
-		Track* renderTrack = m_tracksToRender.back();
-		m_tracksToRender.pop_back();
 
-		// mute everything but the track we are about to render
-		for (auto track : m_unmuted)
+	restoreMutedState();
+	emit finished();
+}
+
+std::vector<Track*> RenderManager::unmutedTracks()
+{
+	auto tracks = std::vector<Track*>{};
+	const auto containers = std::array<TrackContainer*, 2>{Engine::getSong(), Engine::patternStore()};
+	for (const auto container : containers)
+	{
+		for (const auto& tk : container->tracks())
 		{
-			track->setMuted(track != renderTrack);
+			// Don't render automation tracks
+			if (!tk->isMuted() && (tk->type() == Track::Type::Instrument || tk->type() == Track::Type::Sample))
+			{
+				tracks.push_back(tk);
+			}
 		}
-
-		// for multi-render, prefix each output file with a different number
-		int trackNum = m_tracksToRender.size() + 1;
-
-		render( pathForTrack(renderTrack, trackNum) );
 	}
+	return tracks;
 }
 
 // Render the song into individual tracks
-void RenderManager::renderTracks()
+void RenderManager::renderTracks(StemSource source)
 {
-	const TrackContainer::TrackList& tl = Engine::getSong()->tracks();
+	// find all currently unmuted tracks -- we want to render these.
+	auto tracks = unmutedTracks();
 
-	// find all currently unnmuted tracks -- we want to render these.
-	for (const auto& tk : tl)
+	if (source == StemSource::Master && !tracks.empty())
 	{
-		Track::Type type = tk->type();
+		// remember which tracks were unmuted to restore them at the end
+		m_unmuted = tracks;
+		m_tracksToRender = tracks;
+		renderNextTrack();
+		return;
+	}
 
-		// Don't render automation tracks
-		if ( tk->isMuted() == false &&
-				( type == Track::Type::Instrument || type == Track::Type::Sample ) )
-		{
-			m_unmuted.push_back(tk);
-		}
+	if (tracks.empty())
+	{
+		emit finished();
+		return;
 	}
 
-	const TrackContainer::TrackList& t2 = Engine::patternStore()->tracks();
-	for (const auto& tk : t2)
+	// tap the output of each track's audio bus, after its effects but before
+	// the mixer, instead of muting all other tracks and replaying the song
+	// once per track
+	auto stems = std::vector<ProjectRenderer::Stem>{};
+	for (auto i = std::size_t{0}; i < tracks.size(); ++i)
 	{
-		Track::Type type = tk->type();
+		Track* track = tracks[i];
+		AudioBusHandle* bus = track->type() == Track::Type::Instrument
+			? static_cast<InstrumentTrack*>(track)->audioBusHandle()
+			: static_cast<SampleTrack*>(track)->audioBusHandle();
+		stems.push_back({bus, pathForTrack(track, static_cast<int>(i) + 1)});
+	}
 
-		// Don't render automation tracks
-		if ( tk->isMuted() == false &&
-				( type == Track::Type::Instrument || type == Track::Type::Sample ) )
-		{
-			m_unmuted.push_back(tk);
-		}
+	m_numStems = stems.size();
+	start(std::make_unique<ProjectRenderer>(m_outputSettings, m_format, stems));
+}
+
+// Render the song once for the next track, with all other tracks muted
+void RenderManager::renderNextTrack()
+{
+	// pop the next track from our rendering queue
+	Track* renderTrack = m_tracksToRender.back();
+	m_tracksToRender.pop_back();
+
+	for (auto track : m_unmuted)
+	{
+		track->setMuted(track != renderTrack);
 	}
 
-	// copy the list of unmuted tracks into our rendering queue.
-	// we need to remember which tracks were unmuted to restore state at the end.
-	m_tracksToRender = m_unmuted;
+	// for multi-render, prefix each output file with a different number
+	const int trackNum = m_tracksToRender.size() + 1;
+	start(std::make_unique<ProjectRenderer>(m_outputSettings, m_format, pathForTrack(renderTrack, trackNum)));
+}
 
-	renderNextTrack();
+// Unmute all tracks that were muted while rendering tracks one after another
+void RenderManager::restoreMutedState()
+{
+	while (!m_unmuted.empty())
+	{
+		Track* restoreTrack = m_unmuted.back();
+		m_unmuted.pop_back();
+		restoreTrack->setMuted(false);
+	}
 }
 
 // Render the song into a single track
 void RenderManager::renderProject()
 {
-	render( m_outputPath );
+	start(std::make_unique<ProjectRenderer>(m_outputSettings, m_format, m_outputPath));
 }
 
-void RenderManager::render(QString outputPath)
+void RenderManager::start(std::unique_ptr<ProjectRenderer> renderer)
 {
-	m_activeRenderer = std::make_unique<ProjectRenderer>(m_outputSettings, m_format, outputPath);
+	m_activeRenderer = std::move(renderer);
 
 	if( m_activeRenderer->isReady() )
 	{
@@ -142,28 +184,15 @@ void RenderManager::render(QString outputPath)
 		connect( m_activeRenderer.get(), SIGNAL(progressChanged(int)),
 				this, SIGNAL(progressChanged(int)));
 
-		// when it is finished, render the next track.
-		// if we have not queued any tracks, renderNextTrack will just clean up
 		connect( m_activeRenderer.get(), SIGNAL(finished()),
-				this, SLOT(renderNextTrack()));
+				this, SLOT(renderFinished()));
 
 		m_activeRenderer->startProcessing();
 	}
 	else
 	{
 		qDebug( "Renderer failed to acquire a file device!" );
-		renderNextTrack();
-	}
-}
-
-// Unmute all tracks that were muted while rendering tracks
-void RenderManager::restoreMutedState()
-{
-	while (!m_unmuted.empty())
-	{
-		Track* restoreTrack = m_unmuted.back();
-		m_unmuted.pop_back();
-		restoreTrack->setMuted( false );
+		renderFinished();
 	}
 }
 
@@ -183,12 +212,16 @@ void RenderManager::updateConsoleProgress()
 	{
 		m_activeRenderer->updateConsoleProgress();
 
-		int totalNum = m_unmuted.size();
-		if ( totalNum > 0 )
+		if (!m_unmuted.empty())
+		{
+			// we are rendering one track after another, append a track counter to the output
+			const auto totalNum = m_unmuted.size();
+			fprintf(stderr, "(%zu/%zu)", totalNum - m_tracksToRender.size(), totalNum);
+		}
+		else if ( m_numStems > 0 )
 		{
-			// we are rendering multiple tracks, append a track counter to the output
-			int trackNum = totalNum - m_tracksToRender.size();
-			fprintf( stderr, "(%d/%d)", trackNum, totalNum );
+			// we are rendering multiple tracks, append the number of stems to the output
+			fprintf( stderr, "(%zu tracks)", m_numStems );
 		}
 	}
 }
@@ -134,6 +134,14 @@ bool SamplePlayHandle::isFromTrack( const Track * _track ) const
 
 
 
+QString SamplePlayHandle::profilerName() const
+{
+	return m_track ? QString( "%1 (sample)" ).arg( m_track->name() ) : QString( "Sample" );
+}
+
+
+
+
 f_cnt_t SamplePlayHandle::totalFrames() const
 {
 	return (m_sample->endFrame() - m_sample->startFrame()) *
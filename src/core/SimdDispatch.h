@@ -0,0 +1,74 @@
+/*
+ * SimdDispatch.h - choosing between kernels compiled for different
+ *                  instruction sets at runtime
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_SIMD_DISPATCH_H
+#define LMMS_SIMD_DISPATCH_H
+
+#include <vector>
+
+#include "SimdVector.h"
+
+namespace lmms::simd
+{
+
+/**
+ * @brief One kind of kernel sets, e.g. MixKernels::KernelSet, compiled for
+ * each instruction set.
+ *
+ * Every kernel set but the scalar one comes from a translation unit compiled
+ * for its instruction set. If that translation unit wasn't compiled for it,
+ * e.g. AVX2 on ARM or with MinGW, the set is nullptr.
+ *
+ * Only include this in translation units compiled for the baseline
+ * instruction set.
+ */
+template<typename KernelSet>
+struct KernelSets
+{
+	const KernelSet* scalar;
+	const KernelSet* sse2;
+	const KernelSet* avx2;
+	const KernelSet* avx512;
+
+	//! @return the fastest set this build and CPU can run
+	const KernelSet& best() const
+	{
+		if (avx512 && cpuSupports(Isa::Avx512)) { return *avx512; }
+		if (avx2 && cpuSupports(Isa::Avx2)) { return *avx2; }
+		return sse2 ? *sse2 : *scalar;
+	}
+
+	//! @return all sets this build and CPU can run, the scalar one first
+	std::vector<const KernelSet*> supported() const
+	{
+		auto sets = std::vector<const KernelSet*>{scalar};
+		if (sse2) { sets.push_back(sse2); }
+		if (avx2 && cpuSupports(Isa::Avx2)) { sets.push_back(avx2); }
+		if (avx512 && cpuSupports(Isa::Avx512)) { sets.push_back(avx512); }
+		return sets;
+	}
+};
+
+} // namespace lmms::simd
+
+#endif // LMMS_SIMD_DISPATCH_H
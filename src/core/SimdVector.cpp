@@ -0,0 +1,75 @@
+/*
+ * SimdVector.cpp - runtime detection of the instruction sets used by kernels
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "SimdVector.h"
+
+#include "lmmsconfig.h"
+
+#if defined(LMMS_HOST_X86_64) || defined(LMMS_HOST_X86)
+	#if defined(_MSC_VER) && !defined(__clang__)
+		#include <immintrin.h>
+		#include <intrin.h>
+	#endif
+#endif
+
+namespace lmms::simd
+{
+
+bool cpuSupports([[maybe_unused]] Isa isa)
+{
+#if !defined(LMMS_HOST_X86_64) && !defined(LMMS_HOST_X86)
+	return false;
+#elif defined(__GNUC__) || defined(__clang__)
+	// these also check whether the OS saves the extended registers
+	__builtin_cpu_init();
+	switch (isa)
+	{
+		case Isa::Avx2: return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+		case Isa::Avx512: return __builtin_cpu_supports("avx512f");
+	}
+	return false;
+#elif defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 0);
+	if (info[0] < 7) { return false; }
+
+	__cpuid(info, 1);
+	const bool osxsave = info[2] & (1 << 27);
+	const bool fma = info[2] & (1 << 12);
+	if (!osxsave) { return false; }
+	const auto xcr0 = _xgetbv(0);
+
+	__cpuidex(info, 7, 0);
+	switch (isa)
+	{
+		// XMM and YMM state
+		case Isa::Avx2: return fma && (info[1] & (1 << 5)) && (xcr0 & 0x6) == 0x6;
+		// additionally opmask and ZMM state
+		case Isa::Avx512: return (info[1] & (1 << 16)) && (xcr0 & 0xe6) == 0xe6;
+	}
+	return false;
+#else
+	return false;
+#endif
+}
+
+} // namespace lmms::simd
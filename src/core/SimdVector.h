@@ -0,0 +1,192 @@
+/*
+ * SimdVector.h - thin wrappers around vector registers, for kernels that are
+ *                compiled once per instruction set
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_SIMD_VECTOR_H
+#define LMMS_SIMD_VECTOR_H
+
+#include <cstddef>
+#include <cstdint>
+
+#ifdef __SSE2__
+	#include <emmintrin.h>
+#endif
+#ifdef __SSE4_1__
+	#include <smmintrin.h>
+#endif
+#if defined(__AVX2__) || defined(__AVX512F__)
+	#include <immintrin.h>
+#endif
+#if defined(__AVX512F__) && defined(__GNUC__) && !defined(__clang__)
+	// GCC's AVX-512 intrinsics start from _mm512_undefined_ps(), which
+	// triggers false positives once they are inlined
+	#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+// MSVC doesn't define __FMA__, but /arch:AVX2 implies it
+#if defined(__AVX2__) && (defined(__FMA__) || defined(_MSC_VER))
+	#define LMMS_SIMD_AVX2
+#endif
+#ifdef __AVX512F__
+	#define LMMS_SIMD_AVX512
+#endif
+
+namespace lmms::simd
+{
+
+enum class Isa
+{
+	Avx2, //!< AVX2 and FMA
+	Avx512 //!< AVX-512F
+};
+
+//! Whether the CPU and OS support @p isa. Defined in a translation unit
+//! compiled for the baseline instruction set, so it is safe to call anywhere.
+bool cpuSupports(Isa isa);
+
+// This header is included by translation units compiled with different
+// instruction sets. Everything in here must have internal linkage, otherwise
+// the linker may pick e.g. the AVX2 version of a function for all callers.
+//
+// Each struct wraps one vector register of floats and provides:
+//   Width, load(), store(), set1(), add(), sub(), mul(), mulAdd(), min(),
+//   max(), floor(), lt(), le(), gt(), ge(), select() and gather()
+// gather() takes indices as whole numbers stored in floats. The comparisons
+// return a mask that is only meant to be passed to select().
+namespace
+{
+
+#ifdef __SSE2__
+struct Sse2
+{
+	using Vec = __m128;
+	static constexpr std::size_t Width = 4;
+
+	static Vec load(const float* p) { return _mm_loadu_ps(p); }
+	static void store(float* p, Vec v) { _mm_storeu_ps(p, v); }
+	static Vec set1(float x) { return _mm_set1_ps(x); }
+	static Vec add(Vec a, Vec b) { return _mm_add_ps(a, b); }
+	static Vec sub(Vec a, Vec b) { return _mm_sub_ps(a, b); }
+	static Vec mul(Vec a, Vec b) { return _mm_mul_ps(a, b); }
+	static Vec mulAdd(Vec a, Vec b, Vec c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+	static Vec min(Vec a, Vec b) { return _mm_min_ps(a, b); }
+	static Vec max(Vec a, Vec b) { return _mm_max_ps(a, b); }
+	static Vec lt(Vec a, Vec b) { return _mm_cmplt_ps(a, b); }
+	static Vec le(Vec a, Vec b) { return _mm_cmple_ps(a, b); }
+	static Vec gt(Vec a, Vec b) { return _mm_cmpgt_ps(a, b); }
+	static Vec ge(Vec a, Vec b) { return _mm_cmpge_ps(a, b); }
+
+	static Vec select(Vec mask, Vec a, Vec b)
+	{
+#ifdef __SSE4_1__
+		return _mm_blendv_ps(b, a, mask);
+#else
+		return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+#endif
+	}
+
+	static Vec floor(Vec x)
+	{
+#ifdef __SSE4_1__
+		return _mm_floor_ps(x);
+#else
+		// truncation rounds negative numbers up, phases stay far below 2^31
+		const Vec t = _mm_cvtepi32_ps(_mm_cvttps_epi32(x));
+		return _mm_sub_ps(t, _mm_and_ps(_mm_cmpgt_ps(t, x), _mm_set1_ps(1.f)));
+#endif
+	}
+
+	static Vec gather(const float* table, Vec indices)
+	{
+		alignas(16) std::int32_t i[Width];
+		_mm_store_si128(reinterpret_cast<__m128i*>(i), _mm_cvttps_epi32(indices));
+		return _mm_setr_ps(table[i[0]], table[i[1]], table[i[2]], table[i[3]]);
+	}
+};
+#endif
+
+
+#ifdef LMMS_SIMD_AVX2
+struct Avx2
+{
+	using Vec = __m256;
+	static constexpr std::size_t Width = 8;
+
+	static Vec load(const float* p) { return _mm256_loadu_ps(p); }
+	static void store(float* p, Vec v) { _mm256_storeu_ps(p, v); }
+	static Vec set1(float x) { return _mm256_set1_ps(x); }
+	static Vec add(Vec a, Vec b) { return _mm256_add_ps(a, b); }
+	static Vec sub(Vec a, Vec b) { return _mm256_sub_ps(a, b); }
+	static Vec mul(Vec a, Vec b) { return _mm256_mul_ps(a, b); }
+	static Vec mulAdd(Vec a, Vec b, Vec c) { return _mm256_fmadd_ps(a, b, c); }
+	static Vec min(Vec a, Vec b) { return _mm256_min_ps(a, b); }
+	static Vec max(Vec a, Vec b) { return _mm256_max_ps(a, b); }
+	static Vec floor(Vec x) { return _mm256_floor_ps(x); }
+	static Vec lt(Vec a, Vec b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+	static Vec le(Vec a, Vec b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+	static Vec gt(Vec a, Vec b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+	static Vec ge(Vec a, Vec b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+	static Vec select(Vec mask, Vec a, Vec b) { return _mm256_blendv_ps(b, a, mask); }
+
+	static Vec gather(const float* table, Vec indices)
+	{
+		return _mm256_i32gather_ps(table, _mm256_cvttps_epi32(indices), sizeof(float));
+	}
+};
+#endif
+
+
+#ifdef LMMS_SIMD_AVX512
+struct Avx512
+{
+	using Vec = __m512;
+	using Mask = __mmask16;
+	static constexpr std::size_t Width = 16;
+
+	static Vec load(const float* p) { return _mm512_loadu_ps(p); }
+	static void store(float* p, Vec v) { _mm512_storeu_ps(p, v); }
+	static Vec set1(float x) { return _mm512_set1_ps(x); }
+	static Vec add(Vec a, Vec b) { return _mm512_add_ps(a, b); }
+	static Vec sub(Vec a, Vec b) { return _mm512_sub_ps(a, b); }
+	static Vec mul(Vec a, Vec b) { return _mm512_mul_ps(a, b); }
+	static Vec mulAdd(Vec a, Vec b, Vec c) { return _mm512_fmadd_ps(a, b, c); }
+	static Vec min(Vec a, Vec b) { return _mm512_min_ps(a, b); }
+	static Vec max(Vec a, Vec b) { return _mm512_max_ps(a, b); }
+	static Vec floor(Vec x) { return _mm512_roundscale_ps(x, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC); }
+	static Mask lt(Vec a, Vec b) { return _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ); }
+	static Mask le(Vec a, Vec b) { return _mm512_cmp_ps_mask(a, b, _CMP_LE_OQ); }
+	static Mask gt(Vec a, Vec b) { return _mm512_cmp_ps_mask(a, b, _CMP_GT_OQ); }
+	static Mask ge(Vec a, Vec b) { return _mm512_cmp_ps_mask(a, b, _CMP_GE_OQ); }
+	static Vec select(Mask mask, Vec a, Vec b) { return _mm512_mask_blend_ps(mask, b, a); }
+
+	static Vec gather(const float* table, Vec indices)
+	{
+		return _mm512_i32gather_ps(_mm512_cvttps_epi32(indices), table, sizeof(float));
+	}
+};
+#endif
+
+} // namespace
+
+} // namespace lmms::simd
+
+#endif // LMMS_SIMD_VECTOR_H
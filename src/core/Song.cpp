@@ -31,6 +31,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <span>
 
 #include "AutomationTrack.h"
 #include "AutomationEditor.h"
@@ -94,7 +95,7 @@ Song::Song() :
 	m_loopMidiClip( false ),
 	m_loopRenderCount(1),
 	m_loopRenderRemaining(1),
-	m_oldAutomatedValues()
+	m_sampleExactAutomation(ConfigManager::inst()->value("audioengine", "sampleexactautomation", "0").toInt())
 {
 	connect( &m_tempoModel, SIGNAL(dataChanged()),
 			this, SLOT(setTempo()), Qt::DirectConnection );
@@ -341,6 +342,12 @@ void Song::processNextBuffer()
 			}
 		}
 
+		if (sampleExactAutomation())
+		{
+			// Follow the automation curves between two ticks too
+			processAutomationRamps(frameOffsetInTick, frameOffsetInPeriod, framesToPlay);
+		}
+
 		// Update frame counters
 		frameOffsetInPeriod += framesToPlay;
 		frameOffsetInTick += framesToPlay;
@@ -354,9 +361,10 @@ void Song::processNextBuffer()
 
 void Song::processAutomations(const TrackList &tracklist, TimePos timeStart, f_cnt_t)
 {
-	AutomatedValueMap values;
-
-	QSet<const AutomatableModel*> recordedModels;
+	// The containers are kept between ticks, so this doesn't allocate
+	// once they are large enough for the project
+	m_automatedValues.clear();
+	m_recordedModels.clear();
 
 	TrackContainer* container = this;
 	int clipNum = -1;
@@ -378,19 +386,20 @@ void Song::processAutomations(const TrackList &tracklist, TimePos timeStart, f_c
 		return;
 	}
 
-	values = container->automatedValuesAt(timeStart, clipNum);
+	container->collectAutomatedValues(timeStart, clipNum, m_automatedValues);
+	m_automatedValues.evaluate();
 	const TrackList& tracks = container->tracks();
 
-	Track::clipVector clips;
+	m_recordingClips.clear();
 	for (Track* track : tracks)
 	{
 		if (track->type() == Track::Type::Automation) {
-			track->getClipsInRange(clips, 0, timeStart);
+			track->getClipsInRange(m_recordingClips, 0, timeStart);
 		}
 	}
 
 	// Process recording
-	for (Clip* clip : clips)
+	for (Clip* clip : m_recordingClips)
 	{
 		auto p = dynamic_cast<AutomationClip *>(clip);
 		TimePos relTime = timeStart - p->startPosition();
@@ -406,27 +415,28 @@ void Song::processAutomations(const TrackList &tracklist, TimePos timeStart, f_c
 			// and store that so that when playing it back, it scales the value correctly.
 			p->recordValue(relTime, recordedModel->inverseScaledValue(recordedModel->value<float>()));
 
-			recordedModels << recordedModel;
+			m_recordedModels.push_back(recordedModel);
 		}
 	}
 
 	// Checks if an automated model stopped being automated by automation clip
 	// so we can move the control back to any connected controller again
-	for (auto it = m_oldAutomatedValues.begin(); it != m_oldAutomatedValues.end(); it++)
+	for (AutomatableModel* model : m_oldAutomatedModels)
 	{
-		AutomatableModel * am = it.key();
-		if (!values.contains(am))
+		if (!m_automatedValues.contains(model))
 		{
-			am->setUseControllerValue(true);
+			model->setUseControllerValue(true);
 		}
 	}
-	m_oldAutomatedValues = values;
+	m_oldAutomatedModels.clear();
 
 	// Apply values
-	for (auto it = values.begin(); it != values.end(); it++)
+	for (const auto& entry : m_automatedValues)
 	{
-		AutomatableModel* model = it.key();
-		bool isRecording = recordedModels.contains(model);
+		AutomatableModel* model = entry.model;
+		m_oldAutomatedModels.push_back(model);
+
+		bool isRecording = isRecordedModel(model);
 		model->setUseControllerValue(isRecording);
 
 		if (!isRecording)
@@ -436,11 +446,42 @@ void Song::processAutomations(const TrackList &tracklist, TimePos timeStart, f_c
 			 * Y axis can be set to logarithmic, and automation clips store
 			 * the actual values, and not the invertedScaledValue.
 			 */
-			model->setValue(model->scaledValue(it.value()), true);
+			model->setValue(model->scaledValue(entry.value), true);
 		}
 	}
 }
 
+
+
+
+void Song::processAutomationRamps(float frameOffsetInTick, f_cnt_t offset, f_cnt_t frames)
+{
+	// only grows when the buffer size is raised
+	if (m_automationRamp.size() < frames) { m_automationRamp.resize(frames); }
+	const auto ramp = std::span{m_automationRamp}.first(frames);
+
+	const float ticksPerFrame = 1.f / Engine::framesPerTick();
+	for (const auto& entry : m_automatedValues)
+	{
+		if (isRecordedModel(entry.model)) { continue; }
+
+		AutomatedValueList::valuesAfter(entry, frameOffsetInTick * ticksPerFrame, ticksPerFrame, ramp);
+		for (auto& value : ramp)
+		{
+			value = entry.model->scaledValue(value);
+		}
+		entry.model->setAutomatedValues(offset, ramp);
+	}
+}
+
+
+
+
+bool Song::isRecordedModel(const AutomatableModel* model) const
+{
+	return std::find(m_recordedModels.begin(), m_recordedModels.end(), model) != m_recordedModels.end();
+}
+
 void Song::processMetronome(size_t bufferOffset)
 {
 	const auto currentPlayMode = playMode();
@@ -695,12 +736,12 @@ void Song::stop()
 
 	// Moves the control of the models that were processed on the last frame
 	// back to their controllers.
-	for (auto it = m_oldAutomatedValues.begin(); it != m_oldAutomatedValues.end(); it++)
+	for (AutomatableModel* model : m_oldAutomatedModels)
 	{
-		AutomatableModel * am = it.key();
-		am->setUseControllerValue(true);
+		model->setUseControllerValue(true);
 	}
-	m_oldAutomatedValues.clear();
+	m_oldAutomatedModels.clear();
+	m_automatedValues.clear();
 
 	m_playMode = PlayMode::None;
 
@@ -837,11 +878,17 @@ bpm_t Song::getTempo()
 }
 
 
-AutomatedValueMap Song::automatedValuesAt(TimePos time, int clipNum) const
+void Song::collectAutomatedValues(TimePos time, int clipNum, AutomatedValueList& values) const
 {
-	auto trackList = TrackList{m_globalAutomationTrack};
-	trackList.insert(trackList.end(), tracks().begin(), tracks().end());
-	return TrackContainer::automatedValuesFromTracks(trackList, time, clipNum);
+	// the global automation track comes first, so it has the lowest precedence
+	auto& clips = clipNum < 0 ? values.songClips() : values.patternClips();
+	clips.clear();
+	gatherAutomationClips(m_globalAutomationTrack, time, clipNum, clips);
+	for (Track* track : tracks())
+	{
+		gatherAutomationClips(track, time, clipNum, clips);
+	}
+	addAutomatedValues(clips, time, values);
 }
 
 
@@ -899,8 +946,9 @@ void Song::clearProject()
 	m_masterPitchModel.reset();
 	m_timeSigModel.reset();
 
-	// Clear the m_oldAutomatedValues AutomatedValueMap
-	m_oldAutomatedValues.clear();
+	// Forget the models automated in the last tick
+	m_oldAutomatedModels.clear();
+	m_automatedValues.clear();
 
 	AutomationClip::globalAutomationClip( &m_tempoModel )->clear();
 	AutomationClip::globalAutomationClip( &m_masterVolumeModel )->
@@ -281,6 +281,7 @@ void Track::loadTrack(const QDomElement& element, bool presetMode)
 		deleteClips();
 	}
 
+	m_loadingClips = true;
 	QDomNode node = element.firstChild();
 	while( !node.isNull() )
 	{
@@ -301,6 +302,8 @@ void Track::loadTrack(const QDomElement& element, bool presetMode)
 		}
 		node = node.nextSibling();
 	}
+	m_loadingClips = false;
+	invalidateClipIndex();
 
 	int storedHeight = element.attribute( "trackheight" ).toInt();
 	if( storedHeight >= MINIMAL_TRACK_HEIGHT )
@@ -341,6 +344,8 @@ void Track::loadSettings(const QDomElement& element)
 Clip * Track::addClip( Clip * clip )
 {
 	m_clips.push_back( clip );
+	m_playCursor.reserve(m_clips.size());
+	invalidateClipIndex();
 
 	emit clipAdded( clip );
 
@@ -360,6 +365,7 @@ void Track::removeClip( Clip * clip )
 	if( it != m_clips.end() )
 	{
 		m_clips.erase( it );
+		invalidateClipIndex();
 		if( Engine::getSong() )
 		{
 			Engine::getSong()->updateLength();
@@ -369,6 +375,15 @@ void Track::removeClip( Clip * clip )
 }
 
 
+void Track::invalidateClipIndex()
+{
+	m_clipIndex.invalidate();
+	if (!m_loadingClips) { m_clipIndex.update(m_clips); }
+}
+
+
+
+
 /*! \brief Remove all Clips from this track */
 void Track::deleteClips()
 {
@@ -448,26 +463,19 @@ int Track::getClipNum( const Clip * clip )
  *  the given time period.
  *
  *  We return the Clips we find in order by time, earliest Clips first.
+ *  The lookup goes through an index, so consecutive periods during
+ *  playback don't have to look at every Clip of the track.
  *
  *  \param clipV The list to contain the found clips.
  *  \param start The MIDI start time of the range.
  *  \param end   The MIDI endi time of the range.
+ *  \param cursor Remembers the last range of a caller that queries
+ *     consecutive ranges, such as m_playCursor.
  */
 void Track::getClipsInRange( clipVector & clipV, const TimePos & start,
-							const TimePos & end )
+							const TimePos & end, ClipIndex::Cursor * cursor )
 {
-	for( Clip* clip : m_clips )
-	{
-		int s = clip->startPosition();
-		int e = clip->endPosition();
-		if( ( s <= end ) && ( e >= start ) )
-		{
-			// Clip is within given range
-			// Insert sorted by Clip's position
-			clipV.insert(std::upper_bound(clipV.begin(), clipV.end(), clip, Clip::comparePosition),
-						clip);
-		}
-	}
+	m_clipIndex.clipsInRange(m_clips, clipV, start.getTicks(), end.getTicks(), cursor);
 }
 
 
@@ -484,6 +492,7 @@ void Track::getClipsInRange( clipVector & clipV, const TimePos & start,
 void Track::swapPositionOfClips( int clipNum1, int clipNum2 )
 {
 	qSwap( m_clips[clipNum1], m_clips[clipNum2] );
+	invalidateClipIndex();
 
 	const TimePos pos = m_clips[clipNum1]->startPosition();
 
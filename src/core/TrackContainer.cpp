@@ -24,6 +24,8 @@
  */
 
 
+#include <limits>
+
 #include <QCoreApplication>
 #include <QProgressDialog>
 #include <QDomElement>
@@ -260,42 +262,62 @@ bool TrackContainer::isEmpty() const
 
 AutomatedValueMap TrackContainer::automatedValuesAt(TimePos time, int clipNum) const
 {
-	return automatedValuesFromTracks(tracks(), time, clipNum);
+	auto values = AutomatedValueList{};
+	collectAutomatedValues(time, clipNum, values);
+	values.evaluate();
+	return values.toMap();
 }
 
 
-AutomatedValueMap TrackContainer::automatedValuesFromTracks(const TrackList &tracks, TimePos time, int clipNum)
-{
-	Track::clipVector clips;
 
-	for (Track* track: tracks)
+
+void TrackContainer::collectAutomatedValues(TimePos time, int clipNum, AutomatedValueList& values) const
+{
+	auto& clips = clipNum < 0 ? values.songClips() : values.patternClips();
+	clips.clear();
+	for (Track* track : tracks())
 	{
-		if (track->isMuted()) {
-			continue;
-		}
+		gatherAutomationClips(track, time, clipNum, clips);
+	}
+	addAutomatedValues(clips, time, values);
+}
 
-		switch(track->type())
-		{
-		case Track::Type::Automation:
-		case Track::Type::HiddenAutomation:
-		case Track::Type::Pattern:
-			if (clipNum < 0) {
-				track->getClipsInRange(clips, 0, time);
-			} else {
-				Q_ASSERT(track->numOfClips() > clipNum);
-				clips.push_back(track->getClip(clipNum));
-			}
-		default:
-			break;
+
+
+
+void TrackContainer::gatherAutomationClips(Track* track, TimePos time, int clipNum, Track::clipVector& clips)
+{
+	if (track->isMuted()) {
+		return;
+	}
+
+	switch(track->type())
+	{
+	case Track::Type::Automation:
+	case Track::Type::HiddenAutomation:
+	case Track::Type::Pattern:
+		if (clipNum < 0) {
+			track->getClipsInRange(clips, 0, time);
+		} else {
+			Q_ASSERT(track->numOfClips() > clipNum);
+			clips.push_back(track->getClip(clipNum));
 		}
+	default:
+		break;
 	}
+}
+
 
-	AutomatedValueMap valueMap;
 
+
+void TrackContainer::addAutomatedValues(const Track::clipVector& clips, TimePos time, AutomatedValueList& values)
+{
 	Q_ASSERT(std::is_sorted(clips.begin(), clips.end(), Clip::comparePosition));
 
-	for(Clip* clip : clips)
+	// Later clips take precedence, and the first clip added for a model wins
+	for (auto it = clips.rbegin(); it != clips.rend(); ++it)
 	{
+		Clip* clip = *it;
 		if (clip->isMuted() || clip->startPosition() > time) {
 			continue;
 		}
@@ -305,15 +327,14 @@ AutomatedValueMap TrackContainer::automatedValuesFromTracks(const TrackList &tra
 			if (! p->hasAutomation()) {
 				continue;
 			}
-			TimePos relTime = time - p->startPosition() - p->startTimeOffset();
-			if (!p->isInPattern()) {
-				relTime = std::min(static_cast<int>(relTime), p->length() - p->startTimeOffset());
-			}
-			float value = p->valueAt(relTime);
+			const TimePos relTime = time - p->startPosition() - p->startTimeOffset();
+			const float end = p->isInPattern()
+				? std::numeric_limits<float>::infinity()
+				: static_cast<float>(p->length() - p->startTimeOffset());
 
 			for (AutomatableModel* model : p->objects())
 			{
-				valueMap[model] = value;
+				if (model) { values.add(model, p, static_cast<float>(relTime.getTicks()), end); }
 			}
 		}
 		else if (auto* pattern = dynamic_cast<PatternClip*>(clip))
@@ -325,21 +346,11 @@ AutomatedValueMap TrackContainer::automatedValuesFromTracks(const TrackList &tra
 			patTime = std::min(patTime, clip->length());
 			patTime = patTime % (patStore->lengthOfPattern(patIndex) * TimePos::ticksPerBar());
 
-			auto patValues = patStore->automatedValuesAt(patTime, patIndex);
-			for (auto it=patValues.begin(); it != patValues.end(); it++)
-			{
-				// override old values, pattern track with the highest index takes precedence
-				valueMap[it.key()] = it.value();
-			}
-		}
-		else
-		{
-			continue;
+			// pattern track with the highest index takes precedence
+			patStore->collectAutomatedValues(patTime, patIndex, values);
 		}
 	}
-
-	return valueMap;
-};
+}
 
 
 } // namespace lmms
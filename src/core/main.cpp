@@ -58,7 +58,6 @@
 #include "MainApplication.h"
 #include "ConfigManager.h"
 #include "DataFile.h"
-#include "NotePlayHandle.h"
 #include "embed.h"
 #include "Engine.h"
 #include "GuiApplication.h"
@@ -68,6 +67,8 @@
 #include "MixHelpers.h"
 #include "OutputSettings.h"
 #include "ProjectRenderer.h"
+#include "RealtimeAudit.h"
+#include "RenderBenchmark.h"
 #include "RenderManager.h"
 #include "Song.h"
 
@@ -165,6 +166,9 @@ void printHelp()
 		"  compress <in>                         Compress file <in>\n"
 		"  render <project> [options...]         Render given project file\n"
 		"  rendertracks <project> [options...]   Render each track to a different file\n"
+		"  render-bench <project|dir>... [options...]\n"
+		"                                        Measure loading and rendering the given\n"
+		"                                        projects without writing audio files\n"
 		"  upgrade <in> [out]                    Upgrade file <in> and save as <out>\n"
 		"                                        Standard out is used if no output file\n"
 		"                                        is specified\n"
@@ -202,10 +206,29 @@ void printHelp()
 		"          If not specified, render will overwrite the input file\n"
 		"          For \"rendertracks\", this might be required\n"
 		"  -p, --profile <out>            Dump profiling information to file <out>\n"
+		"          If <out> ends with .json, the processing time of every\n"
+		"          track, effect chain and mixer channel is written\n"
+		"          as Chrome trace events.\n"
+		"      --rt-audit <report>        Record heap allocations and lock calls\n"
+		"          made by the audio threads into <report>.\n"
+		"          Exits with an error if there were any.\n"
+		"          Requires a build with WANT_DEBUG_RT_AUDIT.\n"
+		"      --through-mixer            For \"rendertracks\", include mixer channel\n"
+		"          and master effects. The song is rendered once per track\n"
+		"          instead of once for all tracks.\n"
 		"  -s, --samplerate <samplerate>  Specify output samplerate in Hz\n"
 		"          Range: 44100 (default) to 192000\n"
 		"          Possible values: 1, 2, 4, 8\n"
-		"          Default: 2\n\n",
+		"          Default: 2\n"
+		"\nOptions for \"render-bench\":\n"
+		"  -n, --repeat <count>           Render every project <count> times\n"
+		"          Default: 3\n"
+		"  -o, --output <path>            Write all results as JSON to <path>\n"
+		"      --reference <file>         Compare the rendered output against the\n"
+		"          hashes stored in <file>, exit with an error on mismatch\n"
+		"      --update-reference         Store the hashes of this run in the\n"
+		"          reference file instead\n"
+		"  -p, --profile <out>            See above\n\n",
 		LMMS_VERSION, LMMS_PROJECT_COPYRIGHT );
 }
 
@@ -253,7 +276,10 @@ int main( int argc, char * * argv )
 	bool allowRoot = false;
 	bool renderLoop = false;
 	bool renderTracks = false;
-	QString fileToLoad, fileToImport, renderOut, profilerOutputFile, configFile;
+	bool renderThroughMixer = false;
+	bool renderBench = false;
+	RenderBenchmark::Settings benchSettings;
+	QString fileToLoad, fileToImport, renderOut, profilerOutputFile, rtAuditFile, configFile;
 
 	// first of two command-line parsing stages
 	for (int i = 1; i < argc; ++i)
@@ -279,6 +305,11 @@ int main( int argc, char * * argv )
 			coreOnly = true;
 			renderTracks = true;
 		}
+		else if (arg == "render-bench")
+		{
+			coreOnly = true;
+			renderBench = true;
+		}
 		else if (arg == "--allowroot")
 		{
 			allowRoot = true;
@@ -344,9 +375,6 @@ int main( int argc, char * * argv )
 	}
 #endif
 
-	// initialize memory managers
-	NotePlayHandleManager::init();
-
 	// initialize RNG
 	srand( getpid() + time( 0 ) );
 
@@ -482,10 +510,67 @@ int main( int argc, char * * argv )
 			fileToLoad = QString::fromLocal8Bit( argv[i] );
 			renderOut = fileToLoad;
 		}
+		else if( arg == "render-bench" )
+		{
+			// handled in the first stage, so the options below can be checked
+		}
+		else if( arg == "--repeat" || arg == "-n" )
+		{
+			if( !renderBench )
+			{
+				return usageError( QString( "%1 is only supported by render-bench" ).arg( arg ) );
+			}
+
+			++i;
+
+			if( i == argc )
+			{
+				return usageError( "No repeat count specified" );
+			}
+
+			benchSettings.repetitions = QString( argv[i] ).toInt();
+			if( benchSettings.repetitions < 1 )
+			{
+				return usageError( QString( "Invalid repeat count %1" ).arg( argv[i] ) );
+			}
+		}
+		else if( arg == "--reference" )
+		{
+			if( !renderBench )
+			{
+				return usageError( "--reference is only supported by render-bench" );
+			}
+
+			++i;
+
+			if( i == argc )
+			{
+				return usageError( "No reference file specified" );
+			}
+
+			benchSettings.referenceFile = QString::fromLocal8Bit( argv[i] );
+		}
+		else if( arg == "--update-reference" )
+		{
+			if( !renderBench )
+			{
+				return usageError( "--update-reference is only supported by render-bench" );
+			}
+
+			benchSettings.updateReference = true;
+		}
 		else if( arg == "--loop" || arg == "-l" )
 		{
 			renderLoop = true;
 		}
+		else if( arg == "--through-mixer" )
+		{
+			if( !renderTracks )
+			{
+				return usageError( "--through-mixer is only supported by rendertracks" );
+			}
+			renderThroughMixer = true;
+		}
 		else if( arg == "--output" || arg == "-o" )
 		{
 			++i;
@@ -638,6 +723,22 @@ int main( int argc, char * * argv )
 
 			profilerOutputFile = QString::fromLocal8Bit( argv[i] );
 		}
+		else if( arg == "--rt-audit" )
+		{
+			++i;
+
+			if( i == argc )
+			{
+				return usageError( "No realtime audit report specified" );
+			}
+
+			if( !RealtimeAudit::isSupported() )
+			{
+				return usageError( "This build of LMMS has no realtime audit support" );
+			}
+
+			rtAuditFile = QString::fromLocal8Bit( argv[i] );
+		}
 		else if( arg == "--config" || arg == "-c" )
 		{
 			++i;
@@ -655,10 +756,27 @@ int main( int argc, char * * argv )
 			{
 				return usageError( QString( "Invalid option %1" ).arg( argv[i] ) );
 			}
+			if( renderBench )
+			{
+				benchSettings.paths << QString::fromLocal8Bit( argv[i] );
+				continue;
+			}
 			fileToLoad = QString::fromLocal8Bit( argv[i] );
 		}
 	}
 
+	if( renderBench )
+	{
+		if( benchSettings.paths.isEmpty() )
+		{
+			return noInputFileError();
+		}
+		if( benchSettings.updateReference && benchSettings.referenceFile.isEmpty() )
+		{
+			return usageError( "--update-reference requires --reference" );
+		}
+	}
+
 	// Test file argument before continuing
 	if( !fileToLoad.isEmpty() )
 	{
@@ -704,10 +822,28 @@ int main( int argc, char * * argv )
 #endif
 
 	bool destroyEngine = false;
+	int ret = EXIT_SUCCESS;
+
+	if( renderBench )
+	{
+		Engine::init( true );
+		destroyEngine = true;
+
+		// make noise and other random sources as reproducible as possible
+		srand( 0 );
 
+		if( profilerOutputFile.isEmpty() == false )
+		{
+			Engine::audioEngine()->profiler().setOutputFile( profilerOutputFile );
+		}
+
+		benchSettings.outputFile = renderOut;
+		RenderBenchmark benchmark( benchSettings );
+		ret = benchmark.run() ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
 	// if we have an output file for rendering, just render the song
 	// without starting the GUI
-	if( !renderOut.isEmpty() )
+	else if( !renderOut.isEmpty() )
 	{
 		Engine::init( true );
 		destroyEngine = true;
@@ -733,6 +869,15 @@ int main( int argc, char * * argv )
 
 		// create renderer
 		auto r = new RenderManager(os, eff, renderOut);
+		QObject::connect( r, &RenderManager::finished, [r, os]
+		{
+			const auto frames = r->framesRendered();
+			const auto seconds = r->renderTime();
+			const auto framesPerSecond = seconds > 0 ? frames / seconds : 0.0;
+			printf( "\nRendered %llu frames in %.2f s: %.0f frames/sec (%.1fx realtime)\n",
+				static_cast<unsigned long long>( frames ), seconds, framesPerSecond,
+				framesPerSecond / os.getSampleRate() );
+		} );
 		QCoreApplication::instance()->connect( r,
 				SIGNAL(finished()), SLOT(quit()));
 
@@ -747,10 +892,17 @@ int main( int argc, char * * argv )
 			Engine::audioEngine()->profiler().setOutputFile( profilerOutputFile );
 		}
 
+		if( !rtAuditFile.isEmpty() )
+		{
+			RealtimeAudit::enable();
+		}
+
 		// start now!
 		if ( renderTracks )
 		{
-			r->renderTracks();
+			r->renderTracks( renderThroughMixer
+				? RenderManager::StemSource::Master
+				: RenderManager::StemSource::TrackBus );
 		}
 		else
 		{
@@ -912,9 +1064,27 @@ int main( int argc, char * * argv )
 		}
 	}
 
-	const int ret = app->exec();
+	if( !renderBench )
+	{
+		ret = app->exec();
+	}
 	delete app;
 
+	if( RealtimeAudit::isEnabled() )
+	{
+		const auto violations = RealtimeAudit::violationCount();
+		if( !RealtimeAudit::writeReport( rtAuditFile ) )
+		{
+			printf( "\nCould not write realtime audit report to %s\n", rtAuditFile.toUtf8().constData() );
+		}
+		if( violations > 0 )
+		{
+			printf( "\nRealtime audit: %zu violation(s), see %s\n",
+				violations, rtAuditFile.toUtf8().constData() );
+			ret = EXIT_FAILURE;
+		}
+	}
+
 	if( destroyEngine )
 	{
 		Engine::destroy();
@@ -936,8 +1106,5 @@ int main( int argc, char * * argv )
 	}
 #endif
 
-
-	NotePlayHandleManager::free();
-
 	return ret;
 }
@@ -102,6 +102,16 @@ void MidiClient::subscribeWritablePort( MidiPort* , const QString& , bool )
 
 void MidiClientRaw::parseData( const unsigned char c )
 {
+	parseData( c, MidiInputQueue::Clock::now() );
+}
+
+
+
+
+void MidiClientRaw::parseData( const unsigned char c, MidiInputQueue::Clock::time_point arrival )
+{
+	m_midiParseData.m_arrival = arrival;
+
 	/*********************************************************************/
 	/* 'Process' system real-time messages                               */
 	/*********************************************************************/
@@ -240,7 +250,7 @@ void MidiClientRaw::processParsedEvent()
 {
 	for (const auto& midiPort : m_midiPorts)
 	{
-		midiPort->processInEvent(m_midiParseData.m_midiEvent);
+		midiPort->processInEvent(m_midiParseData.m_midiEvent, TimePos{}, m_midiParseData.m_arrival);
 	}
 }
 
@@ -0,0 +1,47 @@
+/*
+ * MidiInputQueue.cpp - timestamped MIDI events on their way from a MIDI client
+ *                      to the audio engine
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "MidiInputQueue.h"
+
+#include <algorithm>
+
+namespace lmms
+{
+
+
+f_cnt_t MidiInputQueue::frameOffset(Clock::time_point arrival, Clock::time_point previousPeriod,
+	Clock::time_point currentPeriod, f_cnt_t frames)
+{
+	// Periods are rendered whenever the audio device asks for them, which
+	// isn't always evenly spaced in time. Scaling by the actual time between
+	// them keeps the events in order and never pushes them past the period.
+	const auto interval = currentPeriod - previousPeriod;
+	if (frames == 0 || interval <= Clock::duration::zero() || arrival <= previousPeriod) { return 0; }
+
+	const auto offset = static_cast<f_cnt_t>(
+		static_cast<double>((arrival - previousPeriod).count()) / interval.count() * frames);
+	return std::min(offset, frames - 1);
+}
+
+
+} // namespace lmms
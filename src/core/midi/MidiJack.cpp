@@ -184,6 +184,10 @@ void MidiJack::JackMidiRead(jack_nframes_t nframes)
 	jack_nframes_t event_index = 0;
 	jack_nframes_t event_count = jack_midi_get_event_count(port_buf);
 
+	// the events arrived during the previous cycle, at the frame they carry
+	const auto cycleStart = MidiInputQueue::Clock::now();
+	const auto frameDuration = std::chrono::duration<double>{1.0 / jack_get_sample_rate(jackClient())};
+
 	int rval = jack_midi_event_get(&in_event, port_buf, 0);
 	if (rval == 0 /* 0 = success */)
 	{
@@ -191,10 +195,13 @@ void MidiJack::JackMidiRead(jack_nframes_t nframes)
 		{
 			while((in_event.time == i) && (event_index < event_count))
 			{
+				const auto arrival = cycleStart - std::chrono::duration_cast<MidiInputQueue::Clock::duration>(
+					static_cast<double>(nframes - i) * frameDuration);
+
 				// lmms is setup to parse bytes coming from a device
 				// parse it byte by byte as it expects
 				for (unsigned int b = 0; b < in_event.size; b++)
-					parseData( *(in_event.buffer + b) );
+					parseData( *(in_event.buffer + b), arrival );
 
 				event_index++;
 				if(event_index < event_count)
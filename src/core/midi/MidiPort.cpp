@@ -26,6 +26,8 @@
 #include <QDomElement>
 
 #include "MidiPort.h"
+#include "AudioEngine.h"
+#include "Engine.h"
 #include "MidiClient.h"
 #include "MidiDummy.h"
 #include "MidiEventProcessor.h"
@@ -63,7 +65,8 @@ MidiPort::MidiPort( const QString& name,
 	m_outputProgramModel( 1, 1, MidiProgramCount, this, tr( "Output MIDI program" ) ),
 	m_baseVelocityModel( MidiMaxVelocity/2, 1, MidiMaxVelocity, this, tr( "Base velocity" ) ),
 	m_readableModel( false, this, tr( "Receive MIDI-events" ) ),
-	m_writableModel( false, this, tr( "Send MIDI-events" ) )
+	m_writableModel( false, this, tr( "Send MIDI-events" ) ),
+	m_inputQueued( false )
 {
 	m_midiClient->addPort( this );
 
@@ -91,6 +94,8 @@ MidiPort::MidiPort( const QString& name,
 	}
 
 	updateMidiPortMode();
+
+	setInputQueued( true );
 }
 
 
@@ -98,6 +103,8 @@ MidiPort::MidiPort( const QString& name,
 
 MidiPort::~MidiPort()
 {
+	setInputQueued( false );
+
 	// unsubscribe ports
 	m_readableModel.setValue( false );
 	m_writableModel.setValue( false );
@@ -127,7 +134,55 @@ void MidiPort::setMode( Mode mode )
 
 
 
+void MidiPort::setInputQueued( bool queued )
+{
+	// Without an audio engine, nothing would ever take the events out of the
+	// queue, so they're dispatched right away
+	if( queued == m_inputQueued || !Engine::audioEngine() )
+	{
+		return;
+	}
+
+	if( queued )
+	{
+		Engine::audioEngine()->addMidiInputPort( this );
+		m_inputQueued = true;
+	}
+	else
+	{
+		m_inputQueued = false;
+		Engine::audioEngine()->removeMidiInputPort( this );
+	}
+}
+
+
+
+
 void MidiPort::processInEvent( const MidiEvent& event, const TimePos& time )
+{
+	processInEvent( event, time, MidiInputQueue::Clock::now() );
+}
+
+
+
+
+void MidiPort::processInEvent( const MidiEvent& event, const TimePos& time, MidiInputQueue::Clock::time_point arrival )
+{
+	// SysEx data belongs to the client, so those events can't wait. If the
+	// queue is full, a late event is still better than a lost one.
+	if( m_inputQueued && Engine::audioEngine()->midiInputTimestamping() && event.type() != MidiSysEx
+		&& m_inputQueue.push( event, time, arrival ) )
+	{
+		return;
+	}
+
+	dispatchInEvent( event, time, 0 );
+}
+
+
+
+
+void MidiPort::dispatchInEvent( const MidiEvent& event, const TimePos& time, f_cnt_t offset )
 {
 	// mask event
 	if( isInputEnabled() &&
@@ -149,7 +204,7 @@ void MidiPort::processInEvent( const MidiEvent& event, const TimePos& time )
 			}
 		}
 
-		m_midiEventProcessor->processInEvent( inEvent, time );
+		m_midiEventProcessor->processInEvent( inEvent, time, offset );
 	}
 }
 
@@ -37,6 +37,7 @@
 
 #include "AboutDialog.h"
 #include "AutomationEditor.h"
+#include "BufferManager.h"
 #include "ControllerRackView.h"
 #include "DeprecationHelper.h"
 #include "embed.h"
@@ -46,6 +47,7 @@
 #include "FileDialog.h"
 #include "Metronome.h"
 #include "MixerView.h"
+#include "NotePlayHandle.h"
 #include "GuiApplication.h"
 #include "ImportFilter.h"
 #include "InstrumentTrackView.h"
@@ -1364,6 +1366,10 @@ void MainWindow::keyReleaseEvent( QKeyEvent * _ke )
 
 void MainWindow::timerEvent( QTimerEvent * _te)
 {
+	// grow the play handle pools outside of the audio threads
+	BufferManager::refill();
+	NotePlayHandleManager::refill();
+
 	emit periodicUpdate();
 }
 
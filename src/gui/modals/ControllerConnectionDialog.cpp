@@ -56,6 +56,9 @@ public:
 		m_detectedMidiChannel( 0 ),
 		m_detectedMidiController(NONE)
 	{
+		// this controller belongs to the dialog, keep its events away from
+		// the audio engine
+		m_midiPort.setInputQueued( false );
 		updateName();
 	}
 
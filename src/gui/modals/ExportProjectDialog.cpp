@@ -163,6 +163,15 @@ ExportProjectDialog::ExportProjectDialog(const QString& path, Mode mode, QWidget
 	exportSettingsLayout->addWidget(m_exportBetweenLoopMarkersBox);
 	exportSettingsLayout->addLayout(loopRepeatLayout);
 
+	if (m_mode == Mode::ExportTracks)
+	{
+		// see RenderManager::StemSource
+		m_exportThroughMixerBox = new QCheckBox(tr("Include mixer channel and master effects"));
+		m_exportThroughMixerBox->setToolTip(tr("Without this, each track is exported after its own effects, "
+			"and the song is rendered only once for all tracks. With this, the song is rendered once per track."));
+		exportSettingsLayout->addWidget(m_exportThroughMixerBox);
+	}
+
 	m_fileFormatSettingsLayout->addRow(m_fileFormatLabel, m_fileFormatComboBox);
 
 	auto startCancelButtonsLayout = new QHBoxLayout{};
@@ -270,7 +279,9 @@ void ExportProjectDialog::onStartButtonClicked()
 		m_renderManager->renderProject();
 		break;
 	case Mode::ExportTracks:
-		m_renderManager->renderTracks();
+		m_renderManager->renderTracks(m_exportThroughMixerBox->isChecked()
+			? RenderManager::StemSource::Master
+			: RenderManager::StemSource::TrackBus);
 		break;
 	}
 }
@@ -39,7 +39,9 @@
 #include "MainWindow.h"
 #include "MidiSetupWidget.h"
 #include "ProjectJournal.h"
+#include "RemotePluginPool.h"
 #include "SetupDialog.h"
+#include "Song.h"
 #include "TabBar.h"
 #include "TabButton.h"
 #include "TimeLineWidget.h"
@@ -142,14 +144,26 @@ SetupDialog::SetupDialog(ConfigTab tab_to_open) :
 			"ui", "vstalwaysontop").toInt()),
 	m_disableAutoQuit(ConfigManager::inst()->value(
 			"ui", "disableautoquit", "1").toInt()),
+	m_remoteProcessingRing(ConfigManager::inst()->value(
+			"audioengine", "remoteprocessingring", "0").toInt()),
+	m_remotePipelining(ConfigManager::inst()->value(
+			"audioengine", "remotepipelining", "0").toInt()),
+	m_remotePluginPool(ConfigManager::inst()->value(
+			"audioengine", "remotepluginpool", "0").toInt()),
 	m_bufferSize(ConfigManager::inst()->value(
 			"audioengine", "framesperaudiobuffer").toInt()),
 	m_mixSanitization(ConfigManager::inst()->value(
 			"audioengine", "sanitizemix", "1").toInt()),
+	m_taskGraph(ConfigManager::inst()->value(
+			"audioengine", "taskgraph", "0").toInt()),
+	m_sampleExactAutomation(ConfigManager::inst()->value(
+			"audioengine", "sampleexactautomation", "0").toInt()),
 	m_sampleRate(ConfigManager::inst()->value(
 			"audioengine", "samplerate").toInt()),
 	m_midiAutoQuantize(ConfigManager::inst()->value(
 			"midi", "autoquantize", "0").toInt() != 0),
+	m_midiTimestampInput(ConfigManager::inst()->value(
+			"midi", "timestampinput", "0").toInt() != 0),
 	m_workingDir(QDir::toNativeSeparators(ConfigManager::inst()->workingDir())),
 	m_vstDir(QDir::toNativeSeparators(ConfigManager::inst()->vstDir())),
 	m_ladspaDir(QDir::toNativeSeparators(ConfigManager::inst()->ladspaDir())),
@@ -476,6 +490,26 @@ SetupDialog::SetupDialog(ConfigTab tab_to_open) :
 	addCheckBox(tr("Keep effects running even without input"), pluginsBox, pluginsLayout,
 		m_disableAutoQuit, SLOT(toggleDisableAutoQuit(bool)), false);
 
+	const auto remoteProcessingRingCheckBox = addCheckBox(tr("Exchange audio with remote plugins through shared memory"),
+		pluginsBox, pluginsLayout, m_remoteProcessingRing, SLOT(toggleRemoteProcessingRing(bool)), false);
+	remoteProcessingRingCheckBox->setToolTip(tr("Plugins running in a separate process, like ZynAddSubFX, get "
+												"their work without the message channel, which saves system "
+												"calls in every period. Applies to plugins loaded afterwards."));
+
+	const auto remotePipeliningCheckBox = addCheckBox(tr("Let remote plugins render one period ahead"),
+		pluginsBox, pluginsLayout, m_remotePipelining, SLOT(toggleRemotePipelining(bool)), false);
+	remotePipeliningCheckBox->setToolTip(tr("Remote plugins render in parallel with the rest of the project, "
+											"which adds one period of latency to them. Requires exchanging "
+											"audio through shared memory."));
+
+	const auto remotePluginPoolCheckBox = addCheckBox(tr("Start remote plugin processes in advance"),
+		pluginsBox, pluginsLayout, m_remotePluginPool, SLOT(toggleRemotePluginPool(bool)), false);
+	remotePluginPoolCheckBox->setToolTip(tr("Keeps a spare process ready for every kind of remote plugin "
+											"used so far, and starts several at once while a project is "
+											"loading. The plugins themselves are still loaded one after "
+											"another. Loading VST plugins gets faster, at the cost of "
+											"idle processes."));
+
 
 	// Performance layout ordering.
 	performance_layout->addWidget(autoSaveBox);
@@ -662,6 +696,18 @@ SetupDialog::SetupDialog(ConfigTab tab_to_open) :
 	enableMixSanitizationCheckbox->setToolTip(tr("Provides protection from any plugins or tracks that generate "
 												 "corrupted audio, but may negatively impact performance."));
 
+	const auto enableTaskGraphCheckbox = addCheckBox(tr("Process tracks and mixer as one task graph"), otherBox,
+		otherBoxLayout, m_taskGraph, SLOT(toggleTaskGraph(bool)), false);
+	enableTaskGraphCheckbox->setToolTip(tr("Lets track effects and mixer channels start as soon as their own "
+										   "inputs are done instead of waiting for all tracks. May reduce CPU load "
+										   "peaks in projects with uneven load per track."));
+
+	const auto sampleExactAutomationCheckbox = addCheckBox(tr("Apply automation sample by sample"), otherBox,
+		otherBoxLayout, m_sampleExactAutomation, SLOT(toggleSampleExactAutomation(bool)), false);
+	sampleExactAutomationCheckbox->setToolTip(tr("Instruments and effects that support it follow automation "
+												 "curves between ticks instead of ramping linearly from one "
+												 "tick to the next. Slightly increases CPU usage."));
+
 	// Audio layout ordering.
 	audio_layout->addWidget(audioInterfaceBox);
 	audio_layout->addWidget(as_w);
@@ -787,11 +833,23 @@ SetupDialog::SetupDialog(ConfigTab tab_to_open) :
 		box->setToolTip(tr("If enabled, notes will be automatically quantized when recording them from a MIDI controller. If disabled, they are always recorded at the highest possible resolution."));
 	}
 
+	// MIDI live input tab
+	auto* midiLiveInputTab = new QGroupBox(tr("Live input"), midi_w);
+	auto* midiLiveInputLayout = new QVBoxLayout(midiLiveInputTab);
+	{
+		auto *box = addCheckBox(tr("Play notes at the time they arrive"),
+								midiLiveInputTab, midiLiveInputLayout,
+								m_midiTimestampInput, SLOT(toggleMidiTimestampInput(bool)),
+								false);
+		box->setToolTip(tr("If enabled, notes from a MIDI controller are delayed by one period and played at the exact frame matching their arrival, so live playing doesn't jitter. If disabled, they are played right away at the start of the next period."));
+	}
+
 	// MIDI layout ordering.
 	midi_layout->addWidget(midiInterfaceBox);
 	midi_layout->addWidget(ms_w);
 	midi_layout->addWidget(midiAutoAssignBox);
 	midi_layout->addWidget(midiRecordingTab);
+	midi_layout->addWidget(midiLiveInputTab);
 	midi_layout->addStretch();
 
 
@@ -1027,10 +1085,20 @@ void SetupDialog::accept()
 					QString::number(m_vstAlwaysOnTop));
 	ConfigManager::inst()->setValue("ui", "disableautoquit",
 					QString::number(m_disableAutoQuit));
+	ConfigManager::inst()->setValue("audioengine", "remoteprocessingring",
+					QString::number(m_remoteProcessingRing));
+	ConfigManager::inst()->setValue("audioengine", "remotepipelining",
+					QString::number(m_remotePipelining));
+	ConfigManager::inst()->setValue("audioengine", "remotepluginpool",
+					QString::number(m_remotePluginPool));
 	ConfigManager::inst()->setValue("audioengine", "audiodev",
 					m_audioIfaceNames[m_audioInterfaces->currentText()]);
 	ConfigManager::inst()->setValue("audioengine", "sanitizemix",
 					QString::number(m_mixSanitization));
+	ConfigManager::inst()->setValue("audioengine", "taskgraph",
+					QString::number(m_taskGraph));
+	ConfigManager::inst()->setValue("audioengine", "sampleexactautomation",
+					QString::number(m_sampleExactAutomation));
 	ConfigManager::inst()->setValue("audioengine", "samplerate",
 					QString::number(m_sampleRate));
 	ConfigManager::inst()->setValue("audioengine", "framesperaudiobuffer",
@@ -1040,6 +1108,7 @@ void SetupDialog::accept()
 	ConfigManager::inst()->setValue("midi", "midiautoassign",
 					m_assignableMidiDevices->currentText());
 	ConfigManager::inst()->setValue("midi", "autoquantize", QString::number(m_midiAutoQuantize));
+	ConfigManager::inst()->setValue("midi", "timestampinput", QString::number(m_midiTimestampInput));
 
 
 	ConfigManager::inst()->setWorkingDir(QDir::fromNativeSeparators(m_workingDir));
@@ -1239,12 +1308,43 @@ void SetupDialog::toggleDisableAutoQuit(bool enabled)
 	m_disableAutoQuit = enabled;
 }
 
+
+void SetupDialog::toggleRemoteProcessingRing(bool enabled)
+{
+	m_remoteProcessingRing = enabled;
+}
+
+
+void SetupDialog::toggleRemotePipelining(bool enabled)
+{
+	m_remotePipelining = enabled;
+}
+
+
+void SetupDialog::toggleRemotePluginPool(bool enabled)
+{
+	m_remotePluginPool = enabled;
+	Engine::remotePluginPool()->setEnabled(m_remotePluginPool);
+}
+
 void SetupDialog::toggleMixSanitization(bool enabled)
 {
 	m_mixSanitization = enabled;
 	Engine::audioEngine()->setSanitizationEnabled(m_mixSanitization);
 }
 
+void SetupDialog::toggleTaskGraph(bool enabled)
+{
+	m_taskGraph = enabled;
+	Engine::audioEngine()->setTaskGraphEnabled(m_taskGraph);
+}
+
+void SetupDialog::toggleSampleExactAutomation(bool enabled)
+{
+	m_sampleExactAutomation = enabled;
+	Engine::getSong()->setSampleExactAutomation(m_sampleExactAutomation);
+}
+
 void SetupDialog::audioInterfaceChanged(const QString & iface)
 {
 	for(AswMap::iterator it = m_audioIfaceSetupWidgets.begin();
@@ -1332,6 +1432,12 @@ void SetupDialog::toggleMidiAutoQuantization(bool enabled)
 	m_midiAutoQuantize = enabled;
 }
 
+void SetupDialog::toggleMidiTimestampInput(bool enabled)
+{
+	m_midiTimestampInput = enabled;
+	Engine::audioEngine()->setMidiInputTimestamping(m_midiTimestampInput);
+}
+
 
 // Paths settings slots.
 
@@ -108,7 +108,11 @@ void AutomatableSlider::wheelEvent( QWheelEvent * _me )
 {
 	bool old_status = m_showStatus;
 	m_showStatus = true;
+	// consecutive wheel steps are undone at once
+	model()->addJournalCheckPoint( true );
+	model()->saveJournallingState( false );
 	QSlider::wheelEvent( _me );
+	model()->restoreJournallingState();
 	m_showStatus = old_status;
 }
 
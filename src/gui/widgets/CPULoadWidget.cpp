@@ -28,6 +28,7 @@
 #include <QPainter>
 
 #include "AudioEngine.h"
+#include "AutomatableModel.h"
 #include "CPULoadWidget.h"
 #include "embed.h"
 #include "Engine.h"
@@ -95,15 +96,31 @@ void CPULoadWidget::updateCpuLoad()
 	// to be useful as overload indicator in AudioEngine::criticalXRuns().
 	const int new_load = (m_currentLoad + Engine::audioEngine()->cpuLoad()) / 2;
 
+	// show the MIDI latency of the last complete window, so that it follows
+	// changes instead of averaging over the whole session
+	if (++m_midiLatencyUpdates == MidiLatencyWindow)
+	{
+		m_midiLatency = Engine::audioEngine()->profiler().midiInputLatency();
+		Engine::audioEngine()->profiler().resetMidiInputLatency();
+		m_midiLatencyUpdates = 0;
+	}
+
 	if (new_load != m_currentLoad)
 	{
 		auto engine = Engine::audioEngine();
+		const auto& midiLatency = m_midiLatency;
+		const auto midiLatencyText = midiLatency.events() == 0 ? QString{} : "\n"
+			+ tr("Live MIDI latency: %1 ms, jitter: %2 ms")
+				.arg(midiLatency.percentile(0.5) / 1000, 0, 'f', 1)
+				.arg((midiLatency.percentile(0.95) - midiLatency.percentile(0.05)) / 1000, 0, 'f', 1);
 		setToolTip(
 			tr("DSP total: %1%").arg(new_load) + "\n"
 			+ tr(" - Notes and setup: %1%").arg(engine->detailLoad(AudioEngineProfiler::DetailType::NoteSetup)) + "\n"
 			+ tr(" - Instruments: %1%").arg(engine->detailLoad(AudioEngineProfiler::DetailType::Instruments)) + "\n"
 			+ tr(" - Effects: %1%").arg(engine->detailLoad(AudioEngineProfiler::DetailType::Effects)) + "\n"
-			+ tr(" - Mixing: %1%").arg(engine->detailLoad(AudioEngineProfiler::DetailType::Mixing))
+			+ tr(" - Mixing: %1%").arg(engine->detailLoad(AudioEngineProfiler::DetailType::Mixing)) + "\n"
+			+ tr("Parameters recomputed per period: %1").arg(AutomatableModel::recomputedValueBuffers())
+			+ midiLatencyText
 		);
 		m_currentLoad = new_load;
 		m_changed = true;
@@ -273,7 +273,11 @@ void Fader::wheelEvent (QWheelEvent* ev)
 
 	const float increment = determineAdjustmentDelta(ev->modifiers()) * direction;
 
+	// consecutive wheel steps are undone at once
+	model()->addJournalCheckPoint(true);
+	model()->saveJournallingState(false);
 	adjustByDecibelDelta(increment);
+	model()->restoreJournallingState();
 
 	ev->accept();
 }
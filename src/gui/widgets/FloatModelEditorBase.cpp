@@ -380,7 +380,11 @@ void FloatModelEditorBase::wheelEvent(QWheelEvent * we)
 	const float scaledValueOffset = model()->scaledValue(model()->inverseScaledValue(currentValue) + valueOffset) - currentValue;
 	const float stepMult = std::max(scaledValueOffset / step, 1.f);
 	const int inc = direction * stepMult;
+	// consecutive wheel steps are undone at once
+	model()->addJournalCheckPoint(true);
+	model()->saveJournallingState(false);
 	model()->incValue(inc);
+	model()->restoreJournallingState();
 
 	// Only force a text update for the 1st wheel event
 	showTextFloat(0, 1000, m_interaction != oldInteraction);
@@ -196,7 +196,11 @@ void LcdFloatSpinBox::wheelEvent(QWheelEvent *event)
 	else { m_intStep = false; }
 
 	event->accept();
+	// consecutive wheel steps are undone at once
+	model()->addJournalCheckPoint(true);
+	model()->saveJournallingState(false);
 	model()->setValue(model()->value() + ((event->angleDelta().y() > 0) ? 1 : -1) * getStep());
+	model()->restoreJournallingState();
 	emit manualChange();
 }
 
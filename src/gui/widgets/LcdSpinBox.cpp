@@ -148,7 +148,11 @@ void LcdSpinBox::wheelEvent(QWheelEvent * we)
 	we->accept();
 	const int direction = (we->angleDelta().y() > 0 ? 1 : -1) * (we->inverted() ? -1 : 1);
 
+	// consecutive wheel steps are undone at once
+	model()->addJournalCheckPoint(true);
+	model()->saveJournallingState(false);
 	model()->setValue(model()->value() + direction * model()->step<int>());
+	model()->restoreJournallingState();
 	emit manualChange();
 }
 
@@ -23,6 +23,8 @@
  */
 #include "InstrumentTrack.h"
 
+#include <algorithm>
+
 #include "AudioEngine.h"
 #include "AutomationClip.h"
 #include "ConfigManager.h"
@@ -81,11 +83,14 @@ InstrumentTrack::InstrumentTrack(TrackContainer* tc) :
 
 	m_mixerChannelModel.setRange( 0, Engine::mixer()->numChannels()-1, 1);
 
+	m_audioBusHandle.setVoiceProcessor(&m_soundShaping);
+
 	for( int i = 0; i < NumKeys; ++i )
 	{
 		m_notes[i] = nullptr;
 		m_runningMidiNotes[i] = 0;
 	}
+	m_sustainedNotes.reserve(NumKeys);
 
 
 	// Initialize the m_midiCCEnabled variable, but it's actually going to be connected
@@ -262,17 +267,11 @@ void InstrumentTrack::processAudioBuffer( SampleFrame* buf, const f_cnt_t frames
 	if (!m_instrument->isSingleStreamed() && n != nullptr)
 	{
 		const f_cnt_t offset = n->noteOffset();
-		m_soundShaping.processAudioBuffer( buf + offset, frames - offset, n );
 		const float vol = ( (float) n->getVolume() * DefaultVolumeRatio );
 		const panning_t pan = std::clamp(n->getPanning(), PanningLeft, PanningRight);
 		StereoVolumeVector vv = panningToVolumeVector( pan, vol );
-		for( f_cnt_t f = offset; f < frames; ++f )
-		{
-			for( int c = 0; c < 2; ++c )
-			{
-				buf[f][c] *= vv.vol[c];
-			}
-		}
+		// the sound shaping applies vv last, possibly later in this period
+		m_soundShaping.processAudioBuffer( buf + offset, frames - offset, n, vv );
 	}
 }
 
@@ -298,6 +297,18 @@ MidiEvent InstrumentTrack::applyMasterKey( const MidiEvent& event )
 
 
 
+void InstrumentTrack::releaseSustainedNote(NotePlayHandle* nph)
+{
+	if (nph && nph->isReleased() && nph->origin() == NotePlayHandle::Origin::MidiInput)
+	{
+		nph->setLength(TimePos(static_cast<f_cnt_t>(nph->totalFramesPlayed() / Engine::framesPerTick())));
+		midiNoteOff(*nph);
+	}
+}
+
+
+
+
 void InstrumentTrack::processCCEvent(int controller)
 {
 	// Does nothing if the LED is disabled
@@ -365,7 +376,19 @@ void InstrumentTrack::processInEvent( const MidiEvent& event, const TimePos& tim
 					m_notes[event.key()]->origin() ==
 					NotePlayHandle::Origin::MidiInput)
 				{
-					m_sustainedNotes << m_notes[event.key()];
+					// A key struck again while the pedal is down ends the
+					// recorded length of its earlier note
+					const auto sustained = std::find_if(m_sustainedNotes.begin(), m_sustainedNotes.end(),
+						[&](const NotePlayHandle* nph) { return nph->key() == event.key(); });
+					if (sustained != m_sustainedNotes.end())
+					{
+						releaseSustainedNote(*sustained);
+						*sustained = m_notes[event.key()];
+					}
+					else
+					{
+						m_sustainedNotes.push_back(m_notes[event.key()]);
+					}
 				}
 				m_notes[event.key()] = nullptr;
 				Engine::audioEngine()->doneChangeInModel();
@@ -400,18 +423,7 @@ void InstrumentTrack::processInEvent( const MidiEvent& event, const TimePos& tim
 				{
 					for (NotePlayHandle* nph : m_sustainedNotes)
 					{
-						if (nph && nph->isReleased())
-						{
-							if( nph->origin() ==
-								NotePlayHandle::Origin::MidiInput)
-							{
-								nph->setLength(
-									TimePos( static_cast<f_cnt_t>(
-									nph->totalFramesPlayed() /
-									Engine::framesPerTick() ) ) );
-								midiNoteOff( *nph );
-							}
-						}
+						releaseSustainedNote(nph);
 					}
 					m_sustainedNotes.clear();
 					m_sustainPedalPressed = false;
@@ -717,7 +729,7 @@ bool InstrumentTrack::play( const TimePos & _start, const f_cnt_t _frames,
 	else
 	{
 		getClipsInRange( clips, _start, _start + static_cast<int>(
-					_frames / frames_per_tick ) );
+					_frames / frames_per_tick ), &m_playCursor );
 	}
 
 	// Handle automation: detuning
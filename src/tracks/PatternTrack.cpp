@@ -100,7 +100,7 @@ bool PatternTrack::play( const TimePos & _start, const f_cnt_t _frames,
 	}
 
 	clipVector clips;
-	getClipsInRange( clips, _start, _start + static_cast<int>( _frames / Engine::framesPerTick() ) );
+	getClipsInRange( clips, _start, _start + static_cast<int>( _frames / Engine::framesPerTick() ), &m_playCursor );
 
 	if( clips.size() == 0 )
 	{
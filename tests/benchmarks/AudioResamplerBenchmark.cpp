@@ -0,0 +1,90 @@
+/*
+ * AudioResamplerBenchmark.cpp - benchmarks of the AudioResampler modes
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "Benchmark.h"
+
+#include <array>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "AudioEngine.h"
+#include "AudioResampler.h"
+
+namespace lmms::bench
+{
+
+namespace
+{
+
+constexpr f_cnt_t Frames = DEFAULT_BUFFER_SIZE;
+
+struct ResamplerState
+{
+	ResamplerState(AudioResampler::Mode mode, double ratio) :
+		resampler(mode),
+		input(Frames * 2),
+		output(static_cast<std::size_t>(std::ceil(Frames * ratio) + 1) * 2)
+	{
+		resampler.setRatio(ratio);
+		for (auto i = std::size_t{0}; i < input.size(); ++i)
+		{
+			input[i] = std::sin(0.01f * static_cast<float>(i));
+		}
+	}
+
+	AudioResampler resampler;
+	std::vector<float> input;
+	std::vector<float> output;
+};
+
+} // namespace
+
+LMMS_BENCHMARK_GROUP(audioResamplerBenchmarks)
+{
+	using Mode = AudioResampler::Mode;
+	const auto modes = std::array{
+		std::pair{Mode::ZOH, "ZOH"},
+		std::pair{Mode::Linear, "Linear"},
+		std::pair{Mode::SincFastest, "SincFastest"},
+		std::pair{Mode::SincMedium, "SincMedium"},
+		std::pair{Mode::SincBest, "SincBest"}
+	};
+
+	// 44.1 kHz samples played back at 48 kHz, the most common case
+	constexpr auto ratio = 48000.0 / 44100.0;
+
+	for (const auto& [mode, name] : modes)
+	{
+		auto state = std::make_shared<ResamplerState>(mode, ratio);
+		add(std::string{"AudioResampler/"} + name, Frames, [state] {
+			const auto result = state->resampler.process(
+				{state->input.data(), 2, Frames},
+				{state->output.data(), 2, static_cast<f_cnt_t>(state->output.size() / 2)});
+			doNotOptimize(result.outputFramesGenerated);
+		});
+	}
+}
+
+} // namespace lmms::bench
@@ -0,0 +1,130 @@
+/*
+ * BasicFiltersBenchmark.cpp - benchmarks of the BasicFilters types
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "Benchmark.h"
+
+#include <array>
+#include <deque>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "AudioEngine.h"
+#include "BasicFilters.h"
+#include "SampleFrame.h"
+
+namespace lmms::bench
+{
+
+namespace
+{
+
+constexpr f_cnt_t Frames = DEFAULT_BUFFER_SIZE;
+constexpr int BankVoices = 16;
+
+// in the order of BasicFilters<>::FilterType
+constexpr auto FilterTypeNames = std::array{
+	"LowPass", "HiPass", "BandPass_CSG", "BandPass_CZPG", "Notch", "AllPass", "Moog", "DoubleLowPass",
+	"Lowpass_RC12", "Bandpass_RC12", "Highpass_RC12", "Lowpass_RC24", "Bandpass_RC24", "Highpass_RC24",
+	"Formantfilter", "DoubleMoog", "Lowpass_SV", "Bandpass_SV", "Highpass_SV", "Notch_SV", "FastFormant",
+	"Tripole"
+};
+static_assert(FilterTypeNames.size() == static_cast<std::size_t>(BasicFilters<>::FilterType::Tripole) + 1);
+
+struct FilterState
+{
+	explicit FilterState(BasicFilters<>::FilterType type) :
+		filter(44100),
+		input(Frames),
+		output(Frames)
+	{
+		filter.setFilterType(type);
+		filter.calcFilterCoeffs(1000.f, 0.5f);
+
+		auto rng = std::mt19937{42};
+		auto dist = std::uniform_real_distribution<float>{-1.f, 1.f};
+		for (auto& frame : input) { frame = SampleFrame{dist(rng), dist(rng)}; }
+	}
+
+	BasicFilters<> filter;
+	std::vector<SampleFrame> input;
+	std::vector<SampleFrame> output;
+};
+
+//! The notes of one track, filtered together like InstrumentSoundShaping does
+struct FilterBankState
+{
+	explicit FilterBankState(BasicFilters<>::FilterType type) :
+		cutoff(Frames, 1000.f),
+		resonance(Frames, 0.5f)
+	{
+		auto rng = std::mt19937{42};
+		auto dist = std::uniform_real_distribution<float>{-1.f, 1.f};
+		for (int v = 0; v < BankVoices; ++v)
+		{
+			filters.emplace_back(44100).setFilterType(type);
+			auto& buffer = buffers.emplace_back(Frames);
+			for (auto& frame : buffer) { frame = SampleFrame{dist(rng), dist(rng)}; }
+			voices.push_back({&filters.back(), buffer.data()->data(), Frames, cutoff.data(), resonance.data()});
+		}
+	}
+
+	std::deque<BasicFilters<>> filters;
+	std::vector<std::vector<SampleFrame>> buffers;
+	std::vector<float> cutoff;
+	std::vector<float> resonance;
+	std::vector<BasicFilterBank<>::Voice> voices;
+	BasicFilterBank<> bank;
+};
+
+} // namespace
+
+LMMS_BENCHMARK_GROUP(basicFiltersBenchmarks)
+{
+	for (auto type = std::size_t{0}; type < FilterTypeNames.size(); ++type)
+	{
+		auto state = std::make_shared<FilterState>(static_cast<BasicFilters<>::FilterType>(type));
+		add(std::string{"BasicFilters/"} + FilterTypeNames[type], Frames, [state] {
+			for (auto f = f_cnt_t{0}; f < Frames; ++f)
+			{
+				state->output[f][0] = state->filter.update(state->input[f][0], 0);
+				state->output[f][1] = state->filter.update(state->input[f][1], 1);
+			}
+			doNotOptimize(state->output.back());
+		});
+		add(std::string{"BasicFilters/"} + FilterTypeNames[type] + "/block", Frames, [state] {
+			state->output = state->input;
+			state->filter.process(state->output.data(), Frames);
+			doNotOptimize(state->output.back());
+		});
+
+		// the buffers are filtered over and over, which doesn't change the work per frame
+		auto bankState = std::make_shared<FilterBankState>(static_cast<BasicFilters<>::FilterType>(type));
+		add(std::string{"BasicFilterBank/"} + FilterTypeNames[type], Frames * BankVoices, [bankState] {
+			bankState->bank.process(bankState->voices);
+			doNotOptimize(bankState->buffers.back().back());
+		});
+	}
+}
+
+} // namespace lmms::bench
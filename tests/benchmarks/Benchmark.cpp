@@ -0,0 +1,242 @@
+/*
+ * Benchmark.cpp - runner for the lmms-bench microbenchmarks
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "Benchmark.h"
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "ConfigManager.h"
+#include "Engine.h"
+#include "Hardware.h"
+#include "lmmsversion.h"
+
+namespace lmms::bench
+{
+
+namespace
+{
+
+struct Benchmark
+{
+	std::string name;
+	std::size_t itemsPerIteration;
+	std::size_t bytesPerIteration;
+	std::function<void()> body;
+};
+
+std::vector<Benchmark>& benchmarks()
+{
+	static auto s_benchmarks = std::vector<Benchmark>{};
+	return s_benchmarks;
+}
+
+std::vector<void (*)()>& groups()
+{
+	static auto s_groups = std::vector<void (*)()>{};
+	return s_groups;
+}
+
+constexpr int Repetitions = 5;
+
+double runIterations(const Benchmark& benchmark, std::size_t iterations)
+{
+	const auto start = std::chrono::steady_clock::now();
+	for (auto i = std::size_t{0}; i < iterations; ++i) { benchmark.body(); }
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+//! Runs the benchmark for about @p minTime seconds per repetition and
+//! returns its results
+QJsonObject measure(const Benchmark& benchmark, double minTime)
+{
+	// warm up caches and lazy initialization, then find an iteration
+	// count that takes at least minTime
+	auto iterations = std::size_t{1};
+	while (runIterations(benchmark, iterations) < minTime && iterations < (std::size_t{1} << 40))
+	{
+		iterations *= 2;
+	}
+
+	auto nsPerIteration = std::vector<double>{};
+	for (int r = 0; r < Repetitions; ++r)
+	{
+		nsPerIteration.push_back(runIterations(benchmark, iterations) * 1e9 / iterations);
+	}
+	std::sort(nsPerIteration.begin(), nsPerIteration.end());
+	const auto median = nsPerIteration[Repetitions / 2];
+
+	auto result = QJsonObject{
+		{"name", QString::fromStdString(benchmark.name)},
+		{"iterations", static_cast<qint64>(iterations)},
+		{"repetitions", Repetitions},
+		{"ns_per_iteration", median},
+		{"ns_per_iteration_min", nsPerIteration.front()},
+		{"ns_per_iteration_max", nsPerIteration.back()},
+		{"items_per_iteration", static_cast<qint64>(benchmark.itemsPerIteration)},
+		{"items_per_second", benchmark.itemsPerIteration * 1e9 / median}
+	};
+	if (benchmark.bytesPerIteration > 0)
+	{
+		result["bytes_per_iteration"] = static_cast<qint64>(benchmark.bytesPerIteration);
+		result["gigabytes_per_second"] = benchmark.bytesPerIteration / median;
+	}
+	return result;
+}
+
+void printUsage()
+{
+	std::fprintf(stderr,
+		"Usage: lmms-bench [options]\n"
+		"  --filter <text>     Only run benchmarks whose name contains <text>\n"
+		"  --min-time <secs>   Minimum duration of each repetition (default: 0.1)\n"
+		"  --output <file>     Write the JSON results to <file> instead of stdout\n"
+		"  --list              List all benchmarks and exit\n");
+}
+
+} // namespace
+
+
+
+
+void add(std::string name, std::size_t itemsPerIteration, std::function<void()> body)
+{
+	add(std::move(name), itemsPerIteration, 0, std::move(body));
+}
+
+
+
+
+void add(std::string name, std::size_t itemsPerIteration, std::size_t bytesPerIteration,
+	std::function<void()> body)
+{
+	benchmarks().push_back({std::move(name), itemsPerIteration, bytesPerIteration, std::move(body)});
+}
+
+
+
+
+bool addGroup(void (*group)())
+{
+	groups().push_back(group);
+	return true;
+}
+
+} // namespace lmms::bench
+
+
+
+
+int main(int argc, char* argv[])
+{
+	using namespace lmms;
+
+	QCoreApplication app(argc, argv);
+
+	auto filter = std::string{};
+	auto outputFile = QString{};
+	auto minTime = 0.1;
+	auto listOnly = false;
+	for (int i = 1; i < argc; ++i)
+	{
+		const auto arg = std::string{argv[i]};
+		if (arg == "--filter" && i + 1 < argc) { filter = argv[++i]; }
+		else if (arg == "--min-time" && i + 1 < argc) { minTime = std::atof(argv[++i]); }
+		else if (arg == "--output" && i + 1 < argc) { outputFile = QString::fromLocal8Bit(argv[++i]); }
+		else if (arg == "--list") { listOnly = true; }
+		else if (arg == "--help")
+		{
+			bench::printUsage();
+			return EXIT_SUCCESS;
+		}
+		else
+		{
+			bench::printUsage();
+			return EXIT_FAILURE;
+		}
+	}
+
+	// same floating point environment as the audio threads
+	disableDenormals();
+
+	// room for the voices started by the note-on benchmarks
+	ConfigManager::inst()->setValue("audioengine", "polyphony", "1024");
+	Engine::init(true);
+	for (const auto group : bench::groups()) { group(); }
+
+	auto results = QJsonArray{};
+	for (const auto& benchmark : bench::benchmarks())
+	{
+		if (benchmark.name.find(filter) == std::string::npos) { continue; }
+		if (listOnly)
+		{
+			std::printf("%s\n", benchmark.name.c_str());
+			continue;
+		}
+
+		std::fprintf(stderr, "%-60s", benchmark.name.c_str());
+		const auto result = bench::measure(benchmark, minTime);
+		std::fprintf(stderr, "%14.1f ns", result["ns_per_iteration"].toDouble());
+		if (result.contains("gigabytes_per_second"))
+		{
+			std::fprintf(stderr, "%10.2f GB/s", result["gigabytes_per_second"].toDouble());
+		}
+		std::fprintf(stderr, "\n");
+		results.append(result);
+	}
+
+	// release the benchmark state before the engine goes away
+	bench::benchmarks().clear();
+	Engine::destroy();
+
+	if (listOnly) { return EXIT_SUCCESS; }
+
+	const auto json = QJsonDocument{QJsonObject{
+		{"lmms_version", LMMS_VERSION},
+		{"min_time", minTime},
+		{"benchmarks", results}
+	}}.toJson();
+
+	if (outputFile.isEmpty())
+	{
+		std::fwrite(json.constData(), 1, json.size(), stdout);
+		return EXIT_SUCCESS;
+	}
+
+	QFile out(outputFile);
+	if (!out.open(QFile::WriteOnly | QFile::Truncate))
+	{
+		std::fprintf(stderr, "Could not open %s\n", qPrintable(outputFile));
+		return EXIT_FAILURE;
+	}
+	out.write(json);
+	return EXIT_SUCCESS;
+}
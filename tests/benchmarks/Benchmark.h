@@ -0,0 +1,69 @@
+/*
+ * Benchmark.h - minimal harness for the lmms-bench microbenchmarks
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_BENCHMARK_H
+#define LMMS_BENCHMARK_H
+
+#include <cstddef>
+#include <functional>
+#include <string>
+
+namespace lmms::bench
+{
+
+/**
+ * Registers a benchmark. @p body runs one iteration which processes
+ * @p itemsPerIteration items (frames, jobs, ...). Any state the body needs
+ * must be captured by it and is kept alive until all benchmarks ran.
+ */
+void add(std::string name, std::size_t itemsPerIteration, std::function<void()> body);
+
+//! Like add(), for benchmarks limited by memory bandwidth. @p bytesPerIteration
+//! is the number of bytes read and written by one iteration.
+void add(std::string name, std::size_t itemsPerIteration, std::size_t bytesPerIteration,
+	std::function<void()> body);
+
+//! Registers a function adding benchmarks. It is called after the engine
+//! has been initialized, so benchmarks may use Engine.
+bool addGroup(void (*group)());
+
+//! Keeps the compiler from optimizing away a computed value
+template<typename T>
+inline void doNotOptimize(const T& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	asm volatile("" : : "r,m"(value) : "memory");
+#else
+	static volatile const void* sink;
+	sink = &value;
+#endif
+}
+
+} // namespace lmms::bench
+
+//! Defines a benchmark group function and registers it
+#define LMMS_BENCHMARK_GROUP(name) \
+	static void name(); \
+	[[maybe_unused]] static const bool name##Registered = ::lmms::bench::addGroup(&name); \
+	static void name()
+
+#endif // LMMS_BENCHMARK_H
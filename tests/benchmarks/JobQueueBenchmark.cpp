@@ -0,0 +1,124 @@
+/*
+ * JobQueueBenchmark.cpp - throughput of the audio engine worker job queue
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "AudioEngineWorkerThread.h"
+#include "ThreadableJob.h"
+
+namespace lmms::bench
+{
+
+namespace
+{
+
+using JobQueue = AudioEngineWorkerThread::JobQueue;
+
+constexpr std::size_t JobsPerRound = 512;
+
+//! A job doing a fixed amount of arithmetic, roughly a cheap voice
+class DummyJob : public ThreadableJob
+{
+public:
+	bool requiresProcessing() const override { return true; }
+	float result = 0.f;
+
+protected:
+	void doProcessing() override
+	{
+		float acc = 0.f;
+		for (int i = 0; i < 256; ++i) { acc = acc * 0.999f + static_cast<float>(i); }
+		result = acc;
+	}
+};
+
+//! A job queue with numThreads - 1 helper threads, the benchmarking thread
+//! is the inline worker like in AudioEngine
+class JobQueueState
+{
+public:
+	explicit JobQueueState(std::size_t numThreads) :
+		m_queue(numThreads),
+		m_jobs(JobsPerRound)
+	{
+		for (auto w = std::size_t{0}; w + 1 < numThreads; ++w)
+		{
+			m_helpers.emplace_back([this, w] {
+				int seen = -1;
+				while (!m_quit)
+				{
+					if (m_round.load() != seen)
+					{
+						seen = m_round.load();
+						m_queue.run(w);
+					}
+					else { std::this_thread::yield(); }
+				}
+			});
+		}
+	}
+
+	~JobQueueState()
+	{
+		m_quit = true;
+		for (auto& helper : m_helpers) { helper.join(); }
+	}
+
+	void runRound()
+	{
+		m_queue.reset(JobQueue::OperationMode::Static);
+		for (auto& job : m_jobs) { m_queue.addJob(&job); }
+		m_queue.start();
+		++m_round;
+		m_queue.run();
+		m_queue.wait();
+	}
+
+private:
+	JobQueue m_queue;
+	std::vector<DummyJob> m_jobs;
+	std::vector<std::thread> m_helpers;
+	std::atomic<int> m_round{-1};
+	std::atomic<bool> m_quit{false};
+};
+
+} // namespace
+
+LMMS_BENCHMARK_GROUP(jobQueueBenchmarks)
+{
+	const auto maxThreads = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+	for (auto threads = std::size_t{1};; threads = std::min(threads * 2, maxThreads))
+	{
+		auto state = std::make_shared<JobQueueState>(threads);
+		add("JobQueue/" + std::to_string(threads) + "threads", JobsPerRound, [state] { state->runRound(); });
+		if (threads == maxThreads) { break; }
+	}
+}
+
+} // namespace lmms::bench
@@ -0,0 +1,140 @@
+/*
+ * MixHelpersBenchmark.cpp - benchmarks of the MixHelpers functions
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "Benchmark.h"
+
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "AudioBuffer.h"
+#include "AudioEngine.h"
+#include "MixHelpers.h"
+#include "SampleFrame.h"
+#include "ValueBuffer.h"
+
+namespace lmms::bench
+{
+
+namespace
+{
+
+constexpr f_cnt_t Frames = DEFAULT_BUFFER_SIZE;
+
+struct Buffers
+{
+	Buffers() :
+		dst(Frames),
+		src(Frames),
+		left(Frames),
+		right(Frames),
+		coeffs1(Frames),
+		coeffs2(Frames),
+		planarDst(Frames),
+		planarSrc(Frames)
+	{
+		auto rng = std::mt19937{42};
+		auto dist = std::uniform_real_distribution<float>{-1.f, 1.f};
+		for (f_cnt_t f = 0; f < Frames; ++f)
+		{
+			dst[f] = SampleFrame(dist(rng), dist(rng));
+			src[f] = SampleFrame(dist(rng), dist(rng));
+			left[f] = dist(rng);
+			right[f] = dist(rng);
+			coeffs1.values()[f] = 0.5f + 0.5f * dist(rng);
+			coeffs2.values()[f] = 0.5f + 0.5f * dist(rng);
+			planarDst.buffer(0)[f] = dist(rng);
+			planarDst.buffer(1)[f] = dist(rng);
+			planarSrc.buffer(0)[f] = dist(rng);
+			planarSrc.buffer(1)[f] = dist(rng);
+		}
+	}
+
+	std::vector<SampleFrame> dst;
+	std::vector<SampleFrame> src;
+	std::vector<sample_t> left;
+	std::vector<sample_t> right;
+	ValueBuffer coeffs1;
+	ValueBuffer coeffs2;
+	AudioBuffer planarDst;
+	AudioBuffer planarSrc;
+};
+
+} // namespace
+
+LMMS_BENCHMARK_GROUP(mixHelpersBenchmarks)
+{
+	using namespace MixHelpers;
+	const auto b = std::make_shared<Buffers>();
+
+	add("MixHelpers/isSilent", Frames, [b] {
+		doNotOptimize(isSilent(b->src.data(), Frames));
+	});
+	add("MixHelpers/add", Frames, [b] {
+		MixHelpers::add(b->dst.data(), b->src.data(), Frames);
+	});
+	add("MixHelpers/multiply", Frames, [b] {
+		multiply(b->dst.data(), 1.f, Frames);
+	});
+	add("MixHelpers/addMultiplied", Frames, [b] {
+		addMultiplied(b->dst.data(), b->src.data(), 0.5f, Frames);
+	});
+	add("MixHelpers/addSwappedMultiplied", Frames, [b] {
+		addSwappedMultiplied(b->dst.data(), b->src.data(), 0.5f, Frames);
+	});
+	add("MixHelpers/addMultipliedByBuffer", Frames, [b] {
+		addMultipliedByBuffer(b->dst.data(), b->src.data(), 0.5f, &b->coeffs1, Frames);
+	});
+	add("MixHelpers/addMultipliedByBuffers", Frames, [b] {
+		addMultipliedByBuffers(b->dst.data(), b->src.data(), &b->coeffs1, &b->coeffs2, Frames);
+	});
+	add("MixHelpers/addMultipliedStereo", Frames, [b] {
+		addMultipliedStereo(b->dst.data(), b->src.data(), 0.5f, 0.25f, Frames);
+	});
+	add("MixHelpers/multiplyAndAddMultiplied", Frames, [b] {
+		multiplyAndAddMultiplied(b->dst.data(), b->src.data(), 0.5f, 0.5f, Frames);
+	});
+	add("MixHelpers/multiplyAndAddMultipliedJoined", Frames, [b] {
+		multiplyAndAddMultipliedJoined(b->dst.data(), b->left.data(), b->right.data(), 0.5f, 0.5f, Frames);
+	});
+
+	add("MixHelpers/planar/add", Frames, [b] {
+		MixHelpers::add(b->planarDst.groupBuffers(0), b->planarSrc.groupBuffers(0));
+	});
+	add("MixHelpers/planar/addInterleaved", Frames, [b] {
+		MixHelpers::add(b->planarDst.groupBuffers(0), b->src.data());
+	});
+	add("MixHelpers/planar/addMultiplied", Frames, [b] {
+		addMultiplied(b->planarDst.groupBuffers(0), b->planarSrc.groupBuffers(0), 0.5f);
+	});
+	add("MixHelpers/planar/addMultipliedToInterleaved", Frames, [b] {
+		addMultiplied(b->dst.data(), b->planarSrc.groupBuffers(0), 0.5f);
+	});
+	add("MixHelpers/planar/addMultipliedByBuffer", Frames, [b] {
+		addMultipliedByBuffer(b->planarDst.groupBuffers(0), b->planarSrc.groupBuffers(0), 0.5f, &b->coeffs1);
+	});
+	add("MixHelpers/planar/addMultipliedByBuffers", Frames, [b] {
+		addMultipliedByBuffers(b->planarDst.groupBuffers(0), b->planarSrc.groupBuffers(0), &b->coeffs1, &b->coeffs2);
+	});
+}
+
+} // namespace lmms::bench
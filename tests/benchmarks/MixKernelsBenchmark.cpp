@@ -0,0 +1,113 @@
+/*
+ * MixKernelsBenchmark.cpp - throughput of the mixing kernels for each instruction set
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+
+#include "Benchmark.h"
+
+#include <array>
+#include <memory>
+#include <random>
+#include <string>
+
+#include "AudioBuffer.h"
+#include "AudioEngine.h"
+#include "MixKernels.h"
+
+namespace lmms::bench
+{
+
+namespace
+{
+
+constexpr f_cnt_t Frames = DEFAULT_BUFFER_SIZE;
+constexpr std::size_t Sources = 8;
+constexpr std::size_t BlockBytes = Frames * sizeof(float);
+
+//! One destination channel, the source channels and two coefficient
+//! channels, all aligned like the buffers of a mixer channel
+struct KernelState
+{
+	KernelState() :
+		buffer(Frames, 1 + Sources + 2)
+	{
+		auto rng = std::mt19937{42};
+		auto dist = std::uniform_real_distribution<float>{-1.f, 1.f};
+		for (ch_cnt_t channel = 0; channel < buffer.totalChannels(); ++channel)
+		{
+			for (f_cnt_t f = 0; f < Frames; ++f) { buffer.buffer(channel)[f] = dist(rng); }
+		}
+		for (std::size_t s = 0; s < Sources; ++s) { srcs[s] = buffer.buffer(1 + s).data(); }
+		for (auto& coeff : coeffs) { coeff = dist(rng); }
+	}
+
+	float* dst() { return buffer.buffer(0).data(); }
+	const float* src() const { return srcs[0]; }
+	const float* coeffs1() const { return buffer.buffer(1 + Sources).data(); }
+	const float* coeffs2() const { return buffer.buffer(2 + Sources).data(); }
+
+	AudioBuffer buffer;
+	std::array<const float*, Sources> srcs;
+	std::array<float, Sources> coeffs;
+};
+
+} // namespace
+
+LMMS_BENCHMARK_GROUP(mixKernelBenchmarks)
+{
+	auto state = std::make_shared<KernelState>();
+	for (const auto set : MixKernels::supported())
+	{
+		const auto prefix = std::string{"MixKernels/"} + set->name + "/";
+
+		// the bytes are the ones read and written per call
+		add(prefix + "add", Frames, 3 * BlockBytes, [state, set] {
+			set->add(state->dst(), state->src(), Frames);
+		});
+		add(prefix + "addMultiplied", Frames, 3 * BlockBytes, [state, set] {
+			set->addMultiplied(state->dst(), state->src(), 0.5f, Frames);
+		});
+		add(prefix + "addMultipliedByBuffer", Frames, 4 * BlockBytes, [state, set] {
+			set->addMultipliedByBuffer(state->dst(), state->src(), 0.5f, state->coeffs1(), Frames);
+		});
+		add(prefix + "addMultipliedByBuffers", Frames, 5 * BlockBytes, [state, set] {
+			set->addMultipliedByBuffers(state->dst(), state->src(), state->coeffs1(), state->coeffs2(), Frames);
+		});
+		add(prefix + "multiplyAndAddMultiplied", Frames, 3 * BlockBytes, [state, set] {
+			set->multiplyAndAddMultiplied(state->dst(), state->src(), 0.5f, 0.5f, Frames);
+		});
+		add(prefix + "isSilent", Frames, BlockBytes, [state, set] {
+			doNotOptimize(set->isSilent(state->src(), Frames, 0.000001f));
+		});
+
+		// summing 8 sources in one pass, compared to one pass per source
+		add(prefix + "addMultipliedMany/8", Frames, (Sources + 2) * BlockBytes, [state, set] {
+			set->addMultipliedMany(state->dst(), state->srcs.data(), state->coeffs.data(), Sources, Frames);
+		});
+		add(prefix + "addMultiplied/8", Frames, 3 * Sources * BlockBytes, [state, set] {
+			for (std::size_t s = 0; s < Sources; ++s)
+			{
+				set->addMultiplied(state->dst(), state->srcs[s], state->coeffs[s], Frames);
+			}
+		});
+	}
+}
+
+} // namespace lmms::bench
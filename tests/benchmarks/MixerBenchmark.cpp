@@ -0,0 +1,100 @@
+/*
+ * MixerBenchmark.cpp - benchmark of Mixer::masterMix()
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "Benchmark.h"
+
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "AudioBuffer.h"
+#include "AudioEngine.h"
+#include "Engine.h"
+#include "Mixer.h"
+#include "SampleFrame.h"
+
+namespace lmms::bench
+{
+
+namespace
+{
+
+constexpr int NumChannels = 64;
+constexpr int NumBuses = 7;
+
+//! Master, NumBuses buses sending to master and the remaining channels each
+//! sending to one of the buses, like a project with grouped tracks
+struct MixerState
+{
+	MixerState() :
+		mixer(Engine::mixer()),
+		frames(Engine::audioEngine()->framesPerPeriod()),
+		input(frames),
+		output(frames)
+	{
+		auto rng = std::mt19937{42};
+		auto dist = std::uniform_real_distribution<float>{-0.1f, 0.1f};
+		const auto buffers = input.groupBuffers(0);
+		for (ch_cnt_t ch = 0; ch < buffers.channels(); ++ch)
+		{
+			for (auto& sample : buffers.buffer(ch)) { sample = dist(rng); }
+			input.assumeNonSilent(ch);
+		}
+
+		// new channels send to master
+		for (int i = 1; i < NumChannels; ++i) { mixer->createChannel(); }
+		for (int i = NumBuses + 1; i < NumChannels; ++i)
+		{
+			mixer->deleteChannelSend(i, 0);
+			mixer->createChannelSend(i, 1 + i % NumBuses);
+			leaves.push_back(i);
+		}
+	}
+
+	~MixerState()
+	{
+		mixer->clear();
+	}
+
+	Mixer* mixer;
+	f_cnt_t frames;
+	AudioBuffer input;
+	std::vector<SampleFrame> output;
+	std::vector<mix_ch_t> leaves;
+};
+
+} // namespace
+
+LMMS_BENCHMARK_GROUP(mixerBenchmarks)
+{
+	auto state = std::make_shared<MixerState>();
+	add("Mixer/masterMix/64channels", state->frames, [state] {
+		state->mixer->prepareMasterMix();
+		for (const auto channel : state->leaves)
+		{
+			state->mixer->mixToChannel(state->input, channel);
+		}
+		state->mixer->masterMix(state->output.data());
+	});
+}
+
+} // namespace lmms::bench
@@ -0,0 +1,99 @@
+/*
+ * NoteOnBenchmark.cpp - cost of starting notes on the built-in synths
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "Benchmark.h"
+
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "AudioEngine.h"
+#include "DummyInstrument.h"
+#include "Engine.h"
+#include "InstrumentTrack.h"
+#include "Note.h"
+#include "NotePlayHandle.h"
+#include "SampleFrame.h"
+#include "Song.h"
+
+namespace lmms::bench
+{
+
+namespace
+{
+
+constexpr std::size_t NumNotes = 1000;
+
+constexpr auto Instruments = std::array{
+	"tripleoscillator", "kicker", "organic", "monstro", "watsyn", "bitinvader"
+};
+
+//! An instrument track with one of the built-in synths. Each round starts
+//! NumNotes notes at once, renders their first period and ends them again.
+struct NoteOnState
+{
+	NoteOnState() :
+		track(Engine::getSong()),
+		handles(NumNotes),
+		buffer(Engine::audioEngine()->framesPerPeriod())
+	{
+	}
+
+	void runRound()
+	{
+		for (auto i = std::size_t{0}; i < NumNotes; ++i)
+		{
+			const auto note = Note{TimePos{0}, TimePos{0}, static_cast<int>(i % NumKeys)};
+			handles[i] = NotePlayHandleManager::acquire(&track, 0, 1000, note);
+			instrument->playNote(handles[i], buffer.data());
+		}
+		for (auto handle : handles)
+		{
+			NotePlayHandleManager::release(handle);
+		}
+	}
+
+	InstrumentTrack track;
+	Instrument* instrument = nullptr;
+	std::vector<NotePlayHandle*> handles;
+	std::vector<SampleFrame> buffer;
+};
+
+} // namespace
+
+LMMS_BENCHMARK_GROUP(noteOnBenchmarks)
+{
+	NotePlayHandleManager::reserve(NumNotes);
+
+	for (const auto name : Instruments)
+	{
+		auto state = std::make_shared<NoteOnState>();
+		state->instrument = state->track.loadInstrument(name);
+		// the plugin couldn't be found, see LMMS_PLUGIN_DIR
+		if (dynamic_cast<DummyInstrument*>(state->instrument)) { continue; }
+
+		add(std::string{"NoteOn/"} + name, NumNotes, [state] { state->runRound(); });
+	}
+}
+
+} // namespace lmms::bench
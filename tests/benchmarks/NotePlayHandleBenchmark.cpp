@@ -0,0 +1,72 @@
+/*
+ * NotePlayHandleBenchmark.cpp - benchmarks of NotePlayHandleManager
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "Benchmark.h"
+
+#include <array>
+#include <memory>
+
+#include "Engine.h"
+#include "InstrumentTrack.h"
+#include "Note.h"
+#include "NotePlayHandle.h"
+#include "Song.h"
+
+namespace lmms::bench
+{
+
+namespace
+{
+
+// a chord on every key of a full keyboard
+constexpr std::size_t NumNotes = 128;
+
+struct NotePlayHandleState
+{
+	NotePlayHandleState() :
+		track(Engine::getSong())
+	{
+	}
+
+	InstrumentTrack track;
+	std::array<NotePlayHandle*, NumNotes> handles = {};
+};
+
+} // namespace
+
+LMMS_BENCHMARK_GROUP(notePlayHandleBenchmarks)
+{
+	auto state = std::make_shared<NotePlayHandleState>();
+	add("NotePlayHandleManager/acquire+release", NumNotes, [state] {
+		for (auto i = std::size_t{0}; i < NumNotes; ++i)
+		{
+			const auto note = Note{TimePos{0}, TimePos{0}, static_cast<int>(i)};
+			state->handles[i] = NotePlayHandleManager::acquire(&state->track, 0, 1000, note);
+		}
+		for (auto handle : state->handles)
+		{
+			NotePlayHandleManager::release(handle);
+		}
+	});
+}
+
+} // namespace lmms::bench
@@ -0,0 +1,168 @@
+/*
+ * OscillatorBenchmark.cpp - benchmarks of Oscillator::update()
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "Benchmark.h"
+
+#include <array>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "AudioEngine.h"
+#include "AutomatableModel.h"
+#include "Oscillator.h"
+#include "OscillatorKernels.h"
+#include "SampleFrame.h"
+
+namespace lmms::bench
+{
+
+namespace
+{
+
+constexpr f_cnt_t Frames = DEFAULT_BUFFER_SIZE;
+
+constexpr auto WaveShapeNames = std::array{
+	"Sine", "Triangle", "Saw", "Square", "MoogSaw", "Exponential", "WhiteNoise", "UserDefined"
+};
+static_assert(WaveShapeNames.size() == Oscillator::NumWaveShapes);
+
+constexpr auto ModulationAlgoNames = std::array{
+	"PhaseModulation", "AmplitudeModulation", "SignalMix", "SynchronizedBySubOsc", "FrequencyModulation"
+};
+static_assert(ModulationAlgoNames.size() == Oscillator::NumModulationAlgos);
+
+//! An oscillator, optionally with a sine sub oscillator, together with the
+//! models and parameters it references
+struct OscillatorState
+{
+	OscillatorState(Oscillator::WaveShape shape, Oscillator::ModulationAlgo algo, bool withSubOsc, bool useWaveTable) :
+		waveShape(static_cast<int>(shape), 0, Oscillator::NumWaveShapes - 1),
+		modAlgo(static_cast<int>(algo), 0, Oscillator::NumModulationAlgos - 1),
+		subWaveShape(static_cast<int>(Oscillator::WaveShape::Sine), 0, Oscillator::NumWaveShapes - 1),
+		subModAlgo(0, 0, Oscillator::NumModulationAlgos - 1),
+		buffer(Frames)
+	{
+		if (withSubOsc)
+		{
+			subOsc = std::make_unique<Oscillator>(&subWaveShape, &subModAlgo, subFreq, detuning, phaseOffset, volume);
+			subOsc->setUseWaveTable(useWaveTable);
+		}
+		osc = std::make_unique<Oscillator>(&waveShape, &modAlgo, freq, detuning, phaseOffset, volume, subOsc.get());
+		osc->setUseWaveTable(useWaveTable);
+	}
+
+	IntModel waveShape;
+	IntModel modAlgo;
+	IntModel subWaveShape;
+	IntModel subModAlgo;
+	float freq = 440.f;
+	float subFreq = 220.f;
+	float detuning = 0.f;
+	float phaseOffset = 0.f;
+	float volume = 1.f;
+	// declared first, the sub oscillator must outlive the oscillator using it
+	std::unique_ptr<Oscillator> subOsc;
+	std::unique_ptr<Oscillator> osc;
+	std::vector<SampleFrame> buffer;
+};
+
+void addOscillatorBenchmark(const std::string& name, std::shared_ptr<OscillatorState> state)
+{
+	add(name, Frames, [state] {
+		state->osc->update(state->buffer.data(), Frames, 0);
+	});
+}
+
+//! Phases spanning a few periods, and a table to look them up in
+struct KernelState
+{
+	KernelState() :
+		phases(Frames),
+		table(OscillatorConstants::WAVETABLE_LENGTH),
+		buffer(Frames)
+	{
+		for (f_cnt_t frame = 0; frame < Frames; ++frame) { phases[frame] = frame * 0.0123f; }
+		for (std::size_t i = 0; i < table.size(); ++i) { table[i] = Oscillator::sinSample(i / static_cast<float>(table.size())); }
+	}
+
+	std::vector<float> phases;
+	std::vector<sample_t> table;
+	std::vector<sample_t> buffer;
+};
+
+} // namespace
+
+LMMS_BENCHMARK_GROUP(oscillatorKernelBenchmarks)
+{
+	using Shape = OscillatorKernels::ShapeKernel OscillatorKernels::KernelSet::*;
+	constexpr auto Shapes = std::array<std::pair<const char*, Shape>, 6>{{
+		{"Sine", &OscillatorKernels::KernelSet::sine},
+		{"Triangle", &OscillatorKernels::KernelSet::triangle},
+		{"Saw", &OscillatorKernels::KernelSet::saw},
+		{"Square", &OscillatorKernels::KernelSet::square},
+		{"MoogSaw", &OscillatorKernels::KernelSet::moogSaw},
+		{"Exponential", &OscillatorKernels::KernelSet::exponential}
+	}};
+
+	auto state = std::make_shared<KernelState>();
+	for (const auto set : OscillatorKernels::supported())
+	{
+		const auto prefix = std::string{"OscillatorKernels/"} + set->name + "/";
+		for (const auto& [name, shape] : Shapes)
+		{
+			add(prefix + name, Frames, [state, kernel = set->*shape] {
+				kernel(state->phases.data(), state->buffer.data(), Frames);
+			});
+		}
+		add(prefix + "Table", Frames, [state, kernel = set->table] {
+			kernel(state->table.data(), state->phases.data(), state->buffer.data(), Frames);
+		});
+	}
+}
+
+LMMS_BENCHMARK_GROUP(oscillatorBenchmarks)
+{
+	using WaveShape = Oscillator::WaveShape;
+	using ModulationAlgo = Oscillator::ModulationAlgo;
+
+	// user defined waves need a sample, they are left out
+	for (auto shape = std::size_t{0}; shape < static_cast<std::size_t>(WaveShape::UserDefined); ++shape)
+	{
+		for (const bool useWaveTable : {false, true})
+		{
+			addOscillatorBenchmark(
+				std::string{"Oscillator/"} + WaveShapeNames[shape] + (useWaveTable ? "/wavetable" : ""),
+				std::make_shared<OscillatorState>(static_cast<WaveShape>(shape),
+					ModulationAlgo::SignalMix, false, useWaveTable));
+		}
+	}
+
+	for (auto algo = std::size_t{0}; algo < Oscillator::NumModulationAlgos; ++algo)
+	{
+		addOscillatorBenchmark(std::string{"Oscillator/Saw+Sine/"} + ModulationAlgoNames[algo],
+			std::make_shared<OscillatorState>(WaveShape::Saw, static_cast<ModulationAlgo>(algo), true, true));
+	}
+}
+
+} // namespace lmms::bench
@@ -25,6 +25,7 @@
 #include "AudioBuffer.h"
 
 #include <QtTest>
+#include <cstdint>
 #include <numeric>
 
 #include "MixHelpers.h"
@@ -119,6 +120,27 @@ private slots:
 		QCOMPARE(ab.totalChannels(), 7);
 	}
 
+	//! Verifies that all channel buffers are aligned and keep their data when a group is added
+	void AddGroup_ChannelsStayAligned()
+	{
+		auto ab = AudioBuffer{10, 3};
+		for (lmms::ch_cnt_t ch = 0; ch < 3; ++ch)
+		{
+			std::iota(ab.buffer(ch).begin(), ab.buffer(ch).end(), ch * 100.f);
+		}
+
+		QVERIFY(ab.addGroup(4) != nullptr);
+		for (lmms::ch_cnt_t ch = 0; ch < ab.totalChannels(); ++ch)
+		{
+			const auto address = reinterpret_cast<std::uintptr_t>(ab.buffer(ch).data());
+			QCOMPARE(address % lmms::AudioBufferAlignment, std::uintptr_t{0});
+			for (lmms::f_cnt_t frame = 0; frame < ab.frames(); ++frame)
+			{
+				QCOMPARE(ab.buffer(ch)[frame], ch < 3 ? ch * 100.f + frame : 0.f);
+			}
+		}
+	}
+
 	//! Verifies that a group with 0 channels cannot be added and doing so has no effect
 	void AddGroup_ZeroChannelsFails()
 	{
@@ -494,6 +516,39 @@ private slots:
 		QCOMPARE(ab.silenceFlags()[2], true); // unused 3rd channel
 	}
 
+	//! Verifies that channels marked silent by `updateSilenceFlags` are zeroed, so that
+	//! residue below the silence threshold is not left behind by `silenceAllChannels`.
+	void UpdateSilenceFlags_ZeroesQuietChannels()
+	{
+		auto ab = AudioBuffer{10, 2};
+		ab.enableSilenceTracking(true);
+
+		// Write a sample that is below the silence threshold but not zero
+		ab.assumeNonSilent(1);
+		ab.group(0).buffer(1)[5] = 1e-8f;
+
+		QCOMPARE(ab.updateSilenceFlags(0b10), true);
+		QCOMPARE(ab.silenceFlags()[1], true);
+		QCOMPARE(ab.group(0).buffer(1)[5], 0.f);
+
+		// Same for `updateAllSilenceFlags`
+		ab.assumeNonSilent(0);
+		ab.group(0).buffer(0)[3] = -1e-8f;
+
+		QCOMPARE(ab.updateAllSilenceFlags(), true);
+		QCOMPARE(ab.group(0).buffer(0)[3], 0.f);
+
+		// Silencing skips the flagged channels, which must already be zero
+		ab.silenceAllChannels();
+		for (lmms::ch_cnt_t ch = 0; ch < 2; ++ch)
+		{
+			for (const auto sample : ab.buffer(ch))
+			{
+				QCOMPARE(sample, 0.f);
+			}
+		}
+	}
+
 	//! Verifies that `updateSilenceFlags` marks selected channels as non-silent when
 	//! silence tracking is disabled.
 	void UpdateSilenceFlags_NonSilentWhenSilenceTrackingDisabled()
@@ -749,6 +804,23 @@ private slots:
 		QCOMPARE(ab.silenceFlags()[2], true);  // updated!
 		QCOMPARE(ab.silenceFlags()[3], true);  // updated!
 	}
+
+	//! Verifies that `silenceAllChannels` only zeroes the channels not known to be silent
+	void SilenceAllChannels_SkipsSilentChannels()
+	{
+		auto ab = AudioBuffer{10, 2};
+		QCOMPARE(ab.silenceTrackingEnabled(), true);
+
+		ab.buffer(0)[5] = 1.f;
+		ab.buffer(1)[5] = 1.f;
+		ab.updateSilenceFlags(0b01);
+
+		// The right channel is still marked silent, so it is left as it is
+		ab.silenceAllChannels();
+		QCOMPARE(ab.silenceFlags().all(), true);
+		QCOMPARE(ab.buffer(0)[5], 0.f);
+		QCOMPARE(ab.buffer(1)[5], 1.f);
+	}
 };
 
 QTEST_GUILESS_MAIN(AudioBufferTest)
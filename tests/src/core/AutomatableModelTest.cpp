@@ -24,9 +24,13 @@
 
 
 #include <QtTest>
+#include <array>
+#include <thread>
+#include <vector>
 #include "AutomatableModel.h"
 #include "ComboBoxModel.h"
 #include "Engine.h"
+#include "ValueBuffer.h"
 
 class AutomatableModelTest : public QObject
 {
@@ -116,6 +120,58 @@ private slots: // tests
 		QVERIFY(!m3.value());
 		QVERIFY(m1.countLinks() == 2);
 	}
+
+	void ValueBufferTests()
+	{
+		using namespace lmms;
+
+		AutomatableModel::incrementPeriodCounter();
+
+		FloatModel model(0.f, 0.f, 1.f);
+		model.setValue(1.f);
+
+		// the ramp from the old value is calculated once and then kept for the period
+		const ValueBuffer* buffer = model.valueBuffer();
+		QVERIFY(buffer != nullptr);
+		QCOMPARE(buffer->values()[0], 0.f);
+		QCOMPARE(model.valueBuffer(), buffer);
+		QCOMPARE(model.valueBuffer(), buffer);
+
+		AutomatableModel::incrementPeriodCounter();
+		QVERIFY(AutomatableModel::recomputedValueBuffers() >= 1);
+
+		// the value didn't change since
+		QVERIFY(model.valueBuffer() == nullptr);
+		QVERIFY(model.valueBuffer() == nullptr);
+	}
+
+	void ValueBufferConcurrentTests()
+	{
+		using namespace lmms;
+
+		FloatModel model(0.f, 0.f, 1.f);
+
+		for (int period = 0; period < 100; ++period)
+		{
+			AutomatableModel::incrementPeriodCounter();
+			model.setValue(period % 2 ? 0.f : 1.f);
+
+			// every thread gets the one published buffer of the period
+			auto buffers = std::array<const ValueBuffer*, 4>{};
+			auto threads = std::vector<std::thread>{};
+			for (auto& buffer : buffers)
+			{
+				threads.emplace_back([&model, &buffer] { buffer = model.valueBuffer(); });
+			}
+			for (auto& thread : threads) { thread.join(); }
+
+			for (const auto buffer : buffers)
+			{
+				QCOMPARE(buffer, model.valueBuffer());
+			}
+			QVERIFY(model.valueBuffer() != nullptr);
+		}
+	}
 };
 
 QTEST_GUILESS_MAIN(AutomatableModelTest)
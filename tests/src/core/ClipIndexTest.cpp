@@ -0,0 +1,186 @@
+/*
+ * ClipIndexTest.cpp - compare Track::getClipsInRange with a scan over all clips
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+
+#include <QObject>
+#include <QtTest>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "AutomationClip.h"
+#include "AutomationTrack.h"
+#include "Engine.h"
+#include "Song.h"
+
+class ClipIndexTest : public QObject
+{
+	Q_OBJECT
+private:
+	using clipVector = lmms::Track::clipVector;
+
+	static clipVector scan(const lmms::Track& track, int start, int end)
+	{
+		auto result = clipVector{};
+		for (const auto clip : track.getClips())
+		{
+			if (clip->startPosition() <= end && clip->endPosition() >= start)
+			{
+				result.insert(std::upper_bound(result.begin(), result.end(), clip,
+					lmms::Clip::comparePosition), clip);
+			}
+		}
+		return result;
+	}
+
+	static clipVector query(lmms::Track& track, int start, int end, lmms::ClipIndex::Cursor* cursor = nullptr)
+	{
+		auto result = clipVector{};
+		track.getClipsInRange(result, start, end, cursor);
+		return result;
+	}
+
+private slots:
+	void initTestCase()
+	{
+		lmms::Engine::init(true);
+	}
+
+	void cleanupTestCase()
+	{
+		lmms::Engine::destroy();
+	}
+
+	void Playback_MatchesScan()
+	{
+		using namespace lmms;
+
+		AutomationTrack track(Engine::getSong());
+		auto rng = std::mt19937{42};
+		for (int i = 0; i < 200; ++i)
+		{
+			auto clip = new AutomationClip(&track);
+			clip->movePosition(static_cast<int>(rng() % 20000));
+			clip->changeLength(static_cast<int>(rng() % 400));
+		}
+
+		// consecutive periods, with the occasional lost tick
+		auto cursor = ClipIndex::Cursor{};
+		for (int start = 0; start < 21000; )
+		{
+			const int end = start + 5;
+			QCOMPARE(query(track, start, end, &cursor), scan(track, start, end));
+			start = end + static_cast<int>(rng() % 2);
+		}
+	}
+
+	void InterleavedCursors_MatchScan()
+	{
+		using namespace lmms;
+
+		AutomationTrack track(Engine::getSong());
+		auto rng = std::mt19937{13};
+		for (int i = 0; i < 200; ++i)
+		{
+			auto clip = new AutomationClip(&track);
+			clip->movePosition(static_cast<int>(rng() % 20000));
+			clip->changeLength(static_cast<int>(rng() % 400));
+		}
+
+		// playback and a second caller walking through the song at another
+		// pace, mixed with one-off queries from the start of the song
+		auto playCursor = ClipIndex::Cursor{};
+		auto otherCursor = ClipIndex::Cursor{};
+		for (int start = 0, otherStart = 0; start < 21000; )
+		{
+			const int end = start + 5;
+			const int otherEnd = otherStart + 11;
+			QCOMPARE(query(track, start, end, &playCursor), scan(track, start, end));
+			QCOMPARE(query(track, otherStart, otherEnd, &otherCursor), scan(track, otherStart, otherEnd));
+			QCOMPARE(query(track, 0, end), scan(track, 0, end));
+			if (rng() % 50 == 0)
+			{
+				track.getClip(rng() % track.numOfClips())->movePosition(static_cast<int>(rng() % 20000));
+			}
+			start = end;
+			otherStart = otherEnd;
+		}
+	}
+
+	void SeeksAndEdits_MatchScan()
+	{
+		using namespace lmms;
+
+		AutomationTrack track(Engine::getSong());
+		auto rng = std::mt19937{7};
+		for (int i = 0; i < 100; ++i)
+		{
+			auto clip = new AutomationClip(&track);
+			clip->movePosition(static_cast<int>(rng() % 5000));
+			clip->changeLength(static_cast<int>(rng() % 100));
+		}
+
+		auto cursor = ClipIndex::Cursor{};
+		int start = 0;
+		for (int i = 0; i < 2000; ++i)
+		{
+			switch (rng() % 8)
+			{
+			case 0: track.getClip(rng() % track.numOfClips())->movePosition(static_cast<int>(rng() % 5000)); break;
+			case 1: track.getClip(rng() % track.numOfClips())->changeLength(static_cast<int>(rng() % 100)); break;
+			case 2: start = static_cast<int>(rng() % 5000); break;
+			case 3: start = 0; break;
+			default: break;
+			}
+			const int end = start + static_cast<int>(rng() % 10);
+			QCOMPARE(query(track, start, end, &cursor), scan(track, start, end));
+			QCOMPARE(query(track, 0, end), scan(track, 0, end));
+			start = end;
+		}
+
+		delete track.getClip(0);
+		QCOMPARE(query(track, 0, 5000), scan(track, 0, 5000));
+	}
+
+	void ExistingResults_StaySorted()
+	{
+		using namespace lmms;
+
+		AutomationTrack first(Engine::getSong());
+		AutomationTrack second(Engine::getSong());
+		for (int i = 0; i < 10; ++i)
+		{
+			(new AutomationClip(&first))->movePosition(i * 20);
+			(new AutomationClip(&second))->movePosition(i * 30);
+		}
+
+		auto clips = clipVector{};
+		first.getClipsInRange(clips, 0, 200);
+		second.getClipsInRange(clips, 0, 200);
+		QCOMPARE(clips.size(), std::size_t{17});
+		QVERIFY(std::is_sorted(clips.begin(), clips.end(), Clip::comparePosition));
+	}
+};
+
+QTEST_GUILESS_MAIN(ClipIndexTest)
+#include "ClipIndexTest.moc"
@@ -0,0 +1,108 @@
+/*
+ * MidiInputQueueTest.cpp
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include <QObject>
+#include <QtTest>
+
+#include "AudioEngineProfiler.h"
+#include "MidiInputQueue.h"
+
+class MidiInputQueueTest : public QObject
+{
+	Q_OBJECT
+private slots:
+	void QueueTests()
+	{
+		using namespace lmms;
+		using namespace std::chrono_literals;
+
+		auto queue = MidiInputQueue{};
+		const auto now = MidiInputQueue::Clock::now();
+
+		QVERIFY(queue.push(MidiEvent(MidiNoteOn, 0, 60, 100), TimePos{}, now));
+		QVERIFY(queue.push(MidiEvent(MidiNoteOff, 0, 60, 0), TimePos{}, now + 1ms));
+
+		auto entry = MidiInputQueue::Entry{};
+		QVERIFY(queue.pop(entry));
+		QCOMPARE(entry.event.type(), MidiNoteOn);
+		QCOMPARE(entry.event.key(), std::int16_t{60});
+		QVERIFY(entry.arrival == now);
+		QVERIFY(queue.pop(entry));
+		QCOMPARE(entry.event.type(), MidiNoteOff);
+		QVERIFY(!queue.pop(entry));
+
+		for (std::size_t i = 0; i < MidiInputQueue::Capacity; ++i)
+		{
+			QVERIFY(queue.push(MidiEvent{}, TimePos{}, now));
+		}
+		QVERIFY(!queue.push(MidiEvent{}, TimePos{}, now));
+	}
+
+	void FrameOffsetTests()
+	{
+		using namespace lmms;
+		using namespace std::chrono_literals;
+
+		const auto previous = MidiInputQueue::Clock::now();
+		const auto current = previous + 10ms;
+
+		QCOMPARE(MidiInputQueue::frameOffset(previous, previous, current, 256), f_cnt_t{0});
+		QCOMPARE(MidiInputQueue::frameOffset(previous + 5ms, previous, current, 256), f_cnt_t{128});
+		QCOMPARE(MidiInputQueue::frameOffset(current, previous, current, 256), f_cnt_t{255});
+
+		// events from before the previous period play right away
+		QCOMPARE(MidiInputQueue::frameOffset(previous - 1s, previous, current, 256), f_cnt_t{0});
+		// so do events arriving while the current period is prepared
+		QCOMPARE(MidiInputQueue::frameOffset(current + 1ms, previous, current, 256), f_cnt_t{255});
+		QCOMPARE(MidiInputQueue::frameOffset(previous + 5ms, previous, previous, 256), f_cnt_t{0});
+	}
+
+	void LatencyHistogramTests()
+	{
+		using namespace lmms;
+		using namespace std::chrono_literals;
+
+		auto profiler = AudioEngineProfiler{};
+		QCOMPARE(profiler.midiInputLatency().events(), std::uint64_t{0});
+		QCOMPARE(profiler.midiInputLatency().percentile(0.5), 0.0);
+
+		for (int i = 0; i < 100; ++i)
+		{
+			profiler.recordMidiInputLatency(5200us);
+		}
+		profiler.recordMidiInputLatency(1h);
+
+		const auto histogram = profiler.midiInputLatency();
+		QCOMPARE(histogram.events(), std::uint64_t{101});
+		QCOMPARE(histogram.counts[10], std::uint64_t{100});
+		QCOMPARE(histogram.counts.back(), std::uint64_t{1});
+
+		const auto median = histogram.percentile(0.5);
+		QVERIFY(median >= 5000.0 && median <= 5500.0);
+
+		profiler.resetMidiInputLatency();
+		QCOMPARE(profiler.midiInputLatency().events(), std::uint64_t{0});
+	}
+};
+
+QTEST_GUILESS_MAIN(MidiInputQueueTest)
+#include "MidiInputQueueTest.moc"
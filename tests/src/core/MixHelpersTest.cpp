@@ -0,0 +1,182 @@
+/*
+ * MixHelpersTest.cpp - compare the planar mixing helpers with the interleaved ones
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+
+#include <QObject>
+#include <QtTest>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "AudioBuffer.h"
+#include "MixHelpers.h"
+#include "SampleFrame.h"
+#include "ValueBuffer.h"
+
+class MixHelpersTest : public QObject
+{
+	Q_OBJECT
+private:
+	// not a multiple of any vector width, so that the scalar tail is tested too
+	static constexpr lmms::f_cnt_t Frames = 253;
+
+	static lmms::SampleFrame sample(lmms::f_cnt_t frame, float frequency)
+	{
+		return {std::sin(frame * frequency), std::cos(frame * frequency * 1.3f)};
+	}
+
+	static std::vector<lmms::SampleFrame> interleaved(float frequency)
+	{
+		auto result = std::vector<lmms::SampleFrame>(Frames);
+		for (lmms::f_cnt_t f = 0; f < Frames; ++f) { result[f] = sample(f, frequency); }
+		return result;
+	}
+
+	//! An AudioBuffer holding the same signal as interleaved(@p frequency)
+	static lmms::AudioBuffer planar(float frequency)
+	{
+		auto result = lmms::AudioBuffer{Frames};
+		for (lmms::f_cnt_t f = 0; f < Frames; ++f)
+		{
+			result.buffer(0)[f] = sample(f, frequency)[0];
+			result.buffer(1)[f] = sample(f, frequency)[1];
+		}
+		return result;
+	}
+
+	static lmms::ValueBuffer values(float frequency, float offset)
+	{
+		auto result = lmms::ValueBuffer{Frames};
+		for (lmms::f_cnt_t f = 0; f < Frames; ++f) { result.values()[f] = std::sin(f * frequency) + offset; }
+		return result;
+	}
+
+	static float maxDifference(const lmms::AudioBuffer& a, const std::vector<lmms::SampleFrame>& b)
+	{
+		float result = 0.f;
+		for (lmms::f_cnt_t f = 0; f < Frames; ++f)
+		{
+			result = std::max({result, std::abs(a.buffer(0)[f] - b[f][0]), std::abs(a.buffer(1)[f] - b[f][1])});
+		}
+		return result;
+	}
+
+	static float maxDifference(const std::vector<lmms::SampleFrame>& a, const std::vector<lmms::SampleFrame>& b)
+	{
+		float result = 0.f;
+		for (lmms::f_cnt_t f = 0; f < Frames; ++f)
+		{
+			result = std::max({result, std::abs(a[f][0] - b[f][0]), std::abs(a[f][1] - b[f][1])});
+		}
+		return result;
+	}
+
+	// the kernels may use fused multiply-adds, which round differently
+	static constexpr float Tolerance = 1e-5f;
+
+private slots:
+	void AddMatchesInterleaved()
+	{
+		using namespace lmms;
+		const auto src = interleaved(0.37f);
+		auto expected = interleaved(0.1f);
+		MixHelpers::add(expected.data(), src.data(), Frames);
+
+		auto planarDst = planar(0.1f);
+		MixHelpers::add(planarDst.groupBuffers(0), planar(0.37f).groupBuffers(0));
+		QVERIFY(maxDifference(planarDst, expected) < Tolerance);
+
+		// play handle output is deinterleaved while it is mixed
+		auto deinterleavedDst = planar(0.1f);
+		MixHelpers::add(deinterleavedDst.groupBuffers(0), src.data());
+		QVERIFY(maxDifference(deinterleavedDst, expected) < Tolerance);
+	}
+
+	void AddMultipliedMatchesInterleaved()
+	{
+		using namespace lmms;
+		auto expected = interleaved(0.1f);
+		MixHelpers::addMultiplied(expected.data(), interleaved(0.37f).data(), 0.7f, Frames);
+
+		auto planarDst = planar(0.1f);
+		MixHelpers::addMultiplied(planarDst.groupBuffers(0), planar(0.37f).groupBuffers(0), 0.7f);
+		QVERIFY(maxDifference(planarDst, expected) < Tolerance);
+
+		// the master channel is interleaved into the output buffer this way
+		auto interleavedDst = interleaved(0.1f);
+		MixHelpers::addMultiplied(interleavedDst.data(), planar(0.37f).groupBuffers(0), 0.7f);
+		QVERIFY(maxDifference(interleavedDst, expected) < Tolerance);
+	}
+
+	void AddMultipliedByBufferMatchesInterleaved()
+	{
+		using namespace lmms;
+		auto coeffs = values(0.01f, 1.f);
+		auto expected = interleaved(0.1f);
+		MixHelpers::addMultipliedByBuffer(expected.data(), interleaved(0.37f).data(), 0.7f, &coeffs, Frames);
+
+		auto actual = planar(0.1f);
+		MixHelpers::addMultipliedByBuffer(actual.groupBuffers(0), planar(0.37f).groupBuffers(0), 0.7f, &coeffs);
+		QVERIFY(maxDifference(actual, expected) < Tolerance);
+	}
+
+	void AddMultipliedByBuffersMatchesInterleaved()
+	{
+		using namespace lmms;
+		auto coeffs1 = values(0.01f, 1.f);
+		auto coeffs2 = values(0.02f, 0.5f);
+		auto expected = interleaved(0.1f);
+		MixHelpers::addMultipliedByBuffers(expected.data(), interleaved(0.37f).data(), &coeffs1, &coeffs2, Frames);
+
+		auto actual = planar(0.1f);
+		MixHelpers::addMultipliedByBuffers(actual.groupBuffers(0), planar(0.37f).groupBuffers(0), &coeffs1, &coeffs2);
+		QVERIFY(maxDifference(actual, expected) < Tolerance);
+	}
+
+	void AddMultipliedManyMatchesAddMultiplied()
+	{
+		using namespace lmms;
+		// more sources than are mixed in one pass
+		constexpr auto Sources = 19;
+		auto srcs = std::vector<AudioBuffer>{};
+		auto views = std::vector<PlanarBufferView<const sample_t>>{};
+		auto coeffs = std::vector<float>{};
+		auto expected = interleaved(0.1f);
+		for (int i = 0; i < Sources; ++i)
+		{
+			const auto frequency = 0.05f + 0.03f * i;
+			const auto coeff = 1.f - 0.1f * i;
+			MixHelpers::addMultiplied(expected.data(), interleaved(frequency).data(), coeff, Frames);
+			srcs.push_back(planar(frequency));
+			coeffs.push_back(coeff);
+		}
+		for (const auto& src : srcs) { views.push_back(src.groupBuffers(0)); }
+
+		auto actual = planar(0.1f);
+		MixHelpers::addMultipliedMany(actual.groupBuffers(0), views, coeffs);
+		QVERIFY(maxDifference(actual, expected) < Tolerance * Sources);
+	}
+};
+
+QTEST_GUILESS_MAIN(MixHelpersTest)
+#include "MixHelpersTest.moc"
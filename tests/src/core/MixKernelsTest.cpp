@@ -0,0 +1,149 @@
+/*
+ * MixKernelsTest.cpp - compare the vectorised mixing kernels with the scalar ones
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+
+#include <QObject>
+#include <QtTest>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "MixKernels.h"
+
+class MixKernelsTest : public QObject
+{
+	Q_OBJECT
+private:
+	// not a multiple of any vector width, so that the scalar tail is tested too
+	static constexpr std::size_t NumSamples = 1003;
+
+	static std::vector<float> signal(float frequency, float offset = 0.f)
+	{
+		auto result = std::vector<float>(NumSamples);
+		for (auto i = std::size_t{0}; i < NumSamples; ++i)
+		{
+			result[i] = std::sin(static_cast<float>(i) * frequency) + offset;
+		}
+		return result;
+	}
+
+	static float maxDifference(const std::vector<float>& a, const std::vector<float>& b)
+	{
+		float result = 0.f;
+		for (auto i = std::size_t{0}; i < a.size(); ++i)
+		{
+			result = std::max(result, std::abs(a[i] - b[i]));
+		}
+		return result;
+	}
+
+	//! Runs @p kernel of the scalar set and of every other set on the same
+	//! input and checks that the results match
+	template<typename F>
+	static void compareWithScalar(F kernel)
+	{
+		const auto sets = lmms::MixKernels::supported();
+		const auto& scalar = *sets.front();
+		for (const auto set : sets)
+		{
+			auto expected = signal(0.1f);
+			auto actual = signal(0.1f);
+			kernel(scalar, expected.data());
+			kernel(*set, actual.data());
+			// fused multiply-adds round differently
+			QVERIFY2(maxDifference(expected, actual) < 1e-5f, set->name);
+		}
+	}
+
+private slots:
+	void KernelsMatchScalar()
+	{
+		using lmms::MixKernels::KernelSet;
+		const auto src = signal(0.37f);
+		const auto coeffs1 = signal(0.01f, 1.f);
+		const auto coeffs2 = signal(0.02f, 0.5f);
+
+		compareWithScalar([&](const KernelSet& set, float* dst) {
+			set.add(dst, src.data(), NumSamples);
+		});
+		compareWithScalar([&](const KernelSet& set, float* dst) {
+			set.addMultiplied(dst, src.data(), 0.7f, NumSamples);
+		});
+		compareWithScalar([&](const KernelSet& set, float* dst) {
+			set.addMultipliedByBuffer(dst, src.data(), 0.7f, coeffs1.data(), NumSamples);
+		});
+		compareWithScalar([&](const KernelSet& set, float* dst) {
+			set.addMultipliedByBuffers(dst, src.data(), coeffs1.data(), coeffs2.data(), NumSamples);
+		});
+		compareWithScalar([&](const KernelSet& set, float* dst) {
+			set.multiplyAndAddMultiplied(dst, src.data(), 0.3f, 0.7f, NumSamples);
+		});
+	}
+
+	void AddMultipliedManyMatchesScalar()
+	{
+		using lmms::MixKernels::KernelSet;
+		const auto srcs = std::array{signal(0.37f), signal(0.11f), signal(0.05f)};
+		const auto srcPtrs = std::array{srcs[0].data(), srcs[1].data(), srcs[2].data()};
+		const auto coeffs = std::array{0.7f, -0.2f, 1.5f};
+
+		for (auto sources = std::size_t{0}; sources <= srcs.size(); ++sources)
+		{
+			compareWithScalar([&](const KernelSet& set, float* dst) {
+				set.addMultipliedMany(dst, srcPtrs.data(), coeffs.data(), sources, NumSamples);
+			});
+		}
+	}
+
+	void IsSilent()
+	{
+		constexpr float Threshold = 0.001f;
+		for (const auto set : lmms::MixKernels::supported())
+		{
+			auto buffer = std::vector<float>(NumSamples, Threshold / 2);
+			QVERIFY2(set->isSilent(buffer.data(), NumSamples, Threshold), set->name);
+
+			// loud samples are found anywhere, including the scalar tail
+			for (const auto index : {std::size_t{0}, NumSamples / 2, NumSamples - 1})
+			{
+				for (const auto loud : {-Threshold, Threshold, std::numeric_limits<float>::quiet_NaN()})
+				{
+					buffer[index] = loud;
+					QVERIFY2(!set->isSilent(buffer.data(), NumSamples, Threshold), set->name);
+					buffer[index] = 0.f;
+				}
+			}
+		}
+	}
+
+	void BestIsSupported()
+	{
+		using namespace lmms::MixKernels;
+		const auto sets = supported();
+		QCOMPARE(&best(), sets.back());
+	}
+};
+
+QTEST_GUILESS_MAIN(MixKernelsTest)
+#include "MixKernelsTest.moc"
@@ -0,0 +1,120 @@
+/*
+ * OscillatorKernelsTest.cpp - compare the vectorised oscillator kernels with
+ *                             the scalar ones
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include <QObject>
+#include <QtTest>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "OscillatorConstants.h"
+#include "OscillatorKernels.h"
+
+class OscillatorKernelsTest : public QObject
+{
+	Q_OBJECT
+private:
+	// not a multiple of any vector width, so that the padded tail is tested too
+	static constexpr std::size_t NumPhases = 1003;
+
+	static std::vector<float> phases()
+	{
+		// negative phases, phases above one and the discontinuities of the
+		// wave shapes at 0.25, 0.5 and 0.75
+		auto result = std::vector<float>(NumPhases);
+		for (auto i = std::size_t{0}; i < NumPhases; ++i)
+		{
+			result[i] = -2.f + static_cast<float>(i) / 200.f;
+		}
+		return result;
+	}
+
+	static float maxDifference(const std::vector<float>& a, const std::vector<float>& b)
+	{
+		float result = 0.f;
+		for (auto i = std::size_t{0}; i < a.size(); ++i)
+		{
+			result = std::max(result, std::abs(a[i] - b[i]));
+		}
+		return result;
+	}
+
+private slots:
+	void ShapesMatchScalar()
+	{
+		using namespace lmms::OscillatorKernels;
+		using Shape = ShapeKernel KernelSet::*;
+		const auto sets = supported();
+		const auto& scalar = *sets.front();
+		const auto in = phases();
+
+		for (const auto set : sets)
+		{
+			for (const Shape shape : {&KernelSet::sine, &KernelSet::triangle, &KernelSet::saw,
+				&KernelSet::square, &KernelSet::moogSaw, &KernelSet::exponential})
+			{
+				auto expected = std::vector<float>(NumPhases);
+				auto actual = std::vector<float>(NumPhases);
+				(scalar.*shape)(in.data(), expected.data(), NumPhases);
+				(set->*shape)(in.data(), actual.data(), NumPhases);
+				// the scalar sine scales its argument in single precision
+				QVERIFY2(maxDifference(expected, actual) < 1e-5f, set->name);
+			}
+		}
+	}
+
+	void TableMatchesScalar()
+	{
+		using namespace lmms::OscillatorKernels;
+		using lmms::OscillatorConstants::WAVETABLE_LENGTH;
+		const auto sets = supported();
+		const auto& scalar = *sets.front();
+		const auto in = phases();
+
+		auto table = std::vector<float>(WAVETABLE_LENGTH);
+		for (auto i = std::size_t{0}; i < table.size(); ++i)
+		{
+			table[i] = std::sin(static_cast<float>(i) * 0.37f);
+		}
+
+		for (const auto set : sets)
+		{
+			auto expected = std::vector<float>(NumPhases);
+			auto actual = std::vector<float>(NumPhases);
+			scalar.table(table.data(), in.data(), expected.data(), NumPhases);
+			set->table(table.data(), in.data(), actual.data(), NumPhases);
+			QVERIFY2(maxDifference(expected, actual) < 1e-5f, set->name);
+		}
+	}
+
+	void BestIsSupported()
+	{
+		using namespace lmms::OscillatorKernels;
+		const auto sets = supported();
+		QCOMPARE(&best(), sets.back());
+	}
+};
+
+QTEST_GUILESS_MAIN(OscillatorKernelsTest)
+#include "OscillatorKernelsTest.moc"
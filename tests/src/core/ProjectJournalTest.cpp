@@ -0,0 +1,252 @@
+/*
+ * ProjectJournalTest.cpp
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include <QObject>
+#include <QtTest>
+
+#include <QDomElement>
+
+#include <memory>
+#include <vector>
+
+#include "AutomatableModel.h"
+#include "ConfigManager.h"
+#include "Engine.h"
+#include "JournallingObject.h"
+#include "ProjectJournal.h"
+
+namespace
+{
+
+//! Like a clip with many notes, each value is saved as a node of its own
+class ValueList : public lmms::JournallingObject
+{
+public:
+	std::vector<int> values;
+
+	QString nodeName() const override { return "valuelist"; }
+
+	void setValue(std::size_t index, int value)
+	{
+		addJournalCheckPoint();
+		values[index] = value;
+	}
+
+protected:
+	void saveSettings(QDomDocument& doc, QDomElement& element) override
+	{
+		for (const auto value : values)
+		{
+			auto node = doc.createElement("value");
+			node.setAttribute("v", value);
+			element.appendChild(node);
+		}
+	}
+
+	void loadSettings(const QDomElement& element) override
+	{
+		values.clear();
+		for (auto node = element.firstChildElement("value"); !node.isNull(); node = node.nextSiblingElement("value"))
+		{
+			values.push_back(node.attribute("v").toInt());
+		}
+	}
+};
+
+} // namespace
+
+class ProjectJournalTest : public QObject
+{
+	Q_OBJECT
+private slots:
+	void initTestCase()
+	{
+		using namespace lmms;
+		Engine::init(true);
+	}
+
+	void cleanupTestCase()
+	{
+		using namespace lmms;
+		Engine::destroy();
+	}
+
+	void UndoRedoTests()
+	{
+		using namespace lmms;
+		auto journal = Engine::projectJournal();
+		journal->clearJournal();
+
+		FloatModel a(0.f, 0.f, 10.f, 1.f);
+		FloatModel b(0.f, 0.f, 10.f, 1.f);
+
+		// check points of different objects in between aren't merged
+		a.setValue(1.f);
+		b.setValue(1.f);
+		a.setValue(2.f);
+		QVERIFY(journal->undoMemory() > 0);
+
+		journal->undo();
+		QCOMPARE(a.value(), 1.f);
+		journal->undo();
+		QCOMPARE(b.value(), 0.f);
+		journal->undo();
+		QCOMPARE(a.value(), 0.f);
+		QVERIFY(!journal->canUndo());
+
+		journal->redo();
+		journal->redo();
+		journal->redo();
+		QCOMPARE(a.value(), 2.f);
+		QCOMPARE(b.value(), 1.f);
+		QVERIFY(!journal->canRedo());
+
+		journal->undo();
+		journal->undo();
+		QCOMPARE(a.value(), 1.f);
+		QCOMPARE(b.value(), 0.f);
+
+		journal->clearJournal();
+		QCOMPARE(journal->undoMemory(), qsizetype{0});
+	}
+
+	void CoalesceTests()
+	{
+		using namespace lmms;
+		auto journal = Engine::projectJournal();
+		journal->clearJournal();
+
+		FloatModel a(0.f, 0.f, 10.f, 1.f);
+
+		// like a widget handling scroll wheel steps
+		const auto scrollTo = [&a](float value) {
+			a.addJournalCheckPoint(true);
+			a.saveJournallingState(false);
+			a.setValue(value);
+			a.restoreJournallingState();
+		};
+
+		// quick coalesced edits of the same object are undone at once
+		scrollTo(1.f);
+		scrollTo(2.f);
+		scrollTo(3.f);
+		journal->undo();
+		QCOMPARE(a.value(), 0.f);
+		QVERIFY(!journal->canUndo());
+
+		// an edit right after undoing isn't merged with the undone one
+		journal->redo();
+		QCOMPARE(a.value(), 3.f);
+		journal->undo();
+		scrollTo(5.f);
+		journal->undo();
+		QCOMPARE(a.value(), 0.f);
+
+		// other edits are never merged, however quick they are
+		a.setValue(1.f);
+		a.setValue(2.f);
+		scrollTo(3.f);
+		a.setValue(4.f);
+		journal->undo();
+		QCOMPARE(a.value(), 3.f);
+		journal->undo();
+		QCOMPARE(a.value(), 2.f);
+		journal->undo();
+		QCOMPARE(a.value(), 1.f);
+
+		journal->clearJournal();
+	}
+
+	void DeltaTests()
+	{
+		using namespace lmms;
+		auto journal = Engine::projectJournal();
+		journal->clearJournal();
+
+		auto list = ValueList{};
+		for (int i = 0; i < 2000; ++i) { list.values.push_back(i * 7919 % 10007); }
+		const auto original = list.values;
+
+		list.setValue(0, -1);
+		const auto fullSize = journal->undoMemory();
+
+		// changes far apart only keep the nodes that changed, not everything in between
+		for (int step = 0; step < 20; ++step)
+		{
+			list.setValue(0, step);
+			list.setValue(list.values.size() - 1, step);
+		}
+		QVERIFY(journal->undoMemory() < 2 * fullSize);
+
+		for (int step = 19; step >= 0; --step)
+		{
+			const int previous = step == 0 ? original.back() : step - 1;
+			journal->undo();
+			QCOMPARE(list.values.front(), step);
+			QCOMPARE(list.values.back(), previous);
+			journal->undo();
+			QCOMPARE(list.values.front(), step == 0 ? -1 : step - 1);
+			QCOMPARE(list.values.back(), previous);
+		}
+		journal->undo();
+		QVERIFY(list.values == original);
+		QVERIFY(!journal->canUndo());
+
+		journal->clearJournal();
+	}
+
+	void MemoryLimitTests()
+	{
+		using namespace lmms;
+		auto journal = Engine::projectJournal();
+		auto config = ConfigManager::inst();
+		const auto oldLimit = config->value("app", "undomemorylimit", "64");
+
+		// the limit is in MB, this leaves room for a few check points only
+		config->setValue("app", "undomemorylimit", "0.001");
+		journal->clearJournal();
+
+		auto models = std::vector<std::unique_ptr<FloatModel>>{};
+		for (int i = 0; i < 100; ++i)
+		{
+			models.push_back(std::make_unique<FloatModel>(0.f, 0.f, 10.f, 1.f));
+			models.back()->setValue(1.f);
+			QVERIFY(journal->undoMemory() <= 1024 * 1024 / 1000 + 1);
+		}
+
+		// only the newest steps are left
+		int steps = 0;
+		for (; journal->canUndo(); ++steps) { journal->undo(); }
+		QVERIFY(steps > 0);
+		QVERIFY(steps < 100);
+		for (int i = 0; i < 100; ++i)
+		{
+			QCOMPARE(models[i]->value(), i < 100 - steps ? 1.f : 0.f);
+		}
+
+		config->setValue("app", "undomemorylimit", oldLimit);
+		journal->clearJournal();
+	}
+};
+
+QTEST_GUILESS_MAIN(ProjectJournalTest)
+#include "ProjectJournalTest.moc"
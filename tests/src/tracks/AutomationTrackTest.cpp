@@ -24,6 +24,8 @@
 
 #include <QtTest>
 
+#include <array>
+
 
 #include "AutomationClip.h"
 #include "AutomationTrack.h"
@@ -85,6 +87,51 @@ private slots:
 		QCOMPARE(c.valueAt(150), 1.0f);
 	}
 
+	void testClipEditedAfterEvaluation()
+	{
+		using namespace lmms;
+
+		AutomationClip c(nullptr);
+		c.setProgressionType(AutomationClip::ProgressionType::Linear);
+		c.putValue(0, 0.0, false);
+		c.putValue(100, 1.0, false);
+		QCOMPARE(c.valueAt(50), 0.5f);
+
+		c.putValue(100, 0.0, false);
+		QCOMPARE(c.valueAt(50), 0.0f);
+
+		c.setProgressionType(AutomationClip::ProgressionType::Discrete);
+		c.putValue(100, 1.0, false);
+		QCOMPARE(c.valueAt(50), 0.0f);
+
+		c.getTimeMap()[0].setOutValue(0.25f);
+		QCOMPARE(c.valueAt(50), 0.25f);
+
+		c.clear();
+		QCOMPARE(c.valueAt(50), 0.0f);
+	}
+
+	void testClipBetweenTicks()
+	{
+		using namespace lmms;
+
+		AutomationClip c(nullptr);
+		c.setProgressionType(AutomationClip::ProgressionType::Linear);
+		c.putValue(0, 0.0, false);
+		c.putValue(100, 1.0, false);
+		c.putValue(200, 0.0, false);
+
+		QCOMPARE(c.valueAt(25.5f), 0.255f);
+		QCOMPARE(c.valueAt(150.f), 0.5f);
+
+		auto values = std::array<float, 4>{};
+		c.valuesAt(99.f, 0.5f, 100.f, values);
+		QCOMPARE(values[0], 0.99f);
+		QCOMPARE(values[1], 0.995f);
+		QCOMPARE(values[2], 1.0f);
+		QCOMPARE(values[3], 1.0f);
+	}
+
 	void testClips()
 	{
 		using namespace lmms;